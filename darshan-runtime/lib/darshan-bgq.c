@@ -65,8 +65,8 @@ static void bgq_cleanup(
     void);
 
 /* macros for obtaining/releasing the BGQ module lock */
-#define BGQ_LOCK() pthread_mutex_lock(&bgq_runtime_mutex)
-#define BGQ_UNLOCK() pthread_mutex_unlock(&bgq_runtime_mutex)
+#define BGQ_LOCK() DARSHAN_MOD_LOCK(DARSHAN_BGQ_MOD, &bgq_runtime_mutex)
+#define BGQ_UNLOCK() DARSHAN_MOD_UNLOCK(DARSHAN_BGQ_MOD, &bgq_runtime_mutex)
 
 /*
  * Function which updates all the counter data
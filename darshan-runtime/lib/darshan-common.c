@@ -12,6 +12,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <limits.h>
 #include <search.h>
@@ -21,8 +22,124 @@
 
 #include "darshan.h"
 
+/* chunk header, padded so that allocations stay aligned */
+union darshan_arena_chunk
+{
+    union darshan_arena_chunk *next;
+    char pad[DARSHAN_ARENA_ALIGN];
+};
+
+static int darshan_arena_new_chunk(struct darshan_arena *arena, size_t size)
+{
+    union darshan_arena_chunk *chunk;
+
+    chunk = malloc(sizeof(*chunk) + size);
+    if(!chunk)
+        return(-1);
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    arena->reserved += sizeof(*chunk) + size;
+    if(__darshan_core_overhead_flag)
+        darshan_core_overhead_memory(arena->slot, sizeof(*chunk) + size);
+
+    return(0);
+}
+
+void darshan_arena_init(struct darshan_arena *arena, int slot)
+{
+    memset(arena, 0, sizeof(*arena));
+    arena->slot = slot;
+
+    return;
+}
+
+void *darshan_arena_alloc(struct darshan_arena *arena, size_t size)
+{
+    void *ptr;
+    void **free_list;
+
+    if(!arena)
+        return(calloc(1, size));
+
+    size = (size + DARSHAN_ARENA_ALIGN - 1) & ~(size_t)(DARSHAN_ARENA_ALIGN - 1);
+    if(size == 0)
+        size = DARSHAN_ARENA_ALIGN;
+    if(size > DARSHAN_ARENA_MAX_CLASS_SIZE)
+    {
+        /* too large to recycle, give it a chunk of its own */
+        if(darshan_arena_new_chunk(arena, size) < 0)
+            return(NULL);
+        ptr = (union darshan_arena_chunk *)arena->chunks + 1;
+        memset(ptr, 0, size);
+        return(ptr);
+    }
+
+    /* reuse freed memory of the same size class first */
+    free_list = &arena->free_lists[size / DARSHAN_ARENA_ALIGN - 1];
+    if(*free_list)
+    {
+        ptr = *free_list;
+        *free_list = *(void **)ptr;
+        memset(ptr, 0, size);
+        return(ptr);
+    }
+
+    if(arena->end - arena->next < (ptrdiff_t)size)
+    {
+        /* the remainder of the current chunk is abandoned */
+        if(darshan_arena_new_chunk(arena, DARSHAN_ARENA_CHUNK_SIZE) < 0)
+            return(NULL);
+        arena->next = (char *)((union darshan_arena_chunk *)arena->chunks + 1);
+        arena->end = arena->next + DARSHAN_ARENA_CHUNK_SIZE;
+    }
+    ptr = arena->next;
+    arena->next += size;
+    memset(ptr, 0, size);
+
+    return(ptr);
+}
+
+void darshan_arena_free(struct darshan_arena *arena, void *ptr, size_t size)
+{
+    void **free_list;
+
+    if(!arena)
+    {
+        free(ptr);
+        return;
+    }
+
+    size = (size + DARSHAN_ARENA_ALIGN - 1) & ~(size_t)(DARSHAN_ARENA_ALIGN - 1);
+    if(!ptr || size > DARSHAN_ARENA_MAX_CLASS_SIZE)
+        return;
+    if(size == 0)
+        size = DARSHAN_ARENA_ALIGN;
+
+    free_list = &arena->free_lists[size / DARSHAN_ARENA_ALIGN - 1];
+    *(void **)ptr = *free_list;
+    *free_list = ptr;
+
+    return;
+}
+
+void darshan_arena_destroy(struct darshan_arena *arena)
+{
+    union darshan_arena_chunk *chunk, *next;
+
+    for(chunk = arena->chunks; chunk; chunk = next)
+    {
+        next = chunk->next;
+        free(chunk);
+    }
+    if(__darshan_core_overhead_flag && arena->reserved)
+        darshan_core_overhead_memory(arena->slot, -(ssize_t)arena->reserved);
+    darshan_arena_init(arena, arena->slot);
+
+    return;
+}
+
 int darshan_add_record_ref(void **hash_head_p, void *handle, size_t handle_sz,
-    void *rec_ref_p)
+    void *rec_ref_p, struct darshan_arena *arena)
 {
     struct darshan_record_ref_tracker *ref_tracker;
     struct darshan_record_ref_tracker *ref_tracker_head =
@@ -30,10 +147,9 @@ int darshan_add_record_ref(void **hash_head_p, void *handle, size_t handle_sz,
     void *handle_p;
 
     /* allocate a reference tracker, with room to store the handle at the end */
-    ref_tracker = malloc(sizeof(*ref_tracker) + handle_sz);
+    ref_tracker = darshan_arena_alloc(arena, sizeof(*ref_tracker) + handle_sz);
     if(!ref_tracker)
         return(0);
-    memset(ref_tracker, 0, sizeof(*ref_tracker) + handle_sz);
 
     /* initialize the reference tracker and add it to the hash table */
     ref_tracker->rec_ref_p = rec_ref_p;
@@ -44,7 +160,8 @@ int darshan_add_record_ref(void **hash_head_p, void *handle, size_t handle_sz,
     return(1);
 }
 
-void *darshan_delete_record_ref(void **hash_head_p, void *handle, size_t handle_sz)
+void *darshan_delete_record_ref(void **hash_head_p, void *handle, size_t handle_sz,
+    struct darshan_arena *arena)
 {
     struct darshan_record_ref_tracker *ref_tracker;
     struct darshan_record_ref_tracker *ref_tracker_head =
@@ -60,17 +177,28 @@ void *darshan_delete_record_ref(void **hash_head_p, void *handle, size_t handle_
     HASH_DELETE(hlink, ref_tracker_head, ref_tracker);
     *hash_head_p = ref_tracker_head;
     rec_ref_p = ref_tracker->rec_ref_p;
-    free(ref_tracker);
+    darshan_arena_free(arena, ref_tracker, sizeof(*ref_tracker) + handle_sz);
 
     return(rec_ref_p);
 }
 
-void darshan_clear_record_refs(void **hash_head_p, int free_flag)
+void darshan_clear_record_refs(void **hash_head_p, int free_flag,
+    struct darshan_arena *arena)
 {
     struct darshan_record_ref_tracker *ref_tracker, *tmp;
     struct darshan_record_ref_tracker *ref_tracker_head =
         *(struct darshan_record_ref_tracker **)hash_head_p;
 
+    if(arena)
+    {
+        /* trackers and references go away with the arena, so only the
+         * hash table's own bookkeeping needs to be freed
+         */
+        HASH_CLEAR(hlink, ref_tracker_head);
+        *hash_head_p = ref_tracker_head;
+        return;
+    }
+
     /* iterate the hash table and remove/free all reference trackers */
     HASH_ITER(hlink, ref_tracker_head, ref_tracker, tmp)
     {
@@ -203,7 +331,8 @@ static int darshan_common_vals_compare(const void *a_p, const void *b_p)
 }
 
 struct darshan_common_val_counter *darshan_track_common_val_counters(
-    void **common_val_root, int64_t *vals, int nvals, int *common_val_count)
+    void **common_val_root, int64_t *vals, int nvals, int *common_val_count,
+    struct darshan_arena *arena)
 {
     struct darshan_common_val_counter* counter;
     struct darshan_common_val_counter* found = NULL;
@@ -225,7 +354,7 @@ struct darshan_common_val_counter *darshan_track_common_val_counters(
     else if(*common_val_count < DARSHAN_COMMON_VAL_MAX_RUNTIME_COUNT)
     {
         /* we can add a new one as long as we haven't hit the limit */
-        counter = malloc(sizeof(*counter));
+        counter = darshan_arena_alloc(arena, sizeof(*counter));
         if(!counter)
         {
             return(NULL);
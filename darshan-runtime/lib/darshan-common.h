@@ -161,6 +161,71 @@ struct darshan_variance_dt
 * darshan-common functions for darshan modules *
 ***********************************************/
 
+/* allocations of up to DARSHAN_ARENA_MAX_CLASS_SIZE bytes are rounded up to
+ * a multiple of DARSHAN_ARENA_ALIGN bytes and recycled through a free list
+ * per size class; larger allocations get a chunk of their own
+ */
+#define DARSHAN_ARENA_ALIGN 16
+#define DARSHAN_ARENA_MAX_CLASS_SIZE 512
+#define DARSHAN_ARENA_CHUNK_SIZE (64*1024)
+
+/* module-private allocator for small, long-lived runtime structures
+ * (record references, handle mappings, common value counters), which are
+ * all released at once when the module is cleaned up
+ */
+struct darshan_arena
+{
+    void *chunks;   /* chunks obtained from malloc, linked by their first word */
+    char *next;     /* next free byte of the current chunk */
+    char *end;      /* end of the current chunk */
+    void *free_lists[DARSHAN_ARENA_MAX_CLASS_SIZE / DARSHAN_ARENA_ALIGN];
+    size_t reserved; /* total size of all chunks */
+    int slot;       /* overhead accounting slot to report memory usage to */
+};
+
+/* darshan_arena_init()
+ *
+ * Initialize the (empty) arena 'arena', reporting the memory it holds to
+ * overhead accounting slot 'slot' (typically the module id).
+ */
+void darshan_arena_init(
+    struct darshan_arena *arena,
+    int slot);
+
+/* darshan_arena_alloc()
+ *
+ * Allocate 'size' bytes of zeroed memory from 'arena', or from the heap
+ * if 'arena' is NULL. Returns NULL if out of memory.
+ */
+void *darshan_arena_alloc(
+    struct darshan_arena *arena,
+    size_t size);
+
+/* darshan_arena_free()
+ *
+ * Return memory allocated with darshan_arena_alloc() for the same
+ * 'size' to 'arena' for reuse (or to the heap if 'arena' is NULL).
+ * Allocations larger than DARSHAN_ARENA_MAX_CLASS_SIZE are only released
+ * by darshan_arena_destroy().
+ */
+void darshan_arena_free(
+    struct darshan_arena *arena,
+    void *ptr,
+    size_t size);
+
+/* darshan_arena_destroy()
+ *
+ * Release all memory allocated from 'arena' at once.
+ */
+void darshan_arena_destroy(
+    struct darshan_arena *arena);
+
+/* tdestroy() callback for trees whose nodes were allocated from an arena */
+static inline void darshan_arena_tree_nofree(void *node)
+{
+    (void)node;
+}
+
 /* track opaque record referencre using a hash link */
 struct darshan_record_ref_tracker
 {
@@ -195,6 +260,8 @@ static inline void *darshan_lookup_record_ref(void *hash_head, void *handle, siz
  * Add the given record reference pointer, 'rec_ref_p' to the hash
  * table whose address is stored in the 'hash_head_p' pointer. The
  * hash is generated from the given 'handle', with size 'handle_sz'.
+ * The reference tracker is allocated from 'arena', or from the heap
+ * if 'arena' is NULL.
  * If the record reference is successfully added, 1 is returned,
  * otherwise, 0 is returned.
  */
@@ -202,30 +269,36 @@ int darshan_add_record_ref(
     void **hash_head_p,
     void *handle,
     size_t handle_sz,
-    void *rec_ref_p);
+    void *rec_ref_p,
+    struct darshan_arena *arena);
 
 /* darshan_delete_record_ref()
  *
  * Delete the record reference for the given 'handle', with size
  * 'handle_sz', from the hash table whose address is stored in
- * the 'hash_head_p' pointer.
+ * the 'hash_head_p' pointer. 'arena' is the arena the record reference
+ * was added with.
  * On success deletion, the corresponding record reference pointer
  * is returned, otherwise NULL is returned.
  */
 void *darshan_delete_record_ref(
     void **hash_head_p,
     void *handle,
-    size_t handle_sz);
+    size_t handle_sz,
+    struct darshan_arena *arena);
 
 /* darshan_clear_record_refs()
  *
  * Clear all record references from the hash table stored in the
  * 'hash_head_p' pointer. If 'free_flag' is set, the corresponding
- * record_reference_pointer is also freed.
+ * record_reference_pointer is also freed. If the references were added
+ * with an 'arena', neither are freed individually; they are released
+ * along with the arena by darshan_arena_destroy().
  */
 void darshan_clear_record_refs(
     void **hash_head_p,
-    int free_flag);
+    int free_flag,
+    struct darshan_arena *arena);
 
 /* darshan_iter_record_ref()
  *
@@ -276,13 +349,17 @@ void darshan_record_sort(
  * 'common_val_count' is a pointer to the number of nodes in the
  * tree (i.e., the number of allocated common value counters), 'vals'
  * is the set of new values to attempt to add, and 'nvals' is the
- * total number of values in the 'vals' pointer.
+ * total number of values in the 'vals' pointer. New counters are
+ * allocated from 'arena' (or from the heap if NULL); trees of counters
+ * allocated from an arena should be destroyed with
+ * darshan_arena_tree_nofree() as the free function.
  */
 struct darshan_common_val_counter *darshan_track_common_val_counters(
     void **common_val_root,
     int64_t *vals,
     int nvals,
-    int *common_val_count);
+    int *common_val_count,
+    struct darshan_arena *arena);
 
 #ifdef HAVE_MPI
 /* darshan_variance_reduce()
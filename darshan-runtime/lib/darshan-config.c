@@ -42,6 +42,44 @@ char* darshan_path_inclusions[] = {
 /* allow users to override the path exclusions */
 char** user_darshan_path_exclusions = NULL;
 
+#define DARSHAN_NAME_RULE_EXCLUDE 1
+#define DARSHAN_NAME_RULE_INCLUDE 2
+
+/* node of a prefix trie over path exclusions and inclusions; the children
+ * of a node are kept in a list linked through their sibling indices
+ */
+struct darshan_name_trie_node
+{
+    char c;
+    int flags;
+    int child;
+    int sibling;
+};
+
+/* path exclusions and inclusions are merged into one trie, so a name is
+ * checked against all of them in a single walk that stops at the first
+ * character no rule shares.  The NAME_EXCLUDE and NAME_INCLUDE regexes
+ * that apply to a module are combined into one alternation, so each name
+ * is matched by a single regexec() call per rule type; modules with the
+ * same rules share the combined regex.
+ */
+struct darshan_name_rules
+{
+    struct darshan_name_trie_node *nodes;
+    int n_nodes;
+    int max_nodes;
+    regex_t regexes[2 * DARSHAN_KNOWN_MODULE_COUNT];
+    char *regex_strs[2 * DARSHAN_KNOWN_MODULE_COUNT];
+    int n_regexes;
+    /* index of the combined regex of each module, or -1 if none apply */
+    int exclusion[DARSHAN_KNOWN_MODULE_COUNT];
+    int inclusion[DARSHAN_KNOWN_MODULE_COUNT];
+    /* set if the regexes could not be combined, in which case the regex
+     * lists of the config are used
+     */
+    int use_lists;
+};
+
 /* helper to convert csv of module names to a module id bit field */
 static uint64_t darshan_module_csv_to_flags(char *mod_csv)
 {
@@ -79,11 +117,33 @@ static uint64_t darshan_module_csv_to_flags(char *mod_csv)
     return(mod_flags);
 }
 
+/* parse the huge page backing of instrumentation memory ("none",
+ * "transparent" or "explicit"), returning -1 for an invalid setting
+ */
+static int darshan_parse_huge_pages(char *str)
+{
+    if(!str)
+        return(-1);
+    if(strcmp(str, "none") == 0)
+        return(DARSHAN_HUGE_PAGES_NONE);
+    if(strcmp(str, "transparent") == 0)
+        return(DARSHAN_HUGE_PAGES_TRANSPARENT);
+    if(strcmp(str, "explicit") == 0)
+        return(DARSHAN_HUGE_PAGES_EXPLICIT);
+
+    darshan_core_fprintf(stderr, "darshan library warning: "\
+        "invalid huge page setting \"%s\"\n", str);
+    return(-1);
+}
+
 void darshan_init_config(struct darshan_config *cfg)
 {
     cfg->mod_mem = DARSHAN_MOD_MEM_MAX;
     cfg->name_mem = DARSHAN_NAME_MEM_MAX;
+    cfg->mod_mem_max = DARSHAN_MOD_MEM_LIMIT;
+    cfg->name_mem_max = DARSHAN_NAME_MEM_LIMIT;
     cfg->mem_alignment = __DARSHAN_MEM_ALIGNMENT;
+    cfg->huge_pages = DARSHAN_HUGE_PAGES_NONE;
     cfg->jobid_env = strdup(__DARSHAN_JOBID);
     cfg->log_hints = strdup(__DARSHAN_LOG_HINTS);
 #ifdef __DARSHAN_LOG_PATH
@@ -92,9 +152,10 @@ void darshan_init_config(struct darshan_config *cfg)
 #ifdef __DARSHAN_ENABLE_MMAP_LOGS
     cfg->mmap_log_path = strdup(DARSHAN_DEF_MMAP_LOG_PATH);
 #endif
-    /* enable all modules except DXT by default */
+    /* enable all modules except DXT and OVERLAP by default */
     DARSHAN_MOD_FLAG_SET(cfg->mod_disabled, DXT_POSIX_MOD);
     DARSHAN_MOD_FLAG_SET(cfg->mod_disabled, DXT_MPIIO_MOD);
+    DARSHAN_MOD_FLAG_SET(cfg->mod_disabled, DARSHAN_OVERLAP_MOD);
 #ifndef DARSHAN_BGQ
     DARSHAN_MOD_FLAG_SET(cfg->mod_disabled, DARSHAN_BGQ_MOD);
 #endif
@@ -147,6 +208,29 @@ void darshan_parse_config_env(struct darshan_config *cfg)
         if(success)
             cfg->name_mem *= (1024 * 1024); /* convert from MiB */
     }
+    /* allow override of the limits module and name record memory can grow to */
+    envstr = getenv(DARSHAN_MOD_MEM_LIMIT_OVERRIDE);
+    if(envstr)
+    {
+        DARSHAN_PARSE_NUMBER_FROM_STR(envstr, size_t, cfg->mod_mem_max, success);
+        if(success)
+            cfg->mod_mem_max *= (1024 * 1024); /* convert from MiB */
+    }
+    envstr = getenv(DARSHAN_NAME_MEM_LIMIT_OVERRIDE);
+    if(envstr)
+    {
+        DARSHAN_PARSE_NUMBER_FROM_STR(envstr, size_t, cfg->name_mem_max, success);
+        if(success)
+            cfg->name_mem_max *= (1024 * 1024); /* convert from MiB */
+    }
+    /* allow instrumentation memory to be backed by huge pages */
+    envstr = getenv(DARSHAN_HUGE_PAGES_OVERRIDE);
+    if(envstr)
+    {
+        ret = darshan_parse_huge_pages(envstr);
+        if(ret >= 0)
+            cfg->huge_pages = ret;
+    }
     /* allow override of darshan memory alignment value */
     #if (__DARSHAN_MEM_ALIGNMENT < 1)
         #error Darshan must be configured with a positive value for --with-mem-align
@@ -442,10 +526,24 @@ void darshan_parse_config_env(struct darshan_config *cfg)
             }
         }
     }
+    envstr = getenv("DARSHAN_OVERLAP_BLOCK_SIZE");
+    if(envstr)
+    {
+        DARSHAN_PARSE_NUMBER_FROM_STR(envstr, int64_t, cfg->overlap_block_size,
+            success);
+    }
+    envstr = getenv("DARSHAN_OVERLAP_MAX_EXTENTS");
+    if(envstr)
+    {
+        DARSHAN_PARSE_NUMBER_FROM_STR(envstr, int, cfg->overlap_max_extents,
+            success);
+    }
     if(getenv("DARSHAN_DUMP_CONFIG"))
         cfg->dump_config_flag = 1;
     if(getenv("DARSHAN_INTERNAL_TIMING"))
         cfg->internal_timing_flag = 1;
+    if(getenv("DARSHAN_OVERHEAD_ACCOUNTING"))
+        cfg->overhead_accounting_flag = 1;
     if(getenv("DARSHAN_DISABLE_SHARED_REDUCTION"))
         cfg->disable_shared_redux_flag = 1;
 
@@ -513,6 +611,27 @@ void darshan_parse_config_file(struct darshan_config *cfg)
                 if(success)
                     cfg->name_mem *= (1024 * 1024); /* convert from MiB */
             }
+            else if(strcmp(key, "MODMEM_MAX") == 0)
+            {
+                val = strtok(NULL, " \t");
+                DARSHAN_PARSE_NUMBER_FROM_STR(val, size_t, cfg->mod_mem_max, success);
+                if(success)
+                    cfg->mod_mem_max *= (1024 * 1024); /* convert from MiB */
+            }
+            else if(strcmp(key, "NAMEMEM_MAX") == 0)
+            {
+                val = strtok(NULL, " \t");
+                DARSHAN_PARSE_NUMBER_FROM_STR(val, size_t, cfg->name_mem_max, success);
+                if(success)
+                    cfg->name_mem_max *= (1024 * 1024); /* convert from MiB */
+            }
+            else if(strcmp(key, "HUGEPAGES") == 0)
+            {
+                val = strtok(NULL, " \t");
+                ret = darshan_parse_huge_pages(val);
+                if(ret >= 0)
+                    cfg->huge_pages = ret;
+            }
             else if(strcmp(key, "MEM_ALIGNMENT") == 0)
             {
                 val = strtok(NULL, " \t");
@@ -823,10 +942,24 @@ void darshan_parse_config_file(struct darshan_config *cfg)
                     }
                 }
             }
+            else if(strcmp(key, "OVERLAP_BLOCK_SIZE") == 0)
+            {
+                val = strtok(NULL, " \t");
+                DARSHAN_PARSE_NUMBER_FROM_STR(val, int64_t,
+                    cfg->overlap_block_size, success);
+            }
+            else if(strcmp(key, "OVERLAP_MAX_EXTENTS") == 0)
+            {
+                val = strtok(NULL, " \t");
+                DARSHAN_PARSE_NUMBER_FROM_STR(val, int,
+                    cfg->overlap_max_extents, success);
+            }
             else if(strcmp(key, "DUMP_CONFIG") == 0)
                 cfg->dump_config_flag = 1;
             else if(strcmp(key, "INTERNAL_TIMING") == 0)
                 cfg->internal_timing_flag = 1;
+            else if(strcmp(key, "OVERHEAD_ACCOUNTING") == 0)
+                cfg->overhead_accounting_flag = 1;
             else if(strcmp(key, "DISABLE_SHARED_REDUCTION") == 0)
                 cfg->disable_shared_redux_flag = 1;
             else
@@ -858,6 +991,12 @@ void darshan_dump_config(struct darshan_config *cfg)
     fprintf(stderr, "##########################\n");
     fprintf(stderr, "# MODMEM = %ld MiB\n", cfg->mod_mem / 1024 / 1024);
     fprintf(stderr, "# NAMEMEM = %ld KiB\n", cfg->name_mem / 1024);
+    fprintf(stderr, "# MODMEM_MAX = %ld MiB\n", cfg->mod_mem_max / 1024 / 1024);
+    fprintf(stderr, "# NAMEMEM_MAX = %ld MiB\n", cfg->name_mem_max / 1024 / 1024);
+    fprintf(stderr, "# HUGEPAGES = %s\n",
+        (cfg->huge_pages == DARSHAN_HUGE_PAGES_EXPLICIT) ? "explicit" :
+        (cfg->huge_pages == DARSHAN_HUGE_PAGES_TRANSPARENT) ? "transparent" :
+        "none");
     fprintf(stderr, "# MEM_ALIGNMENT = %d bytes\n", cfg->mem_alignment);
     fprintf(stderr, "# JOBID = %s\n", cfg->jobid_env);
     fprintf(stderr, "# LOGHINTS = %s\n", (strlen(cfg->log_hints) > 0) ?
@@ -925,6 +1064,12 @@ void darshan_dump_config(struct darshan_config *cfg)
         fprintf(stderr, "# DXT_UNALIGNED_IO_TRIGGER = %.2lf\n",
             cfg->unaligned_io_trigger->u.unaligned_io.thresh_pct);
     }
+    if(cfg->overlap_block_size > 0)
+        fprintf(stderr, "# OVERLAP_BLOCK_SIZE = %" PRId64 "\n",
+            cfg->overlap_block_size);
+    if(cfg->overlap_max_extents > 0)
+        fprintf(stderr, "# OVERLAP_MAX_EXTENTS = %d\n",
+            cfg->overlap_max_extents);
     for(i = 1; i < DARSHAN_KNOWN_MODULE_COUNT; i++)
     {
         fprintf(stderr, "# %s MODULE CONFIG:\n", darshan_module_names[i]);
@@ -977,6 +1122,306 @@ void darshan_dump_config(struct darshan_config *cfg)
     fprintf(stderr, "##########################\n");
 }
 
+static int darshan_name_trie_add(
+    struct darshan_name_rules *rules, const char *prefix, int flag)
+{
+    struct darshan_name_trie_node *tmp_nodes;
+    int node = 0;
+    int child;
+
+    for(; *prefix; prefix++)
+    {
+        for(child = rules->nodes[node].child; child >= 0;
+            child = rules->nodes[child].sibling)
+        {
+            if(rules->nodes[child].c == *prefix)
+                break;
+        }
+        if(child < 0)
+        {
+            if(rules->n_nodes == rules->max_nodes)
+            {
+                tmp_nodes = realloc(rules->nodes,
+                    2 * rules->max_nodes * sizeof(*rules->nodes));
+                if(!tmp_nodes)
+                    return(-1);
+                rules->nodes = tmp_nodes;
+                rules->max_nodes *= 2;
+            }
+            child = rules->n_nodes++;
+            rules->nodes[child].c = *prefix;
+            rules->nodes[child].flags = 0;
+            rules->nodes[child].child = -1;
+            rules->nodes[child].sibling = rules->nodes[node].child;
+            rules->nodes[node].child = child;
+        }
+        node = child;
+    }
+    rules->nodes[node].flags |= flag;
+
+    return(0);
+}
+
+/* returns the rule flags of all path prefixes of the given name */
+static int darshan_name_trie_match(
+    struct darshan_name_rules *rules, const char *name)
+{
+    int node = 0;
+    int flags = rules->nodes[0].flags;
+    int child;
+
+    for(; *name; name++)
+    {
+        for(child = rules->nodes[node].child; child >= 0;
+            child = rules->nodes[child].sibling)
+        {
+            if(rules->nodes[child].c == *name)
+                break;
+        }
+        if(child < 0)
+            break;
+        node = child;
+        flags |= rules->nodes[node].flags;
+    }
+
+    return(flags);
+}
+
+/* same as darshan_name_trie_match(), for when no rules could be compiled */
+static int darshan_name_prefix_match(
+    struct darshan_config *cfg, const char *name)
+{
+    char **path_exclusions;
+    char *path;
+    int tmp_index = 0;
+    int flags = 0;
+
+    path_exclusions = cfg->user_exclude_dirs ?
+        cfg->user_exclude_dirs : cfg->exclude_dirs;
+    while((path = path_exclusions[tmp_index++]))
+    {
+        if(!(strncmp(path, name, strlen(path))))
+        {
+            flags |= DARSHAN_NAME_RULE_EXCLUDE;
+            break;
+        }
+    }
+    if(!cfg->user_exclude_dirs)
+    {
+        tmp_index = 0;
+        while((path = cfg->include_dirs[tmp_index++]))
+        {
+            if(!(strncmp(path, name, strlen(path))))
+            {
+                flags |= DARSHAN_NAME_RULE_INCLUDE;
+                break;
+            }
+        }
+    }
+
+    return(flags);
+}
+
+/* combines the regexes of a list that apply to the given module; returns
+ * the index of the combined regex, -1 if no regexes apply, or -2 if they
+ * can not be combined
+ */
+static int darshan_name_rules_combine(
+    struct darshan_name_rules *rules, struct darshan_core_regex *list,
+    darshan_module_id mod_id)
+{
+    struct darshan_core_regex *regex;
+    char *pattern;
+    size_t len = 0;
+    int i;
+
+    LL_FOREACH(list, regex)
+    {
+        if(!DARSHAN_MOD_FLAG_ISSET(regex->mod_flags, mod_id))
+            continue;
+        /* back-references would refer to the wrong group once combined */
+        for(i = 0; regex->regex_str[i]; i++)
+        {
+            if(regex->regex_str[i] == '\\' && regex->regex_str[i+1])
+            {
+                if(isdigit((unsigned char)regex->regex_str[i+1]))
+                    return(-2);
+                i++;
+            }
+        }
+        len += strlen(regex->regex_str) + 3;
+    }
+    if(len == 0)
+        return(-1);
+
+    pattern = malloc(len);
+    if(!pattern)
+        return(-2);
+    pattern[0] = '\0';
+    LL_FOREACH(list, regex)
+    {
+        if(!DARSHAN_MOD_FLAG_ISSET(regex->mod_flags, mod_id))
+            continue;
+        if(pattern[0])
+            strcat(pattern, "|");
+        strcat(pattern, "(");
+        strcat(pattern, regex->regex_str);
+        strcat(pattern, ")");
+    }
+
+    for(i = 0; i < rules->n_regexes; i++)
+    {
+        if(strcmp(rules->regex_strs[i], pattern) == 0)
+        {
+            free(pattern);
+            return(i);
+        }
+    }
+    if(regcomp(&rules->regexes[i], pattern, REG_EXTENDED | REG_NOSUB) != 0)
+    {
+        free(pattern);
+        return(-2);
+    }
+    rules->regex_strs[i] = pattern;
+    rules->n_regexes++;
+
+    return(i);
+}
+
+static void darshan_free_name_rules(struct darshan_name_rules *rules)
+{
+    int i;
+
+    for(i = 0; i < rules->n_regexes; i++)
+    {
+        regfree(&rules->regexes[i]);
+        free(rules->regex_strs[i]);
+    }
+    free(rules->nodes);
+    free(rules);
+}
+
+void darshan_compile_name_rules(struct darshan_config *cfg)
+{
+    struct darshan_name_rules *rules;
+    char **path_exclusions;
+    char *path;
+    int tmp_index = 0;
+    int ret = 0;
+    int i;
+
+    rules = calloc(1, sizeof(*rules));
+    if(!rules)
+        return;
+    rules->max_nodes = 64;
+    rules->nodes = malloc(rules->max_nodes * sizeof(*rules->nodes));
+    if(!rules->nodes)
+    {
+        free(rules);
+        return;
+    }
+    rules->n_nodes = 1;
+    rules->nodes[0].c = '\0';
+    rules->nodes[0].flags = 0;
+    rules->nodes[0].child = -1;
+    rules->nodes[0].sibling = -1;
+
+    /* user-provided path exclusions override the default exclusions and
+     * inclusions
+     */
+    path_exclusions = cfg->user_exclude_dirs ?
+        cfg->user_exclude_dirs : cfg->exclude_dirs;
+    while(ret == 0 && (path = path_exclusions[tmp_index++]))
+        ret = darshan_name_trie_add(rules, path, DARSHAN_NAME_RULE_EXCLUDE);
+    if(!cfg->user_exclude_dirs)
+    {
+        tmp_index = 0;
+        while(ret == 0 && (path = cfg->include_dirs[tmp_index++]))
+            ret = darshan_name_trie_add(rules, path, DARSHAN_NAME_RULE_INCLUDE);
+    }
+    if(ret < 0)
+    {
+        darshan_free_name_rules(rules);
+        return;
+    }
+
+    for(i = 0; i < DARSHAN_KNOWN_MODULE_COUNT; i++)
+    {
+        rules->exclusion[i] = darshan_name_rules_combine(rules,
+            cfg->rec_exclusion_list, i);
+        rules->inclusion[i] = darshan_name_rules_combine(rules,
+            cfg->rec_inclusion_list, i);
+        if(rules->exclusion[i] == -2 || rules->inclusion[i] == -2)
+            rules->use_lists = 1;
+    }
+
+    cfg->name_rules = rules;
+
+    return;
+}
+
+static int darshan_name_regex_match(
+    struct darshan_name_rules *rules, int rule_index,
+    struct darshan_core_regex *list, const char *name,
+    darshan_module_id mod_id)
+{
+    struct darshan_core_regex *regex;
+
+    if(rules && !rules->use_lists)
+        return(rule_index >= 0 &&
+            regexec(&rules->regexes[rule_index], name, 0, NULL, 0) == 0);
+
+    LL_FOREACH(list, regex)
+    {
+        if(DARSHAN_MOD_FLAG_ISSET(regex->mod_flags, mod_id) &&
+            (regexec(&regex->regex, name, 0, NULL, 0) == 0))
+            return(1);
+    }
+
+    return(0);
+}
+
+int darshan_name_is_excluded(
+    struct darshan_config *cfg,
+    const char *name,
+    darshan_module_id mod_id,
+    int name_is_path)
+{
+    struct darshan_name_rules *rules = cfg->name_rules;
+    int path_flags = 0;
+    int name_excluded, name_included = 0;
+
+    if(mod_id >= DARSHAN_KNOWN_MODULE_COUNT)
+        rules = NULL;
+
+    /* a path is excluded by any matching path exclusion, but can be
+     * included again by a default path inclusion
+     */
+    if(name_is_path)
+    {
+        if(cfg->name_rules)
+            path_flags = darshan_name_trie_match(cfg->name_rules, name);
+        else
+            path_flags = darshan_name_prefix_match(cfg, name);
+    }
+
+    name_excluded = path_flags & DARSHAN_NAME_RULE_EXCLUDE;
+    if(!name_excluded)
+        name_excluded = darshan_name_regex_match(rules,
+            rules ? rules->exclusion[mod_id] : -1, cfg->rec_exclusion_list,
+            name, mod_id);
+    if(!name_excluded)
+        return(0);
+
+    name_included = path_flags & DARSHAN_NAME_RULE_INCLUDE;
+    if(!name_included)
+        name_included = darshan_name_regex_match(rules,
+            rules ? rules->inclusion[mod_id] : -1, cfg->rec_inclusion_list,
+            name, mod_id);
+
+    return(!name_included);
+}
+
 void darshan_free_config(
     struct darshan_config *cfg)
 {
@@ -1024,6 +1469,11 @@ void darshan_free_config(
         regfree(&regex->regex);
         free(regex);
     }
+    if(cfg->name_rules)
+    {
+        darshan_free_name_rules(cfg->name_rules);
+        cfg->name_rules = NULL;
+    }
     if(cfg->rank_exclusions) free(cfg->rank_exclusions);
     if(cfg->rank_inclusions) free(cfg->rank_inclusions);
     if(cfg->small_io_trigger) free(cfg->small_io_trigger);
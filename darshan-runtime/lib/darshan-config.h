@@ -9,12 +9,20 @@
 
 #include "darshan.h"
 
+/* record name exclusion and inclusion rules of a configuration, compiled
+ * by darshan_compile_name_rules()
+ */
+struct darshan_name_rules;
+
 /* configuration parameters for Darshan runtime */
 struct darshan_config
 {
     size_t mod_mem;
     size_t name_mem;
+    size_t mod_mem_max;
+    size_t name_mem_max;
     int mem_alignment;
+    int huge_pages;
     char *jobid_env;
     char *log_hints;
     char *log_path;
@@ -33,11 +41,15 @@ struct darshan_config
     struct darshan_core_regex *rec_inclusion_list;
     struct darshan_core_regex *app_exclusion_list;
     struct darshan_core_regex *app_inclusion_list;
+    struct darshan_name_rules *name_rules;
     char *rank_exclusions;
     char *rank_inclusions;
     struct dxt_trigger *small_io_trigger;
     struct dxt_trigger *unaligned_io_trigger;
+    int64_t overlap_block_size;
+    int overlap_max_extents;
     int internal_timing_flag;
+    int overhead_accounting_flag;
     int disable_shared_redux_flag;
     int dump_config_flag;
 };
@@ -51,6 +63,19 @@ void darshan_parse_config_file(
 /* parse Darshan configuraiton from user environment */
 void darshan_parse_config_env(
     struct darshan_config *cfg);
+/* compile the record name exclusion and inclusion rules of a parsed
+ * Darshan configuration for darshan_name_is_excluded()
+ */
+void darshan_compile_name_rules(
+    struct darshan_config *cfg);
+/* returns 1 if records with the given name are excluded from
+ * instrumentation by the given module, 0 otherwise
+ */
+int darshan_name_is_excluded(
+    struct darshan_config *cfg,
+    const char *name,
+    darshan_module_id mod_id,
+    int name_is_path);
 /* print final Darshan configuration to stderr */
 void darshan_dump_config(
     struct darshan_config *cfg);
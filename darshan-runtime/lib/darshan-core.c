@@ -39,6 +39,9 @@
 #ifdef HAVE_MPI
 #include <mpi.h>
 #endif
+#ifdef __DARSHAN_RDTSCP_CALIBRATE
+#include <cpuid.h>
+#endif
 
 #include "uthash.h"
 #include "utlist.h"
@@ -46,6 +49,7 @@
 #include "darshan-config.h"
 #include "darshan-dynamic.h"
 #include "darshan-dxt.h"
+#include "darshan-overlap.h"
 #include "darshan-ldms.h"
 
 #ifdef DARSHAN_LUSTRE
@@ -56,6 +60,11 @@ extern char* __progname;
 extern char* __progname_full;
 struct darshan_core_runtime *__darshan_core = NULL;
 double __darshan_core_wtime_offset = 0;
+double __darshan_core_wtime_epoch = 0;
+int __darshan_core_overhead_flag = 0;
+#ifdef __DARSHAN_RDTSCP_CALIBRATE
+double __darshan_core_tsc_sec_per_tick = 0;
+#endif
 #ifdef HAVE_STDATOMIC_H
 atomic_flag __darshan_core_mutex = ATOMIC_FLAG_INIT;
 #else
@@ -72,6 +81,49 @@ static int parent_pid;
 static struct darshan_core_mnt_data mnt_data_array[DARSHAN_MAX_MNTS];
 static int mnt_data_count = 0;
 
+/* byte-wise prefix trie over mnt_data_array paths, used to find the longest
+ * mount point matching a file name without comparing against every mount
+ */
+#define DARSHAN_MNT_TRIE_MAX_NODES (DARSHAN_MAX_MNTS * (DARSHAN_MAX_MNT_PATH - 1) + 1)
+struct darshan_core_mnt_trie_node
+{
+    int16_t child;
+    int16_t sibling;
+    int8_t mnt_idx;     /* index into mnt_data_array, or -1 */
+    char c;
+};
+static struct darshan_core_mnt_trie_node mnt_trie[DARSHAN_MNT_TRIE_MAX_NODES];
+static int mnt_trie_count = 0;
+
+/* huge page backing of module record regions and DXT trace buffers (set
+ * from the runtime configuration at startup), and the huge page size
+ */
+static int huge_pages = DARSHAN_HUGE_PAGES_NONE;
+static size_t huge_page_size = DARSHAN_DEF_HUGE_PAGE_SIZE;
+
+/* per-slot overhead accounting state, see darshan_core_overhead_lock() */
+struct darshan_core_overhead
+{
+    double time;        /* time spent holding the module lock */
+    double lock_wait;   /* time spent waiting for the module lock */
+    int64_t calls;      /* outermost lock acquisitions */
+    int64_t contended;  /* acquisitions that found the lock held */
+    double start;       /* start time of the current acquisition */
+    uintptr_t nested_start; /* thread's accounted time when it started */
+    int depth;          /* nesting depth of the current acquisition */
+    int64_t mem;        /* bytes held by the slot's runtime allocators */
+    int64_t mem_hwm;    /* high-water mark of mem */
+};
+static struct darshan_core_overhead overhead_array[DARSHAN_OVERHEAD_SLOT_COUNT];
+/* serializes darshan_core_overhead_add() callers */
+static pthread_mutex_t overhead_mutex = PTHREAD_MUTEX_INITIALIZER;
+/* nanoseconds of overhead accounted so far by each thread, stored directly
+ * in the key's value (differences stay correct if it wraps); modules such
+ * as DXT and HEATMAP are called while another module's lock is held, and
+ * their time is subtracted from that module so it is only counted once
+ */
+static pthread_key_t overhead_nested_key;
+
 #ifdef DARSHAN_BGQ
 extern void bgq_runtime_initialize();
 #endif
@@ -106,10 +158,30 @@ extern void darshan_instrument_lustre_file(darshan_record_id rec_id, int fd);
 static void *darshan_init_mmap_log(
     struct darshan_core_runtime* core, int jobid);
 #endif
+static void darshan_huge_pages_init(
+    int mode);
+static void *darshan_mem_map(
+    size_t size, int prot, int flags, int mode, int *backing);
+static int darshan_mem_region_init(
+    struct darshan_core_runtime *core, struct darshan_core_mem_region *region,
+    struct darshan_log_map *log_map, size_t size, size_t max_size);
+#ifdef __DARSHAN_ENABLE_MMAP_LOGS
+static int darshan_mem_region_grow_file(
+    struct darshan_core_runtime *core, struct darshan_core_mem_region *region,
+    size_t size);
+#endif
+static int darshan_mem_region_grow(
+    struct darshan_core_runtime *core, struct darshan_core_mem_region *region,
+    size_t size);
+static int darshan_core_grow_module(
+    struct darshan_core_runtime *core, struct darshan_core_module *mod,
+    size_t rec_size);
 static void darshan_log_record_hints_and_ver(
     struct darshan_core_runtime* core);
 static void darshan_get_exe_and_mounts(
     struct darshan_core_runtime *core, int argc, char **argv);
+static void darshan_build_mnt_trie(
+    void);
 static int darshan_should_instrument_app(
     struct darshan_core_runtime *core);
 static int darshan_should_instrument_rank(
@@ -152,6 +224,13 @@ static int darshan_deflate_buffer(
 static void darshan_core_cleanup(
     struct darshan_core_runtime* core);
 static void darshan_core_fork_child_cb(void);
+static void darshan_core_record_overhead(
+    struct darshan_core_runtime *core);
+static void darshan_core_record_mem_growth(
+    struct darshan_core_runtime *core);
+#ifdef __DARSHAN_RDTSCP_CALIBRATE
+static void darshan_core_calibrate_tsc(void);
+#endif
 #ifdef HAVE_MPI
 static void darshan_core_reduce_min_time(
     void* in_time_v, void* inout_time_v,
@@ -212,7 +291,15 @@ void darshan_core_initialize(int argc, char **argv)
     if (__darshan_core != NULL || getenv("DARSHAN_DISABLE"))
         return;
 
+#ifdef __DARSHAN_RDTSCP_CALIBRATE
+    darshan_core_calibrate_tsc();
+#endif
+
+    /* sample darshan's clock and the wall clock together, so we can convert
+     * between the two later on
+     */
     init_start = darshan_core_wtime_absolute();
+    clock_gettime(CLOCK_REALTIME, &start_ts);
 
     /* allocate structure to track darshan core runtime information */
     init_core = malloc(sizeof(*init_core));
@@ -240,8 +327,12 @@ void darshan_core_initialize(int argc, char **argv)
         darshan_init_config(&init_core->config);
         darshan_parse_config_file(&init_core->config);
         darshan_parse_config_env(&init_core->config);
+        darshan_compile_name_rules(&init_core->config);
         if(my_rank == 0 && init_core->config.dump_config_flag)
             darshan_dump_config(&init_core->config);
+        darshan_huge_pages_init(init_core->config.huge_pages);
+        overlap_set_params(init_core->config.overlap_block_size,
+            init_core->config.overlap_max_extents);
 
         /* find the job id */
         jobid_str = getenv(init_core->config.jobid_env);
@@ -263,12 +354,9 @@ void darshan_core_initialize(int argc, char **argv)
         init_core->log_hdr_p = malloc(sizeof(struct darshan_header));
         init_core->log_job_p = malloc(sizeof(struct darshan_job));
         init_core->log_exemnt_p = malloc(DARSHAN_EXE_LEN+1);
-        init_core->log_name_p = malloc(init_core->config.name_mem);
-        init_core->log_mod_p = malloc(init_core->config.mod_mem);
 
         if(!(init_core->log_hdr_p) || !(init_core->log_job_p) ||
-           !(init_core->log_exemnt_p) || !(init_core->log_name_p) ||
-           !(init_core->log_mod_p))
+           !(init_core->log_exemnt_p))
         {
             free(init_core);
             return;
@@ -277,8 +365,6 @@ void darshan_core_initialize(int argc, char **argv)
         memset(init_core->log_hdr_p, 0, sizeof(struct darshan_header));
         memset(init_core->log_job_p, 0, sizeof(struct darshan_job));
         memset(init_core->log_exemnt_p, 0, DARSHAN_EXE_LEN+1);
-        memset(init_core->log_name_p, 0, init_core->config.name_mem);
-        memset(init_core->log_mod_p, 0, init_core->config.mod_mem);
 #else
         /* if mmap logs are enabled, we need to initialize the mmap region
          * before setting the corresponding log file region pointers
@@ -296,24 +382,32 @@ void darshan_core_initialize(int argc, char **argv)
             ((char *)init_core->log_hdr_p + sizeof(struct darshan_header));
         init_core->log_exemnt_p = (char *)
             ((char *)init_core->log_job_p + sizeof(struct darshan_job));
-        init_core->log_name_p = (void *)
-            ((char *)init_core->log_exemnt_p + DARSHAN_EXE_LEN + 1);
-        init_core->log_mod_p = (void *)
-            ((char *)init_core->log_name_p + init_core->config.name_mem);
 
         /* set header fields needed for the mmap log mechanism */
         init_core->log_hdr_p->comp_type = DARSHAN_NO_COMP;
-        init_core->log_hdr_p->name_map.off =
-            ((char *)init_core->log_name_p - (char *)init_core->log_hdr_p);
 #endif
 
+        /* name records start out with the configured amount of memory,
+         * which is grown as needed up to the configured limit
+         */
+        if(darshan_mem_region_init(init_core, &init_core->name_region,
+            &init_core->log_hdr_p->name_map, init_core->config.name_mem,
+            init_core->config.name_mem_max) < 0)
+        {
+#ifdef __DARSHAN_ENABLE_MMAP_LOGS
+            unlink(init_core->mmap_log_name);
+#endif
+            free(init_core);
+            return;
+        }
+        init_core->log_name_p = init_core->name_region.base;
+
         /* set known header fields for the log file */
         strcpy(init_core->log_hdr_p->version_string, DARSHAN_LOG_VERSION);
         init_core->log_hdr_p->magic_nr = DARSHAN_MAGIC_NR;
 
         /* set known job-level metadata fields for the log file */
         init_core->log_job_p->uid = getuid();
-        clock_gettime(CLOCK_REALTIME, &start_ts);
         init_core->log_job_p->start_time_sec = (int64_t)start_ts.tv_sec;
         init_core->log_job_p->start_time_nsec = (int64_t)start_ts.tv_nsec;
         init_core->log_job_p->nprocs = nprocs;
@@ -366,6 +460,17 @@ void darshan_core_initialize(int argc, char **argv)
         __DARSHAN_CORE_LOCK();
         __darshan_core = init_core;
         __darshan_core_wtime_offset = init_start;
+        __darshan_core_wtime_epoch = (double)start_ts.tv_sec +
+            1.0e-9 * (double)start_ts.tv_nsec;
+        if(init_core->config.overhead_accounting_flag &&
+           pthread_key_create(&overhead_nested_key, NULL) == 0)
+        {
+            /* NOTE: this must be set before any module is initialized,
+             * since module locks and unlocks have to agree on it
+             */
+            memset(overhead_array, 0, sizeof(overhead_array));
+            __darshan_core_overhead_flag = 1;
+        }
         __DARSHAN_CORE_UNLOCK();
 
         /* bootstrap any modules with static initialization routines */
@@ -479,7 +584,19 @@ void darshan_core_shutdown(int write_log)
     unlink(final_core->mmap_log_name);
 #endif
 
-    final_core->comp_buf = malloc(final_core->config.mod_mem);
+    /* the compression buffer must fit the name records and the records of
+     * any module, which may have outgrown the configured memory
+     */
+    final_core->comp_buf_sz = final_core->config.mod_mem;
+    if(final_core->name_mem_used > final_core->comp_buf_sz)
+        final_core->comp_buf_sz = final_core->name_mem_used;
+    for(i = 0; i < DARSHAN_KNOWN_MODULE_COUNT; i++)
+    {
+        if(final_core->mod_array[i] &&
+           final_core->mod_array[i]->region.size > final_core->comp_buf_sz)
+            final_core->comp_buf_sz = final_core->mod_array[i]->region.size;
+    }
+    final_core->comp_buf = malloc(final_core->comp_buf_sz);
     logfile_name = malloc(__DARSHAN_PATH_MAX);
     if(!final_core->comp_buf || !logfile_name)
         goto cleanup;
@@ -550,6 +667,13 @@ void darshan_core_shutdown(int write_log)
         }
     }
 
+    /* save the number of times record memory had to be grown */
+    darshan_core_record_mem_growth(final_core);
+
+    /* save instrumentation overhead accounting in the log metadata */
+    if(final_core->config.overhead_accounting_flag)
+        darshan_core_record_overhead(final_core);
+
     /* get the log file name */
     darshan_get_logfile_name(logfile_name, final_core);
     if(strlen(logfile_name) == 0)
@@ -801,8 +925,11 @@ static void *darshan_init_mmap_log(struct darshan_core_runtime* core, int jobid)
     sys_page_size = sysconf(_SC_PAGESIZE);
     assert(sys_page_size > 0);
 
-    mmap_size = sizeof(struct darshan_header) + DARSHAN_JOB_RECORD_SIZE +
-        + core->config.name_mem + core->config.mod_mem;
+    /* only the header and job record are mapped here; name and module
+     * records are mapped into separate regions of the file as they are
+     * set up, see darshan_mem_region_init()
+     */
+    mmap_size = sizeof(struct darshan_header) + DARSHAN_JOB_RECORD_SIZE;
     if(mmap_size % sys_page_size)
         mmap_size = ((mmap_size / sys_page_size) + 1) * sys_page_size;
 
@@ -865,13 +992,372 @@ static void *darshan_init_mmap_log(struct darshan_core_runtime* core, int jobid)
         return(NULL);
     }
 
-    /* close darshan log file (this does *not* unmap the log file) */
-    close(mmap_fd);
+    /* keep the log file open to map more of it as records grow */
+    core->mmap_fd = mmap_fd;
+    core->mmap_file_size = mmap_size;
+    core->mmap_next_off = mmap_size;
 
     return(mmap_p);
 }
 #endif
 
+/* use huge pages of the given DARSHAN_HUGE_PAGES_* kind for module
+ * record regions and DXT trace buffers, finding the huge page size
+ */
+static void darshan_huge_pages_init(int mode)
+{
+    FILE *fp;
+    char line[128];
+    unsigned long kb;
+
+    huge_pages = mode;
+    huge_page_size = DARSHAN_DEF_HUGE_PAGE_SIZE;
+    if(mode == DARSHAN_HUGE_PAGES_NONE)
+        return;
+
+    fp = fopen("/proc/meminfo", "r");
+    if(!fp)
+        return;
+    while(fgets(line, sizeof(line), fp))
+    {
+        if(sscanf(line, "Hugepagesize: %lu kB", &kb) == 1 && kb > 0)
+        {
+            huge_page_size = kb * 1024;
+            break;
+        }
+    }
+    fclose(fp);
+
+    return;
+}
+
+/* map 'size' bytes of anonymous memory, backed by huge pages of the given
+ * DARSHAN_HUGE_PAGES_* kind if possible ('size' should then be a multiple
+ * of the huge page size). Explicit huge pages fall back to transparent
+ * huge pages if the huge page pool cannot hold the mapping, and the kind
+ * of huge pages actually used is returned in 'backing'.
+ */
+static void *darshan_mem_map(size_t size, int prot, int flags, int mode,
+    int *backing)
+{
+    char *p, *aligned;
+
+    *backing = DARSHAN_HUGE_PAGES_NONE;
+
+#ifdef MAP_HUGETLB
+    if(mode == DARSHAN_HUGE_PAGES_EXPLICIT)
+    {
+        /* huge pages must be reserved up front, since running out of them
+         * later is only reported as SIGBUS
+         */
+        p = mmap(NULL, size, prot, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+            (flags & ~MAP_NORESERVE), -1, 0);
+        if(p != MAP_FAILED)
+        {
+            *backing = DARSHAN_HUGE_PAGES_EXPLICIT;
+            return(p);
+        }
+    }
+#endif
+
+#ifdef MADV_HUGEPAGE
+    if(mode != DARSHAN_HUGE_PAGES_NONE)
+    {
+        /* transparent huge pages are only used for huge page aligned
+         * memory, so map an extra huge page and trim the mapping to an
+         * aligned one
+         */
+        p = mmap(NULL, size + huge_page_size, prot,
+            MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+        if(p == MAP_FAILED)
+            return(p);
+        aligned = (char *)((((uintptr_t)p + huge_page_size - 1) /
+            huge_page_size) * huge_page_size);
+        if(aligned > p)
+            munmap(p, aligned - p);
+        if(p + huge_page_size > aligned)
+            munmap(aligned + size, (p + huge_page_size) - aligned);
+        if(madvise(aligned, size, MADV_HUGEPAGE) == 0)
+            *backing = DARSHAN_HUGE_PAGES_TRANSPARENT;
+        return(aligned);
+    }
+#endif
+
+    return(mmap(NULL, size, prot, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0));
+}
+
+/* set up 'region' with 'size' accessible bytes, reserving enough address
+ * space for it to grow to 'max_size' bytes without moving. If the address
+ * space cannot be reserved, the region is limited to 'size' bytes. Regions
+ * grow a huge page at a time if huge pages are enabled. For mmap logs,
+ * 'log_map' is the log header entry kept pointing at the region's data.
+ */
+static int darshan_mem_region_init(struct darshan_core_runtime *core,
+    struct darshan_core_mem_region *region, struct darshan_log_map *log_map,
+    size_t size, size_t max_size)
+{
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    int mode = huge_pages;
+    int map_mode;
+    int backing;
+    void *p;
+
+    memset(region, 0, sizeof(*region));
+#ifdef __DARSHAN_ENABLE_MMAP_LOGS
+    /* mmap log regions are mapped from the log file, which can only use
+     * transparent huge pages (if its file system supports them)
+     */
+    if(mode == DARSHAN_HUGE_PAGES_EXPLICIT)
+        mode = DARSHAN_HUGE_PAGES_TRANSPARENT;
+#endif
+    if(mode != DARSHAN_HUGE_PAGES_NONE)
+        page_size = huge_page_size;
+    size = ((size + page_size - 1) / page_size) * page_size;
+    max_size = ((max_size + page_size - 1) / page_size) * page_size;
+    if(max_size < size)
+        max_size = size;
+    if(max_size == 0)
+        return(0);
+
+    /* explicit huge pages are taken from the pool as the region grows, see
+     * darshan_mem_region_grow(), so only a huge page aligned range of
+     * address space is reserved here
+     */
+    map_mode = (mode == DARSHAN_HUGE_PAGES_EXPLICIT) ?
+        DARSHAN_HUGE_PAGES_TRANSPARENT : mode;
+    p = darshan_mem_map(max_size, PROT_NONE, MAP_NORESERVE, map_mode,
+        &backing);
+    if(p == MAP_FAILED && max_size > size && size > 0)
+    {
+        max_size = size;
+        p = darshan_mem_map(max_size, PROT_NONE, MAP_NORESERVE, map_mode,
+            &backing);
+    }
+    if(p == MAP_FAILED)
+        return(-1);
+    if(mode == DARSHAN_HUGE_PAGES_EXPLICIT)
+        backing = DARSHAN_HUGE_PAGES_EXPLICIT;
+    region->base = p;
+    region->max_size = max_size;
+    region->page_size = page_size;
+    region->huge_pages = backing;
+#ifdef __DARSHAN_ENABLE_MMAP_LOGS
+    /* log file space is only given to the region as it grows */
+    region->log_map = log_map;
+#else
+    (void)log_map;
+#endif
+
+    if(size > 0 && darshan_mem_region_grow(core, region, size) < 0)
+    {
+        munmap(region->base, region->max_size);
+        memset(region, 0, sizeof(*region));
+        return(-1);
+    }
+
+    return(0);
+}
+
+#ifdef __DARSHAN_ENABLE_MMAP_LOGS
+/* give 'region' at least 'size' bytes of space in the mmap log file. The
+ * region's space is extended in place if it ends the file; otherwise it is
+ * moved to the end of the file with room to double, and the region's
+ * accessible pages are copied there and remapped at the same address, so
+ * record pointers into the region stay valid.
+ * NOTE: must be called with the core lock held, and with no other thread
+ * writing to the region. The copy goes through a temporary mapping rather
+ * than write calls, which Darshan itself may intercept.
+ */
+static int darshan_mem_region_grow_file(struct darshan_core_runtime *core,
+    struct darshan_core_mem_region *region, size_t size)
+{
+    off_t new_off = region->file_off;
+    size_t new_size = size;
+    void *p;
+
+    if(region->file_size == 0 ||
+       region->file_off + (off_t)region->file_size != core->mmap_next_off)
+    {
+        new_off = ((core->mmap_next_off + region->page_size - 1) /
+            region->page_size) * region->page_size;
+        if(region->file_size > 0 && new_size < 2 * region->file_size)
+            new_size = 2 * region->file_size;
+        if(new_size > region->max_size)
+            new_size = region->max_size;
+    }
+
+    /* extend the log file (holes read as zero) */
+    if(new_off + (off_t)new_size > core->mmap_file_size)
+    {
+        if(ftruncate(core->mmap_fd, new_off + new_size) < 0)
+            return(-1);
+        core->mmap_file_size = new_off + new_size;
+    }
+
+    if(new_off != region->file_off && region->size > 0)
+    {
+        p = mmap(NULL, region->size, PROT_WRITE, MAP_SHARED, core->mmap_fd,
+            new_off);
+        if(p == MAP_FAILED)
+            return(-1);
+        memcpy(p, region->base, region->size);
+        munmap(p, region->size);
+
+        p = mmap(region->base, region->size, PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_FIXED, core->mmap_fd, new_off);
+        if(p == MAP_FAILED)
+            return(-1);
+#ifdef MADV_HUGEPAGE
+        if(region->huge_pages != DARSHAN_HUGE_PAGES_NONE)
+            madvise(p, region->size, MADV_HUGEPAGE);
+#endif
+#ifdef FALLOC_FL_PUNCH_HOLE
+        /* give the moved-from space back to the file system */
+        fallocate(core->mmap_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+            region->file_off, region->file_size);
+#endif
+    }
+
+    region->file_off = new_off;
+    region->file_size = new_size;
+    if(region->log_map)
+        region->log_map->off = new_off;
+    if(new_off + (off_t)new_size > core->mmap_next_off)
+        core->mmap_next_off = new_off + new_size;
+
+    return(0);
+}
+#endif
+
+/* grow 'region' to 'size' bytes, or as close to it as its reserved size
+ * allows. Returns -1 if the region could not grow at all.
+ */
+static int darshan_mem_region_grow(struct darshan_core_runtime *core,
+    struct darshan_core_mem_region *region, size_t size)
+{
+    void *p;
+
+    size = ((size + region->page_size - 1) / region->page_size) *
+        region->page_size;
+    if(size > region->max_size)
+        size = region->max_size;
+    if(size <= region->size)
+        return(-1);
+
+#ifndef __DARSHAN_ENABLE_MMAP_LOGS
+#ifdef MAP_HUGETLB
+    if(region->huge_pages == DARSHAN_HUGE_PAGES_EXPLICIT)
+    {
+        /* reserve huge pages from the pool for the new part of the region
+         * only (running out of them later is only reported as SIGBUS). If
+         * the pool cannot hold it, the region keeps growing with the
+         * transparent huge pages its address space was set up for.
+         */
+        p = mmap(region->base + region->size, size - region->size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_FIXED, -1, 0);
+        if(p != MAP_FAILED)
+        {
+            region->size = size;
+            return(0);
+        }
+        region->huge_pages = DARSHAN_HUGE_PAGES_TRANSPARENT;
+
+        /* the failed mapping unmapped the address space it was to replace,
+         * so reserve it again without replacing anything that another
+         * thread may have mapped there since
+         */
+        p = mmap(region->base + region->size, size - region->size,
+            PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE
+#ifdef MAP_FIXED_NOREPLACE
+            | MAP_FIXED_NOREPLACE
+#endif
+            , -1, 0);
+        if(p != region->base + region->size)
+        {
+            if(p != MAP_FAILED)
+                munmap(p, size - region->size);
+            if(region->max_size > size)
+                munmap(region->base + size, region->max_size - size);
+            region->max_size = region->size;
+            return(-1);
+        }
+#ifdef MADV_HUGEPAGE
+        madvise(p, size - region->size, MADV_HUGEPAGE);
+#endif
+    }
+#endif
+
+    /* anonymous memory reads as zero until written */
+    if(mprotect(region->base + region->size, size - region->size,
+        PROT_READ | PROT_WRITE) < 0)
+        return(-1);
+#else
+    if(size > region->file_size &&
+       darshan_mem_region_grow_file(core, region, size) < 0)
+        return(-1);
+
+    /* map the new part of the region over its reserved address space */
+    p = mmap(region->base + region->size, size - region->size,
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, core->mmap_fd,
+        region->file_off + region->size);
+    if(p == MAP_FAILED)
+        return(-1);
+#ifdef MADV_HUGEPAGE
+    if(region->huge_pages != DARSHAN_HUGE_PAGES_NONE)
+        madvise(p, size - region->size, MADV_HUGEPAGE);
+#endif
+#endif
+    region->size = size;
+
+    return(0);
+}
+
+/* grow the memory of module 'mod' by a chunk, so that it has room for
+ * at least one more record of 'rec_size' bytes, as long as the memory of
+ * all modules stays within the configured limit
+ * NOTE: must be called with the core lock held
+ */
+static int darshan_core_grow_module(struct darshan_core_runtime *core,
+    struct darshan_core_module *mod, size_t rec_size)
+{
+    char *rec_buf_end = (char *)mod->rec_buf_p + mod->rec_mem_avail;
+    size_t mod_mem_limit;
+    size_t grow_size = DARSHAN_MEM_GROW_CHUNK;
+    size_t added;
+
+    /* growth is disabled by a limit no larger than the configured memory,
+     * and DXT modules do not store their records in core memory
+     */
+    if(core->config.mod_mem_max <= core->config.mod_mem || !mod->region.base)
+        return(-1);
+
+    mod_mem_limit = core->config.mod_mem_max;
+    if(core->mod_mem_used + rec_size > mod_mem_limit)
+        return(-1);
+    if(grow_size < rec_size)
+        grow_size = rec_size;
+    if(grow_size > mod_mem_limit - core->mod_mem_used)
+        grow_size = mod_mem_limit - core->mod_mem_used;
+
+    /* pages beyond the end of the module's records may already be
+     * accessible, so only grow the region if they are not enough
+     */
+    if((size_t)(mod->region.base + mod->region.size - rec_buf_end) < grow_size &&
+       darshan_mem_region_grow(core, &mod->region,
+            (rec_buf_end - mod->region.base) + grow_size) < 0)
+        return(-1);
+
+    added = mod->region.base + mod->region.size - rec_buf_end;
+    if(mod->rec_mem_avail + added < rec_size)
+        return(-1);
+    mod->rec_mem_avail += added;
+    core->mod_mem_used += added;
+    mod->grow_count++;
+
+    return(0);
+}
+
 /* record any hints used to write the darshan log in the job data */
 static void darshan_log_record_hints_and_ver(struct darshan_core_runtime* core)
 {
@@ -1069,6 +1555,7 @@ static void darshan_get_exe_and_mounts(struct darshan_core_runtime *core,
      * mount points
      */
     mnt_data_count = 0;
+    mnt_trie_count = 0;
 
     tab = setmntent("/etc/mtab", "r");
     if(!tab)
@@ -1097,23 +1584,67 @@ static void darshan_get_exe_and_mounts(struct darshan_core_runtime *core,
     endmntent(tab);
 
     tab = setmntent("/etc/mtab", "r");
-    if(!tab)
-        return;
-    /* loop through list of mounted file systems */
-    while(mnt_data_count<DARSHAN_MAX_MNTS && (entry = getmntent(tab)) != NULL)
+    if(tab)
     {
-        if(strcmp(entry->mnt_type, "nfs") != 0)
-            continue;
+        /* loop through list of mounted file systems */
+        while(mnt_data_count<DARSHAN_MAX_MNTS && (entry = getmntent(tab)) != NULL)
+        {
+            if(strcmp(entry->mnt_type, "nfs") != 0)
+                continue;
 
-        add_entry(core->log_exemnt_p, &space_left, entry);
+            add_entry(core->log_exemnt_p, &space_left, entry);
+        }
+        endmntent(tab);
     }
-    endmntent(tab);
 
     /* sort mount points in order of longest path to shortest path.  This is
      * necessary so that if we try to match file paths to mount points later
      * we don't match on "/" every time.
      */
     qsort(mnt_data_array, mnt_data_count, sizeof(mnt_data_array[0]), mnt_data_cmp);
+    darshan_build_mnt_trie();
+    return;
+}
+
+/* darshan_build_mnt_trie()
+ *
+ * indexes the (sorted) mount table for darshan_fs_info_from_path(); for
+ * duplicate paths the first entry in the table is kept, matching the
+ * previous linear search
+ */
+static void darshan_build_mnt_trie(void)
+{
+    const char *c;
+    int i, cur, next;
+
+    mnt_trie[0].child = mnt_trie[0].sibling = mnt_trie[0].mnt_idx = -1;
+    mnt_trie_count = 1;
+
+    for(i = 0; i < mnt_data_count; i++)
+    {
+        cur = 0;
+        for(c = mnt_data_array[i].path; *c; c++)
+        {
+            for(next = mnt_trie[cur].child; next >= 0;
+                next = mnt_trie[next].sibling)
+            {
+                if(mnt_trie[next].c == *c)
+                    break;
+            }
+            if(next < 0)
+            {
+                next = mnt_trie_count++;
+                mnt_trie[next].c = *c;
+                mnt_trie[next].child = mnt_trie[next].mnt_idx = -1;
+                mnt_trie[next].sibling = mnt_trie[cur].child;
+                mnt_trie[cur].child = next;
+            }
+            cur = next;
+        }
+        if(mnt_trie[cur].mnt_idx < 0)
+            mnt_trie[cur].mnt_idx = i;
+    }
+
     return;
 }
 
@@ -1285,19 +1816,31 @@ static int darshan_should_instrument_rank(struct darshan_core_runtime *core)
 
 static void darshan_fs_info_from_path(const char *path, struct darshan_fs_info *fs_info)
 {
-    int i;
+    int cur = 0, match = -1;
     fs_info->fs_type = -1;
     fs_info->block_size = -1;
 
-    for(i=0; i<mnt_data_count; i++)
+    if(mnt_trie_count == 0)
+        return;
+
+    /* walk the mount trie, remembering the deepest mount point passed */
+    match = mnt_trie[0].mnt_idx;
+    for(; *path; path++)
     {
-        if(!(strncmp(mnt_data_array[i].path, path, strlen(mnt_data_array[i].path))))
+        for(cur = mnt_trie[cur].child; cur >= 0; cur = mnt_trie[cur].sibling)
         {
-            *fs_info = mnt_data_array[i].fs_info;
-            return;
+            if(mnt_trie[cur].c == *path)
+                break;
         }
+        if(cur < 0)
+            break;
+        if(mnt_trie[cur].mnt_idx >= 0)
+            match = mnt_trie[cur].mnt_idx;
     }
 
+    if(match >= 0)
+        *fs_info = mnt_data_array[match].fs_info;
+
     return;
 }
 
@@ -1350,7 +1893,15 @@ static int darshan_update_name_record_ref(struct darshan_core_runtime *core,
     if(is_new_rec || ((strlen(ref->name_record->name) == 0) && strlen(name) > 0))
     {
         int record_size = sizeof(darshan_record_id) + strlen(name) + 1;
-        if((record_size + core->name_mem_used) > core->config.name_mem)
+        if((record_size + core->name_mem_used) > core->name_region.size)
+        {
+            /* grow name record memory by another chunk, if allowed */
+            if(darshan_mem_region_grow(core, &core->name_region,
+                core->name_mem_used + ((record_size > DARSHAN_MEM_GROW_CHUNK) ?
+                record_size : DARSHAN_MEM_GROW_CHUNK)) == 0)
+                core->name_grow_count++;
+        }
+        if((record_size + core->name_mem_used) > core->name_region.size)
         {
             /* no more room for this name record */
             if(is_new_rec) free(ref);
@@ -1713,7 +2264,7 @@ static int darshan_log_write_job_record(darshan_core_log_fh log_fh,
      */
     void *pointers[2] = {core->log_job_p, core->log_exemnt_p};
     int lengths[2] = {sizeof(struct darshan_job), strlen(core->log_exemnt_p)+1};
-    int comp_buf_sz = core->config.mod_mem;
+    int comp_buf_sz = core->comp_buf_sz;
     int ret;
 
 #ifdef HAVE_MPI
@@ -1944,7 +2495,7 @@ static int darshan_log_write_header(darshan_core_log_fh log_fh,
 static int darshan_log_append(darshan_core_log_fh log_fh, struct darshan_core_runtime *core,
     void *buf, int count, uint64_t *inout_off)
 {
-    int comp_buf_sz = core->config.mod_mem;
+    int comp_buf_sz = core->comp_buf_sz;
     int ret;
 
     /* compress the input buffer */
@@ -2189,6 +2740,11 @@ static void darshan_core_cleanup(struct darshan_core_runtime* core)
     {
         if(core->mod_array[i])
         {
+#ifndef __DARSHAN_ENABLE_MMAP_LOGS
+            if(core->mod_array[i]->region.base)
+                munmap(core->mod_array[i]->region.base,
+                    core->mod_array[i]->region.max_size);
+#endif
             free(core->mod_array[i]);
             core->mod_array[i] = NULL;
         }
@@ -2198,8 +2754,10 @@ static void darshan_core_cleanup(struct darshan_core_runtime* core)
     free(core->log_hdr_p);
     free(core->log_job_p);
     free(core->log_exemnt_p);
-    free(core->log_name_p);
-    free(core->log_mod_p);
+    if(core->name_region.base)
+        munmap(core->name_region.base, core->name_region.max_size);
+#else
+    close(core->mmap_fd);
 #endif
 
 #ifdef HAVE_MPI
@@ -2235,97 +2793,220 @@ static void darshan_core_fork_child_cb(void)
     return;
 }
 
-static int darshan_core_name_is_excluded(const char *name, darshan_module_id mod_id)
+/* reduce overhead accounting across processes and store the totals for each
+ * slot used in the job metadata, as "overhead_<module>=<total time>,<max
+ * process time>,<calls>,<contended lock acquisitions>,<lock wait time>".
+ * Slots whose modules allocate runtime state from an arena are followed by
+ * "arena_<module>=<total bytes>,<max process bytes>", the sum and maximum
+ * of each process's arena memory high-water mark.
+ */
+static void darshan_core_record_overhead(struct darshan_core_runtime *core)
 {
-    int name_is_path;
-    int name_excluded = 0, name_included = 0;
-    char *path_exclusion, *path_inclusion;
-    int tmp_index = 0;
-    struct darshan_core_regex *regex;
-
-    if(!name)
-        return(0);
-
-    /* set flag if this module's record names are based on file paths */
-    name_is_path = 1;
-    if((mod_id == DARSHAN_APMPI_MOD) || (mod_id == DARSHAN_APXC_MOD) ||
-       (mod_id == DARSHAN_HEATMAP_MOD) || (mod_id == DARSHAN_MDHIM_MOD))
-        name_is_path = 0;
+    double ovh_sum[DARSHAN_OVERHEAD_SLOT_COUNT * 5];
+    double ovh_max[DARSHAN_OVERHEAD_SLOT_COUNT * 2];
+    char ovh_str[192];
+    const char *slot_name;
+    int meta_remain;
+    int i;
 
-    if(name_is_path)
+    for(i = 0; i < DARSHAN_OVERHEAD_SLOT_COUNT; i++)
     {
-        /* if record name is a path, check against either default or
-         * user-provided path exclusions
-         */
+        /* total overhead includes time spent waiting on module locks */
+        ovh_sum[i*5] = overhead_array[i].time + overhead_array[i].lock_wait;
+        ovh_sum[i*5+1] = (double)overhead_array[i].calls;
+        ovh_sum[i*5+2] = (double)overhead_array[i].contended;
+        ovh_sum[i*5+3] = overhead_array[i].lock_wait;
+        ovh_sum[i*5+4] = (double)overhead_array[i].mem_hwm;
+        ovh_max[i*2] = ovh_sum[i*5];
+        ovh_max[i*2+1] = ovh_sum[i*5+4];
+    }
 
-        /* if user has set DARSHAN_EXCLUDE_DIRS, override the default ones */
-        if (__darshan_core->config.user_exclude_dirs != NULL) {
-            while((path_exclusion = __darshan_core->config.user_exclude_dirs[tmp_index++])) {
-                if(!(strncmp(path_exclusion, name, strlen(path_exclusion)))) {
-                    name_excluded = 1;
-                    break;
-                }
-            }
+#ifdef HAVE_MPI
+    if(using_mpi)
+    {
+        if(my_rank == 0)
+        {
+            PMPI_Reduce(MPI_IN_PLACE, ovh_sum, DARSHAN_OVERHEAD_SLOT_COUNT * 5,
+                MPI_DOUBLE, MPI_SUM, 0, core->mpi_comm);
+            PMPI_Reduce(MPI_IN_PLACE, ovh_max, DARSHAN_OVERHEAD_SLOT_COUNT * 2,
+                MPI_DOUBLE, MPI_MAX, 0, core->mpi_comm);
         }
-        else {
-            /* scan default exclusion list for paths to exclude */
-            while((path_exclusion = __darshan_core->config.exclude_dirs[tmp_index++])) {
-                if(!(strncmp(path_exclusion, name, strlen(path_exclusion)))) {
-                    name_excluded = 1;
-                    break;
-                }
-            }
+        else
+        {
+            PMPI_Reduce(ovh_sum, ovh_sum, DARSHAN_OVERHEAD_SLOT_COUNT * 5,
+                MPI_DOUBLE, MPI_SUM, 0, core->mpi_comm);
+            PMPI_Reduce(ovh_max, ovh_max, DARSHAN_OVERHEAD_SLOT_COUNT * 2,
+                MPI_DOUBLE, MPI_MAX, 0, core->mpi_comm);
+            return; /* only rank 0 writes job metadata */
         }
     }
+#endif
 
-    if(!name_excluded)
+    for(i = 0; i < DARSHAN_OVERHEAD_SLOT_COUNT; i++)
     {
-        /* check to see if this name is in the module exclusion list provided to
-         * Darshan config
-         */
-        LL_FOREACH(__darshan_core->config.rec_exclusion_list, regex)
+        if(ovh_sum[i*5+1] == 0)
+            continue;
+
+        if(i == DARSHAN_OVERHEAD_LDMS)
+            slot_name = "LDMS";
+        else
+            slot_name = darshan_module_names[i];
+        snprintf(ovh_str, sizeof(ovh_str),
+            "overhead_%s=%.6f,%.6f,%.0f,%.0f,%.6f\n", slot_name,
+            ovh_sum[i*5], ovh_max[i*2], ovh_sum[i*5+1], ovh_sum[i*5+2],
+            ovh_sum[i*5+3]);
+        if(ovh_sum[i*5+4] > 0)
+            snprintf(ovh_str + strlen(ovh_str), sizeof(ovh_str) - strlen(ovh_str),
+                "arena_%s=%.0f,%.0f\n", slot_name, ovh_sum[i*5+4],
+                ovh_max[i*2+1]);
+
+        meta_remain = DARSHAN_JOB_METADATA_LEN -
+            strlen(core->log_job_p->metadata) - 1;
+        if(meta_remain < strlen(ovh_str))
         {
-            if(DARSHAN_MOD_FLAG_ISSET(regex->mod_flags, mod_id) &&
-                (regexec(&regex->regex, name, 0, NULL, 0) == 0))
-            {
-                name_excluded = 1;
-                break;
-            }
+            DARSHAN_WARN("not enough job metadata space to store overhead "
+                "accounting for all modules");
+            break;
         }
+        strcat(core->log_job_p->metadata, ovh_str);
     }
 
-    if(name_is_path && name_excluded && !__darshan_core->config.user_exclude_dirs)
+    return;
+}
+
+/* reduce the number of times module and name record memory was grown
+ * across processes and store the totals in the job metadata, as
+ * "mem_growth_<module>=<count>" for each module whose memory grew and
+ * "mem_growth_names=<count>" for name records
+ */
+static void darshan_core_record_mem_growth(struct darshan_core_runtime *core)
+{
+    int64_t grow_counts[DARSHAN_KNOWN_MODULE_COUNT + 1] = {0};
+    char grow_str[64];
+    int meta_remain;
+    int i;
+
+    for(i = 0; i < DARSHAN_KNOWN_MODULE_COUNT; i++)
     {
-        /* if record name is a path, check against default path inclusions */
-        tmp_index = 0;
-        while((path_inclusion = __darshan_core->config.include_dirs[tmp_index++])) {
-            if(!(strncmp(path_inclusion, name, strlen(path_inclusion)))) {
-                name_included = 1;
-                break;
-            }
+        if(core->mod_array[i])
+            grow_counts[i] = core->mod_array[i]->grow_count;
+    }
+    grow_counts[DARSHAN_KNOWN_MODULE_COUNT] = core->name_grow_count;
+
+#ifdef HAVE_MPI
+    if(using_mpi)
+    {
+        if(my_rank == 0)
+            PMPI_Reduce(MPI_IN_PLACE, grow_counts, DARSHAN_KNOWN_MODULE_COUNT + 1,
+                MPI_INT64_T, MPI_SUM, 0, core->mpi_comm);
+        else
+        {
+            PMPI_Reduce(grow_counts, grow_counts, DARSHAN_KNOWN_MODULE_COUNT + 1,
+                MPI_INT64_T, MPI_SUM, 0, core->mpi_comm);
+            return; /* only rank 0 writes job metadata */
         }
     }
+#endif
 
-    if(name_excluded && !name_included)
+    for(i = 0; i <= DARSHAN_KNOWN_MODULE_COUNT; i++)
     {
-        /* if marked as excluded, make sure there's not a superseding inclusion
-         * associated with this module from Darshan config
-         */
-        LL_FOREACH(__darshan_core->config.rec_inclusion_list, regex)
+        if(grow_counts[i] == 0)
+            continue;
+
+        snprintf(grow_str, sizeof(grow_str), "mem_growth_%s=%" PRId64 "\n",
+            (i < DARSHAN_KNOWN_MODULE_COUNT) ? darshan_module_names[i] : "names",
+            grow_counts[i]);
+        meta_remain = DARSHAN_JOB_METADATA_LEN -
+            strlen(core->log_job_p->metadata) - 1;
+        if(meta_remain < strlen(grow_str))
         {
-            if(DARSHAN_MOD_FLAG_ISSET(regex->mod_flags, mod_id) &&
-                (regexec(&regex->regex, name, 0, NULL, 0) == 0))
-            {
-                name_included = 1;
-                break;
-            }
+            DARSHAN_WARN("not enough job metadata space to store memory "
+                "growth counts for all modules");
+            break;
         }
+        strcat(core->log_job_p->metadata, grow_str);
+    }
+
+    return;
+}
+
+#ifdef __DARSHAN_RDTSCP_CALIBRATE
+/* if the CPU has an invariant TSC that the kernel also trusts, calibrate
+ * its frequency against CLOCK_MONOTONIC so that darshan_core_wtime_absolute()
+ * can use rdtscp; otherwise leave the clock_gettime() fallback in place
+ */
+static void darshan_core_calibrate_tsc(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+    unsigned int flag;
+    unsigned long long tsc1, tsc2;
+    struct timespec ts1, ts2;
+    double elapsed;
+    char clksrc[32] = {0};
+    FILE *clksrc_fp;
+
+    /* only calibrate once, e.g., not again when re-initializing after fork */
+    if(__darshan_core_tsc_sec_per_tick > 0 || getenv("DARSHAN_DISABLE_TSC"))
+        return;
+
+    /* rdtscp support is CPUID.80000001H:EDX[27], invariant TSC (constant
+     * rate across P-/C-states) is CPUID.80000007H:EDX[8]
+     */
+    if(!__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx) || !(edx & (1 << 27)))
+        return;
+    if(!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1 << 8)))
+        return;
 
-        if(!name_included)
-            return(1);
+    /* the kernel stops using the TSC as its clocksource if it finds it is
+     * not synchronized across CPUs, in which case we shouldn't use it either
+     */
+    clksrc_fp = fopen(DARSHAN_TSC_CLOCKSOURCE_PATH, "r");
+    if(clksrc_fp)
+    {
+        if(fgets(clksrc, sizeof(clksrc), clksrc_fp) &&
+            strncmp(clksrc, "tsc", 3) != 0)
+        {
+            fclose(clksrc_fp);
+            return;
+        }
+        fclose(clksrc_fp);
     }
 
-    return(0);
+    clock_gettime(CLOCK_MONOTONIC, &ts1);
+    tsc1 = __rdtscp(&flag);
+    do
+    {
+        tsc2 = __rdtscp(&flag);
+        clock_gettime(CLOCK_MONOTONIC, &ts2);
+        elapsed = (double)(ts2.tv_sec - ts1.tv_sec) +
+            1.0e-9 * (double)(ts2.tv_nsec - ts1.tv_nsec);
+    } while(elapsed < DARSHAN_TSC_CALIBRATION_TIME);
+
+    if(tsc2 > tsc1)
+        __darshan_core_tsc_sec_per_tick = elapsed / (double)(tsc2 - tsc1);
+
+    return;
+}
+#endif
+
+static int darshan_core_name_is_excluded(const char *name, darshan_module_id mod_id)
+{
+    int name_is_path;
+
+    if(!name)
+        return(0);
+
+    /* set flag if this module's record names are based on file paths */
+    name_is_path = 1;
+    if((mod_id == DARSHAN_APMPI_MOD) || (mod_id == DARSHAN_APXC_MOD) ||
+       (mod_id == DARSHAN_HEATMAP_MOD) || (mod_id == DARSHAN_MDHIM_MOD))
+        name_is_path = 0;
+
+    /* path exclusions/inclusions and the NAME_EXCLUDE/NAME_INCLUDE rules of
+     * the config were compiled at startup, see darshan_compile_name_rules()
+     */
+    return(darshan_name_is_excluded(&__darshan_core->config, name, mod_id,
+        name_is_path));
 }
 
 #ifdef HAVE_MPI
@@ -2494,8 +3175,212 @@ void darshan_shutdown_bench(int argc, char **argv)
 }
 #endif
 
+/* crude benchmarking hook into darshan-core to compare the cost of the
+ * clock sources available for darshan_core_wtime() on this platform
+ */
+#define DARSHAN_WTIME_BENCH(__name, __expr) do { \
+    double __t1, __t2; \
+    volatile double __sink = 0; \
+    __t1 = darshan_core_wtime_absolute(); \
+    for(i = 0; i < iters; i++) \
+        __sink += (__expr); \
+    __t2 = darshan_core_wtime_absolute(); \
+    (void)__sink; \
+    printf("%s\t%d\t%.9f\t%.9f\n", __name, iters, __t2-__t1, \
+        (__t2-__t1)/(double)iters); \
+} while(0)
+
+static inline double darshan_wtime_bench_clock(clockid_t clk)
+{
+    struct timespec tp;
+
+    clock_gettime(clk, &tp);
+    return(((double)tp.tv_sec) + 1.0e-9 * ((double)tp.tv_nsec));
+}
+
+void darshan_wtime_bench(int iters)
+{
+    int i;
+#ifdef HAVE_RDTSCP_INTRINSIC
+    unsigned flag;
+#endif
+
+#ifdef __DARSHAN_RDTSCP_CALIBRATE
+    darshan_core_calibrate_tsc();
+    if(__darshan_core_tsc_sec_per_tick > 0)
+        printf("# darshan wtime: calibrated rdtscp (%.6f GHz)\n",
+            1.0e-9 / __darshan_core_tsc_sec_per_tick);
+    else
+        printf("# darshan wtime: CLOCK_MONOTONIC (no usable invariant TSC)\n");
+#elif defined(__DARSHAN_RDTSCP_FREQUENCY)
+    printf("# darshan wtime: rdtscp (configured at %.6f GHz)\n",
+        1.0e-9 * (double)__DARSHAN_RDTSCP_FREQUENCY);
+#else
+    printf("# darshan wtime: CLOCK_MONOTONIC\n");
+#endif
+
+    printf("#<op>\t<iters>\t<total (s)>\t<per op (s)>\n");
+    DARSHAN_WTIME_BENCH("darshan_wtime", darshan_core_wtime());
+    DARSHAN_WTIME_BENCH("clock_realtime",
+        darshan_wtime_bench_clock(CLOCK_REALTIME));
+    DARSHAN_WTIME_BENCH("clock_monotonic",
+        darshan_wtime_bench_clock(CLOCK_MONOTONIC));
+#ifdef CLOCK_MONOTONIC_COARSE
+    DARSHAN_WTIME_BENCH("clock_monotonic_coarse",
+        darshan_wtime_bench_clock(CLOCK_MONOTONIC_COARSE));
+#endif
+#ifdef HAVE_RDTSCP_INTRINSIC
+    DARSHAN_WTIME_BENCH("rdtscp_raw", (double)__rdtscp(&flag));
+#endif
+
+    return;
+}
+
 /* ********************************************************* */
 
+static inline uintptr_t darshan_core_overhead_nested(void)
+{
+    return((uintptr_t)pthread_getspecific(overhead_nested_key));
+}
+
+/* adds 'seconds' to the calling thread's accounted overhead, so that it is
+ * subtracted from any module whose lock the thread currently holds
+ */
+static inline void darshan_core_overhead_nested_add(double seconds)
+{
+    pthread_setspecific(overhead_nested_key, (void *)(darshan_core_overhead_nested() +
+        (uintptr_t)(seconds * 1.0e9 + 0.5)));
+}
+
+void darshan_core_overhead_lock(int slot, pthread_mutex_t *mutex)
+{
+    struct darshan_core_overhead *ovh = &overhead_array[slot];
+    double tm1, tm2;
+
+    tm1 = darshan_core_wtime_absolute();
+    if(pthread_mutex_trylock(mutex) != 0)
+    {
+        pthread_mutex_lock(mutex);
+        tm2 = darshan_core_wtime_absolute();
+        ovh->contended++;
+        ovh->lock_wait += tm2 - tm1;
+        darshan_core_overhead_nested_add(tm2 - tm1);
+        tm1 = tm2;
+    }
+
+    /* the slot is protected by the mutex we now hold */
+    if(ovh->depth++ == 0)
+    {
+        ovh->start = tm1;
+        ovh->nested_start = darshan_core_overhead_nested();
+        ovh->calls++;
+    }
+
+    return;
+}
+
+void darshan_core_overhead_unlock(int slot, pthread_mutex_t *mutex)
+{
+    struct darshan_core_overhead *ovh = &overhead_array[slot];
+    double elapsed;
+
+    if(ovh->depth > 0 && --ovh->depth == 0)
+    {
+        /* only count the time not already accounted to modules called
+         * while the lock was held
+         */
+        elapsed = darshan_core_wtime_absolute() - ovh->start -
+            (double)(darshan_core_overhead_nested() - ovh->nested_start) * 1.0e-9;
+        if(elapsed < 0)
+            elapsed = 0;
+        ovh->time += elapsed;
+        darshan_core_overhead_nested_add(elapsed);
+    }
+    pthread_mutex_unlock(mutex);
+
+    return;
+}
+
+void darshan_core_overhead_memory(int slot, ssize_t delta)
+{
+    pthread_mutex_lock(&overhead_mutex);
+    overhead_array[slot].mem += delta;
+    if(overhead_array[slot].mem > overhead_array[slot].mem_hwm)
+        overhead_array[slot].mem_hwm = overhead_array[slot].mem;
+    pthread_mutex_unlock(&overhead_mutex);
+
+    return;
+}
+
+void darshan_core_overhead_add(int slot, double start)
+{
+    double tm = darshan_core_wtime_absolute();
+
+    pthread_mutex_lock(&overhead_mutex);
+    overhead_array[slot].time += tm - start;
+    overhead_array[slot].calls++;
+    pthread_mutex_unlock(&overhead_mutex);
+    darshan_core_overhead_nested_add(tm - start);
+
+    return;
+}
+
+/* buffers of at least a huge page are mapped separately if huge pages are
+ * enabled, and are sized in whole huge pages
+ */
+#define DARSHAN_HUGE_BUF(__size) \
+    (huge_pages != DARSHAN_HUGE_PAGES_NONE && (__size) >= huge_page_size)
+#define DARSHAN_HUGE_BUF_SIZE(__size) \
+    ((((__size) + huge_page_size - 1) / huge_page_size) * huge_page_size)
+
+void *darshan_core_huge_realloc(void *buf, size_t old_size, size_t new_size)
+{
+    void *new_buf;
+    int backing;
+
+    if(!buf)
+        old_size = 0;
+    if(!DARSHAN_HUGE_BUF(new_size))
+    {
+        if(!DARSHAN_HUGE_BUF(old_size))
+            return(realloc(buf, new_size));
+        new_buf = malloc(new_size);
+    }
+    else if(DARSHAN_HUGE_BUF(old_size) &&
+        DARSHAN_HUGE_BUF_SIZE(new_size) == DARSHAN_HUGE_BUF_SIZE(old_size))
+        return(buf);
+    else
+    {
+        new_buf = darshan_mem_map(DARSHAN_HUGE_BUF_SIZE(new_size),
+            PROT_READ | PROT_WRITE, 0, huge_pages, &backing);
+        if(new_buf == MAP_FAILED)
+            new_buf = NULL;
+    }
+    if(!new_buf)
+        return(NULL);
+
+    if(buf)
+    {
+        memcpy(new_buf, buf, (old_size < new_size) ? old_size : new_size);
+        darshan_core_huge_free(buf, old_size);
+    }
+
+    return(new_buf);
+}
+
+void darshan_core_huge_free(void *buf, size_t size)
+{
+    if(!buf)
+        return;
+
+    if(DARSHAN_HUGE_BUF(size))
+        munmap(buf, DARSHAN_HUGE_BUF_SIZE(size));
+    else
+        free(buf);
+
+    return;
+}
+
 int darshan_core_register_module(
     darshan_module_id mod_id,
     darshan_module_funcs mod_funcs,
@@ -2507,6 +3392,8 @@ int darshan_core_register_module(
     struct darshan_core_module* mod;
     size_t mod_recs_req = *inout_rec_count;
     size_t mod_mem_avail, mod_mem_req;
+    size_t mod_mem_limit;
+    int fixed_rec_count = 0;
 
     *inout_rec_count = 0;
 
@@ -2532,19 +3419,28 @@ int darshan_core_register_module(
         return(-1);
     }
 
-    /* allow user overrides of module record counts */
-    if(__darshan_core->config.mod_max_records_override[mod_id])
-    {
-        /* ignore overrides for modules with static record counts
-         * (i.e., HEATMAP, APMPI, APXC modules)
-         */
-        if((mod_id != DARSHAN_HEATMAP_MOD) && (mod_id != DARSHAN_APXC_MOD) &&
-            (mod_id != DARSHAN_APMPI_MOD))
-            mod_recs_req = __darshan_core->config.mod_max_records_override[mod_id];
-    }
+    /* modules with static record counts (i.e., HEATMAP, APMPI, APXC
+     * modules) never need to grow their memory
+     */
+    if((mod_id == DARSHAN_HEATMAP_MOD) || (mod_id == DARSHAN_APXC_MOD) ||
+        (mod_id == DARSHAN_APMPI_MOD))
+        fixed_rec_count = 1;
+
+    /* allow user overrides of module record counts, other than for modules
+     * with static record counts
+     */
+    if(__darshan_core->config.mod_max_records_override[mod_id] &&
+        !fixed_rec_count)
+        mod_recs_req = __darshan_core->config.mod_max_records_override[mod_id];
 
     mod_mem_req = mod_recs_req * rec_size;
-    mod_mem_avail = __darshan_core->config.mod_mem - __darshan_core->mod_mem_used;
+    mod_mem_avail = 0;
+    if(__darshan_core->config.mod_mem > __darshan_core->mod_mem_used)
+        mod_mem_avail = __darshan_core->config.mod_mem - __darshan_core->mod_mem_used;
+    /* the most memory all modules may grow to */
+    mod_mem_limit = __darshan_core->config.mod_mem;
+    if(__darshan_core->config.mod_mem_max > mod_mem_limit)
+        mod_mem_limit = __darshan_core->config.mod_mem_max;
 
     /* set module structure to register with Darshan core */
     mod->mod_funcs = mod_funcs;
@@ -2554,6 +3450,15 @@ int darshan_core_register_module(
          * we can satisfy given our current global memory usage and set up
          * module memory pointers
          */
+        if(mod_mem_avail < rec_size && !fixed_rec_count)
+        {
+            /* the configured memory is used up, but the module can
+             * start out with a chunk of what it could grow to
+             */
+            mod_mem_avail = mod_mem_limit - __darshan_core->mod_mem_used;
+            if(mod_mem_avail > DARSHAN_MEM_GROW_CHUNK)
+                mod_mem_avail = DARSHAN_MEM_GROW_CHUNK;
+        }
         if(mod_mem_avail >= mod_mem_req)
         {
             mod->rec_mem_avail = mod_mem_req;
@@ -2565,14 +3470,24 @@ int darshan_core_register_module(
             mod->rec_mem_avail = tmp_rec_count * rec_size;
             *inout_rec_count = tmp_rec_count;
         }
-        mod->rec_buf_start = __darshan_core->log_mod_p + __darshan_core->mod_mem_used;
+
+        /* reserve room for the module's records to grow to the memory
+         * limit, so they stay contiguous as the module's memory grows
+         */
+        if(darshan_mem_region_init(__darshan_core, &mod->region,
+            &__darshan_core->log_hdr_p->mod_map[mod_id], mod->rec_mem_avail,
+            fixed_rec_count ? mod->rec_mem_avail :
+            mod_mem_limit - __darshan_core->mod_mem_used) < 0)
+        {
+            __DARSHAN_CORE_UNLOCK();
+            free(mod);
+            *inout_rec_count = 0;
+            return(-1);
+        }
+        mod->rec_buf_start = mod->region.base;
         mod->rec_buf_p = mod->rec_buf_start;
 
         __darshan_core->mod_mem_used += mod->rec_mem_avail;
-#ifdef __DARSHAN_ENABLE_MMAP_LOGS
-        __darshan_core->log_hdr_p->mod_map[mod_id].off =
-            ((char *)mod->rec_buf_start - (char *)__darshan_core->log_hdr_p);
-#endif
     }
     else
     {
@@ -2599,10 +3514,10 @@ int darshan_core_register_module(
     return(0);
 }
 
-/* NOTE: we currently don't really have a simple way of returning the
- * memory allocated to this module back to darshan to hand out to
- * other modules, so all we do is disable the module so darshan does
- * not attempt to call into it at shutdown time
+/* NOTE: the memory granted to this module is released, but is not
+ * handed out to other modules (i.e., it still counts against the module
+ * memory limit), so this mostly disables the module so darshan does not
+ * attempt to call into it at shutdown time
  */
 void darshan_core_unregister_module(
     darshan_module_id mod_id)
@@ -2626,6 +3541,10 @@ void darshan_core_unregister_module(
         __darshan_core->log_hdr_p->mod_map[mod_id].len = 0;
 #endif
     __DARSHAN_CORE_UNLOCK();
+#ifndef __DARSHAN_ENABLE_MMAP_LOGS
+    if(mod && mod->region.base)
+        munmap(mod->region.base, mod->region.max_size);
+#endif
     free(mod);
 
     return;
@@ -2654,8 +3573,12 @@ void *darshan_core_register_record(
         return(NULL);
     }
 
-    /* check to see if this module has enough space to store a new record */
-    if(__darshan_core->mod_array[mod_id]->rec_mem_avail < rec_size)
+    /* check to see if this module has enough space to store a new record,
+     * growing its memory if it does not
+     */
+    if(__darshan_core->mod_array[mod_id]->rec_mem_avail < rec_size &&
+       darshan_core_grow_module(__darshan_core,
+            __darshan_core->mod_array[mod_id], rec_size) < 0)
     {
         DARSHAN_MOD_FLAG_SET(__darshan_core->log_hdr_p->partial_flag, mod_id);
         __DARSHAN_CORE_UNLOCK();
@@ -146,8 +146,8 @@ static pthread_mutex_t daos_runtime_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_
 static int daos_runtime_init_attempted = 0;
 static int my_rank = -1;
 
-#define DAOS_LOCK() pthread_mutex_lock(&daos_runtime_mutex)
-#define DAOS_UNLOCK() pthread_mutex_unlock(&daos_runtime_mutex)
+#define DAOS_LOCK() DARSHAN_MOD_LOCK(DARSHAN_DAOS_MOD, &daos_runtime_mutex)
+#define DAOS_UNLOCK() DARSHAN_MOD_UNLOCK(DARSHAN_DAOS_MOD, &daos_runtime_mutex)
 
 #define DAOS_WTIME() \
     __darshan_disabled ? 0 : darshan_core_wtime();
@@ -223,7 +223,7 @@ static int my_rank = -1;
     DARSHAN_TIMER_INC_NO_OVERLAP(__rec_ref->object_rec->fcounters[DAOS_F_META_TIME], \
         __tm1, __tm2, __rec_ref->last_meta_end); \
     darshan_add_record_ref(&(daos_runtime->oh_hash), __oh_p, \
-        sizeof(daos_handle_t), __rec_ref); \
+        sizeof(daos_handle_t), __rec_ref, NULL); \
 } while(0)
 
 #define DAOS_RECORD_OBJ_READ(__oh, __counter, __sz, __is_async, __tm1, __tm2) do { \
@@ -243,7 +243,7 @@ static int my_rank = -1;
     __rec_ref->object_rec->counters[DAOS_BYTES_READ] += __tmp_sz; \
     DARSHAN_BUCKET_INC(&(__rec_ref->object_rec->counters[DAOS_SIZE_READ_0_100]), __tmp_sz); \
     __cvc = darshan_track_common_val_counters(&__rec_ref->access_root, &__tmp_sz, 1, \
-        &__rec_ref->access_count); \
+        &__rec_ref->access_count, NULL); \
     if(__cvc) DARSHAN_UPDATE_COMMON_VAL_COUNTERS( \
         &(__rec_ref->object_rec->counters[DAOS_ACCESS1_ACCESS]), \
         &(__rec_ref->object_rec->counters[DAOS_ACCESS1_COUNT]), \
@@ -280,7 +280,7 @@ static int my_rank = -1;
     __rec_ref->object_rec->counters[DAOS_BYTES_WRITTEN] += __tmp_sz; \
     DARSHAN_BUCKET_INC(&(__rec_ref->object_rec->counters[DAOS_SIZE_WRITE_0_100]), __tmp_sz); \
     __cvc = darshan_track_common_val_counters(&__rec_ref->access_root, &__tmp_sz, 1, \
-        &__rec_ref->access_count); \
+        &__rec_ref->access_count, NULL); \
     if(__cvc) DARSHAN_UPDATE_COMMON_VAL_COUNTERS( \
         &(__rec_ref->object_rec->counters[DAOS_ACCESS1_ACCESS]), \
         &(__rec_ref->object_rec->counters[DAOS_ACCESS1_COUNT]), \
@@ -311,7 +311,7 @@ static int my_rank = -1;
     __rec_ref->object_rec->fcounters[DAOS_F_CLOSE_END_TIMESTAMP] = __tm2; \
     DARSHAN_TIMER_INC_NO_OVERLAP(__rec_ref->object_rec->fcounters[DAOS_F_META_TIME], \
         __tm1, __tm2, __rec_ref->last_meta_end); \
-    darshan_delete_record_ref(&(daos_runtime->oh_hash), &__oh, sizeof(daos_handle_t)); \
+    darshan_delete_record_ref(&(daos_runtime->oh_hash), &__oh, sizeof(daos_handle_t), NULL); \
 } while(0)
 
 /* DAOS callback routine to measure end of async open calls */
@@ -1826,7 +1826,7 @@ static struct daos_object_record_ref *daos_track_new_object_record(
 
     /* add a reference to this object record based on record id */
     ret = darshan_add_record_ref(&(daos_runtime->rec_id_hash), &rec_id,
-        sizeof(darshan_record_id), rec_ref);
+        sizeof(darshan_record_id), rec_ref, NULL);
     if(ret == 0)
     {
         free(rec_ref);
@@ -1846,7 +1846,7 @@ static struct daos_object_record_ref *daos_track_new_object_record(
     if(!object_rec)
     {
         darshan_delete_record_ref(&(daos_runtime->rec_id_hash),
-            &rec_id, sizeof(darshan_record_id));
+            &rec_id, sizeof(darshan_record_id), NULL);
         free(rec_ref);
         return(NULL);
     }
@@ -2240,8 +2240,8 @@ static void daos_cleanup()
     /* cleanup internal structures used for instrumenting */
     darshan_iter_record_refs(daos_runtime->rec_id_hash,
         &daos_finalize_object_records, NULL);
-    darshan_clear_record_refs(&(daos_runtime->oh_hash), 0);
-    darshan_clear_record_refs(&(daos_runtime->rec_id_hash), 1);
+    darshan_clear_record_refs(&(daos_runtime->oh_hash), 0, NULL);
+    darshan_clear_record_refs(&(daos_runtime->rec_id_hash), 1, NULL);
 
     HASH_ITER(hlink, daos_runtime->poolcont_hash, poolcont_info, tmp)
     {
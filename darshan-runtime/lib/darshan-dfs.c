@@ -129,8 +129,8 @@ static pthread_mutex_t dfs_runtime_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_N
 static int dfs_runtime_init_attempted = 0;
 static int my_rank = -1;
 
-#define DFS_LOCK() pthread_mutex_lock(&dfs_runtime_mutex)
-#define DFS_UNLOCK() pthread_mutex_unlock(&dfs_runtime_mutex)
+#define DFS_LOCK() DARSHAN_MOD_LOCK(DARSHAN_DFS_MOD, &dfs_runtime_mutex)
+#define DFS_UNLOCK() DARSHAN_MOD_UNLOCK(DARSHAN_DFS_MOD, &dfs_runtime_mutex)
 
 #define DAOS_WTIME() \
     __darshan_disabled ? 0 : darshan_core_wtime();
@@ -238,7 +238,7 @@ static int my_rank = -1;
     __rec_ref->file_rec->fcounters[DFS_F_OPEN_END_TIMESTAMP] = __tm2; \
     DARSHAN_TIMER_INC_NO_OVERLAP(__rec_ref->file_rec->fcounters[DFS_F_META_TIME], \
         __tm1, __tm2, __rec_ref->last_meta_end); \
-    darshan_add_record_ref(&(dfs_runtime->file_obj_hash), __obj_p, sizeof(*__obj_p), __rec_ref); \
+    darshan_add_record_ref(&(dfs_runtime->file_obj_hash), __obj_p, sizeof(*__obj_p), __rec_ref, NULL); \
 } while(0)
 
 #define DFS_RECORD_READ(__obj, __read_size, __counter, __is_async, __tm1, __tm2) do { \
@@ -257,7 +257,7 @@ static int my_rank = -1;
     __rec_ref->file_rec->counters[DFS_BYTES_READ] += __sz; \
     DARSHAN_BUCKET_INC(&(__rec_ref->file_rec->counters[DFS_SIZE_READ_0_100]), __sz); \
     __cvc = darshan_track_common_val_counters(&__rec_ref->access_root, &__sz, 1, \
-        &__rec_ref->access_count); \
+        &__rec_ref->access_count, NULL); \
     if(__cvc) DARSHAN_UPDATE_COMMON_VAL_COUNTERS( \
         &(__rec_ref->file_rec->counters[DFS_ACCESS1_ACCESS]), \
         &(__rec_ref->file_rec->counters[DFS_ACCESS1_COUNT]), \
@@ -296,7 +296,7 @@ static int my_rank = -1;
     __rec_ref->file_rec->counters[DFS_BYTES_WRITTEN] += __sz; \
     DARSHAN_BUCKET_INC(&(__rec_ref->file_rec->counters[DFS_SIZE_WRITE_0_100]), __sz); \
     __cvc = darshan_track_common_val_counters(&__rec_ref->access_root, &__sz, 1, \
-        &__rec_ref->access_count); \
+        &__rec_ref->access_count, NULL); \
     if(__cvc) DARSHAN_UPDATE_COMMON_VAL_COUNTERS( \
         &(__rec_ref->file_rec->counters[DFS_ACCESS1_ACCESS]), \
         &(__rec_ref->file_rec->counters[DFS_ACCESS1_COUNT]), \
@@ -505,7 +505,7 @@ int DARSHAN_DECL(dfs_release)(dfs_obj_t *obj)
         DARSHAN_TIMER_INC_NO_OVERLAP(
             rec_ref->file_rec->fcounters[DFS_F_META_TIME],
             tm1, tm2, rec_ref->last_meta_end);
-        darshan_delete_record_ref(&(dfs_runtime->file_obj_hash), &obj, sizeof(obj));
+        darshan_delete_record_ref(&(dfs_runtime->file_obj_hash), &obj, sizeof(obj), NULL);
     }
     DFS_POST_RECORD();
 
@@ -982,7 +982,7 @@ static struct dfs_file_record_ref *dfs_track_new_file_record(
 
     /* add a reference to this file record based on record id */
     ret = darshan_add_record_ref(&(dfs_runtime->rec_id_hash), &rec_id,
-        sizeof(darshan_record_id), rec_ref);
+        sizeof(darshan_record_id), rec_ref, NULL);
     if(ret == 0)
     {
         free(rec_ref);
@@ -1002,7 +1002,7 @@ static struct dfs_file_record_ref *dfs_track_new_file_record(
     if(!file_rec)
     {
         darshan_delete_record_ref(&(dfs_runtime->rec_id_hash),
-            &rec_id, sizeof(darshan_record_id));
+            &rec_id, sizeof(darshan_record_id), NULL);
         free(rec_ref);
         return(NULL);
     }
@@ -1377,8 +1377,8 @@ static void dfs_cleanup()
     /* cleanup internal structures used for instrumenting */
     darshan_iter_record_refs(dfs_runtime->rec_id_hash,
         &dfs_finalize_file_records, NULL);
-    darshan_clear_record_refs(&(dfs_runtime->file_obj_hash), 0);
-    darshan_clear_record_refs(&(dfs_runtime->rec_id_hash), 1);
+    darshan_clear_record_refs(&(dfs_runtime->file_obj_hash), 0, NULL);
+    darshan_clear_record_refs(&(dfs_runtime->rec_id_hash), 1, NULL);
 
     HASH_ITER(hlink, dfs_runtime->mount_hash, mnt_info, tmp)
     {
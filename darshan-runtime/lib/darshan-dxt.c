@@ -108,6 +108,8 @@ static struct dxt_file_record_ref *dxt_posix_track_new_file_record(
     darshan_record_id rec_id);
 static struct dxt_file_record_ref *dxt_mpiio_track_new_file_record(
     darshan_record_id rec_id);
+static void dxt_free_record_data(
+    void *rec_ref_p, void *user_ptr);
 
 /* DXT output/cleanup routines for darshan-core */
 static void dxt_posix_output(
@@ -132,6 +134,13 @@ static int dxt_my_rank = -1;
 
 #define DXT_LOCK() pthread_mutex_lock(&dxt_runtime_mutex)
 #define DXT_UNLOCK() pthread_mutex_unlock(&dxt_runtime_mutex)
+/* variants used when appending trace segments, which account overhead to
+ * the DXT_POSIX or DXT_MPIIO module respectively
+ */
+#define DXT_POSIX_LOCK() DARSHAN_MOD_LOCK(DXT_POSIX_MOD, &dxt_runtime_mutex)
+#define DXT_POSIX_UNLOCK() DARSHAN_MOD_UNLOCK(DXT_POSIX_MOD, &dxt_runtime_mutex)
+#define DXT_MPIIO_LOCK() DARSHAN_MOD_LOCK(DXT_MPIIO_MOD, &dxt_runtime_mutex)
+#define DXT_MPIIO_UNLOCK() DARSHAN_MOD_UNLOCK(DXT_MPIIO_MOD, &dxt_runtime_mutex)
 
 /************************************************************
  *  DXT routines exposed to Darshan core and other modules  *
@@ -228,11 +237,11 @@ void dxt_posix_write(darshan_record_id rec_id, int64_t offset,
     struct dxt_file_record_ref* rec_ref = NULL;
     struct dxt_file_record *file_rec;
 
-    DXT_LOCK();
+    DXT_POSIX_LOCK();
 
     if(!dxt_posix_runtime || dxt_posix_runtime->frozen)
     {
-        DXT_UNLOCK();
+        DXT_POSIX_UNLOCK();
         return;
     }
 
@@ -244,7 +253,7 @@ void dxt_posix_write(darshan_record_id rec_id, int64_t offset,
         rec_ref = dxt_posix_track_new_file_record(rec_id);
         if(!rec_ref)
         {
-            DXT_UNLOCK();
+            DXT_POSIX_UNLOCK();
             return;
         }
     }
@@ -254,7 +263,7 @@ void dxt_posix_write(darshan_record_id rec_id, int64_t offset,
     if(file_rec->write_count == rec_ref->write_available_buf)
     {
         /* no more memory for i/o segments ... back out */
-        DXT_UNLOCK();
+        DXT_POSIX_UNLOCK();
         return;
     }
 
@@ -264,7 +273,7 @@ void dxt_posix_write(darshan_record_id rec_id, int64_t offset,
     rec_ref->write_traces[file_rec->write_count].end_time = end_time;
     file_rec->write_count += 1;
 
-    DXT_UNLOCK();
+    DXT_POSIX_UNLOCK();
 }
 
 void dxt_posix_read(darshan_record_id rec_id, int64_t offset,
@@ -273,11 +282,11 @@ void dxt_posix_read(darshan_record_id rec_id, int64_t offset,
     struct dxt_file_record_ref* rec_ref = NULL;
     struct dxt_file_record *file_rec;
 
-    DXT_LOCK();
+    DXT_POSIX_LOCK();
 
     if(!dxt_posix_runtime || dxt_posix_runtime->frozen)
     {
-        DXT_UNLOCK();
+        DXT_POSIX_UNLOCK();
         return;
     }
 
@@ -289,7 +298,7 @@ void dxt_posix_read(darshan_record_id rec_id, int64_t offset,
         rec_ref = dxt_posix_track_new_file_record(rec_id);
         if(!rec_ref)
         {
-            DXT_UNLOCK();
+            DXT_POSIX_UNLOCK();
             return;
         }
     }
@@ -299,7 +308,7 @@ void dxt_posix_read(darshan_record_id rec_id, int64_t offset,
     if(file_rec->read_count == rec_ref->read_available_buf)
     {
         /* no more memory for i/o segments ... back out */
-        DXT_UNLOCK();
+        DXT_POSIX_UNLOCK();
         return;
     }
 
@@ -309,7 +318,7 @@ void dxt_posix_read(darshan_record_id rec_id, int64_t offset,
     rec_ref->read_traces[file_rec->read_count].end_time = end_time;
     file_rec->read_count += 1;
 
-    DXT_UNLOCK();
+    DXT_POSIX_UNLOCK();
 }
 
 void dxt_mpiio_write(darshan_record_id rec_id, int64_t offset,
@@ -318,11 +327,11 @@ void dxt_mpiio_write(darshan_record_id rec_id, int64_t offset,
     struct dxt_file_record_ref* rec_ref = NULL;
     struct dxt_file_record *file_rec;
 
-    DXT_LOCK();
+    DXT_MPIIO_LOCK();
 
     if(!dxt_mpiio_runtime || dxt_mpiio_runtime->frozen)
     {
-        DXT_UNLOCK();
+        DXT_MPIIO_UNLOCK();
         return;
     }
 
@@ -334,7 +343,7 @@ void dxt_mpiio_write(darshan_record_id rec_id, int64_t offset,
         rec_ref = dxt_mpiio_track_new_file_record(rec_id);
         if(!rec_ref)
         {
-            DXT_UNLOCK();
+            DXT_MPIIO_UNLOCK();
             return;
         }
     }
@@ -344,7 +353,7 @@ void dxt_mpiio_write(darshan_record_id rec_id, int64_t offset,
     if(file_rec->write_count == rec_ref->write_available_buf)
     {
         /* no more memory for i/o segments ... back out */
-        DXT_UNLOCK();
+        DXT_MPIIO_UNLOCK();
         return;
     }
 
@@ -354,7 +363,7 @@ void dxt_mpiio_write(darshan_record_id rec_id, int64_t offset,
     rec_ref->write_traces[file_rec->write_count].end_time = end_time;
     file_rec->write_count += 1;
 
-    DXT_UNLOCK();
+    DXT_MPIIO_UNLOCK();
 }
 
 void dxt_mpiio_read(darshan_record_id rec_id, int64_t offset,
@@ -363,11 +372,11 @@ void dxt_mpiio_read(darshan_record_id rec_id, int64_t offset,
     struct dxt_file_record_ref* rec_ref = NULL;
     struct dxt_file_record *file_rec;
 
-    DXT_LOCK();
+    DXT_MPIIO_LOCK();
 
     if(!dxt_mpiio_runtime || dxt_mpiio_runtime->frozen)
     {
-        DXT_UNLOCK();
+        DXT_MPIIO_UNLOCK();
         return;
     }
 
@@ -379,7 +388,7 @@ void dxt_mpiio_read(darshan_record_id rec_id, int64_t offset,
         rec_ref = dxt_mpiio_track_new_file_record(rec_id);
         if(!rec_ref)
         {
-            DXT_UNLOCK();
+            DXT_MPIIO_UNLOCK();
             return;
         }
     }
@@ -389,7 +398,7 @@ void dxt_mpiio_read(darshan_record_id rec_id, int64_t offset,
     if(file_rec->read_count == rec_ref->read_available_buf)
     {
         /* no more memory for i/o segments ... back out */
-        DXT_UNLOCK();
+        DXT_MPIIO_UNLOCK();
         return;
     }
 
@@ -399,7 +408,7 @@ void dxt_mpiio_read(darshan_record_id rec_id, int64_t offset,
     rec_ref->read_traces[file_rec->read_count].end_time = end_time;
     file_rec->read_count += 1;
 
-    DXT_UNLOCK();
+    DXT_MPIIO_UNLOCK();
 }
 
 static void dxt_posix_filter_traces_iterator(void *rec_ref_p, void *user_ptr)
@@ -449,12 +458,10 @@ static void dxt_posix_filter_traces_iterator(void *rec_ref_p, void *user_ptr)
         {
             /* first check the MPI-IO traces to see if we should drop there */
             mpiio_rec_ref = darshan_delete_record_ref(&dxt_mpiio_runtime->rec_id_hash,
-                &psx_file->base_rec.id, sizeof(darshan_record_id));
+                &psx_file->base_rec.id, sizeof(darshan_record_id), NULL);
             if(mpiio_rec_ref)
             {
-                free(mpiio_rec_ref->write_traces);
-                free(mpiio_rec_ref->read_traces);
-                free(mpiio_rec_ref->file_rec);
+                dxt_free_record_data(mpiio_rec_ref, NULL);
                 free(mpiio_rec_ref);
             }
         }
@@ -463,12 +470,10 @@ static void dxt_posix_filter_traces_iterator(void *rec_ref_p, void *user_ptr)
         {
             /* then delete the POSIX trace records */
             psx_rec_ref = darshan_delete_record_ref(&dxt_posix_runtime->rec_id_hash,
-                &psx_file->base_rec.id, sizeof(darshan_record_id));
+                &psx_file->base_rec.id, sizeof(darshan_record_id), NULL);
             if(psx_rec_ref)
             {
-                free(psx_rec_ref->write_traces);
-                free(psx_rec_ref->read_traces);
-                free(psx_rec_ref->file_rec);
+                dxt_free_record_data(psx_rec_ref, NULL);
                 free(psx_rec_ref);
             }
         }
@@ -549,7 +554,8 @@ static void check_wr_trace_buf(struct dxt_file_record_ref *rec_ref,
              */
             write_available_buf += write_count_inc;
             rec_ref->write_traces =
-                (segment_info *)realloc(rec_ref->write_traces,
+                (segment_info *)darshan_core_huge_realloc(rec_ref->write_traces,
+                        rec_ref->write_available_buf * sizeof(segment_info),
                         write_available_buf * sizeof(segment_info));
 
             rec_ref->write_available_buf = write_available_buf;
@@ -607,7 +613,8 @@ static void check_rd_trace_buf(struct dxt_file_record_ref *rec_ref,
              */
             read_available_buf += read_count_inc;
             rec_ref->read_traces =
-                (segment_info *)realloc(rec_ref->read_traces,
+                (segment_info *)darshan_core_huge_realloc(rec_ref->read_traces,
+                        rec_ref->read_available_buf * sizeof(segment_info),
                         read_available_buf * sizeof(segment_info));
 
             rec_ref->read_available_buf = read_available_buf;
@@ -635,7 +642,7 @@ static struct dxt_file_record_ref *dxt_posix_track_new_file_record(
 
     /* add a reference to this file record based on record id */
     ret = darshan_add_record_ref(&(dxt_posix_runtime->rec_id_hash), &rec_id,
-            sizeof(darshan_record_id), rec_ref);
+            sizeof(darshan_record_id), rec_ref, NULL);
     if(ret == 0)
     {
         free(rec_ref);
@@ -656,7 +663,7 @@ static struct dxt_file_record_ref *dxt_posix_track_new_file_record(
          NULL) == NULL)
     {
         darshan_delete_record_ref(&(dxt_posix_runtime->rec_id_hash),
-            &rec_id, sizeof(darshan_record_id));
+            &rec_id, sizeof(darshan_record_id), NULL);
         free(rec_ref);
         DXT_UNLOCK();
         return(NULL);
@@ -667,7 +674,7 @@ static struct dxt_file_record_ref *dxt_posix_track_new_file_record(
     if(!file_rec)
     {
         darshan_delete_record_ref(&(dxt_posix_runtime->rec_id_hash),
-            &rec_id, sizeof(darshan_record_id));
+            &rec_id, sizeof(darshan_record_id), NULL);
         free(rec_ref);
         DXT_UNLOCK();
         return(NULL);
@@ -707,7 +714,7 @@ static struct dxt_file_record_ref *dxt_mpiio_track_new_file_record(
 
     /* add a reference to this file record based on record id */
     ret = darshan_add_record_ref(&(dxt_mpiio_runtime->rec_id_hash), &rec_id,
-            sizeof(darshan_record_id), rec_ref);
+            sizeof(darshan_record_id), rec_ref, NULL);
     if(ret == 0)
     {
         free(rec_ref);
@@ -728,7 +735,7 @@ static struct dxt_file_record_ref *dxt_mpiio_track_new_file_record(
          NULL) == NULL)
     {
         darshan_delete_record_ref(&(dxt_mpiio_runtime->rec_id_hash),
-            &rec_id, sizeof(darshan_record_id));
+            &rec_id, sizeof(darshan_record_id), NULL);
         free(rec_ref);
         DXT_UNLOCK();
         return(NULL);
@@ -739,7 +746,7 @@ static struct dxt_file_record_ref *dxt_mpiio_track_new_file_record(
     if(!file_rec)
     {
         darshan_delete_record_ref(&(dxt_mpiio_runtime->rec_id_hash),
-            &rec_id, sizeof(darshan_record_id));
+            &rec_id, sizeof(darshan_record_id), NULL);
         free(rec_ref);
         DXT_UNLOCK();
         return(NULL);
@@ -764,8 +771,10 @@ static void dxt_free_record_data(void *rec_ref_p, void *user_ptr)
 {
     struct dxt_file_record_ref *dxt_rec_ref = (struct dxt_file_record_ref *)rec_ref_p;
 
-    free(dxt_rec_ref->write_traces);
-    free(dxt_rec_ref->read_traces);
+    darshan_core_huge_free(dxt_rec_ref->write_traces,
+        dxt_rec_ref->write_available_buf * sizeof(segment_info));
+    darshan_core_huge_free(dxt_rec_ref->read_traces,
+        dxt_rec_ref->read_available_buf * sizeof(segment_info));
     free(dxt_rec_ref->file_rec);
 }
 
@@ -828,7 +837,8 @@ static void dxt_posix_output(
 
     *dxt_posix_buf_sz = 0;
 
-    dxt_posix_runtime->record_buf = malloc(dxt_posix_runtime->mem_allocated);
+    dxt_posix_runtime->record_buf = darshan_core_huge_realloc(NULL, 0,
+        dxt_posix_runtime->mem_allocated);
     if(!(dxt_posix_runtime->record_buf))
         return;
     memset(dxt_posix_runtime->record_buf, 0, dxt_posix_runtime->mem_allocated);
@@ -851,12 +861,13 @@ static void dxt_posix_cleanup()
 {
     assert(dxt_posix_runtime);
 
-    free(dxt_posix_runtime->record_buf);
+    darshan_core_huge_free(dxt_posix_runtime->record_buf,
+        dxt_posix_runtime->mem_allocated);
 
     /* cleanup internal structures used for instrumenting */
     darshan_iter_record_refs(dxt_posix_runtime->rec_id_hash,
         dxt_free_record_data, NULL);
-    darshan_clear_record_refs(&(dxt_posix_runtime->rec_id_hash), 1);
+    darshan_clear_record_refs(&(dxt_posix_runtime->rec_id_hash), 1, NULL);
 
     free(dxt_posix_runtime);
     dxt_posix_runtime = NULL;
@@ -919,7 +930,8 @@ static void dxt_mpiio_output(
 
     *dxt_mpiio_buf_sz = 0;
 
-    dxt_mpiio_runtime->record_buf = malloc(dxt_mpiio_runtime->mem_allocated);
+    dxt_mpiio_runtime->record_buf = darshan_core_huge_realloc(NULL, 0,
+        dxt_mpiio_runtime->mem_allocated);
     if(!(dxt_mpiio_runtime->record_buf))
         return;
     memset(dxt_mpiio_runtime->record_buf, 0, dxt_mpiio_runtime->mem_allocated);
@@ -942,12 +954,13 @@ static void dxt_mpiio_cleanup()
 {
     assert(dxt_mpiio_runtime);
 
-    free(dxt_mpiio_runtime->record_buf);
+    darshan_core_huge_free(dxt_mpiio_runtime->record_buf,
+        dxt_mpiio_runtime->mem_allocated);
 
     /* cleanup internal structures used for instrumenting */
     darshan_iter_record_refs(dxt_mpiio_runtime->rec_id_hash,
         dxt_free_record_data, NULL);
-    darshan_clear_record_refs(&(dxt_mpiio_runtime->rec_id_hash), 1);
+    darshan_clear_record_refs(&(dxt_mpiio_runtime->rec_id_hash), 1, NULL);
 
     free(dxt_mpiio_runtime);
     dxt_mpiio_runtime = NULL;
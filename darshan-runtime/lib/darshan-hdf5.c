@@ -68,6 +68,34 @@ struct hdf5_file_record_ref
 #endif
 };
 
+/* analysis of the file dataspace selection passed to an H5Dread/H5Dwrite
+ * call -- this is gathered without holding the module lock and then
+ * applied to the corresponding dataset record
+ */
+struct hdf5_selection_info
+{
+    H5S_sel_type type;
+    hssize_t npoints;
+    hsize_t start[H5S_MAX_RANK];
+    hsize_t end[H5S_MAX_RANK];
+    int have_bounds;
+    int regular; /* 1 if regular hyperslab, 0 if irregular, -1 if unknown */
+    int64_t access_vals[H5D_MAX_NDIMS+H5D_MAX_NDIMS];
+};
+
+/* analysis of the last single-block hyperslab selection a dataset was
+ * accessed with, keyed by dataspace id and selection shape -- reused
+ * dataspaces whose selection window is only moved between accesses
+ * can skip the regular hyperslab queries entirely
+ */
+struct hdf5_selection_cache
+{
+    hid_t space_id; /* 0 (H5S_ALL) if cache is empty */
+    hssize_t npoints;
+    hsize_t extent[H5S_MAX_RANK];
+    int64_t access_vals[H5D_MAX_NDIMS+H5D_MAX_NDIMS];
+};
+
 /* structure that can track i/o stats for a given HDF5 dataset record at runtime */
 struct hdf5_dataset_record_ref
 {
@@ -78,6 +106,7 @@ struct hdf5_dataset_record_ref
     double last_meta_end;
     void *access_root;
     int access_count;
+    struct hdf5_selection_cache sel_cache;
 #ifdef HAVE_LDMS
     int64_t close_counts;
 #endif
@@ -100,6 +129,16 @@ static struct hdf5_file_record_ref *hdf5_track_new_file_record(
     darshan_record_id rec_id, const char *rec_name);
 static struct hdf5_dataset_record_ref *hdf5_track_new_dataset_record(
     darshan_record_id rec_id, const char *rec_name);
+static void hdf5_selection_query(
+    hid_t space_id, struct hdf5_selection_info *sel);
+static int hdf5_selection_cache_lookup(
+    struct hdf5_dataset_record_ref *rec_ref, hid_t space_id,
+    struct hdf5_selection_info *sel);
+static void hdf5_selection_analyze(
+    hid_t space_id, struct hdf5_selection_info *sel);
+static void hdf5_selection_cache_update(
+    struct hdf5_dataset_record_ref *rec_ref, hid_t space_id,
+    struct hdf5_selection_info *sel);
 static void hdf5_finalize_dataset_records(
     void *rec_ref_p, void *user_ptr);
 #ifdef HAVE_MPI
@@ -135,6 +174,13 @@ static int my_rank = -1;
 
 #define HDF5_LOCK() pthread_mutex_lock(&hdf5_runtime_mutex)
 #define HDF5_UNLOCK() pthread_mutex_unlock(&hdf5_runtime_mutex)
+/* variants used by the instrumentation wrappers, which account overhead to
+ * the H5F or H5D module respectively
+ */
+#define H5F_LOCK() DARSHAN_MOD_LOCK(DARSHAN_H5F_MOD, &hdf5_runtime_mutex)
+#define H5F_UNLOCK() DARSHAN_MOD_UNLOCK(DARSHAN_H5F_MOD, &hdf5_runtime_mutex)
+#define H5D_LOCK() DARSHAN_MOD_LOCK(DARSHAN_H5D_MOD, &hdf5_runtime_mutex)
+#define H5D_UNLOCK() DARSHAN_MOD_UNLOCK(DARSHAN_H5D_MOD, &hdf5_runtime_mutex)
 
 #define HDF5_WTIME() \
     __darshan_disabled ? 0 : darshan_core_wtime();
@@ -150,17 +196,17 @@ static int my_rank = -1;
  */
 #define H5F_PRE_RECORD() do { \
     if(!__darshan_disabled) { \
-        HDF5_LOCK(); \
+        H5F_LOCK(); \
         if(!hdf5_file_runtime && !h5f_runtime_init_attempted) \
             hdf5_file_runtime_initialize(); \
         if(hdf5_file_runtime && !hdf5_file_runtime->frozen) break; \
-        HDF5_UNLOCK(); \
+        H5F_UNLOCK(); \
     } \
     return(ret); \
 } while(0)
 
 #define H5F_POST_RECORD() do { \
-    HDF5_UNLOCK(); \
+    H5F_UNLOCK(); \
 } while(0)
 
 #define H5F_RECORD_OPEN(__ret, __path, __use_mpio, __tm1, __tm2) do { \
@@ -184,7 +230,7 @@ static int my_rank = -1;
     __rec_ref->file_rec->fcounters[H5F_F_OPEN_END_TIMESTAMP] = __tm2; \
     DARSHAN_TIMER_INC_NO_OVERLAP(__rec_ref->file_rec->fcounters[H5F_F_META_TIME], \
         __tm1, __tm2, __rec_ref->last_meta_end); \
-    darshan_add_record_ref(&(hdf5_file_runtime->hid_hash), &__ret, sizeof(hid_t), __rec_ref); \
+    darshan_add_record_ref(&(hdf5_file_runtime->hid_hash), &__ret, sizeof(hid_t), __rec_ref, NULL); \
     if(__newpath != __path) free(__newpath); \
     /* LDMS to publish realtime open tracing information to daemon*/ \
     if(dC.ldms_lib)\
@@ -443,7 +489,7 @@ herr_t DARSHAN_DECL(H5Fclose)(hid_t file_id)
                 rec_ref->file_rec->fcounters[H5F_F_META_TIME],
                 tm1, tm2, rec_ref->last_meta_end);
             darshan_delete_record_ref(&(hdf5_file_runtime->hid_hash),
-                &file_id, sizeof(hid_t));
+                &file_id, sizeof(hid_t), NULL);
 
 #ifdef HAVE_LDMS
             rec_ref->close_counts++;
@@ -474,17 +520,17 @@ herr_t DARSHAN_DECL(H5Fclose)(hid_t file_id)
  */
 #define H5D_PRE_RECORD() do { \
     if(!__darshan_disabled) { \
-        HDF5_LOCK(); \
+        H5D_LOCK(); \
         if(!hdf5_dataset_runtime && !h5d_runtime_init_attempted) \
             hdf5_dataset_runtime_initialize(); \
         if(hdf5_dataset_runtime && !hdf5_dataset_runtime->frozen) break; \
-        HDF5_UNLOCK(); \
+        H5D_UNLOCK(); \
     } \
     return(ret); \
 } while(0)
 
 #define H5D_POST_RECORD() do { \
-    HDF5_UNLOCK(); \
+    H5D_UNLOCK(); \
 } while(0)
 
 #define H5D_RECORD_OPEN(__ret, __loc_id, __name, __type_id, __space_id, __dcpl_id, __use_depr,  __tm1, __tm2) do { \
@@ -541,7 +587,7 @@ herr_t DARSHAN_DECL(H5Fclose)(hid_t file_id)
     } \
     __rec_ref->dataset_rec->counters[H5D_DATATYPE_SIZE] = H5Tget_size(__type_id); \
     __rec_ref->dataset_rec->file_rec_id = __file_rec_id; \
-    darshan_add_record_ref(&(hdf5_dataset_runtime->hid_hash), &__ret, sizeof(hid_t), __rec_ref); \
+    darshan_add_record_ref(&(hdf5_dataset_runtime->hid_hash), &__ret, sizeof(hid_t), __rec_ref, NULL); \
     /* LDMS to publish runtime h5d tracing information to daemon*/ \
     if(dC.ldms_lib)\
         if(dC.hdf5_enable_ldms)\
@@ -689,11 +735,11 @@ herr_t DARSHAN_DECL(H5Dread)(hid_t dataset_id, hid_t mem_type_id, hid_t mem_spac
     struct hdf5_dataset_record_ref *rec_ref;
     size_t access_size;
     size_t type_size;
-    ssize_t file_sel_npoints;
-    H5S_sel_type file_sel_type;
+    struct hdf5_selection_info sel;
+    int need_sel_analysis = 0;
+    int need_dxpl_query = 0;
     int64_t common_access_vals[H5D_MAX_NDIMS+H5D_MAX_NDIMS+1] = {0};
     struct darshan_common_val_counter *cvc;
-    int i;
     double tm1, tm2, elapsed;
     herr_t ret;
 
@@ -706,79 +752,92 @@ herr_t DARSHAN_DECL(H5Dread)(hid_t dataset_id, hid_t mem_type_id, hid_t mem_spac
 
     if(ret >= 0)
     {
+        if(__darshan_disabled)
+            return(ret);
+
+        /* query the selection before acquiring the module lock */
+        hdf5_selection_query(file_space_id, &sel);
+
         H5D_PRE_RECORD();
         rec_ref = darshan_lookup_record_ref(hdf5_dataset_runtime->hid_hash,
             &dataset_id, sizeof(hid_t));
         if(rec_ref)
+        {
+            need_sel_analysis = hdf5_selection_cache_lookup(rec_ref,
+                file_space_id, &sel);
+#ifdef DARSHAN_HDF5_PAR_BUILD
+            /* query the transfer mode of the DXPL on each call until a
+             * collective access has been counted for this dataset.  DXPL
+             * modes are not cached per DXPL id, as H5Pset_dxpl_mpio() can
+             * change the mode of a DXPL between calls.
+             */
+            if(xfer_plist_id != H5P_DEFAULT &&
+                !rec_ref->dataset_rec->counters[H5D_USE_MPIIO_COLLECTIVE])
+                need_dxpl_query = 1;
+#endif
+        }
+        if(rec_ref && (need_sel_analysis || need_dxpl_query))
+        {
+            /* drop the lock for any remaining HDF5 queries, then look the
+             * dataset back up, as it may have been closed in the meantime
+             */
+            H5D_POST_RECORD();
+            if(need_sel_analysis)
+                hdf5_selection_analyze(file_space_id, &sel);
+#ifdef DARSHAN_HDF5_PAR_BUILD
+            if(need_dxpl_query)
+            {
+                herr_t tmp_ret;
+                H5FD_mpio_xfer_t xfer_mode;
+                tmp_ret = H5Pget_dxpl_mpio(xfer_plist_id, &xfer_mode);
+                if(tmp_ret < 0 || xfer_mode != H5FD_MPIO_COLLECTIVE)
+                    need_dxpl_query = 0;
+            }
+#endif
+            H5D_PRE_RECORD();
+            rec_ref = darshan_lookup_record_ref(hdf5_dataset_runtime->hid_hash,
+                &dataset_id, sizeof(hid_t));
+        }
+        if(rec_ref)
         {
             rec_ref->dataset_rec->counters[H5D_READS] += 1;
             if(rec_ref->last_io_type == DARSHAN_IO_WRITE)
                 rec_ref->dataset_rec->counters[H5D_RW_SWITCHES] += 1;
             rec_ref->last_io_type = DARSHAN_IO_READ;
             if(file_space_id == H5S_ALL)
-            {
-                file_sel_npoints = rec_ref->dataset_rec->counters[H5D_DATASPACE_NPOINTS];
-                file_sel_type = H5S_SEL_ALL;
-            }
-            else
-            {
-                file_sel_npoints = H5Sget_select_npoints(file_space_id);
-                file_sel_type = H5Sget_select_type(file_space_id);
-            }
-            if(file_sel_type == H5S_SEL_POINTS)
+                sel.npoints = rec_ref->dataset_rec->counters[H5D_DATASPACE_NPOINTS];
+            if(sel.type == H5S_SEL_POINTS)
                 rec_ref->dataset_rec->counters[H5D_POINT_SELECTS] += 1;
-            else if (file_sel_type == H5S_SEL_HYPERSLABS)
+            else if (sel.type == H5S_SEL_HYPERSLABS)
             {
 #ifdef HAVE_H5SGET_REGULAR_HYPERSLAB
-                if(H5Sis_regular_hyperslab(file_space_id))
+                if(sel.regular == 1)
                 {
-                    hsize_t start_dims[H5D_MAX_NDIMS] = {0};
-                    hsize_t stride_dims[H5D_MAX_NDIMS] = {0};
-                    hsize_t count_dims[H5D_MAX_NDIMS] = {0};
-                    hsize_t block_dims[H5D_MAX_NDIMS] = {0};
                     rec_ref->dataset_rec->counters[H5D_REGULAR_HYPERSLAB_SELECTS] += 1;
-                    H5Sget_regular_hyperslab(file_space_id,
-                        start_dims, stride_dims, count_dims, block_dims);
-                    for(i = 0; i < H5D_MAX_NDIMS; i++)
-                    {
-                        common_access_vals[1+i] = count_dims[H5D_MAX_NDIMS - i - 1] *
-                            block_dims[H5D_MAX_NDIMS - i - 1];
-                        common_access_vals[1+i+H5D_MAX_NDIMS] =
-                            stride_dims[H5D_MAX_NDIMS - i - 1];
-                    }
+                    hdf5_selection_cache_update(rec_ref, file_space_id, &sel);
                 }
-                else
+                else if(sel.regular == 0)
                     rec_ref->dataset_rec->counters[H5D_IRREGULAR_HYPERSLAB_SELECTS] += 1;
-#else
-                for(i = 0; i < H5D_MAX_NDIMS; i++)
-                {
-                    common_access_vals[1+i] = -1;
-                    common_access_vals[1+i+H5D_MAX_NDIMS] = -1;
-                }
 #endif
+                memcpy(&common_access_vals[1], sel.access_vals,
+                    sizeof(sel.access_vals));
             }
+#ifdef DARSHAN_HDF5_PAR_BUILD
+            if(need_dxpl_query)
+                rec_ref->dataset_rec->counters[H5D_USE_MPIIO_COLLECTIVE] = 1;
+#endif
             type_size = rec_ref->dataset_rec->counters[H5D_DATATYPE_SIZE];
-            access_size = file_sel_npoints * type_size;
+            access_size = sel.npoints * type_size;
             rec_ref->dataset_rec->counters[H5D_BYTES_READ] += access_size;
             DARSHAN_BUCKET_INC(
                 &(rec_ref->dataset_rec->counters[H5D_SIZE_READ_AGG_0_100]), access_size);
             common_access_vals[0] = access_size;
             cvc = darshan_track_common_val_counters(&rec_ref->access_root,
-                common_access_vals, H5D_MAX_NDIMS+H5D_MAX_NDIMS+1, &rec_ref->access_count);
+                common_access_vals, H5D_MAX_NDIMS+H5D_MAX_NDIMS+1, &rec_ref->access_count, NULL);
             if(cvc) DARSHAN_UPDATE_COMMON_VAL_COUNTERS(
                 &(rec_ref->dataset_rec->counters[H5D_ACCESS1_ACCESS]),
                 &(rec_ref->dataset_rec->counters[H5D_ACCESS1_COUNT]),
                 cvc->vals, cvc->nvals, cvc->freq, 0);
-#ifdef DARSHAN_HDF5_PAR_BUILD
-            if(xfer_plist_id != H5P_DEFAULT)
-            {
-                herr_t tmp_ret;
-                H5FD_mpio_xfer_t xfer_mode;
-                tmp_ret = H5Pget_dxpl_mpio(xfer_plist_id, &xfer_mode);
-                if(tmp_ret >= 0 && xfer_mode == H5FD_MPIO_COLLECTIVE)
-                    rec_ref->dataset_rec->counters[H5D_USE_MPIIO_COLLECTIVE] = 1;
-            }
-#endif
             if(rec_ref->dataset_rec->fcounters[H5D_F_READ_START_TIMESTAMP] == 0 ||
              rec_ref->dataset_rec->fcounters[H5D_F_READ_START_TIMESTAMP] > tm1)
                 rec_ref->dataset_rec->fcounters[H5D_F_READ_START_TIMESTAMP] = tm1;
@@ -820,11 +879,11 @@ herr_t DARSHAN_DECL(H5Dwrite)(hid_t dataset_id, hid_t mem_type_id, hid_t mem_spa
     struct hdf5_dataset_record_ref *rec_ref;
     size_t access_size;
     size_t type_size;
-    ssize_t file_sel_npoints;
-    H5S_sel_type file_sel_type;
+    struct hdf5_selection_info sel;
+    int need_sel_analysis = 0;
+    int need_dxpl_query = 0;
     int64_t common_access_vals[H5D_MAX_NDIMS+H5D_MAX_NDIMS+1] = {0};
     struct darshan_common_val_counter *cvc;
-    int i;
     double tm1, tm2, elapsed;
     herr_t ret;
 
@@ -837,79 +896,92 @@ herr_t DARSHAN_DECL(H5Dwrite)(hid_t dataset_id, hid_t mem_type_id, hid_t mem_spa
 
     if(ret >= 0)
     {
+        if(__darshan_disabled)
+            return(ret);
+
+        /* query the selection before acquiring the module lock */
+        hdf5_selection_query(file_space_id, &sel);
+
         H5D_PRE_RECORD();
         rec_ref = darshan_lookup_record_ref(hdf5_dataset_runtime->hid_hash,
             &dataset_id, sizeof(hid_t));
         if(rec_ref)
+        {
+            need_sel_analysis = hdf5_selection_cache_lookup(rec_ref,
+                file_space_id, &sel);
+#ifdef DARSHAN_HDF5_PAR_BUILD
+            /* query the transfer mode of the DXPL on each call until a
+             * collective access has been counted for this dataset.  DXPL
+             * modes are not cached per DXPL id, as H5Pset_dxpl_mpio() can
+             * change the mode of a DXPL between calls.
+             */
+            if(xfer_plist_id != H5P_DEFAULT &&
+                !rec_ref->dataset_rec->counters[H5D_USE_MPIIO_COLLECTIVE])
+                need_dxpl_query = 1;
+#endif
+        }
+        if(rec_ref && (need_sel_analysis || need_dxpl_query))
+        {
+            /* drop the lock for any remaining HDF5 queries, then look the
+             * dataset back up, as it may have been closed in the meantime
+             */
+            H5D_POST_RECORD();
+            if(need_sel_analysis)
+                hdf5_selection_analyze(file_space_id, &sel);
+#ifdef DARSHAN_HDF5_PAR_BUILD
+            if(need_dxpl_query)
+            {
+                herr_t tmp_ret;
+                H5FD_mpio_xfer_t xfer_mode;
+                tmp_ret = H5Pget_dxpl_mpio(xfer_plist_id, &xfer_mode);
+                if(tmp_ret < 0 || xfer_mode != H5FD_MPIO_COLLECTIVE)
+                    need_dxpl_query = 0;
+            }
+#endif
+            H5D_PRE_RECORD();
+            rec_ref = darshan_lookup_record_ref(hdf5_dataset_runtime->hid_hash,
+                &dataset_id, sizeof(hid_t));
+        }
+        if(rec_ref)
         {
             rec_ref->dataset_rec->counters[H5D_WRITES] += 1;
             if(rec_ref->last_io_type == DARSHAN_IO_READ)
                 rec_ref->dataset_rec->counters[H5D_RW_SWITCHES] += 1;
             rec_ref->last_io_type = DARSHAN_IO_WRITE;
             if(file_space_id == H5S_ALL)
-            {
-                file_sel_npoints = rec_ref->dataset_rec->counters[H5D_DATASPACE_NPOINTS];
-                file_sel_type = H5S_SEL_ALL;
-            }
-            else
-            {
-                file_sel_npoints = H5Sget_select_npoints(file_space_id);
-                file_sel_type = H5Sget_select_type(file_space_id);
-            }
-            if(file_sel_type == H5S_SEL_POINTS)
+                sel.npoints = rec_ref->dataset_rec->counters[H5D_DATASPACE_NPOINTS];
+            if(sel.type == H5S_SEL_POINTS)
                 rec_ref->dataset_rec->counters[H5D_POINT_SELECTS] += 1;
-            else if (file_sel_type == H5S_SEL_HYPERSLABS)
+            else if (sel.type == H5S_SEL_HYPERSLABS)
             {
 #ifdef HAVE_H5SGET_REGULAR_HYPERSLAB
-                if(H5Sis_regular_hyperslab(file_space_id))
+                if(sel.regular == 1)
                 {
-                    hsize_t start_dims[H5D_MAX_NDIMS] = {0};
-                    hsize_t stride_dims[H5D_MAX_NDIMS] = {0};
-                    hsize_t count_dims[H5D_MAX_NDIMS] = {0};
-                    hsize_t block_dims[H5D_MAX_NDIMS] = {0};
                     rec_ref->dataset_rec->counters[H5D_REGULAR_HYPERSLAB_SELECTS] += 1;
-                    H5Sget_regular_hyperslab(file_space_id,
-                        start_dims, stride_dims, count_dims, block_dims);
-                    for(i = 0; i < H5D_MAX_NDIMS; i++)
-                    {
-                        common_access_vals[1+i] = count_dims[H5D_MAX_NDIMS - i - 1] *
-                            block_dims[H5D_MAX_NDIMS - i - 1];
-                        common_access_vals[1+i+H5D_MAX_NDIMS] =
-                            stride_dims[H5D_MAX_NDIMS - i - 1];
-                    }
+                    hdf5_selection_cache_update(rec_ref, file_space_id, &sel);
                 }
-                else
+                else if(sel.regular == 0)
                     rec_ref->dataset_rec->counters[H5D_IRREGULAR_HYPERSLAB_SELECTS] += 1;
-#else
-                for(i = 0; i < H5D_MAX_NDIMS; i++)
-                {
-                    common_access_vals[1+i] = -1;
-                    common_access_vals[1+i+H5D_MAX_NDIMS] = -1;
-                }
 #endif
+                memcpy(&common_access_vals[1], sel.access_vals,
+                    sizeof(sel.access_vals));
             }
+#ifdef DARSHAN_HDF5_PAR_BUILD
+            if(need_dxpl_query)
+                rec_ref->dataset_rec->counters[H5D_USE_MPIIO_COLLECTIVE] = 1;
+#endif
             type_size = rec_ref->dataset_rec->counters[H5D_DATATYPE_SIZE];
-            access_size = file_sel_npoints * type_size;
+            access_size = sel.npoints * type_size;
             rec_ref->dataset_rec->counters[H5D_BYTES_WRITTEN] += access_size;
             DARSHAN_BUCKET_INC(
                 &(rec_ref->dataset_rec->counters[H5D_SIZE_WRITE_AGG_0_100]), access_size);
             common_access_vals[0] = access_size;
             cvc = darshan_track_common_val_counters(&rec_ref->access_root,
-                common_access_vals, H5D_MAX_NDIMS+H5D_MAX_NDIMS+1, &rec_ref->access_count);
+                common_access_vals, H5D_MAX_NDIMS+H5D_MAX_NDIMS+1, &rec_ref->access_count, NULL);
             if(cvc) DARSHAN_UPDATE_COMMON_VAL_COUNTERS(
                 &(rec_ref->dataset_rec->counters[H5D_ACCESS1_ACCESS]),
                 &(rec_ref->dataset_rec->counters[H5D_ACCESS1_COUNT]),
                 cvc->vals, cvc->nvals, cvc->freq, 0);
-#ifdef DARSHAN_HDF5_PAR_BUILD
-            if(xfer_plist_id != H5P_DEFAULT)
-            {
-                herr_t tmp_ret;
-                H5FD_mpio_xfer_t xfer_mode;
-                tmp_ret = H5Pget_dxpl_mpio(xfer_plist_id, &xfer_mode);
-                if(tmp_ret >= 0 && xfer_mode == H5FD_MPIO_COLLECTIVE)
-                    rec_ref->dataset_rec->counters[H5D_USE_MPIIO_COLLECTIVE] = 1;
-            }
-#endif
             if(rec_ref->dataset_rec->fcounters[H5D_F_WRITE_START_TIMESTAMP] == 0 ||
              rec_ref->dataset_rec->fcounters[H5D_F_WRITE_START_TIMESTAMP] > tm1)
                 rec_ref->dataset_rec->fcounters[H5D_F_WRITE_START_TIMESTAMP] = tm1;
@@ -1002,7 +1074,7 @@ herr_t DARSHAN_DECL(H5Dclose)(hid_t dataset_id)
             rec_ref->dataset_rec->fcounters[H5D_F_CLOSE_END_TIMESTAMP] = tm2;
             DARSHAN_TIMER_INC_NO_OVERLAP(rec_ref->dataset_rec->fcounters[H5D_F_META_TIME],
                 tm1, tm2, rec_ref->last_meta_end);
-            darshan_delete_record_ref(&(hdf5_dataset_runtime->hid_hash), &dataset_id, sizeof(hid_t));
+            darshan_delete_record_ref(&(hdf5_dataset_runtime->hid_hash), &dataset_id, sizeof(hid_t), NULL);
 
 #ifdef HAVE_LDMS
             rec_ref->close_counts++;
@@ -1288,7 +1360,7 @@ herr_t DARSHAN_DECL(H5Oclose)(hid_t object_id)
             rec_ref->dataset_rec->fcounters[H5D_F_CLOSE_END_TIMESTAMP] = tm2;
             DARSHAN_TIMER_INC_NO_OVERLAP(rec_ref->dataset_rec->fcounters[H5D_F_META_TIME],
                 tm1, tm2, rec_ref->last_meta_end);
-            darshan_delete_record_ref(&(hdf5_dataset_runtime->hid_hash), &object_id, sizeof(hid_t));
+            darshan_delete_record_ref(&(hdf5_dataset_runtime->hid_hash), &object_id, sizeof(hid_t), NULL);
         }
         H5D_POST_RECORD();
     }
@@ -1395,7 +1467,7 @@ static struct hdf5_file_record_ref *hdf5_track_new_file_record(
 
     /* add a reference to this file record based on record id */
     ret = darshan_add_record_ref(&(hdf5_file_runtime->rec_id_hash), &rec_id,
-        sizeof(darshan_record_id), rec_ref);
+        sizeof(darshan_record_id), rec_ref, NULL);
     if(ret == 0)
     {
         free(rec_ref);
@@ -1415,7 +1487,7 @@ static struct hdf5_file_record_ref *hdf5_track_new_file_record(
     if(!file_rec)
     {
         darshan_delete_record_ref(&(hdf5_file_runtime->rec_id_hash),
-            &rec_id, sizeof(darshan_record_id));
+            &rec_id, sizeof(darshan_record_id), NULL);
         free(rec_ref);
         return(NULL);
     }
@@ -1443,7 +1515,7 @@ static struct hdf5_dataset_record_ref *hdf5_track_new_dataset_record(
 
     /* add a reference to this dataset record based on record id */
     ret = darshan_add_record_ref(&(hdf5_dataset_runtime->rec_id_hash), &rec_id,
-        sizeof(darshan_record_id), rec_ref);
+        sizeof(darshan_record_id), rec_ref, NULL);
     if(ret == 0)
     {
         free(rec_ref);
@@ -1463,7 +1535,7 @@ static struct hdf5_dataset_record_ref *hdf5_track_new_dataset_record(
     if(!dataset_rec)
     {
         darshan_delete_record_ref(&(hdf5_dataset_runtime->rec_id_hash),
-            &rec_id, sizeof(darshan_record_id));
+            &rec_id, sizeof(darshan_record_id), NULL);
         free(rec_ref);
         return(NULL);
     }
@@ -1485,6 +1557,140 @@ static struct hdf5_dataset_record_ref *hdf5_track_new_dataset_record(
     return(rec_ref);
 }
 
+/* gather the cheap parts of a file selection analysis: point count,
+ * selection type and (for hyperslabs) bounding box -- must be called
+ * without holding the HDF5 module lock
+ */
+static void hdf5_selection_query(
+    hid_t space_id, struct hdf5_selection_info *sel)
+{
+    memset(sel, 0, sizeof(*sel));
+    sel->regular = -1;
+
+    if(space_id == H5S_ALL)
+    {
+        /* point count is filled in from the dataset record */
+        sel->type = H5S_SEL_ALL;
+        return;
+    }
+
+    sel->npoints = H5Sget_select_npoints(space_id);
+    sel->type = H5Sget_select_type(space_id);
+    if(sel->type == H5S_SEL_HYPERSLABS)
+    {
+#ifdef HAVE_H5SGET_REGULAR_HYPERSLAB
+        if(H5Sget_select_bounds(space_id, sel->start, sel->end) >= 0)
+            sel->have_bounds = 1;
+#else
+        int i;
+        for(i = 0; i < H5D_MAX_NDIMS+H5D_MAX_NDIMS; i++)
+            sel->access_vals[i] = -1;
+#endif
+    }
+
+    return;
+}
+
+/* check a dataset's selection cache against the given selection, filling
+ * in the cached analysis on a hit -- returns 1 if the selection still
+ * needs hdf5_selection_analyze(), 0 otherwise (module lock must be held)
+ */
+static int hdf5_selection_cache_lookup(
+    struct hdf5_dataset_record_ref *rec_ref, hid_t space_id,
+    struct hdf5_selection_info *sel)
+{
+#ifdef HAVE_H5SGET_REGULAR_HYPERSLAB
+    struct hdf5_selection_cache *cache = &rec_ref->sel_cache;
+    int ndims = rec_ref->dataset_rec->counters[H5D_DATASPACE_NDIMS];
+    int i;
+
+    if(sel->type != H5S_SEL_HYPERSLABS)
+        return(0);
+
+    if(!sel->have_bounds || space_id != cache->space_id ||
+        sel->npoints != cache->npoints || ndims <= 0 || ndims > H5S_MAX_RANK)
+        return(1);
+    for(i = 0; i < ndims; i++)
+    {
+        if(sel->end[i] - sel->start[i] + 1 != cache->extent[i])
+            return(1);
+    }
+
+    /* same dataspace and the selection still fills a box of the same shape,
+     * so it is the same single block we analyzed before (possibly moved)
+     */
+    sel->regular = 1;
+    memcpy(sel->access_vals, cache->access_vals, sizeof(sel->access_vals));
+    return(0);
+#else
+    return(0);
+#endif
+}
+
+/* query the regular hyperslab parameters of a selection -- must be called
+ * without holding the HDF5 module lock
+ */
+static void hdf5_selection_analyze(
+    hid_t space_id, struct hdf5_selection_info *sel)
+{
+#ifdef HAVE_H5SGET_REGULAR_HYPERSLAB
+    hsize_t start_dims[H5S_MAX_RANK] = {0};
+    hsize_t stride_dims[H5S_MAX_RANK] = {0};
+    hsize_t count_dims[H5S_MAX_RANK] = {0};
+    hsize_t block_dims[H5S_MAX_RANK] = {0};
+    int i;
+
+    if(H5Sis_regular_hyperslab(space_id))
+    {
+        sel->regular = 1;
+        H5Sget_regular_hyperslab(space_id,
+            start_dims, stride_dims, count_dims, block_dims);
+        for(i = 0; i < H5D_MAX_NDIMS; i++)
+        {
+            sel->access_vals[i] = count_dims[H5D_MAX_NDIMS - i - 1] *
+                block_dims[H5D_MAX_NDIMS - i - 1];
+            sel->access_vals[i+H5D_MAX_NDIMS] =
+                stride_dims[H5D_MAX_NDIMS - i - 1];
+        }
+    }
+    else
+        sel->regular = 0;
+#endif
+
+    return;
+}
+
+/* remember a regular hyperslab selection in the dataset's selection cache
+ * if it is a single block, i.e. it exactly fills its bounding box (module
+ * lock must be held)
+ */
+static void hdf5_selection_cache_update(
+    struct hdf5_dataset_record_ref *rec_ref, hid_t space_id,
+    struct hdf5_selection_info *sel)
+{
+    struct hdf5_selection_cache *cache = &rec_ref->sel_cache;
+    int ndims = rec_ref->dataset_rec->counters[H5D_DATASPACE_NDIMS];
+    hssize_t volume = 1;
+    int i;
+
+    if(!sel->have_bounds || ndims <= 0 || ndims > H5S_MAX_RANK ||
+        sel->npoints <= 0)
+        return;
+
+    for(i = 0; i < ndims; i++)
+        volume *= (sel->end[i] - sel->start[i] + 1);
+    if(volume != sel->npoints)
+        return;
+
+    cache->space_id = space_id;
+    cache->npoints = sel->npoints;
+    for(i = 0; i < ndims; i++)
+        cache->extent[i] = sel->end[i] - sel->start[i] + 1;
+    memcpy(cache->access_vals, sel->access_vals, sizeof(cache->access_vals));
+
+    return;
+}
+
 static void hdf5_finalize_dataset_records(void *rec_ref_p, void *user_ptr)
 {
     struct hdf5_dataset_record_ref *rec_ref =
@@ -2078,8 +2284,8 @@ static void hdf5_file_cleanup()
     assert(hdf5_file_runtime);
 
     /* cleanup internal structures used for instrumenting */
-    darshan_clear_record_refs(&(hdf5_file_runtime->hid_hash), 0);
-    darshan_clear_record_refs(&(hdf5_file_runtime->rec_id_hash), 1);
+    darshan_clear_record_refs(&(hdf5_file_runtime->hid_hash), 0, NULL);
+    darshan_clear_record_refs(&(hdf5_file_runtime->rec_id_hash), 1, NULL);
 
     free(hdf5_file_runtime);
     hdf5_file_runtime = NULL;
@@ -2097,8 +2303,8 @@ static void hdf5_dataset_cleanup()
     /* cleanup internal structures used for instrumenting */
     darshan_iter_record_refs(hdf5_dataset_runtime->rec_id_hash,
         &hdf5_finalize_dataset_records, NULL);
-    darshan_clear_record_refs(&(hdf5_dataset_runtime->hid_hash), 0);
-    darshan_clear_record_refs(&(hdf5_dataset_runtime->rec_id_hash), 1);
+    darshan_clear_record_refs(&(hdf5_dataset_runtime->hid_hash), 0, NULL);
+    darshan_clear_record_refs(&(hdf5_dataset_runtime->rec_id_hash), 1, NULL);
 
     free(hdf5_dataset_runtime);
     hdf5_dataset_runtime = NULL;
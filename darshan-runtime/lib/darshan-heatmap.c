@@ -243,7 +243,7 @@ static void heatmap_cleanup()
     assert(heatmap_runtime);
 
     /* cleanup internal structures used for instrumenting */
-    darshan_clear_record_refs(&(heatmap_runtime->rec_id_hash), 1);
+    darshan_clear_record_refs(&(heatmap_runtime->rec_id_hash), 1, NULL);
 
     free(heatmap_runtime);
     heatmap_runtime = NULL;
@@ -374,10 +374,14 @@ void heatmap_update(darshan_record_id heatmap_id, int rw_flag,
     int bin_index = 0;
     double top_boundary, bottom_boundary, seconds_in_bin;
     int64_t intermediate_bytes;
+    double ovh_start = 0;
 
     /* if size is zero, we have no work to do here */
     if(size == 0) return;
 
+    if(__darshan_core_overhead_flag)
+        ovh_start = darshan_core_wtime_absolute();
+
     HEATMAP_PRE_RECORD_VOID();
 
     rec_ref = darshan_lookup_record_ref(heatmap_runtime->rec_id_hash, &heatmap_id, sizeof(darshan_record_id));
@@ -439,6 +443,12 @@ void heatmap_update(darshan_record_id heatmap_id, int rw_flag,
 
     HEATMAP_POST_RECORD();
 
+    /* the heatmap lock may be a spinlock, so account for overhead here
+     * rather than with DARSHAN_MOD_LOCK()
+     */
+    if(__darshan_core_overhead_flag)
+        darshan_core_overhead_add(DARSHAN_HEATMAP_MOD, ovh_start);
+
     return;
 }
 
@@ -456,7 +466,7 @@ static struct heatmap_record_ref *heatmap_track_new_record(
 
     /* add a reference to this record */
     ret = darshan_add_record_ref(&(heatmap_runtime->rec_id_hash), &rec_id,
-        sizeof(darshan_record_id), rec_ref);
+        sizeof(darshan_record_id), rec_ref, NULL);
     if(ret == 0)
     {
         free(rec_ref);
@@ -475,7 +485,7 @@ static struct heatmap_record_ref *heatmap_track_new_record(
     if(!heatmap_rec)
     {
         darshan_delete_record_ref(&(heatmap_runtime->rec_id_hash),
-            &rec_id, sizeof(darshan_record_id));
+            &rec_id, sizeof(darshan_record_id), NULL);
         free(rec_ref);
         return(NULL);
     }
@@ -209,6 +209,10 @@ void darshan_ldms_connector_send(uint64_t record_id, int64_t rank, int64_t recor
     int rc, ret, i, size, exists, found;
     struct timespec tspec_start, tspec_end;
     uint64_t micro_s;
+    double ovh_start = 0;
+
+    if(__darshan_core_overhead_flag)
+        ovh_start = darshan_core_wtime_absolute();
 
     pthread_mutex_lock(&dC.ln_lock);
     if (dC.ldms_darsh != NULL)
@@ -259,6 +263,9 @@ void darshan_ldms_connector_send(uint64_t record_id, int64_t rank, int64_t recor
     if (rc)
        darshan_core_fprintf(stderr, "LDMS library: darshanConnector - error %d publishing stream data.\n", rc);
 
+    if(__darshan_core_overhead_flag)
+        darshan_core_overhead_add(DARSHAN_OVERHEAD_LDMS, ovh_start);
+
     out_1:
 	 return;
 }
@@ -55,8 +55,8 @@ static pthread_mutex_t lustre_runtime_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZE
 static int lustre_runtime_init_attempted = 0;
 static int my_rank = -1;
 
-#define LUSTRE_LOCK() pthread_mutex_lock(&lustre_runtime_mutex)
-#define LUSTRE_UNLOCK() pthread_mutex_unlock(&lustre_runtime_mutex)
+#define LUSTRE_LOCK() DARSHAN_MOD_LOCK(DARSHAN_LUSTRE_MOD, &lustre_runtime_mutex)
+#define LUSTRE_UNLOCK() DARSHAN_MOD_UNLOCK(DARSHAN_LUSTRE_MOD, &lustre_runtime_mutex)
 
 static void darshan_get_lustre_layout_size(struct llapi_layout *lustre_layout,
     int *num_comps, int *num_stripes)
@@ -267,7 +267,7 @@ void darshan_instrument_lustre_file(darshan_record_id rec_id, int fd)
         }
     
         ret = darshan_add_record_ref(&(lustre_runtime->record_id_hash),
-            &rec_id, sizeof(darshan_record_id), rec_ref);
+            &rec_id, sizeof(darshan_record_id), rec_ref, NULL);
         if(ret == 0)
         {
             free(rec_ref);
@@ -287,7 +287,7 @@ void darshan_instrument_lustre_file(darshan_record_id rec_id, int fd)
         {
             /* if NULL, darshan has no more memory for instrumenting */
             darshan_delete_record_ref(&(lustre_runtime->record_id_hash),
-                &rec_id, sizeof(darshan_record_id));
+                &rec_id, sizeof(darshan_record_id), NULL);
             free(rec_ref);
             llapi_layout_free(lustre_layout);
             LUSTRE_UNLOCK();
@@ -478,7 +478,7 @@ static void lustre_cleanup()
     assert(lustre_runtime);
 
     /* cleanup data structures */
-    darshan_clear_record_refs(&(lustre_runtime->record_id_hash), 1);
+    darshan_clear_record_refs(&(lustre_runtime->record_id_hash), 1, NULL);
     free(lustre_runtime);
     lustre_runtime = NULL;
     lustre_runtime_init_attempted = 0;
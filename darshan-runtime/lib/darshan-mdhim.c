@@ -119,8 +119,8 @@ static int mdhim_runtime_init_attempted = 0;
 static int my_rank = -1;
 
 /* macros for obtaining/releasing the "MDHIM" module lock */
-#define MDHIM_LOCK() pthread_mutex_lock(&mdhim_runtime_mutex)
-#define MDHIM_UNLOCK() pthread_mutex_unlock(&mdhim_runtime_mutex)
+#define MDHIM_LOCK() DARSHAN_MOD_LOCK(DARSHAN_MDHIM_MOD, &mdhim_runtime_mutex)
+#define MDHIM_UNLOCK() DARSHAN_MOD_UNLOCK(DARSHAN_MDHIM_MOD, &mdhim_runtime_mutex)
 
 #define MDHIM_WTIME() \
     __darshan_disabled ? 0 : darshan_core_wtime();
@@ -373,7 +373,7 @@ static struct mdhim_record_ref *mdhim_track_new_record(
      * table, using the Darshan record identifier as the handle
      */
     ret = darshan_add_record_ref(&(mdhim_runtime->rec_id_hash), &rec_id,
-        sizeof(darshan_record_id), rec_ref);
+        sizeof(darshan_record_id), rec_ref, NULL);
     if(ret == 0)
     {
         free(rec_ref);
@@ -395,7 +395,7 @@ static struct mdhim_record_ref *mdhim_track_new_record(
     {
         /* if registration fails, delete record reference and return */
         darshan_delete_record_ref(&(mdhim_runtime->rec_id_hash),
-            &rec_id, sizeof(darshan_record_id));
+            &rec_id, sizeof(darshan_record_id), NULL);
         free(rec_ref);
         return(NULL);
     }
@@ -600,7 +600,7 @@ static void mdhim_cleanup()
     assert(mdhim_runtime);
 
     /* iterate the hash of record references and free them */
-    darshan_clear_record_refs(&(mdhim_runtime->rec_id_hash), 1);
+    darshan_clear_record_refs(&(mdhim_runtime->rec_id_hash), 1, NULL);
 
     free(mdhim_runtime);
     mdhim_runtime = NULL;
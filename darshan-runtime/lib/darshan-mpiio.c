@@ -29,6 +29,7 @@
 #include "darshan-dynamic.h"
 #include "darshan-dxt.h"
 #include "darshan-heatmap.h"
+#include "darshan-overlap.h"
 #include "darshan-ldms.h"
 
 DARSHAN_FORWARD_DECL(PMPI_File_close, int, (MPI_File *fh));
@@ -163,6 +164,7 @@ struct mpiio_runtime
     int file_rec_count;
     darshan_record_id heatmap_id;
     int frozen; /* flag to indicate that the counters should no longer be modified */
+    struct darshan_arena arena; /* record references and handle mappings */
 };
 
 static void mpiio_runtime_initialize(
@@ -191,8 +193,8 @@ static pthread_mutex_t mpiio_runtime_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER
 static int mpiio_runtime_init_attempted = 0;
 static int my_rank = -1;
 
-#define MPIIO_LOCK() pthread_mutex_lock(&mpiio_runtime_mutex)
-#define MPIIO_UNLOCK() pthread_mutex_unlock(&mpiio_runtime_mutex)
+#define MPIIO_LOCK() DARSHAN_MOD_LOCK(DARSHAN_MPIIO_MOD, &mpiio_runtime_mutex)
+#define MPIIO_UNLOCK() DARSHAN_MOD_UNLOCK(DARSHAN_MPIIO_MOD, &mpiio_runtime_mutex)
 
 #define MPIIO_WTIME() \
     __darshan_disabled ? 0 : darshan_core_wtime();
@@ -246,7 +248,10 @@ static int my_rank = -1;
     rec_ref->file_rec->fcounters[MPIIO_F_OPEN_END_TIMESTAMP] = __tm2; \
     DARSHAN_TIMER_INC_NO_OVERLAP(rec_ref->file_rec->fcounters[MPIIO_F_META_TIME], \
         __tm1, __tm2, rec_ref->last_meta_end); \
-    darshan_add_record_ref(&(mpiio_runtime->fh_hash), &__fh, sizeof(MPI_File), rec_ref); \
+    darshan_add_record_ref(&(mpiio_runtime->fh_hash), &__fh, sizeof(MPI_File), rec_ref, \
+        &(mpiio_runtime->arena)); \
+    /* OVERLAP to track the file even if this rank never writes to it */ \
+    overlap_file_open(rec_id); \
     if(newpath != __path) free(newpath); \
     /* LDMS to publish realtime open tracing information to daemon*/ \
     if(dC.ldms_lib)\
@@ -286,7 +291,7 @@ static int get_byte_offset = 0;
     DARSHAN_BUCKET_INC(&(rec_ref->file_rec->counters[MPIIO_SIZE_READ_AGG_0_100]), size); \
     size_ll = size; \
     cvc = darshan_track_common_val_counters(&rec_ref->access_root, &size_ll, 1, \
-        &rec_ref->access_count); \
+        &rec_ref->access_count, &(mpiio_runtime->arena)); \
     if(cvc) DARSHAN_UPDATE_COMMON_VAL_COUNTERS( \
         &(rec_ref->file_rec->counters[MPIIO_ACCESS1_ACCESS]), \
         &(rec_ref->file_rec->counters[MPIIO_ACCESS1_COUNT]), \
@@ -333,7 +338,7 @@ static int get_byte_offset = 0;
     DARSHAN_BUCKET_INC(&(rec_ref->file_rec->counters[MPIIO_SIZE_WRITE_AGG_0_100]), size); \
     size_ll = size; \
     cvc = darshan_track_common_val_counters(&rec_ref->access_root, &size_ll, 1, \
-        &rec_ref->access_count); \
+        &rec_ref->access_count, &(mpiio_runtime->arena)); \
     if(cvc) DARSHAN_UPDATE_COMMON_VAL_COUNTERS( \
         &(rec_ref->file_rec->counters[MPIIO_ACCESS1_ACCESS]), \
         &(rec_ref->file_rec->counters[MPIIO_ACCESS1_COUNT]), \
@@ -1184,7 +1189,7 @@ int DARSHAN_DECL(MPI_File_close)(MPI_File *fh)
             rec_ref->file_rec->fcounters[MPIIO_F_META_TIME],
             tm1, tm2, rec_ref->last_meta_end);
         darshan_delete_record_ref(&(mpiio_runtime->fh_hash),
-            &tmp_fh, sizeof(MPI_File));
+            &tmp_fh, sizeof(MPI_File), &(mpiio_runtime->arena));
 
 #ifdef HAVE_LDMS
         rec_ref->close_counts++;
@@ -1241,6 +1246,7 @@ static void mpiio_runtime_initialize()
         return;
     }
     memset(mpiio_runtime, 0, sizeof(*mpiio_runtime));
+    darshan_arena_init(&(mpiio_runtime->arena), DARSHAN_MPIIO_MOD);
 
     /* allow DXT module to initialize if needed */
     dxt_mpiio_runtime_initialize();
@@ -1258,17 +1264,16 @@ static struct mpiio_file_record_ref *mpiio_track_new_file_record(
     struct mpiio_file_record_ref *rec_ref = NULL;
     int ret;
 
-    rec_ref = malloc(sizeof(*rec_ref));
+    rec_ref = darshan_arena_alloc(&(mpiio_runtime->arena), sizeof(*rec_ref));
     if(!rec_ref)
         return(NULL);
-    memset(rec_ref, 0, sizeof(*rec_ref));
 
     /* add a reference to this file record based on record id */
     ret = darshan_add_record_ref(&(mpiio_runtime->rec_id_hash), &rec_id,
-        sizeof(darshan_record_id), rec_ref);
+        sizeof(darshan_record_id), rec_ref, &(mpiio_runtime->arena));
     if(ret == 0)
     {
-        free(rec_ref);
+        darshan_arena_free(&(mpiio_runtime->arena), rec_ref, sizeof(*rec_ref));
         return(NULL);
     }
 
@@ -1285,8 +1290,8 @@ static struct mpiio_file_record_ref *mpiio_track_new_file_record(
     if(!file_rec)
     {
         darshan_delete_record_ref(&(mpiio_runtime->rec_id_hash),
-            &rec_id, sizeof(darshan_record_id));
-        free(rec_ref);
+            &rec_id, sizeof(darshan_record_id), &(mpiio_runtime->arena));
+        darshan_arena_free(&(mpiio_runtime->arena), rec_ref, sizeof(*rec_ref));
         return(NULL);
     }
 
@@ -1304,7 +1309,7 @@ static void mpiio_finalize_file_records(void *rec_ref_p, void *user_ptr)
     struct mpiio_file_record_ref *rec_ref =
         (struct mpiio_file_record_ref *)rec_ref_p;
 
-    tdestroy(rec_ref->access_root, free);
+    tdestroy(rec_ref->access_root, darshan_arena_tree_nofree);
     return;
 }
 
@@ -1805,8 +1810,9 @@ static void mpiio_cleanup()
     /* cleanup internal structures used for instrumenting */
     darshan_iter_record_refs(mpiio_runtime->rec_id_hash,
         &mpiio_finalize_file_records, NULL);
-    darshan_clear_record_refs(&(mpiio_runtime->fh_hash), 0);
-    darshan_clear_record_refs(&(mpiio_runtime->rec_id_hash), 1);
+    darshan_clear_record_refs(&(mpiio_runtime->fh_hash), 0, &(mpiio_runtime->arena));
+    darshan_clear_record_refs(&(mpiio_runtime->rec_id_hash), 1, &(mpiio_runtime->arena));
+    darshan_arena_destroy(&(mpiio_runtime->arena));
 
     free(mpiio_runtime);
     mpiio_runtime = NULL;
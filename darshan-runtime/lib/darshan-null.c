@@ -112,8 +112,8 @@ static pthread_mutex_t null_runtime_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_
 static int my_rank = -1;
 
 /* macros for obtaining/releasing the "NULL" module lock */
-#define NULL_LOCK() pthread_mutex_lock(&null_runtime_mutex)
-#define NULL_UNLOCK() pthread_mutex_unlock(&null_runtime_mutex)
+#define NULL_LOCK() DARSHAN_MOD_LOCK(DARSHAN_NULL_MOD, &null_runtime_mutex)
+#define NULL_UNLOCK() DARSHAN_MOD_UNLOCK(DARSHAN_NULL_MOD, &null_runtime_mutex)
 
 /* the NULL_PRE_RECORD macro is executed before performing NULL
  * module instrumentation of a call. It obtains a lock for updating
@@ -271,7 +271,7 @@ static struct null_record_ref *null_track_new_record(
      * table, using the Darshan record identifier as the handle
      */
     ret = darshan_add_record_ref(&(null_runtime->rec_id_hash), &rec_id,
-        sizeof(darshan_record_id), rec_ref);
+        sizeof(darshan_record_id), rec_ref, NULL);
     if(ret == 0)
     {
         free(rec_ref);
@@ -292,7 +292,7 @@ static struct null_record_ref *null_track_new_record(
     {
         /* if registration fails, delete record reference and return */
         darshan_delete_record_ref(&(null_runtime->rec_id_hash),
-            &rec_id, sizeof(darshan_record_id));
+            &rec_id, sizeof(darshan_record_id), NULL);
         free(rec_ref);
         return(NULL);
     }
@@ -340,7 +340,7 @@ static void null_cleanup()
     NULL_LOCK();
 
     /* iterate the hash of record references and free them */
-    darshan_clear_record_refs(&(null_runtime->rec_id_hash), 1);
+    darshan_clear_record_refs(&(null_runtime->rec_id_hash), 1, NULL);
 
     free(null_runtime);
     null_runtime = NULL;
@@ -0,0 +1,1332 @@
+/*
+ * Copyright (C) 2026 University of Chicago.
+ * See COPYRIGHT notice in top-level directory.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <darshan-runtime-config.h>
+#endif
+
+#define _XOPEN_SOURCE 500
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <assert.h>
+
+#include "darshan.h"
+#include "darshan-overlap.h"
+
+/* default size of the blocks used for block counters, if the file system
+ * of a file does not report a preferred block size
+ */
+#define OVERLAP_DEF_BLOCK_SIZE (1024*1024)
+
+/* default number of extents tracked per file and rank; once exceeded, the
+ * closest extents are coarsened together until half of them are left
+ */
+#define OVERLAP_DEF_MAX_EXTENTS 1024
+
+/* maximum number of extents (from all ranks) gathered to rank 0 at once
+ * when reducing shared files; a shared file with more extents than this
+ * does not get cross-rank counters
+ */
+#define OVERLAP_GATHER_MAX_RUNS (4*1024*1024)
+
+/* a run of 'count' written extents of 'length' bytes, starting every
+ * 'stride' bytes from 'offset'.  Strided writes (e.g., each rank writing
+ * every n-th block of a shared file) are thus kept as a single run, while
+ * a run with a count of 1 is a plain extent.
+ */
+struct overlap_run
+{
+    int64_t offset;
+    int64_t length;
+    int64_t stride;
+    int64_t count;
+};
+
+/* offset following the last byte of a run */
+#define OVERLAP_RUN_END(__run) \
+    ((__run)->offset + ((__run)->count - 1) * (__run)->stride + (__run)->length)
+
+/* The overlap_file_record_ref structure maintains the extents written to
+ * the file record pointed to by 'file_rec', as a sorted array of runs that
+ * cover disjoint ranges of the file.
+ */
+struct overlap_file_record_ref
+{
+    struct darshan_overlap_file *file_rec;
+    struct overlap_run *runs;
+    int run_count;
+    int run_max;
+};
+
+/* The overlap_runtime structure maintains necessary state for storing
+ * OVERLAP file records and for coordinating with darshan-core at
+ * shutdown time.
+ */
+struct overlap_runtime
+{
+    void *rec_id_hash;
+    int file_rec_count;
+    struct darshan_arena arena;
+    int frozen; /* flag to indicate that the counters should no longer be modified */
+};
+
+/* iterator over the extents of an array of runs, in offset order.  If
+ * 'block_size' is set, the ranges of blocks touched by the extents are
+ * returned instead, with adjacent ranges combined.
+ */
+struct overlap_stream
+{
+    const struct overlap_run *runs;
+    int run_count;
+    int run;
+    int64_t ext;
+    int64_t block_size;
+};
+
+/* start or end of an extent, as sorted by overlap_sweep() */
+struct overlap_event
+{
+    int64_t pos;
+    int64_t end;    /* end of the extent, for start events */
+    int stream;     /* stream of the extent, or -1 for end events */
+};
+
+/* statistics accumulated while sweeping over the extents of a file */
+struct overlap_sweep_stats
+{
+    int64_t block_size;
+    int64_t unique_bytes;
+    int64_t shared_bytes;
+    int64_t overlap_blocks; /* blocks with bytes written by several ranks */
+    int64_t last_overlap_block;
+    int64_t blocks;
+    int64_t shared_blocks;
+    int64_t max_writers;
+    int64_t writer_sum;
+    int64_t writer_hist[OVERLAP_BLOCK_WRITERS_17_PLUS-OVERLAP_BLOCK_WRITERS_1+1];
+};
+
+static struct overlap_file_record_ref *overlap_track_new_file_record(
+    darshan_record_id rec_id);
+static void overlap_insert_extent(
+    struct overlap_file_record_ref *rec_ref, int64_t start, int64_t end);
+static void overlap_coarsen_runs(
+    struct overlap_file_record_ref *rec_ref, int target);
+static void overlap_compute_counters(
+    struct darshan_overlap_file *file_rec, struct overlap_stream *streams,
+    int nstreams);
+static void overlap_free_record_runs(
+    void *rec_ref_p, void *user_ptr);
+#ifdef HAVE_MPI
+static void overlap_invalidate_shared_counters(
+    struct darshan_overlap_file *file_rec);
+static void overlap_record_reduction_op(
+    void* inrec_v, void* inoutrec_v, int *len, MPI_Datatype *datatype);
+static void overlap_shared_record_extents(
+    MPI_Comm mod_comm, struct darshan_overlap_file *inrec_array,
+    struct darshan_overlap_file *outrec_array, int shared_rec_count);
+static void overlap_mpi_redux(
+    void *overlap_buf, MPI_Comm mod_comm,
+    darshan_record_id *shared_recs, int shared_rec_count);
+#endif
+static void overlap_output(
+    void **overlap_buf, int *overlap_buf_sz);
+static void overlap_cleanup(
+    void);
+
+static struct overlap_runtime *overlap_runtime = NULL;
+/* set while overlap_runtime exists, so that POSIX and MPI-IO calls can
+ * skip the module lock when OVERLAP is disabled
+ */
+static int overlap_active = 0;
+static pthread_mutex_t overlap_runtime_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+static int my_rank = -1;
+static int64_t overlap_block_size = 0;
+static int overlap_max_extents = OVERLAP_DEF_MAX_EXTENTS;
+
+#define OVERLAP_LOCK() DARSHAN_MOD_LOCK(DARSHAN_OVERLAP_MOD, &overlap_runtime_mutex)
+#define OVERLAP_UNLOCK() DARSHAN_MOD_UNLOCK(DARSHAN_OVERLAP_MOD, &overlap_runtime_mutex)
+
+/****************************************************************
+ *  OVERLAP routines exposed to Darshan core and other modules  *
+ ****************************************************************/
+
+void overlap_set_params(int64_t block_size, int max_extents)
+{
+    /* NOTE: this is called by darshan-core before any module is
+     * initialized, so no locking is needed
+     */
+    overlap_block_size = block_size;
+    if(max_extents > 0)
+        overlap_max_extents = max_extents;
+
+    return;
+}
+
+void overlap_posix_runtime_initialize()
+{
+    size_t overlap_rec_count = DARSHAN_DEF_MOD_REC_COUNT;
+    darshan_module_funcs mod_funcs = {
+#ifdef HAVE_MPI
+    .mod_redux_func = &overlap_mpi_redux,
+#endif
+    .mod_output_func = &overlap_output,
+    .mod_cleanup_func = &overlap_cleanup
+    };
+    int ret;
+
+    /* register the OVERLAP module with darshan core */
+    ret = darshan_core_register_module(
+        DARSHAN_OVERLAP_MOD,
+        mod_funcs,
+        sizeof(struct darshan_overlap_file),
+        &overlap_rec_count,
+        &my_rank,
+        NULL);
+    if(ret < 0)
+        return;
+
+    OVERLAP_LOCK();
+    overlap_runtime = malloc(sizeof(*overlap_runtime));
+    if(!overlap_runtime)
+    {
+        darshan_core_unregister_module(DARSHAN_OVERLAP_MOD);
+        OVERLAP_UNLOCK();
+        return;
+    }
+    memset(overlap_runtime, 0, sizeof(*overlap_runtime));
+    darshan_arena_init(&(overlap_runtime->arena), DARSHAN_OVERLAP_MOD);
+    __atomic_store_n(&overlap_active, 1, __ATOMIC_RELEASE);
+    OVERLAP_UNLOCK();
+
+    return;
+}
+
+void overlap_file_open(darshan_record_id rec_id)
+{
+    struct overlap_file_record_ref *rec_ref;
+
+    if(!__atomic_load_n(&overlap_active, __ATOMIC_ACQUIRE))
+        return;
+
+    OVERLAP_LOCK();
+
+    if(!overlap_runtime || overlap_runtime->frozen)
+    {
+        OVERLAP_UNLOCK();
+        return;
+    }
+
+    rec_ref = darshan_lookup_record_ref(overlap_runtime->rec_id_hash,
+        &rec_id, sizeof(darshan_record_id));
+    if(!rec_ref)
+        overlap_track_new_file_record(rec_id);
+
+    OVERLAP_UNLOCK();
+    return;
+}
+
+void overlap_posix_write(darshan_record_id rec_id, int64_t offset,
+    int64_t length)
+{
+    struct overlap_file_record_ref *rec_ref;
+
+    if(length <= 0 || !__atomic_load_n(&overlap_active, __ATOMIC_ACQUIRE))
+        return;
+
+    OVERLAP_LOCK();
+
+    if(!overlap_runtime || overlap_runtime->frozen)
+    {
+        OVERLAP_UNLOCK();
+        return;
+    }
+
+    rec_ref = darshan_lookup_record_ref(overlap_runtime->rec_id_hash,
+        &rec_id, sizeof(darshan_record_id));
+    if(!rec_ref)
+    {
+        rec_ref = overlap_track_new_file_record(rec_id);
+        if(!rec_ref)
+        {
+            OVERLAP_UNLOCK();
+            return;
+        }
+    }
+
+    rec_ref->file_rec->counters[OVERLAP_WRITES] += 1;
+    rec_ref->file_rec->counters[OVERLAP_BYTES_WRITTEN] += length;
+    overlap_insert_extent(rec_ref, offset, offset + length);
+
+    OVERLAP_UNLOCK();
+    return;
+}
+
+/*******************************************************
+ * internal helper functions for the OVERLAP module    *
+ *******************************************************/
+
+static struct overlap_file_record_ref *overlap_track_new_file_record(
+    darshan_record_id rec_id)
+{
+    struct darshan_overlap_file *file_rec = NULL;
+    struct overlap_file_record_ref *rec_ref = NULL;
+    struct darshan_fs_info fs_info;
+    char *rec_name;
+    int ret;
+
+    /* files are only tracked once the POSIX or MPI-IO module has
+     * registered them
+     */
+    rec_name = darshan_core_lookup_record_name(rec_id);
+    if(!rec_name)
+        return(NULL);
+
+    rec_ref = darshan_arena_alloc(&(overlap_runtime->arena), sizeof(*rec_ref));
+    if(!rec_ref)
+        return(NULL);
+
+    /* add a reference to this file record based on record id */
+    ret = darshan_add_record_ref(&(overlap_runtime->rec_id_hash), &rec_id,
+        sizeof(darshan_record_id), rec_ref, &(overlap_runtime->arena));
+    if(ret == 0)
+    {
+        darshan_arena_free(&(overlap_runtime->arena), rec_ref, sizeof(*rec_ref));
+        return(NULL);
+    }
+
+    /* register the actual file record with darshan-core so it is persisted
+     * in the log file
+     */
+    file_rec = darshan_core_register_record(
+        rec_id,
+        rec_name,
+        DARSHAN_OVERLAP_MOD,
+        sizeof(struct darshan_overlap_file),
+        &fs_info);
+
+    if(!file_rec)
+    {
+        darshan_delete_record_ref(&(overlap_runtime->rec_id_hash),
+            &rec_id, sizeof(darshan_record_id), &(overlap_runtime->arena));
+        darshan_arena_free(&(overlap_runtime->arena), rec_ref, sizeof(*rec_ref));
+        return(NULL);
+    }
+
+    /* registering this file record was successful, so initialize some fields */
+    file_rec->base_rec.id = rec_id;
+    file_rec->base_rec.rank = my_rank;
+    if(overlap_block_size > 0)
+        file_rec->counters[OVERLAP_BLOCK_SIZE] = overlap_block_size;
+    else if(fs_info.block_size > 0)
+        file_rec->counters[OVERLAP_BLOCK_SIZE] = fs_info.block_size;
+    else
+        file_rec->counters[OVERLAP_BLOCK_SIZE] = OVERLAP_DEF_BLOCK_SIZE;
+    rec_ref->file_rec = file_rec;
+    overlap_runtime->file_rec_count++;
+
+    return(rec_ref);
+}
+
+/* make room for at least 'count' runs in the run array of 'rec_ref' */
+static int overlap_reserve_runs(struct overlap_file_record_ref *rec_ref,
+    int count)
+{
+    struct overlap_run *runs;
+    int run_max = rec_ref->run_max ? rec_ref->run_max : 4;
+
+    if(count <= rec_ref->run_max)
+        return(0);
+
+    while(run_max < count)
+        run_max *= 2;
+    runs = realloc(rec_ref->runs, run_max * sizeof(*runs));
+    if(!runs)
+        return(-1);
+    if(__darshan_core_overhead_flag)
+        darshan_core_overhead_memory(DARSHAN_OVERLAP_MOD,
+            (ssize_t)(run_max - rec_ref->run_max) * sizeof(*runs));
+    rec_ref->runs = runs;
+    rec_ref->run_max = run_max;
+
+    return(0);
+}
+
+/* set 'sub' to the 'count' extents of 'run' starting with extent 'first' */
+static void overlap_sub_run(const struct overlap_run *run, int64_t first,
+    int64_t count, struct overlap_run *sub)
+{
+    sub->offset = run->offset + first * run->stride;
+    sub->length = run->length;
+    sub->stride = (count > 1) ? run->stride : run->length;
+    sub->count = count;
+
+    return;
+}
+
+/* find the extents of 'run' that overlap or touch [start, end): 'first'
+ * is set to the first such extent and 'last' to the last one ('last' is
+ * less than 'first' if there are none).  Returns the number of bytes of
+ * the run within [start, end).
+ */
+static int64_t overlap_run_intersect(const struct overlap_run *run,
+    int64_t start, int64_t end, int64_t *first, int64_t *last)
+{
+    int64_t ext_start, ext_end;
+    int64_t bytes = 0;
+    int64_t i;
+
+    if(start <= run->offset + run->length)
+        *first = 0;
+    else
+        *first = (start - run->offset - run->length + run->stride - 1) /
+            run->stride;
+
+    if(end < run->offset)
+        *last = -1;
+    else
+        *last = (end - run->offset) / run->stride;
+    if(*last > run->count - 1)
+        *last = run->count - 1;
+
+    for(i = *first; i <= *last; i++)
+    {
+        ext_start = run->offset + i * run->stride;
+        ext_end = ext_start + run->length;
+        if(ext_start < start)
+            ext_start = start;
+        if(ext_end > end)
+            ext_end = end;
+        if(ext_end > ext_start)
+            bytes += ext_end - ext_start;
+    }
+
+    return(bytes);
+}
+
+/* add the written extent [start, end) to the runs of 'rec_ref', counting
+ * bytes that were already written as rewritten
+ */
+static void overlap_insert_extent(struct overlap_file_record_ref *rec_ref,
+    int64_t start, int64_t end)
+{
+    struct overlap_run *runs;
+    struct overlap_run *last;
+    struct overlap_run new_runs[3];
+    int64_t first_ext, last_ext, tmp_ext;
+    int64_t merged_start, merged_end;
+    int64_t rewrite_bytes = 0;
+    int n = rec_ref->run_count;
+    int lo, hi, mid, i, j, k;
+    int new_count = 0;
+
+    /* at most one run is split into three */
+    if(overlap_reserve_runs(rec_ref, n + 2) < 0)
+        return;
+    runs = rec_ref->runs;
+
+    /* the common cases of appending to the last run: a contiguous write
+     * after a plain extent, or the next extent of a strided run
+     */
+    last = n ? &runs[n-1] : NULL;
+    if(last && start >= OVERLAP_RUN_END(last))
+    {
+        if(last->count == 1 && start == OVERLAP_RUN_END(last))
+        {
+            last->length += end - start;
+            last->stride = last->length;
+            return;
+        }
+        if(end - start == last->length &&
+           (last->count == 1 ||
+            start == last->offset + last->count * last->stride))
+        {
+            if(last->count == 1)
+                last->stride = start - last->offset;
+            last->count++;
+            return;
+        }
+    }
+
+    /* find the runs that overlap or touch the new extent: the first run
+     * ending at or after 'start', up to the last run starting at or
+     * before 'end'
+     */
+    lo = 0;
+    hi = n;
+    while(lo < hi)
+    {
+        mid = lo + (hi - lo) / 2;
+        if(OVERLAP_RUN_END(&runs[mid]) < start)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    i = lo;
+    for(j = i; j < n && runs[j].offset <= end; j++);
+
+    if(i == j)
+    {
+        /* nothing to merge with, insert a new extent */
+        memmove(&runs[i+1], &runs[i], (n - i) * sizeof(*runs));
+        runs[i].offset = start;
+        runs[i].length = end - start;
+        runs[i].stride = end - start;
+        runs[i].count = 1;
+        new_count = n + 1;
+    }
+    else
+    {
+        /* runs between the first and last one are covered completely */
+        rewrite_bytes = overlap_run_intersect(&runs[i], start, end,
+            &first_ext, &last_ext);
+        for(k = i + 1; k < j - 1; k++)
+            rewrite_bytes += runs[k].count * runs[k].length;
+        if(j > i + 1)
+            rewrite_bytes += overlap_run_intersect(&runs[j-1], start, end,
+                &tmp_ext, &last_ext);
+        rec_ref->file_rec->counters[OVERLAP_REWRITE_BYTES] += rewrite_bytes;
+
+        /* a rewrite within a single extent leaves the runs unchanged */
+        if(j == i + 1 && first_ext == last_ext &&
+           rewrite_bytes == end - start)
+            return;
+
+        /* merge the touched extents with the new extent, keeping the
+         * extents before and after them as separate runs
+         */
+        merged_start = start;
+        merged_end = end;
+        if(j > i + 1 || first_ext <= last_ext)
+        {
+            if(runs[i].offset + first_ext * runs[i].stride < merged_start)
+                merged_start = runs[i].offset + first_ext * runs[i].stride;
+            if(runs[j-1].offset + last_ext * runs[j-1].stride +
+               runs[j-1].length > merged_end)
+                merged_end = runs[j-1].offset + last_ext * runs[j-1].stride +
+                    runs[j-1].length;
+        }
+
+        k = 0;
+        if(first_ext > 0)
+            overlap_sub_run(&runs[i], 0, first_ext, &new_runs[k++]);
+        new_runs[k].offset = merged_start;
+        new_runs[k].length = merged_end - merged_start;
+        new_runs[k].stride = merged_end - merged_start;
+        new_runs[k].count = 1;
+        k++;
+        if(last_ext < runs[j-1].count - 1)
+            overlap_sub_run(&runs[j-1], last_ext + 1,
+                runs[j-1].count - last_ext - 1, &new_runs[k++]);
+
+        memmove(&runs[i+k], &runs[j], (n - j) * sizeof(*runs));
+        memcpy(&runs[i], new_runs, k * sizeof(*runs));
+        new_count = n - (j - i) + k;
+    }
+    rec_ref->run_count = new_count;
+
+    if(rec_ref->run_count > overlap_max_extents)
+        overlap_coarsen_runs(rec_ref,
+            (overlap_max_extents > 1) ? overlap_max_extents / 2 : 1);
+
+    return;
+}
+
+static int overlap_cost_compare(const void *a_p, const void *b_p)
+{
+    int64_t a = *(const int64_t *)a_p;
+    int64_t b = *(const int64_t *)b_p;
+
+    return((a > b) - (a < b));
+}
+
+/* number of unwritten bytes covered by a run */
+static int64_t overlap_run_gap_bytes(const struct overlap_run *run)
+{
+    return((run->count - 1) * (run->stride - run->length));
+}
+
+/* merge neighboring runs of 'rec_ref' into plain extents until only
+ * 'target' runs are left, preferring the merges that cover the fewest
+ * unwritten bytes
+ */
+static void overlap_coarsen_runs(struct overlap_file_record_ref *rec_ref,
+    int target)
+{
+    struct overlap_run *runs = rec_ref->runs;
+    struct overlap_run cur;
+    int64_t *costs, *sorted;
+    int64_t threshold;
+    int64_t cur_bytes, run_end;
+    int n = rec_ref->run_count;
+    int merges = n - target;
+    int merged = 0;
+    int out = 0;
+    int k;
+
+    if(merges <= 0)
+        return;
+
+    costs = malloc(2 * (n - 1) * sizeof(*costs));
+    if(!costs)
+        return;
+    sorted = &costs[n-1];
+
+    /* the cost of merging two runs is the gap between them, plus the gaps
+     * within them if they are strided
+     */
+    for(k = 0; k < n - 1; k++)
+        costs[k] = runs[k+1].offset - OVERLAP_RUN_END(&runs[k]) +
+            overlap_run_gap_bytes(&runs[k]) +
+            overlap_run_gap_bytes(&runs[k+1]);
+    memcpy(sorted, costs, (n - 1) * sizeof(*costs));
+    qsort(sorted, n - 1, sizeof(*sorted), overlap_cost_compare);
+    threshold = sorted[merges-1];
+
+    cur = runs[0];
+    cur_bytes = cur.count * cur.length;
+    for(k = 0; k < n - 1; k++)
+    {
+        if(merges > 0 && costs[k] <= threshold)
+        {
+            run_end = OVERLAP_RUN_END(&runs[k+1]);
+            cur.length = run_end - cur.offset;
+            cur.stride = cur.length;
+            cur.count = 1;
+            cur_bytes += runs[k+1].count * runs[k+1].length;
+            merged = 1;
+            merges--;
+        }
+        else
+        {
+            if(merged)
+                rec_ref->file_rec->counters[OVERLAP_COARSENED_BYTES] +=
+                    cur.length - cur_bytes;
+            runs[out++] = cur;
+            cur = runs[k+1];
+            cur_bytes = cur.count * cur.length;
+            merged = 0;
+        }
+    }
+    if(merged)
+        rec_ref->file_rec->counters[OVERLAP_COARSENED_BYTES] +=
+            cur.length - cur_bytes;
+    runs[out++] = cur;
+    rec_ref->run_count = out;
+
+    free(costs);
+    return;
+}
+
+static void overlap_stream_init(struct overlap_stream *stream,
+    const struct overlap_run *runs, int run_count, int64_t block_size)
+{
+    stream->runs = runs;
+    stream->run_count = run_count;
+    stream->run = 0;
+    stream->ext = 0;
+    stream->block_size = block_size;
+
+    return;
+}
+
+/* get the next extent (or block range) of 'stream' as [start, end).
+ * Returns 0 once the stream is exhausted.
+ */
+static int overlap_stream_next(struct overlap_stream *stream,
+    int64_t *start, int64_t *end)
+{
+    const struct overlap_run *run;
+    int64_t bs = stream->block_size;
+    int64_t ext_start, ext_end;
+
+    if(stream->run >= stream->run_count)
+        return(0);
+
+    run = &stream->runs[stream->run];
+    ext_start = run->offset + stream->ext * run->stride;
+    ext_end = ext_start + run->length;
+    if(++stream->ext == run->count)
+    {
+        stream->run++;
+        stream->ext = 0;
+    }
+
+    if(!bs)
+    {
+        *start = ext_start;
+        *end = ext_end;
+        return(1);
+    }
+
+    /* combine the following extents that touch the same or adjacent blocks */
+    *start = ext_start / bs;
+    *end = (ext_end - 1) / bs + 1;
+    while(stream->run < stream->run_count)
+    {
+        run = &stream->runs[stream->run];
+        ext_start = run->offset + stream->ext * run->stride;
+        if(ext_start / bs > *end)
+            break;
+
+        /* if the gaps within a strided run are smaller than a block, its
+         * remaining extents touch a contiguous range of blocks
+         */
+        if(run->stride - run->length < bs)
+            stream->ext = run->count - 1;
+        ext_end = run->offset + stream->ext * run->stride + run->length;
+        if((ext_end - 1) / bs + 1 > *end)
+            *end = (ext_end - 1) / bs + 1;
+        if(++stream->ext == run->count)
+        {
+            stream->run++;
+            stream->ext = 0;
+        }
+    }
+
+    return(1);
+}
+
+/* events are ordered by position, with end events first */
+static int overlap_event_before(const struct overlap_event *a,
+    const struct overlap_event *b)
+{
+    if(a->pos != b->pos)
+        return(a->pos < b->pos);
+    return(a->stream < b->stream);
+}
+
+static void overlap_heap_push(struct overlap_event *heap, int *heap_size,
+    struct overlap_event ev)
+{
+    int i = (*heap_size)++;
+
+    while(i > 0 && overlap_event_before(&ev, &heap[(i-1)/2]))
+    {
+        heap[i] = heap[(i-1)/2];
+        i = (i-1)/2;
+    }
+    heap[i] = ev;
+
+    return;
+}
+
+static struct overlap_event overlap_heap_pop(struct overlap_event *heap,
+    int *heap_size)
+{
+    struct overlap_event top = heap[0];
+    struct overlap_event ev = heap[--(*heap_size)];
+    int i = 0, child;
+
+    while((child = 2*i + 1) < *heap_size)
+    {
+        if(child + 1 < *heap_size &&
+           overlap_event_before(&heap[child+1], &heap[child]))
+            child++;
+        if(!overlap_event_before(&heap[child], &ev))
+            break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    if(*heap_size > 0)
+        heap[i] = ev;
+
+    return(top);
+}
+
+static void overlap_byte_span(struct overlap_sweep_stats *stats,
+    int64_t start, int64_t end, int depth)
+{
+    int64_t first, last;
+
+    stats->unique_bytes += end - start;
+    if(depth < 2)
+        return;
+
+    /* note which blocks hold bytes written by several ranks */
+    stats->shared_bytes += end - start;
+    first = start / stats->block_size;
+    last = (end - 1) / stats->block_size;
+    if(first <= stats->last_overlap_block)
+        first = stats->last_overlap_block + 1;
+    if(last >= first)
+    {
+        stats->overlap_blocks += last - first + 1;
+        stats->last_overlap_block = last;
+    }
+
+    return;
+}
+
+static void overlap_block_span(struct overlap_sweep_stats *stats,
+    int64_t start, int64_t end, int depth)
+{
+    int bucket;
+
+    stats->blocks += end - start;
+    stats->writer_sum += depth * (end - start);
+    if(depth > stats->max_writers)
+        stats->max_writers = depth;
+    if(depth > 1)
+        stats->shared_blocks += end - start;
+
+    /* buckets of 1, 2, 3-4, 5-8, 9-16 and 17+ writers */
+    for(bucket = 0; bucket < 5 && depth > (1 << bucket); bucket++);
+    stats->writer_hist[bucket] += end - start;
+
+    return;
+}
+
+/* sweep over the extents of all streams in offset order, calling 'span_fn'
+ * for each range covered by the same number ('depth') of streams.  Since
+ * the extents of a stream are disjoint, the depth is the number of streams
+ * (ranks) that wrote to the range.
+ */
+static int overlap_sweep(struct overlap_stream *streams, int nstreams,
+    void (*span_fn)(struct overlap_sweep_stats *, int64_t, int64_t, int),
+    struct overlap_sweep_stats *stats)
+{
+    struct overlap_event *heap;
+    struct overlap_event ev;
+    int heap_size = 0;
+    int64_t pos = 0;
+    int depth = 0;
+    int i;
+
+    /* each stream has at most one pending start and one pending end */
+    heap = malloc(2 * nstreams * sizeof(*heap));
+    if(!heap)
+        return(-1);
+
+    for(i = 0; i < nstreams; i++)
+    {
+        if(overlap_stream_next(&streams[i], &ev.pos, &ev.end))
+        {
+            ev.stream = i;
+            overlap_heap_push(heap, &heap_size, ev);
+        }
+    }
+
+    while(heap_size > 0)
+    {
+        ev = overlap_heap_pop(heap, &heap_size);
+        if(depth > 0 && ev.pos > pos)
+            span_fn(stats, pos, ev.pos, depth);
+        pos = ev.pos;
+
+        if(ev.stream < 0)
+        {
+            depth--;
+            continue;
+        }
+
+        depth++;
+        i = ev.stream;
+        ev.pos = ev.end;
+        ev.stream = -1;
+        overlap_heap_push(heap, &heap_size, ev);
+        if(overlap_stream_next(&streams[i], &ev.pos, &ev.end))
+        {
+            ev.stream = i;
+            overlap_heap_push(heap, &heap_size, ev);
+        }
+    }
+
+    free(heap);
+    return(0);
+}
+
+/* compute the byte and block counters of 'file_rec' from the extents
+ * written by each rank, given as one stream per rank
+ */
+static void overlap_compute_counters(struct darshan_overlap_file *file_rec,
+    struct overlap_stream *streams, int nstreams)
+{
+    struct overlap_sweep_stats stats;
+    int64_t block_size = file_rec->counters[OVERLAP_BLOCK_SIZE];
+    int writers = 0;
+    int ret;
+    int i;
+
+    memset(&stats, 0, sizeof(stats));
+    stats.block_size = block_size;
+    stats.last_overlap_block = -1;
+
+    for(i = 0; i < nstreams; i++)
+    {
+        if(streams[i].run_count > 0)
+            writers++;
+        overlap_stream_init(&streams[i], streams[i].runs,
+            streams[i].run_count, 0);
+    }
+    ret = overlap_sweep(streams, nstreams, overlap_byte_span, &stats);
+    if(ret == 0)
+    {
+        for(i = 0; i < nstreams; i++)
+            overlap_stream_init(&streams[i], streams[i].runs,
+                streams[i].run_count, block_size);
+        ret = overlap_sweep(streams, nstreams, overlap_block_span, &stats);
+    }
+    if(ret < 0)
+    {
+        /* set invalid values if the counters could not be computed */
+        for(i = OVERLAP_UNIQUE_BYTES; i <= OVERLAP_BLOCK_WRITERS_17_PLUS; i++)
+            if(i != OVERLAP_REWRITE_BYTES && i != OVERLAP_BLOCK_SIZE)
+                file_rec->counters[i] = -1;
+        file_rec->fcounters[OVERLAP_F_MEAN_BLOCK_WRITERS] = -1;
+        return;
+    }
+
+    file_rec->counters[OVERLAP_UNIQUE_BYTES] = stats.unique_bytes;
+    file_rec->counters[OVERLAP_SHARED_BYTES] = stats.shared_bytes;
+    file_rec->counters[OVERLAP_WRITER_RANKS] = writers;
+    file_rec->counters[OVERLAP_BLOCKS] = stats.blocks;
+    file_rec->counters[OVERLAP_SHARED_BLOCKS] = stats.shared_blocks;
+    file_rec->counters[OVERLAP_FALSE_SHARED_BLOCKS] =
+        stats.shared_blocks - stats.overlap_blocks;
+    file_rec->counters[OVERLAP_MAX_BLOCK_WRITERS] = stats.max_writers;
+    for(i = OVERLAP_BLOCK_WRITERS_1; i <= OVERLAP_BLOCK_WRITERS_17_PLUS; i++)
+        file_rec->counters[i] = stats.writer_hist[i - OVERLAP_BLOCK_WRITERS_1];
+    if(stats.blocks > 0)
+        file_rec->fcounters[OVERLAP_F_MEAN_BLOCK_WRITERS] =
+            (double)stats.writer_sum / stats.blocks;
+
+    return;
+}
+
+static void overlap_free_record_runs(void *rec_ref_p, void *user_ptr)
+{
+    struct overlap_file_record_ref *rec_ref = rec_ref_p;
+
+    if(__darshan_core_overhead_flag)
+        darshan_core_overhead_memory(DARSHAN_OVERLAP_MOD,
+            -(ssize_t)(rec_ref->run_max * sizeof(*rec_ref->runs)));
+    free(rec_ref->runs);
+    rec_ref->runs = NULL;
+    rec_ref->run_count = rec_ref->run_max = 0;
+
+    return;
+}
+
+#ifdef HAVE_MPI
+/* mark the cross-rank counters of a shared record as unknown */
+static void overlap_invalidate_shared_counters(
+    struct darshan_overlap_file *file_rec)
+{
+    int i;
+
+    for(i = OVERLAP_UNIQUE_BYTES; i <= OVERLAP_BLOCK_WRITERS_17_PLUS; i++)
+        if(i != OVERLAP_REWRITE_BYTES && i != OVERLAP_BLOCK_SIZE)
+            file_rec->counters[i] = -1;
+    file_rec->fcounters[OVERLAP_F_MEAN_BLOCK_WRITERS] = -1;
+
+    return;
+}
+
+static void overlap_record_reduction_op(void* inrec_v, void* inoutrec_v,
+    int *len, MPI_Datatype *datatype)
+{
+    struct darshan_overlap_file *inrec = inrec_v;
+    struct darshan_overlap_file *inoutrec = inoutrec_v;
+    int i;
+
+    /* the remaining counters are computed from the extents of all ranks */
+    for(i=0; i<*len; i++)
+    {
+        /* sum */
+        inoutrec->counters[OVERLAP_WRITES] += inrec->counters[OVERLAP_WRITES];
+        inoutrec->counters[OVERLAP_BYTES_WRITTEN] +=
+            inrec->counters[OVERLAP_BYTES_WRITTEN];
+        inoutrec->counters[OVERLAP_REWRITE_BYTES] +=
+            inrec->counters[OVERLAP_REWRITE_BYTES];
+        inoutrec->counters[OVERLAP_COARSENED_BYTES] +=
+            inrec->counters[OVERLAP_COARSENED_BYTES];
+
+        /* max */
+        if(inrec->counters[OVERLAP_BLOCK_SIZE] >
+           inoutrec->counters[OVERLAP_BLOCK_SIZE])
+            inoutrec->counters[OVERLAP_BLOCK_SIZE] =
+                inrec->counters[OVERLAP_BLOCK_SIZE];
+
+        inoutrec->base_rec.rank = -1;
+
+        inrec++;
+        inoutrec++;
+    }
+
+    return;
+}
+
+/* gather the extents of each shared record to rank 0, which computes the
+ * cross-rank counters of the reduced records in 'outrec_array'.  Records
+ * are gathered in batches of at most OVERLAP_GATHER_MAX_RUNS runs.
+ */
+static void overlap_shared_record_extents(MPI_Comm mod_comm,
+    struct darshan_overlap_file *inrec_array,
+    struct darshan_overlap_file *outrec_array, int shared_rec_count)
+{
+    struct overlap_file_record_ref *rec_ref;
+    struct overlap_run *send_buf = NULL;
+    struct overlap_run *recv_buf = NULL;
+    struct overlap_stream *streams = NULL;
+    int *run_counts;
+    int *all_counts = NULL;
+    int *batches;
+    int *recv_counts = NULL;
+    int *displs = NULL;
+    int *cursors = NULL;
+    int64_t total, batch_runs = 0, max_batch_runs = 0;
+    int send_count;
+    int nprocs;
+    int nbatches = 0;
+    int batch, first = 0, last;
+    int ok, all_ok;
+    MPI_Datatype run_type;
+    int i, p;
+
+    PMPI_Comm_size(mod_comm, &nprocs);
+
+    run_counts = malloc(2 * shared_rec_count * sizeof(*run_counts));
+    if(my_rank == 0)
+        all_counts = malloc((size_t)nprocs * shared_rec_count *
+            sizeof(*all_counts));
+    ok = (run_counts && (my_rank != 0 || all_counts));
+
+    /* no rank can skip the collectives below on its own, so if any rank
+     * is out of memory, all of them give up on the cross-rank counters
+     */
+    PMPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_MIN, mod_comm);
+    if(!all_ok)
+    {
+        if(my_rank == 0)
+        {
+            for(i = 0; i < shared_rec_count; i++)
+                overlap_invalidate_shared_counters(&outrec_array[i]);
+        }
+        free(all_counts);
+        free(run_counts);
+        return;
+    }
+
+    batches = &run_counts[shared_rec_count];
+    for(i = 0; i < shared_rec_count; i++)
+    {
+        rec_ref = darshan_lookup_record_ref(overlap_runtime->rec_id_hash,
+            &inrec_array[i].base_rec.id, sizeof(darshan_record_id));
+        assert(rec_ref);
+        run_counts[i] = rec_ref->run_count;
+    }
+
+    PMPI_Gather(run_counts, shared_rec_count, MPI_INT, all_counts,
+        shared_rec_count, MPI_INT, 0, mod_comm);
+
+    /* rank 0 assigns records to batches, skipping records too large to
+     * gather (-1)
+     */
+    if(my_rank == 0)
+    {
+        for(i = 0; i < shared_rec_count; i++)
+        {
+            total = 0;
+            for(p = 0; p < nprocs; p++)
+                total += all_counts[p * shared_rec_count + i];
+            if(total > OVERLAP_GATHER_MAX_RUNS)
+            {
+                batches[i] = -1;
+                continue;
+            }
+            if(nbatches == 0 || batch_runs + total > OVERLAP_GATHER_MAX_RUNS)
+            {
+                nbatches++;
+                batch_runs = 0;
+            }
+            batches[i] = nbatches - 1;
+            batch_runs += total;
+            if(batch_runs > max_batch_runs)
+                max_batch_runs = batch_runs;
+        }
+
+        recv_buf = malloc((max_batch_runs ? max_batch_runs : 1) *
+            sizeof(*recv_buf));
+        streams = malloc(nprocs * sizeof(*streams));
+        recv_counts = malloc(3 * nprocs * sizeof(*recv_counts));
+        if(!recv_buf || !streams || !recv_counts)
+        {
+            for(i = 0; i < shared_rec_count; i++)
+                batches[i] = -1;
+        }
+        else
+        {
+            displs = &recv_counts[nprocs];
+            cursors = &recv_counts[2 * nprocs];
+        }
+    }
+    PMPI_Bcast(batches, shared_rec_count, MPI_INT, 0, mod_comm);
+
+    PMPI_Type_contiguous(sizeof(struct overlap_run), MPI_BYTE, &run_type);
+    PMPI_Type_commit(&run_type);
+
+    for(batch = 0; ; batch++)
+    {
+        /* find the records of this batch, which follow those of the
+         * previous batch
+         */
+        while(first < shared_rec_count && batches[first] < 0)
+            first++;
+        if(first == shared_rec_count)
+            break;
+        send_count = 0;
+        for(last = first; last < shared_rec_count && batches[last] <= batch;
+            last++)
+        {
+            if(batches[last] == batch)
+                send_count += run_counts[last];
+        }
+
+        send_buf = malloc((send_count ? send_count : 1) * sizeof(*send_buf));
+        assert(send_buf);
+        send_count = 0;
+        for(i = first; i < last; i++)
+        {
+            if(batches[i] != batch)
+                continue;
+            rec_ref = darshan_lookup_record_ref(overlap_runtime->rec_id_hash,
+                &inrec_array[i].base_rec.id, sizeof(darshan_record_id));
+            memcpy(&send_buf[send_count], rec_ref->runs,
+                run_counts[i] * sizeof(*send_buf));
+            send_count += run_counts[i];
+        }
+
+        if(my_rank == 0)
+        {
+            for(p = 0; p < nprocs; p++)
+            {
+                recv_counts[p] = 0;
+                for(i = first; i < last; i++)
+                    if(batches[i] == batch)
+                        recv_counts[p] += all_counts[p * shared_rec_count + i];
+                displs[p] = p ? displs[p-1] + recv_counts[p-1] : 0;
+                cursors[p] = displs[p];
+            }
+        }
+
+        PMPI_Gatherv(send_buf, send_count, run_type, recv_buf, recv_counts,
+            displs, run_type, 0, mod_comm);
+        free(send_buf);
+
+        if(my_rank == 0)
+        {
+            for(i = first; i < last; i++)
+            {
+                if(batches[i] != batch)
+                    continue;
+                for(p = 0; p < nprocs; p++)
+                {
+                    streams[p].runs = &recv_buf[cursors[p]];
+                    streams[p].run_count = all_counts[p * shared_rec_count + i];
+                    cursors[p] += streams[p].run_count;
+                }
+                overlap_compute_counters(&outrec_array[i], streams, nprocs);
+            }
+        }
+        first = last;
+    }
+
+    /* records that could not be gathered get invalid cross-rank counters */
+    if(my_rank == 0)
+    {
+        for(i = 0; i < shared_rec_count; i++)
+        {
+            if(batches[i] < 0)
+                overlap_invalidate_shared_counters(&outrec_array[i]);
+        }
+    }
+
+    PMPI_Type_free(&run_type);
+    free(recv_counts);
+    free(streams);
+    free(recv_buf);
+    free(all_counts);
+    free(run_counts);
+    return;
+}
+#endif
+
+/********************************************************************************
+ *     functions exported by this module for coordinating with darshan-core     *
+ ********************************************************************************/
+
+#ifdef HAVE_MPI
+static void overlap_mpi_redux(
+    void *overlap_buf,
+    MPI_Comm mod_comm,
+    darshan_record_id *shared_recs,
+    int shared_rec_count)
+{
+    int overlap_rec_count;
+    struct overlap_file_record_ref *rec_ref;
+    struct darshan_overlap_file *overlap_rec_buf =
+        (struct darshan_overlap_file *)overlap_buf;
+    struct darshan_overlap_file *red_send_buf = NULL;
+    struct darshan_overlap_file *red_recv_buf = NULL;
+    MPI_Datatype red_type;
+    MPI_Op red_op;
+    int i;
+
+    OVERLAP_LOCK();
+    assert(overlap_runtime);
+
+    overlap_runtime->frozen = 1;
+    overlap_rec_count = overlap_runtime->file_rec_count;
+
+    /* necessary initialization of shared records */
+    for(i = 0; i < shared_rec_count; i++)
+    {
+        rec_ref = darshan_lookup_record_ref(overlap_runtime->rec_id_hash,
+            &shared_recs[i], sizeof(darshan_record_id));
+        assert(rec_ref);
+
+        rec_ref->file_rec->base_rec.rank = -1;
+    }
+
+    /* sort the array of records so we get all of the shared records
+     * (marked by rank -1) in a contiguous portion at end of the array
+     */
+    darshan_record_sort(overlap_rec_buf, overlap_rec_count,
+        sizeof(struct darshan_overlap_file));
+
+    /* make send_buf point to the shared files at the end of sorted array */
+    red_send_buf = &(overlap_rec_buf[overlap_rec_count-shared_rec_count]);
+
+    /* allocate memory for the reduction output on rank 0 */
+    if(my_rank == 0)
+    {
+        red_recv_buf = malloc(shared_rec_count * sizeof(struct darshan_overlap_file));
+        if(!red_recv_buf)
+        {
+            OVERLAP_UNLOCK();
+            return;
+        }
+    }
+
+    /* construct a datatype for an OVERLAP file record.  This is serving no
+     * purpose except to make sure we can do a reduction on proper boundaries
+     */
+    PMPI_Type_contiguous(sizeof(struct darshan_overlap_file),
+        MPI_BYTE, &red_type);
+    PMPI_Type_commit(&red_type);
+
+    /* register an OVERLAP file record reduction operator */
+    PMPI_Op_create(overlap_record_reduction_op, 1, &red_op);
+
+    /* reduce the summed counters of shared OVERLAP file records */
+    PMPI_Reduce(red_send_buf, red_recv_buf,
+        shared_rec_count, red_type, red_op, 0, mod_comm);
+
+    /* merge the extents of all ranks for the remaining counters */
+    overlap_shared_record_extents(mod_comm, red_send_buf, red_recv_buf,
+        shared_rec_count);
+
+    /* update module state to account for shared file reduction */
+    if(my_rank == 0)
+    {
+        /* overwrite local shared records with globally reduced records */
+        int tmp_ndx = overlap_rec_count - shared_rec_count;
+        memcpy(&(overlap_rec_buf[tmp_ndx]), red_recv_buf,
+            shared_rec_count * sizeof(struct darshan_overlap_file));
+        free(red_recv_buf);
+    }
+    else
+    {
+        /* drop shared records on non-zero ranks */
+        overlap_runtime->file_rec_count -= shared_rec_count;
+    }
+
+    PMPI_Type_free(&red_type);
+    PMPI_Op_free(&red_op);
+
+    OVERLAP_UNLOCK();
+    return;
+}
+#endif
+
+static void overlap_output(
+    void **overlap_buf,
+    int *overlap_buf_sz)
+{
+    struct darshan_overlap_file *overlap_rec_buf =
+        (struct darshan_overlap_file *)*overlap_buf;
+    struct overlap_file_record_ref *rec_ref;
+    struct overlap_stream stream;
+    int out = 0;
+    int i;
+
+    OVERLAP_LOCK();
+    assert(overlap_runtime);
+
+    /* compute the counters of records only written by this rank; shared
+     * records were completed by the reduction.  Records of files that were
+     * opened but never written are dropped.
+     */
+    for(i = 0; i < overlap_runtime->file_rec_count; i++)
+    {
+        if(overlap_rec_buf[i].counters[OVERLAP_WRITES] == 0)
+            continue;
+        if(overlap_rec_buf[i].base_rec.rank != -1)
+        {
+            rec_ref = darshan_lookup_record_ref(overlap_runtime->rec_id_hash,
+                &overlap_rec_buf[i].base_rec.id, sizeof(darshan_record_id));
+            assert(rec_ref);
+            overlap_stream_init(&stream, rec_ref->runs, rec_ref->run_count, 0);
+            overlap_compute_counters(&overlap_rec_buf[i], &stream, 1);
+        }
+        if(out != i)
+            overlap_rec_buf[out] = overlap_rec_buf[i];
+        out++;
+    }
+    overlap_runtime->file_rec_count = out;
+
+    *overlap_buf_sz =
+        overlap_runtime->file_rec_count * sizeof(struct darshan_overlap_file);
+
+    overlap_runtime->frozen = 1;
+
+    OVERLAP_UNLOCK();
+    return;
+}
+
+static void overlap_cleanup()
+{
+    OVERLAP_LOCK();
+    assert(overlap_runtime);
+
+    /* cleanup internal structures used for instrumenting */
+    darshan_iter_record_refs(overlap_runtime->rec_id_hash,
+        &overlap_free_record_runs, NULL);
+    darshan_clear_record_refs(&(overlap_runtime->rec_id_hash), 1,
+        &(overlap_runtime->arena));
+    darshan_arena_destroy(&(overlap_runtime->arena));
+
+    __atomic_store_n(&overlap_active, 0, __ATOMIC_RELEASE);
+    free(overlap_runtime);
+    overlap_runtime = NULL;
+
+    OVERLAP_UNLOCK();
+    return;
+}
+
+/*
+ * Local variables:
+ *  c-indent-level: 4
+ *  c-basic-offset: 4
+ * End:
+ *
+ * vim: ts=8 sts=4 sw=4 expandtab
+ */
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2026 University of Chicago.
+ * See COPYRIGHT notice in top-level directory.
+ *
+ */
+
+#ifndef __DARSHAN_OVERLAP_H
+#define __DARSHAN_OVERLAP_H
+
+#include <stdint.h>
+
+#ifdef DARSHAN_OVERLAP
+
+/* overlap_set_params()
+ *
+ * sets the block size used for block counters (0 to use the block size of
+ * each file's file system) and the maximum number of extents tracked for
+ * each file before nearby extents are coarsened together
+ */
+void overlap_set_params(int64_t block_size, int max_extents);
+
+/* overlap_posix_runtime_initialize()
+ *
+ * OVERLAP function exposed to POSIX module for initializing the OVERLAP
+ * runtime.
+ */
+void overlap_posix_runtime_initialize(void);
+
+/* overlap_file_open()
+ *
+ * starts tracking file record 'rec_id' when it is opened through POSIX or
+ * MPI-IO, so that ranks that open a shared file without writing to it
+ * still take part in the reduction of its extents
+ */
+void overlap_file_open(darshan_record_id rec_id);
+
+/* overlap_posix_write()
+ *
+ * records a POSIX write of 'length' bytes at offset 'offset' to file
+ * record 'rec_id'
+ */
+void overlap_posix_write(darshan_record_id rec_id, int64_t offset,
+    int64_t length);
+
+#else
+
+/* as with the heatmap module, stubs are provided when the OVERLAP module is
+ * not built so that callers do not need preprocessor guards
+ */
+
+#define overlap_set_params(block_size, max_extents) do {} while(0)
+#define overlap_posix_runtime_initialize() do {} while(0)
+#define overlap_file_open(rec_id) do {} while(0)
+#define overlap_posix_write(rec_id, offset, length) do {} while(0)
+
+#endif
+
+#endif /* __DARSHAN_OVERLAP_H */
@@ -106,6 +106,17 @@ static int my_rank = -1;
 
 #define PNETCDF_LOCK() pthread_mutex_lock(&pnetcdf_runtime_mutex)
 #define PNETCDF_UNLOCK() pthread_mutex_unlock(&pnetcdf_runtime_mutex)
+/* variants used by the instrumentation wrappers, which account overhead to
+ * the PNETCDF_FILE or PNETCDF_VAR module respectively
+ */
+#define PNETCDF_FILE_LOCK() \
+    DARSHAN_MOD_LOCK(DARSHAN_PNETCDF_FILE_MOD, &pnetcdf_runtime_mutex)
+#define PNETCDF_FILE_UNLOCK() \
+    DARSHAN_MOD_UNLOCK(DARSHAN_PNETCDF_FILE_MOD, &pnetcdf_runtime_mutex)
+#define PNETCDF_VAR_LOCK() \
+    DARSHAN_MOD_LOCK(DARSHAN_PNETCDF_VAR_MOD, &pnetcdf_runtime_mutex)
+#define PNETCDF_VAR_UNLOCK() \
+    DARSHAN_MOD_UNLOCK(DARSHAN_PNETCDF_VAR_MOD, &pnetcdf_runtime_mutex)
 
 #define PNETCDF_WTIME() \
     __darshan_disabled ? 0 : darshan_core_wtime();
@@ -117,17 +128,17 @@ static int my_rank = -1;
  */
 #define PNETCDF_FILE_PRE_RECORD() do { \
     if(!__darshan_disabled) { \
-        PNETCDF_LOCK(); \
+        PNETCDF_FILE_LOCK(); \
         if(!pnetcdf_file_runtime && !pnetcdf_file_runtime_init_attempted) \
             pnetcdf_file_runtime_initialize(); \
         if(pnetcdf_file_runtime && !pnetcdf_file_runtime->frozen) break; \
-        PNETCDF_UNLOCK(); \
+        PNETCDF_FILE_UNLOCK(); \
     } \
     return(ret); \
 } while(0)
 
 #define PNETCDF_FILE_POST_RECORD() do { \
-    PNETCDF_UNLOCK(); \
+    PNETCDF_FILE_UNLOCK(); \
 } while(0)
 
 #define DARSHAN_PNETCDF_VAR_DELIM ":"
@@ -139,17 +150,17 @@ static int my_rank = -1;
  */
 #define PNETCDF_VAR_PRE_RECORD() do { \
     if(!__darshan_disabled) { \
-        PNETCDF_LOCK(); \
+        PNETCDF_VAR_LOCK(); \
         if(!pnetcdf_var_runtime && !pnetcdf_var_runtime_init_attempted) \
             pnetcdf_var_runtime_initialize(); \
         if(pnetcdf_var_runtime && !pnetcdf_var_runtime->frozen) break; \
-        PNETCDF_UNLOCK(); \
+        PNETCDF_VAR_UNLOCK(); \
     } \
     return(ret); \
 } while(0)
 
 #define PNETCDF_VAR_POST_RECORD() do { \
-    PNETCDF_UNLOCK(); \
+    PNETCDF_VAR_UNLOCK(); \
 } while(0)
 
 /*********************************************************
@@ -250,7 +261,7 @@ static struct pnetcdf_file_record_ref *pnetcdf_file_track_new_record(
 
     /* add a reference to this file record based on record id */
     ret = darshan_add_record_ref(&(pnetcdf_file_runtime->rec_id_hash), &rec_id,
-        sizeof(darshan_record_id), rec_ref);
+        sizeof(darshan_record_id), rec_ref, NULL);
     if(ret == 0)
     {
         free(rec_ref);
@@ -270,7 +281,7 @@ static struct pnetcdf_file_record_ref *pnetcdf_file_track_new_record(
     if(!file_rec)
     {
         darshan_delete_record_ref(&(pnetcdf_file_runtime->rec_id_hash),
-            &rec_id, sizeof(darshan_record_id));
+            &rec_id, sizeof(darshan_record_id), NULL);
         free(rec_ref);
         return(NULL);
     }
@@ -297,7 +308,7 @@ static struct pnetcdf_var_record_ref *pnetcdf_var_track_new_record(
 
     /* add a reference to this variable record based on record id */
     ret = darshan_add_record_ref(&(pnetcdf_var_runtime->rec_id_hash), &rec_id,
-        sizeof(darshan_record_id), rec_ref);
+        sizeof(darshan_record_id), rec_ref, NULL);
     if(ret == 0)
     {
         free(rec_ref);
@@ -317,7 +328,7 @@ static struct pnetcdf_var_record_ref *pnetcdf_var_track_new_record(
     if(!var_rec)
     {
         darshan_delete_record_ref(&(pnetcdf_var_runtime->rec_id_hash),
-            &rec_id, sizeof(darshan_record_id));
+            &rec_id, sizeof(darshan_record_id), NULL);
         free(rec_ref);
         return(NULL);
     }
@@ -913,8 +924,8 @@ static void pnetcdf_file_cleanup(void)
     assert(pnetcdf_file_runtime);
 
     /* cleanup internal structures used for instrumenting */
-    darshan_clear_record_refs(&(pnetcdf_file_runtime->ncid_hash), 0);
-    darshan_clear_record_refs(&(pnetcdf_file_runtime->rec_id_hash), 1);
+    darshan_clear_record_refs(&(pnetcdf_file_runtime->ncid_hash), 0, NULL);
+    darshan_clear_record_refs(&(pnetcdf_file_runtime->rec_id_hash), 1, NULL);
 
     free(pnetcdf_file_runtime);
     pnetcdf_file_runtime = NULL;
@@ -936,8 +947,8 @@ static void pnetcdf_var_cleanup(void)
         &pnetcdf_var_finalize_records, NULL);
 
     /* cleanup internal structures used for instrumenting */
-    darshan_clear_record_refs(&(pnetcdf_var_runtime->varid_hash), 0);
-    darshan_clear_record_refs(&(pnetcdf_var_runtime->rec_id_hash), 1);
+    darshan_clear_record_refs(&(pnetcdf_var_runtime->varid_hash), 0, NULL);
+    darshan_clear_record_refs(&(pnetcdf_var_runtime->rec_id_hash), 1, NULL);
 
     free(pnetcdf_var_runtime);
     pnetcdf_var_runtime = NULL;
@@ -35,6 +35,7 @@
 #include "darshan-dynamic.h"
 #include "darshan-dxt.h"
 #include "darshan-heatmap.h"
+#include "darshan-overlap.h"
 #include "darshan-ldms.h"
 
 #ifndef HAVE_OFF64_T
@@ -163,6 +164,7 @@ struct posix_runtime
     int file_rec_count;
     darshan_record_id heatmap_id;
     int frozen; /* flag to indicate that the counters should no longer be modified */
+    struct darshan_arena arena; /* record references and handle mappings */
 };
 
 /* struct to track information about aio operations in flight */
@@ -207,8 +209,8 @@ static int posix_runtime_init_attempted = 0;
 static int my_rank = -1;
 static int darshan_mem_alignment = 1;
 
-#define POSIX_LOCK() pthread_mutex_lock(&posix_runtime_mutex)
-#define POSIX_UNLOCK() pthread_mutex_unlock(&posix_runtime_mutex)
+#define POSIX_LOCK() DARSHAN_MOD_LOCK(DARSHAN_POSIX_MOD, &posix_runtime_mutex)
+#define POSIX_UNLOCK() DARSHAN_MOD_UNLOCK(DARSHAN_POSIX_MOD, &posix_runtime_mutex)
 
 #define POSIX_WTIME() \
     __darshan_disabled ? 0 : darshan_core_wtime();
@@ -248,6 +250,8 @@ static int darshan_mem_alignment = 1;
         break; \
     } \
     _POSIX_RECORD_OPEN(__ret, __rec_ref, __mode, __tm1, __tm2, 1, -1); \
+    /* OVERLAP to track the file even if this rank never writes to it */ \
+    overlap_file_open(__rec_id); \
     if(__newpath != __path) free(__newpath); \
     /* LDMS to publish realtime open tracing information to daemon*/ \
     if(dC.ldms_lib)\
@@ -275,7 +279,8 @@ static int darshan_mem_alignment = 1;
     __rec_ref->file_rec->fcounters[POSIX_F_OPEN_END_TIMESTAMP] = __tm2; \
     DARSHAN_TIMER_INC_NO_OVERLAP(__rec_ref->file_rec->fcounters[POSIX_F_META_TIME], \
         __tm1, __tm2, __rec_ref->last_meta_end); \
-    darshan_add_record_ref(&(posix_runtime->fd_hash), &__ret, sizeof(int), __rec_ref); \
+    darshan_add_record_ref(&(posix_runtime->fd_hash), &__ret, sizeof(int), __rec_ref, \
+        &(posix_runtime->arena)); \
 } while(0)
 
 #define POSIX_RECORD_READ(__ret, __fd, __pread_flag, __pread_offset, __aligned, __tm1, __tm2) do { \
@@ -313,13 +318,13 @@ static int darshan_mem_alignment = 1;
     rec_ref->file_rec->counters[POSIX_READS] += 1; \
     DARSHAN_BUCKET_INC(&(rec_ref->file_rec->counters[POSIX_SIZE_READ_0_100]), __ret); \
     cvc = darshan_track_common_val_counters(&rec_ref->access_root, &__ret, 1, \
-        &rec_ref->access_count); \
+        &rec_ref->access_count, &(posix_runtime->arena)); \
     if(cvc) DARSHAN_UPDATE_COMMON_VAL_COUNTERS( \
         &(rec_ref->file_rec->counters[POSIX_ACCESS1_ACCESS]), \
         &(rec_ref->file_rec->counters[POSIX_ACCESS1_COUNT]), \
         cvc->vals, 1, cvc->freq, 0); \
     cvc = darshan_track_common_val_counters(&rec_ref->stride_root, &stride, 1, \
-        &rec_ref->stride_count); \
+        &rec_ref->stride_count, &(posix_runtime->arena)); \
     if(cvc) DARSHAN_UPDATE_COMMON_VAL_COUNTERS( \
         &(rec_ref->file_rec->counters[POSIX_STRIDE1_STRIDE]), \
         &(rec_ref->file_rec->counters[POSIX_STRIDE1_COUNT]), \
@@ -363,6 +368,8 @@ static int darshan_mem_alignment = 1;
         this_offset = rec_ref->offset; \
     /* DXT to record detailed write tracing information */ \
     dxt_posix_write(rec_ref->file_rec->base_rec.id, this_offset, __ret, __tm1, __tm2); \
+    /* OVERLAP to record the written extent */ \
+    overlap_posix_write(rec_ref->file_rec->base_rec.id, this_offset, __ret); \
     /* heatmap to record traffic summary */ \
     heatmap_update(posix_runtime->heatmap_id, HEATMAP_WRITE, __ret, __tm1, __tm2); \
     if(this_offset > rec_ref->last_byte_written) \
@@ -382,13 +389,13 @@ static int darshan_mem_alignment = 1;
     rec_ref->file_rec->counters[POSIX_WRITES] += 1; \
     DARSHAN_BUCKET_INC(&(rec_ref->file_rec->counters[POSIX_SIZE_WRITE_0_100]), __ret); \
     cvc = darshan_track_common_val_counters(&rec_ref->access_root, &__ret, 1, \
-        &rec_ref->access_count); \
+        &rec_ref->access_count, &(posix_runtime->arena)); \
     if(cvc) DARSHAN_UPDATE_COMMON_VAL_COUNTERS( \
         &(rec_ref->file_rec->counters[POSIX_ACCESS1_ACCESS]), \
         &(rec_ref->file_rec->counters[POSIX_ACCESS1_COUNT]), \
         cvc->vals, 1, cvc->freq, 0); \
     cvc = darshan_track_common_val_counters(&rec_ref->stride_root, &stride, 1, \
-        &rec_ref->stride_count); \
+        &rec_ref->stride_count, &(posix_runtime->arena)); \
     if(cvc) DARSHAN_UPDATE_COMMON_VAL_COUNTERS( \
         &(rec_ref->file_rec->counters[POSIX_STRIDE1_STRIDE]), \
         &(rec_ref->file_rec->counters[POSIX_STRIDE1_COUNT]), \
@@ -1650,7 +1657,8 @@ int DARSHAN_DECL(close)(int fd)
         DARSHAN_TIMER_INC_NO_OVERLAP(
             rec_ref->file_rec->fcounters[POSIX_F_META_TIME],
             tm1, tm2, rec_ref->last_meta_end);
-        darshan_delete_record_ref(&(posix_runtime->fd_hash), &fd, sizeof(int));
+        darshan_delete_record_ref(&(posix_runtime->fd_hash), &fd, sizeof(int),
+            &(posix_runtime->arena));
 
 #ifdef HAVE_LDMS
         rec_ref->close_counts++;
@@ -1959,10 +1967,14 @@ static void posix_runtime_initialize()
         return;
     }
     memset(posix_runtime, 0, sizeof(*posix_runtime));
+    darshan_arena_init(&(posix_runtime->arena), DARSHAN_POSIX_MOD);
 
     /* allow DXT module to initialize if needed */
     dxt_posix_runtime_initialize();
 
+    /* allow OVERLAP module to initialize if needed */
+    overlap_posix_runtime_initialize();
+
     /* register a heatmap */
     posix_runtime->heatmap_id = heatmap_register("heatmap:POSIX");
 
@@ -1977,17 +1989,16 @@ static struct posix_file_record_ref *posix_track_new_file_record(
     struct darshan_fs_info fs_info;
     int ret;
 
-    rec_ref = malloc(sizeof(*rec_ref));
+    rec_ref = darshan_arena_alloc(&(posix_runtime->arena), sizeof(*rec_ref));
     if(!rec_ref)
         return(NULL);
-    memset(rec_ref, 0, sizeof(*rec_ref));
 
     /* add a reference to this file record based on record id */
     ret = darshan_add_record_ref(&(posix_runtime->rec_id_hash), &rec_id,
-        sizeof(darshan_record_id), rec_ref);
+        sizeof(darshan_record_id), rec_ref, &(posix_runtime->arena));
     if(ret == 0)
     {
-        free(rec_ref);
+        darshan_arena_free(&(posix_runtime->arena), rec_ref, sizeof(*rec_ref));
         return(NULL);
     }
 
@@ -2004,8 +2015,8 @@ static struct posix_file_record_ref *posix_track_new_file_record(
     if(!file_rec)
     {
         darshan_delete_record_ref(&(posix_runtime->rec_id_hash),
-            &rec_id, sizeof(darshan_record_id));
-        free(rec_ref);
+            &rec_id, sizeof(darshan_record_id), &(posix_runtime->arena));
+        darshan_arena_free(&(posix_runtime->arena), rec_ref, sizeof(*rec_ref));
         return(NULL);
     }
 
@@ -2078,8 +2089,8 @@ static void posix_finalize_file_records(void *rec_ref_p, void *user_ptr)
     struct posix_file_record_ref *rec_ref =
         (struct posix_file_record_ref *)rec_ref_p;
 
-    tdestroy(rec_ref->access_root, free);
-    tdestroy(rec_ref->stride_root, free);
+    tdestroy(rec_ref->access_root, darshan_arena_tree_nofree);
+    tdestroy(rec_ref->stride_root, darshan_arena_tree_nofree);
     return;
 }
 
@@ -2654,8 +2665,9 @@ static void posix_cleanup()
     /* cleanup internal structures used for instrumenting */
     darshan_iter_record_refs(posix_runtime->rec_id_hash,
         &posix_finalize_file_records, NULL);
-    darshan_clear_record_refs(&(posix_runtime->fd_hash), 0);
-    darshan_clear_record_refs(&(posix_runtime->rec_id_hash), 1);
+    darshan_clear_record_refs(&(posix_runtime->fd_hash), 0, &(posix_runtime->arena));
+    darshan_clear_record_refs(&(posix_runtime->rec_id_hash), 1, &(posix_runtime->arena));
+    darshan_arena_destroy(&(posix_runtime->arena));
 
     free(posix_runtime);
     posix_runtime = NULL;
@@ -141,6 +141,47 @@ struct stdio_file_record_ref
 #endif
 };
 
+/* Per-thread accumulation of small writes to the stream a thread most
+ * recently wrote to.  Writes that fit in the batch are accounted for
+ * without taking the STDIO lock, looking up the stream, or updating the
+ * heatmap; the batch is folded into the stream's file record in one step
+ * when it fills up, when the stream is flushed, closed, read from (by this
+ * thread), or repositioned, when the thread exits, and at shutdown.  The
+ * cached stream and record also let the thread skip the stream hash lookup
+ * for other operations on the same stream.
+ *
+ * Batches are linked on a list so that other threads can flush them, and
+ * are never freed; a thread's batch is returned to the list for reuse when
+ * the thread exits.  'stream', 'rec_ref', 'in_use', and the list are
+ * protected by the STDIO lock, while the accumulated values are protected
+ * by the per-batch lock, which is normally only taken by the owner thread.
+ */
+struct stdio_write_batch
+{
+    FILE *stream;
+    struct stdio_file_record_ref *rec_ref;
+    int64_t writes;
+    int64_t bytes;
+    double start;
+    double end;
+    double time;
+    double last_write_end;
+    int in_use;
+#ifdef HAVE_STDATOMIC_H
+    atomic_flag lock;
+#else
+    pthread_mutex_t lock;
+#endif
+    struct stdio_write_batch *next;
+};
+
+/* batches are folded into the file record before exceeding the default
+ * stdio buffer size, or spanning more time than this (so that heatmap and
+ * timestamp resolution are not noticeably affected)
+ */
+#define STDIO_BATCH_MAX_BYTES BUFSIZ
+#define STDIO_BATCH_MAX_TIME 0.01
+
 /* The stdio_runtime structure maintains necessary state for storing
  * STDIO file records and for coordinating with darshan-core at
  * shutdown time.
@@ -152,6 +193,7 @@ struct stdio_runtime
     int file_rec_count;
     darshan_record_id heatmap_id;
     int frozen; /* flag to indicate that the counters should no longer be modified */
+    struct darshan_arena arena; /* record references and handle mappings */
 };
 
 static struct stdio_runtime *stdio_runtime = NULL;
@@ -159,6 +201,9 @@ static pthread_mutex_t stdio_runtime_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER
 static int stdio_runtime_init_attempted = 0;
 static int darshan_mem_alignment = 1;
 static int my_rank = -1;
+static struct stdio_write_batch *stdio_batch_list = NULL;
+static pthread_key_t stdio_batch_key;
+static pthread_once_t stdio_batch_key_once = PTHREAD_ONCE_INIT;
 
 static void stdio_runtime_initialize(
     void);
@@ -178,6 +223,20 @@ static void stdio_output(
     void **stdio_buf, int *stdio_buf_sz);
 static void stdio_cleanup(
     void);
+static void stdio_batch_key_init(
+    void);
+static void stdio_batch_release(
+    void *batch_p);
+static struct stdio_file_record_ref *stdio_lookup_stream(
+    FILE *stream);
+static void stdio_batch_fold(
+    struct stdio_write_batch *batch);
+static void stdio_batch_flush_self(
+    FILE *stream);
+static void stdio_batch_flush_stream(
+    FILE *stream, int invalidate);
+static void stdio_batch_arm(
+    FILE *stream, struct stdio_file_record_ref *rec_ref);
 
 /* extern function def for querying record name from a POSIX fd */
 extern char *darshan_posix_lookup_record_name(int fd);
@@ -189,12 +248,32 @@ extern int (*__real_fileno)(FILE *stream);
 extern int __real_fileno(FILE *stream);
 #endif
 
-#define STDIO_LOCK() pthread_mutex_lock(&stdio_runtime_mutex)
-#define STDIO_UNLOCK() pthread_mutex_unlock(&stdio_runtime_mutex)
+#define STDIO_LOCK() DARSHAN_MOD_LOCK(DARSHAN_STDIO_MOD, &stdio_runtime_mutex)
+#define STDIO_UNLOCK() DARSHAN_MOD_UNLOCK(DARSHAN_STDIO_MOD, &stdio_runtime_mutex)
 
 #define STDIO_WTIME() \
     __darshan_disabled ? 0 : darshan_core_wtime();
 
+#ifdef HAVE_STDATOMIC_H
+#define STDIO_BATCH_LOCK(__batch) \
+    while (atomic_flag_test_and_set(&(__batch)->lock))
+#define STDIO_BATCH_UNLOCK(__batch) \
+    atomic_flag_clear(&(__batch)->lock)
+#else
+#define STDIO_BATCH_LOCK(__batch) pthread_mutex_lock(&(__batch)->lock)
+#define STDIO_BATCH_UNLOCK(__batch) pthread_mutex_unlock(&(__batch)->lock)
+#endif
+
+/* try to account for a write to a stream in the calling thread's batch,
+ * returning immediately (without taking the STDIO lock) if successful;
+ * otherwise fall through to the regular PRE_RECORD()/RECORD_WRITE() path
+ */
+#define STDIO_BATCH_WRITE(__fp, __bytes, __tm1, __tm2) do { \
+    if(!__darshan_disabled && \
+        stdio_batch_write(__fp, __bytes, __tm1, __tm2)) \
+        return(ret); \
+} while(0)
+
 /* note that if the break condition is triggered in this macro, then it
  * will exit the do/while loop holding a lock that will be released in
  * POST_RECORD().  Otherwise it will release the lock here (if held) and
@@ -253,15 +332,20 @@ extern int __real_fileno(FILE *stream);
         __rec_ref->file_rec->fcounters[STDIO_F_OPEN_START_TIMESTAMP] = __tm1; \
     __rec_ref->file_rec->fcounters[STDIO_F_OPEN_END_TIMESTAMP] = __tm2; \
     DARSHAN_TIMER_INC_NO_OVERLAP(__rec_ref->file_rec->fcounters[STDIO_F_META_TIME], __tm1, __tm2, __rec_ref->last_meta_end); \
-    darshan_add_record_ref(&(stdio_runtime->stream_hash), &(__ret), sizeof(__ret), __rec_ref); \
+    /* drop batches still referring to a previous use of this stream */ \
+    stdio_batch_flush_stream(__ret, 1); \
+    darshan_add_record_ref(&(stdio_runtime->stream_hash), &(__ret), sizeof(__ret), __rec_ref, \
+        &(stdio_runtime->arena)); \
 } while(0)
 
 
 #define STDIO_RECORD_READ(__fp, __bytes,  __tm1, __tm2) do{ \
     struct stdio_file_record_ref* rec_ref; \
     int64_t this_offset; \
-    rec_ref = darshan_lookup_record_ref(stdio_runtime->stream_hash, &(__fp), sizeof(__fp)); \
+    rec_ref = stdio_lookup_stream(__fp); \
     if(!rec_ref) break; \
+    /* writes batched by this thread precede this read */ \
+    stdio_batch_flush_self(__fp); \
     this_offset = rec_ref->offset; \
     rec_ref->offset = this_offset + __bytes; \
     /* heatmap to record traffic summary */ \
@@ -284,7 +368,14 @@ extern int __real_fileno(FILE *stream);
 #define STDIO_RECORD_WRITE(__fp, __bytes,  __tm1, __tm2, __fflush_flag) do{ \
     struct stdio_file_record_ref* rec_ref; \
     int64_t this_offset; \
-    rec_ref = darshan_lookup_record_ref(stdio_runtime->stream_hash, &(__fp), sizeof(__fp)); \
+    /* fold batched writes into the record before this one, including \
+     * those of all threads for flushes (of all streams, if __fp is NULL) \
+     */ \
+    if(__fflush_flag) \
+        stdio_batch_flush_stream(__fp, 0); \
+    else \
+        stdio_batch_flush_self(NULL); \
+    rec_ref = stdio_lookup_stream(__fp); \
     if(!rec_ref) break; \
     this_offset = rec_ref->offset; \
     rec_ref->offset = this_offset + __bytes; \
@@ -306,8 +397,47 @@ extern int __real_fileno(FILE *stream);
     if(dC.ldms_lib)\
         if(dC.stdio_enable_ldms)\
             darshan_ldms_connector_send(rec_ref->file_rec->base_rec.id, rec_ref->file_rec->base_rec.rank, rec_ref->file_rec->counters[STDIO_WRITES], "write", this_offset, __bytes, rec_ref->file_rec->counters[STDIO_MAX_BYTE_WRITTEN], -1, rec_ref->file_rec->counters[STDIO_FLUSHES], __tm1, __tm2,  rec_ref->file_rec->fcounters[STDIO_F_WRITE_TIME], "STDIO", "MOD"); \
+    /* let subsequent writes to this stream by this thread be batched, \
+     * unless they are being published to LDMS individually \
+     */ \
+    if(!__fflush_flag && !(dC.ldms_lib && dC.stdio_enable_ldms)) \
+        stdio_batch_arm(__fp, rec_ref); \
 } while(0)
 
+/* account for a write in the calling thread's batch, if it is already
+ * caching 'stream' and the write fits in the batch; returns 1 if the write
+ * was batched and 0 otherwise
+ */
+static inline int stdio_batch_write(FILE *stream, int64_t bytes,
+    double tm1, double tm2)
+{
+    struct stdio_write_batch *batch;
+    int batched = 0;
+
+    pthread_once(&stdio_batch_key_once, stdio_batch_key_init);
+    batch = pthread_getspecific(stdio_batch_key);
+    if(!batch)
+        return(0);
+
+    STDIO_BATCH_LOCK(batch);
+    if(batch->stream == stream &&
+        batch->bytes + bytes <= STDIO_BATCH_MAX_BYTES &&
+        (batch->writes == 0 || tm2 - batch->start <= STDIO_BATCH_MAX_TIME))
+    {
+        if(batch->writes == 0)
+            batch->start = tm1;
+        batch->end = tm2;
+        batch->writes += 1;
+        batch->bytes += bytes;
+        DARSHAN_TIMER_INC_NO_OVERLAP(batch->time, tm1, tm2,
+            batch->last_write_end);
+        batched = 1;
+    }
+    STDIO_BATCH_UNLOCK(batch);
+
+    return(batched);
+}
+
 FILE* DARSHAN_DECL(fopen)(const char *path, const char *mode)
 {
     FILE* ret;
@@ -464,6 +594,8 @@ int DARSHAN_DECL(fclose)(FILE *fp)
     tm2 = STDIO_WTIME();
 
     STDIO_PRE_RECORD();
+    /* fold in and drop any batched writes to the stream */
+    stdio_batch_flush_stream(fp, 1);
     rec_ref = darshan_lookup_record_ref(stdio_runtime->stream_hash, &fp, sizeof(fp));
     if(rec_ref)
     {
@@ -474,7 +606,8 @@ int DARSHAN_DECL(fclose)(FILE *fp)
         DARSHAN_TIMER_INC_NO_OVERLAP(
             rec_ref->file_rec->fcounters[STDIO_F_META_TIME],
             tm1, tm2, rec_ref->last_meta_end);
-        darshan_delete_record_ref(&(stdio_runtime->stream_hash), &fp, sizeof(fp));
+        darshan_delete_record_ref(&(stdio_runtime->stream_hash), &fp, sizeof(fp),
+            &(stdio_runtime->arena));
 
 #ifdef HAVE_LDMS
         rec_ref->close_counts++;
@@ -500,6 +633,8 @@ size_t DARSHAN_DECL(fwrite)(const void *ptr, size_t size, size_t nmemb, FILE *st
     ret = __real_fwrite(ptr, size, nmemb, stream);
     tm2 = STDIO_WTIME();
 
+    if(ret > 0)
+        STDIO_BATCH_WRITE(stream, size*ret, tm1, tm2);
     STDIO_PRE_RECORD();
     if(ret > 0)
         STDIO_RECORD_WRITE(stream, size*ret, tm1, tm2, 0);
@@ -520,6 +655,8 @@ int DARSHAN_DECL(fputc)(int c, FILE *stream)
     ret = __real_fputc(c, stream);
     tm2 = STDIO_WTIME();
 
+    if(ret != EOF)
+        STDIO_BATCH_WRITE(stream, 1, tm1, tm2);
     STDIO_PRE_RECORD();
     if(ret != EOF)
         STDIO_RECORD_WRITE(stream, 1, tm1, tm2, 0);
@@ -539,6 +676,8 @@ int DARSHAN_DECL(putw)(int w, FILE *stream)
     ret = __real_putw(w, stream);
     tm2 = STDIO_WTIME();
 
+    if(ret != EOF)
+        STDIO_BATCH_WRITE(stream, sizeof(int), tm1, tm2);
     STDIO_PRE_RECORD();
     if(ret != EOF)
         STDIO_RECORD_WRITE(stream, sizeof(int), tm1, tm2, 0);
@@ -560,6 +699,8 @@ int DARSHAN_DECL(fputs)(const char *s, FILE *stream)
     ret = __real_fputs(s, stream);
     tm2 = STDIO_WTIME();
 
+    if(ret != EOF && ret > 0)
+        STDIO_BATCH_WRITE(stream, strlen(s), tm1, tm2);
     STDIO_PRE_RECORD();
     if(ret != EOF && ret > 0)
         STDIO_RECORD_WRITE(stream, strlen(s), tm1, tm2, 0);
@@ -579,6 +720,8 @@ int DARSHAN_DECL(vprintf)(const char *format, va_list ap)
     ret = __real_vprintf(format, ap);
     tm2 = STDIO_WTIME();
 
+    if(ret > 0)
+        STDIO_BATCH_WRITE(stdout, ret, tm1, tm2);
     STDIO_PRE_RECORD();
     if(ret > 0)
         STDIO_RECORD_WRITE(stdout, ret, tm1, tm2, 0);
@@ -598,6 +741,8 @@ int DARSHAN_DECL(vfprintf)(FILE *stream, const char *format, va_list ap)
     ret = __real_vfprintf(stream, format, ap);
     tm2 = STDIO_WTIME();
 
+    if(ret > 0)
+        STDIO_BATCH_WRITE(stream, ret, tm1, tm2);
     STDIO_PRE_RECORD();
     if(ret > 0)
         STDIO_RECORD_WRITE(stream, ret, tm1, tm2, 0);
@@ -624,6 +769,8 @@ int DARSHAN_DECL(printf)(const char *format, ...)
     va_end(ap);
     tm2 = STDIO_WTIME();
 
+    if(ret > 0)
+        STDIO_BATCH_WRITE(stdout, ret, tm1, tm2);
     STDIO_PRE_RECORD();
     if(ret > 0)
         STDIO_RECORD_WRITE(stdout, ret, tm1, tm2, 0);
@@ -649,6 +796,8 @@ int DARSHAN_DECL(fprintf)(FILE *stream, const char *format, ...)
     va_end(ap);
     tm2 = STDIO_WTIME();
 
+    if(ret > 0)
+        STDIO_BATCH_WRITE(stream, ret, tm1, tm2);
     STDIO_PRE_RECORD();
     if(ret > 0)
         STDIO_RECORD_WRITE(stream, ret, tm1, tm2, 0);
@@ -727,6 +876,8 @@ int DARSHAN_DECL(_IO_putc)(int c, FILE *stream)
     ret = __real__IO_putc(c, stream);
     tm2 = STDIO_WTIME();
 
+    if(ret != EOF)
+        STDIO_BATCH_WRITE(stream, 1, tm1, tm2);
     STDIO_PRE_RECORD();
     if(ret != EOF)
         STDIO_RECORD_WRITE(stream, 1, tm1, tm2, 0);
@@ -883,7 +1034,9 @@ void DARSHAN_DECL(rewind)(FILE *stream)
         return;
     }
 
-    rec_ref = darshan_lookup_record_ref(stdio_runtime->stream_hash, &stream, sizeof(stream));
+    /* batched writes were made at the old stream position */
+    stdio_batch_flush_stream(stream, 0);
+    rec_ref = stdio_lookup_stream(stream);
 
     if(rec_ref)
     {
@@ -913,7 +1066,9 @@ int DARSHAN_DECL(fseek)(FILE *stream, long offset, int whence)
     if(ret >= 0)
     {
         STDIO_PRE_RECORD();
-        rec_ref = darshan_lookup_record_ref(stdio_runtime->stream_hash, &stream, sizeof(stream));
+        /* batched writes were made at the old stream position */
+        stdio_batch_flush_stream(stream, 0);
+        rec_ref = stdio_lookup_stream(stream);
         if(rec_ref)
         {
             rec_ref->offset = ftell(stream);
@@ -943,7 +1098,9 @@ int DARSHAN_DECL(fseeko)(FILE *stream, off_t offset, int whence)
     if(ret >= 0)
     {
         STDIO_PRE_RECORD();
-        rec_ref = darshan_lookup_record_ref(stdio_runtime->stream_hash, &stream, sizeof(stream));
+        /* batched writes were made at the old stream position */
+        stdio_batch_flush_stream(stream, 0);
+        rec_ref = stdio_lookup_stream(stream);
         if(rec_ref)
         {
             rec_ref->offset = ftell(stream);
@@ -973,7 +1130,9 @@ int DARSHAN_DECL(fseeko64)(FILE *stream, off64_t offset, int whence)
     if(ret >= 0)
     {
         STDIO_PRE_RECORD();
-        rec_ref = darshan_lookup_record_ref(stdio_runtime->stream_hash, &stream, sizeof(stream));
+        /* batched writes were made at the old stream position */
+        stdio_batch_flush_stream(stream, 0);
+        rec_ref = stdio_lookup_stream(stream);
         if(rec_ref)
         {
             rec_ref->offset = ftell(stream);
@@ -1003,7 +1162,9 @@ int DARSHAN_DECL(fsetpos)(FILE *stream, const fpos_t *pos)
     if(ret >= 0)
     {
         STDIO_PRE_RECORD();
-        rec_ref = darshan_lookup_record_ref(stdio_runtime->stream_hash, &stream, sizeof(stream));
+        /* batched writes were made at the old stream position */
+        stdio_batch_flush_stream(stream, 0);
+        rec_ref = stdio_lookup_stream(stream);
         if(rec_ref)
         {
             rec_ref->offset = ftell(stream);
@@ -1033,7 +1194,9 @@ int DARSHAN_DECL(fsetpos64)(FILE *stream, const fpos64_t *pos)
     if(ret >= 0)
     {
         STDIO_PRE_RECORD();
-        rec_ref = darshan_lookup_record_ref(stdio_runtime->stream_hash, &stream, sizeof(stream));
+        /* batched writes were made at the old stream position */
+        stdio_batch_flush_stream(stream, 0);
+        rec_ref = stdio_lookup_stream(stream);
         if(rec_ref)
         {
             rec_ref->offset = ftell(stream);
@@ -1089,6 +1252,7 @@ static void stdio_runtime_initialize()
         return;
     }
     memset(stdio_runtime, 0, sizeof(*stdio_runtime));
+    darshan_arena_init(&(stdio_runtime->arena), DARSHAN_STDIO_MOD);
 
     /* instantiate records for stdin, stdout, and stderr */
     STDIO_RECORD_OPEN(stdin, "<STDIN>", 0, 0);
@@ -1109,17 +1273,16 @@ static struct stdio_file_record_ref *stdio_track_new_file_record(
     struct darshan_fs_info fs_info;
     int ret;
 
-    rec_ref = malloc(sizeof(*rec_ref));
+    rec_ref = darshan_arena_alloc(&(stdio_runtime->arena), sizeof(*rec_ref));
     if(!rec_ref)
         return(NULL);
-    memset(rec_ref, 0, sizeof(*rec_ref));
 
     /* add a reference to this file record based on record id */
     ret = darshan_add_record_ref(&(stdio_runtime->rec_id_hash), &rec_id,
-        sizeof(darshan_record_id), rec_ref);
+        sizeof(darshan_record_id), rec_ref, &(stdio_runtime->arena));
     if(ret == 0)
     {
-        free(rec_ref);
+        darshan_arena_free(&(stdio_runtime->arena), rec_ref, sizeof(*rec_ref));
         return(NULL);
     }
 
@@ -1136,8 +1299,8 @@ static struct stdio_file_record_ref *stdio_track_new_file_record(
     if(!file_rec)
     {
         darshan_delete_record_ref(&(stdio_runtime->rec_id_hash),
-            &rec_id, sizeof(darshan_record_id));
-        free(rec_ref);
+            &rec_id, sizeof(darshan_record_id), &(stdio_runtime->arena));
+        darshan_arena_free(&(stdio_runtime->arena), rec_ref, sizeof(*rec_ref));
         return(NULL);
     }
 
@@ -1151,6 +1314,182 @@ static struct stdio_file_record_ref *stdio_track_new_file_record(
     return(rec_ref);
 }
 
+static void stdio_batch_key_init()
+{
+    pthread_key_create(&stdio_batch_key, stdio_batch_release);
+    return;
+}
+
+/* thread exit callback: fold in any batched writes and give up the batch */
+static void stdio_batch_release(void *batch_p)
+{
+    struct stdio_write_batch *batch = batch_p;
+
+    STDIO_LOCK();
+    if(batch->stream)
+    {
+        STDIO_BATCH_LOCK(batch);
+        if(stdio_runtime && !stdio_runtime->frozen)
+            stdio_batch_fold(batch);
+        batch->stream = NULL;
+        batch->rec_ref = NULL;
+        STDIO_BATCH_UNLOCK(batch);
+    }
+    batch->in_use = 0;
+    STDIO_UNLOCK();
+
+    return;
+}
+
+/* look up the record for a stream, checking the stream cached by the calling
+ * thread's batch before the stream hash; STDIO lock must be held
+ */
+static struct stdio_file_record_ref *stdio_lookup_stream(FILE *stream)
+{
+    struct stdio_write_batch *batch;
+
+    pthread_once(&stdio_batch_key_once, stdio_batch_key_init);
+    batch = pthread_getspecific(stdio_batch_key);
+    if(batch && stream && batch->stream == stream)
+        return(batch->rec_ref);
+
+    return(darshan_lookup_record_ref(stdio_runtime->stream_hash, &stream,
+        sizeof(stream)));
+}
+
+/* fold a batch's accumulated writes into its stream's file record; the STDIO
+ * lock and the batch lock must be held
+ */
+static void stdio_batch_fold(struct stdio_write_batch *batch)
+{
+    struct stdio_file_record_ref *rec_ref = batch->rec_ref;
+    struct darshan_stdio_file *file_rec;
+    int64_t this_offset;
+
+    if(batch->writes == 0)
+        return;
+    file_rec = rec_ref->file_rec;
+
+    /* this gives the same result as recording the writes one at a time,
+     * as long as no other thread wrote to the stream in the meantime
+     */
+    this_offset = rec_ref->offset;
+    rec_ref->offset = this_offset + batch->bytes;
+    heatmap_update(stdio_runtime->heatmap_id, HEATMAP_WRITE, batch->bytes,
+        batch->start, batch->end);
+    if(file_rec->counters[STDIO_MAX_BYTE_WRITTEN] < (this_offset + batch->bytes - 1))
+        file_rec->counters[STDIO_MAX_BYTE_WRITTEN] = (this_offset + batch->bytes - 1);
+    file_rec->counters[STDIO_BYTES_WRITTEN] += batch->bytes;
+    file_rec->counters[STDIO_WRITES] += batch->writes;
+    if(file_rec->fcounters[STDIO_F_WRITE_START_TIMESTAMP] == 0 ||
+     file_rec->fcounters[STDIO_F_WRITE_START_TIMESTAMP] > batch->start)
+        file_rec->fcounters[STDIO_F_WRITE_START_TIMESTAMP] = batch->start;
+    if(file_rec->fcounters[STDIO_F_WRITE_END_TIMESTAMP] < batch->end)
+        file_rec->fcounters[STDIO_F_WRITE_END_TIMESTAMP] = batch->end;
+    file_rec->fcounters[STDIO_F_WRITE_TIME] += batch->time;
+    if(rec_ref->last_write_end < batch->last_write_end)
+        rec_ref->last_write_end = batch->last_write_end;
+
+    batch->writes = 0;
+    batch->bytes = 0;
+    batch->time = 0;
+    batch->last_write_end = rec_ref->last_write_end;
+
+    return;
+}
+
+/* fold in the calling thread's batched writes, if its batch is caching
+ * 'stream' (or any stream, if NULL); STDIO lock must be held
+ */
+static void stdio_batch_flush_self(FILE *stream)
+{
+    struct stdio_write_batch *batch;
+
+    pthread_once(&stdio_batch_key_once, stdio_batch_key_init);
+    batch = pthread_getspecific(stdio_batch_key);
+    if(!batch || !batch->stream || (stream && batch->stream != stream))
+        return;
+
+    STDIO_BATCH_LOCK(batch);
+    stdio_batch_fold(batch);
+    STDIO_BATCH_UNLOCK(batch);
+
+    return;
+}
+
+/* fold in the batched writes of all threads to 'stream' (or to any stream,
+ * if NULL), additionally dropping the cached stream from the batches if
+ * 'invalidate' is set; STDIO lock must be held
+ */
+static void stdio_batch_flush_stream(FILE *stream, int invalidate)
+{
+    struct stdio_write_batch *batch;
+
+    for(batch = stdio_batch_list; batch; batch = batch->next)
+    {
+        if(!batch->stream || (stream && batch->stream != stream))
+            continue;
+
+        STDIO_BATCH_LOCK(batch);
+        stdio_batch_fold(batch);
+        if(invalidate)
+        {
+            batch->stream = NULL;
+            batch->rec_ref = NULL;
+        }
+        STDIO_BATCH_UNLOCK(batch);
+    }
+
+    return;
+}
+
+/* start batching the calling thread's writes to 'stream', allocating a batch
+ * for the thread if needed; STDIO lock must be held
+ */
+static void stdio_batch_arm(FILE *stream, struct stdio_file_record_ref *rec_ref)
+{
+    struct stdio_write_batch *batch;
+
+    pthread_once(&stdio_batch_key_once, stdio_batch_key_init);
+    batch = pthread_getspecific(stdio_batch_key);
+    if(!batch)
+    {
+        /* reuse the batch of an exited thread, if there is one */
+        for(batch = stdio_batch_list; batch; batch = batch->next)
+        {
+            if(!batch->in_use)
+                break;
+        }
+        if(!batch)
+        {
+            batch = malloc(sizeof(*batch));
+            if(!batch)
+                return;
+            memset(batch, 0, sizeof(*batch));
+#ifdef HAVE_STDATOMIC_H
+            atomic_flag_clear(&batch->lock);
+#else
+            pthread_mutex_init(&batch->lock, NULL);
+#endif
+            batch->next = stdio_batch_list;
+            stdio_batch_list = batch;
+        }
+        if(pthread_setspecific(stdio_batch_key, batch) != 0)
+            return;
+        batch->in_use = 1;
+    }
+
+    STDIO_BATCH_LOCK(batch);
+    if(batch->stream)
+        stdio_batch_fold(batch);
+    batch->stream = stream;
+    batch->rec_ref = rec_ref;
+    batch->last_write_end = rec_ref->last_write_end;
+    STDIO_BATCH_UNLOCK(batch);
+
+    return;
+}
+
 #ifdef HAVE_MPI
 static void stdio_record_reduction_op(void* infile_v, void* inoutfile_v,
     int *len, MPI_Datatype *datatype)
@@ -1384,6 +1723,9 @@ static void stdio_mpi_redux(
     STDIO_LOCK();
     assert(stdio_runtime);
 
+    /* fold in all outstanding batched writes */
+    stdio_batch_flush_stream(NULL, 1);
+
     stdio_rec_count = stdio_runtime->file_rec_count;
 
     /* necessary initialization of shared records */
@@ -1493,6 +1835,9 @@ static void stdio_output(
     STDIO_LOCK();
     assert(stdio_runtime);
 
+    /* fold in all outstanding batched writes */
+    stdio_batch_flush_stream(NULL, 1);
+
     stdio_rec_count = stdio_runtime->file_rec_count;
 
     /* filter out any records that have no activity on them; this is
@@ -1538,12 +1883,29 @@ static void stdio_output(
 
 static void stdio_cleanup()
 {
+    struct stdio_write_batch *batch;
+
     STDIO_LOCK();
     assert(stdio_runtime);
 
+    /* drop references to records from write batches, which are kept
+     * around for reuse by any later runtime instance
+     */
+    for(batch = stdio_batch_list; batch; batch = batch->next)
+    {
+        STDIO_BATCH_LOCK(batch);
+        batch->stream = NULL;
+        batch->rec_ref = NULL;
+        batch->writes = 0;
+        batch->bytes = 0;
+        batch->time = 0;
+        STDIO_BATCH_UNLOCK(batch);
+    }
+
     /* cleanup internal structures used for instrumenting */
-    darshan_clear_record_refs(&(stdio_runtime->stream_hash), 0);
-    darshan_clear_record_refs(&(stdio_runtime->rec_id_hash), 1);
+    darshan_clear_record_refs(&(stdio_runtime->stream_hash), 0, &(stdio_runtime->arena));
+    darshan_clear_record_refs(&(stdio_runtime->rec_id_hash), 1, &(stdio_runtime->arena));
+    darshan_arena_destroy(&(stdio_runtime->arena));
 
     free(stdio_runtime);
     stdio_runtime = NULL;
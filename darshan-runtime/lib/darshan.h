@@ -52,6 +52,15 @@
 /* Environment variable to override memory for name records */
 #define DARSHAN_NAME_MEM_OVERRIDE "DARSHAN_NAMEMEM"
 
+/* Environment variables to override the limits module and name record
+ * memory can grow to
+ */
+#define DARSHAN_MOD_MEM_LIMIT_OVERRIDE "DARSHAN_MODMEM_MAX"
+#define DARSHAN_NAME_MEM_LIMIT_OVERRIDE "DARSHAN_NAMEMEM_MAX"
+
+/* Environment variable to back instrumentation memory with huge pages */
+#define DARSHAN_HUGE_PAGES_OVERRIDE "DARSHAN_HUGEPAGES"
+
 #ifdef __DARSHAN_ENABLE_MMAP_LOGS
 /* Environment variable to override default mmap log path */
 #define DARSHAN_MMAP_LOG_PATH_OVERRIDE "DARSHAN_MMAP_LOGPATH"
@@ -78,6 +87,30 @@
 #define DARSHAN_NAME_MEM_MAX (1 * 1024 * 1024)
 #endif
 
+/* once the memory above is used up, module and name record memory is
+ * grown in chunks of DARSHAN_MEM_GROW_CHUNK bytes, up to a default limit
+ * of 1 GiB for module records and 256 MiB for name records
+ */
+#define DARSHAN_MEM_GROW_CHUNK (1024 * 1024)
+#define DARSHAN_MOD_MEM_LIMIT (1024L * 1024L * 1024L)
+#define DARSHAN_NAME_MEM_LIMIT (256L * 1024L * 1024L)
+
+/* ways of backing module records and DXT trace buffers with huge pages,
+ * as selected by DARSHAN_HUGEPAGES, and the huge page size assumed if
+ * the system does not report one
+ */
+#define DARSHAN_HUGE_PAGES_NONE 0
+#define DARSHAN_HUGE_PAGES_TRANSPARENT 1
+#define DARSHAN_HUGE_PAGES_EXPLICIT 2
+#define DARSHAN_DEF_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+/* minimum interval (in seconds) to calibrate the TSC frequency over, and
+ * the file reporting the kernel's current clocksource
+ */
+#define DARSHAN_TSC_CALIBRATION_TIME 0.005
+#define DARSHAN_TSC_CLOCKSOURCE_PATH \
+    "/sys/devices/system/clocksource/clocksource0/current_clocksource"
+
 /* maximum buffer size for full paths, for internal use only */
 #define __DARSHAN_PATH_MAX 4096
 
@@ -125,6 +158,27 @@ struct darshan_core_regex
     struct darshan_core_regex *next;
 };
 
+/* contiguous region of log memory that can grow in place: address space
+ * for the largest size the region may grow to is reserved up front, and
+ * pages are only made accessible (backed by the log file, for mmap logs)
+ * as the region grows. For mmap logs, only the accessible part of the
+ * region is given space in the log file, and that space is moved to the
+ * end of the file if the region outgrows it.
+ */
+struct darshan_core_mem_region
+{
+    char *base;
+    size_t size;        /* accessible bytes at base */
+    size_t max_size;    /* reserved bytes at base */
+    size_t page_size;   /* granularity the region grows in */
+    int huge_pages;     /* DARSHAN_HUGE_PAGES_* backing of the region */
+#ifdef __DARSHAN_ENABLE_MMAP_LOGS
+    off_t file_off;     /* offset of the region in the mmap log file */
+    size_t file_size;   /* bytes of the mmap log file held at file_off */
+    struct darshan_log_map *log_map; /* header entry locating the region */
+#endif
+};
+
 /* in memory structure to keep up with job level data */
 struct darshan_core_runtime
 {
@@ -133,17 +187,22 @@ struct darshan_core_runtime
     struct darshan_job *log_job_p;
     char *log_exemnt_p;
     void *log_name_p;
-    void *log_mod_p;
 
     /* darshan-core internal data structures */
     struct darshan_core_module* mod_array[DARSHAN_KNOWN_MODULE_COUNT];
     struct darshan_config config;
     size_t mod_mem_used;
     struct darshan_core_name_record_ref *name_hash;
+    struct darshan_core_mem_region name_region;
     size_t name_mem_used;
+    int name_grow_count;
     char *comp_buf;
+    int comp_buf_sz;
 #ifdef __DARSHAN_ENABLE_MMAP_LOGS
     char mmap_log_name[__DARSHAN_PATH_MAX];
+    int mmap_fd;
+    off_t mmap_file_size;   /* current size of the mmap log file */
+    off_t mmap_next_off;    /* end of the file space held by regions */
 #endif
 #ifdef HAVE_MPI
     MPI_Comm mpi_comm;
@@ -157,6 +216,11 @@ struct darshan_core_runtime
  */
 extern struct darshan_core_runtime *__darshan_core;
 extern double __darshan_core_wtime_offset;
+extern double __darshan_core_wtime_epoch;
+extern int __darshan_core_overhead_flag;
+#ifdef __DARSHAN_RDTSCP_CALIBRATE
+extern double __darshan_core_tsc_sec_per_tick;
+#endif
 #ifdef HAVE_STDATOMIC_H
 extern atomic_flag __darshan_core_mutex;
 #define __DARSHAN_CORE_LOCK() \
@@ -276,6 +340,8 @@ struct darshan_core_module
     void *rec_buf_start;
     void *rec_buf_p;
     size_t rec_mem_avail;
+    struct darshan_core_mem_region region;
+    int grow_count;     /* number of times the region was grown */
     darshan_module_funcs mod_funcs;
 };
 
@@ -384,7 +450,11 @@ static inline int darshan_core_disabled_instrumentation(void)
     return(ret);
 }
 
-/* retrieve absolute wtime */
+/* retrieve absolute wtime
+ *
+ * NOTE: this is a monotonic clock with an arbitrary origin; use
+ * darshan_core_abs_timespec_from_wtime() to convert to wall-clock time.
+ */
 static inline double darshan_core_wtime_absolute(void)
 {
 #ifdef __DARSHAN_RDTSCP_FREQUENCY
@@ -395,8 +465,19 @@ static inline double darshan_core_wtime_absolute(void)
     ts = __rdtscp(&flag);
     return((double)ts/(double)__DARSHAN_RDTSCP_FREQUENCY);
 #else
-    /* normal path */
     struct timespec tp;
+#ifdef __DARSHAN_RDTSCP_CALIBRATE
+    /* use rdtscp if darshan-core found an invariant TSC and calibrated it */
+    if(__darshan_core_tsc_sec_per_tick > 0)
+    {
+        unsigned flag;
+        unsigned long long ts;
+
+        ts = __rdtscp(&flag);
+        return((double)ts * __darshan_core_tsc_sec_per_tick);
+    }
+#endif
+    /* normal path */
     /* some notes on what function to use to retrieve time as of 2021-05:
      * - clock_gettime() is faster than MPI_Wtime() across platforms
      * - clock_gettime() is at least competitive with gettimeofday()
@@ -406,8 +487,10 @@ static inline double darshan_core_wtime_absolute(void)
      *   - the _COARSE variants are not implemented with vDSO on POWER
      *     platforms
      *   - it is not well defined how much precision will be sacrificed
+     * - CLOCK_MONOTONIC is used rather than CLOCK_REALTIME so that elapsed
+     *   times are not corrupted by NTP adjustments during the job
      */
-    clock_gettime(CLOCK_REALTIME, &tp);
+    clock_gettime(CLOCK_MONOTONIC, &tp);
     return(((double)tp.tv_sec) + 1.0e-9 * ((double)tp.tv_nsec));
 #endif
 }
@@ -431,15 +514,100 @@ static inline struct timespec darshan_core_abs_timespec_from_wtime(double t)
 {
     struct timespec tp;
 
-    /* add time offset back to get to absolute time */
-    t += __darshan_core_wtime_offset;
+    /* add wall-clock time of darshan start back to get to absolute time */
+    t += __darshan_core_wtime_epoch;
 
     /* cast to integer type, deliberately truncating after decimal point to get whole number seconds */
     tp.tv_sec = (time_t)t;
     /* subtract seconds out, then multiply remainder to nsecs and cast */
     tp.tv_nsec = (time_t)((t - (double)tp.tv_sec) / 1.0e-9);
     return(tp);
-} 
+}
+
+/* overhead accounting slots: one per module id, plus one for LDMS streaming,
+ * which is not specific to any module
+ */
+#define DARSHAN_OVERHEAD_LDMS DARSHAN_KNOWN_MODULE_COUNT
+#define DARSHAN_OVERHEAD_SLOT_COUNT (DARSHAN_KNOWN_MODULE_COUNT + 1)
+
+/* darshan_core_overhead_lock()
+ *
+ * Locks a module's runtime mutex, accounting the time the lock is held to
+ * overhead slot 'slot' (with nested acquisitions of recursive mutexes only
+ * counted once), as well as any time spent waiting for the lock if it was
+ * already held by another thread. Slot accounting is protected by 'mutex'
+ * itself, so a given slot must always be used with the same mutex.
+ */
+void darshan_core_overhead_lock(
+    int slot,
+    pthread_mutex_t *mutex);
+
+/* darshan_core_overhead_unlock()
+ *
+ * Unlocks a mutex locked with darshan_core_overhead_lock().
+ */
+void darshan_core_overhead_unlock(
+    int slot,
+    pthread_mutex_t *mutex);
+
+/* darshan_core_overhead_add()
+ *
+ * Accounts the time elapsed since 'start' (a darshan_core_wtime_absolute()
+ * timestamp) to overhead slot 'slot', for instrumentation that is not
+ * serialized by a module runtime mutex.
+ */
+void darshan_core_overhead_add(
+    int slot,
+    double start);
+
+/* darshan_core_overhead_memory()
+ *
+ * Accounts 'delta' bytes of memory obtained (or, if negative, released)
+ * by a module's runtime allocator to overhead slot 'slot', so that the
+ * high-water mark of the slot's memory usage can be reported.
+ */
+void darshan_core_overhead_memory(
+    int slot,
+    ssize_t delta);
+
+/* darshan_core_huge_realloc()
+ *
+ * Resizes instrumentation buffer 'buf' from 'old_size' to 'new_size' bytes,
+ * with the semantics of realloc(). If huge pages are enabled, buffers of at
+ * least a huge page are mapped separately and backed by huge pages, so the
+ * buffer must only be resized and freed with these functions, passing its
+ * current size.
+ */
+void *darshan_core_huge_realloc(
+    void *buf,
+    size_t old_size,
+    size_t new_size);
+
+/* darshan_core_huge_free()
+ *
+ * Frees instrumentation buffer 'buf' of 'size' bytes, allocated with
+ * darshan_core_huge_realloc().
+ */
+void darshan_core_huge_free(
+    void *buf,
+    size_t size);
+
+/* lock and unlock a module runtime mutex, using the overhead accounting
+ * variants above only if the user enabled DARSHAN_OVERHEAD_ACCOUNTING
+ */
+#define DARSHAN_MOD_LOCK(__slot, __mutex) do { \
+    if(__darshan_core_overhead_flag) \
+        darshan_core_overhead_lock(__slot, __mutex); \
+    else \
+        pthread_mutex_lock(__mutex); \
+} while(0)
+
+#define DARSHAN_MOD_UNLOCK(__slot, __mutex) do { \
+    if(__darshan_core_overhead_flag) \
+        darshan_core_overhead_unlock(__slot, __mutex); \
+    else \
+        pthread_mutex_unlock(__mutex); \
+} while(0)
 
 /* darshan_core_fprintf()
  *
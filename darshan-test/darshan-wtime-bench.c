@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2026 University of Chicago.
+ * See COPYRIGHT notice in top-level directory.
+ *
+ */
+
+/* Benchmark to compare the cost of the clock sources Darshan can use to
+ * timestamp intercepted calls.  Must be linked against the Darshan runtime
+ * library.
+ */
+
+/* Arguments: an integer specifying the number of iterations to run of each
+ * test phase
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+/* NOTE: we deliberately provide our own function declaration here; there is
+ * no header installed with the instrumentation package that defines the
+ * benchmarking hooks for us.  This should only be used by special-purpose
+ * benchmarking tools.
+ */
+void darshan_wtime_bench(int iters);
+
+int main(int argc, char **argv)
+{
+    int iters;
+    int ret;
+
+    if(argc != 2)
+    {
+        fprintf(stderr, "Usage: %s <number of iterations>\n", argv[0]);
+        return(-1);
+    }
+
+    ret = sscanf(argv[1], "%d", &iters);
+    if(ret != 1 || iters <= 0)
+    {
+        fprintf(stderr, "Usage: %s <number of iterations>\n", argv[0]);
+        return(-1);
+    }
+
+    darshan_wtime_bench(iters);
+
+    return(0);
+}
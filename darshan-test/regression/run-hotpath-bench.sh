@@ -0,0 +1,131 @@
+#!/bin/bash
+
+# Builds and runs the hotpath-bench microbenchmark (test-cases/src) against
+# an installed Darshan for a given platform, once without Darshan and once
+# for each of a set of Darshan runtime configurations, and collects the
+# results into a single JSON file ($DARSHAN_TMP/hotpath-bench.json).
+#
+# Arguments are the same as run-all.sh.  The platform's env.sh determines
+# how the benchmark is instrumented (e.g., workstation-ld-preload for
+# LD_PRELOAD, workstation-cc-wrapper or workstation-profile-conf-static for
+# static wrapping).
+#
+# Optional environment variables:
+#   HOTPATH_ITERS: iterations per thread for each operation (default 100000)
+#   HOTPATH_THREADS: comma-separated thread counts (default 1,2,4,8)
+#   HOTPATH_DIR: directory to create files in (default $DARSHAN_TMP); must
+#                not be excluded from Darshan instrumentation (e.g., /dev/shm)
+#   HOTPATH_LDMS: set to include a configuration with LDMS streaming enabled
+
+if [ "$#" -ne 3 ]; then
+    echo "Usage: run-hotpath-bench.sh <darshan_install_path> <tmp_path> <platform>" 1>&2
+    echo "Example: ./run-hotpath-bench.sh ~/darshan-install /tmp/test workstation-ld-preload" 1>&2
+    exit 1
+fi
+
+# set variables for use by other sub-scripts
+DARSHAN_PATH=$1
+if [[ "$DARSHAN_PATH" == *":"* ]]; then
+    export DARSHAN_RUNTIME_PATH=`echo $DARSHAN_PATH | cut -f1 -d:`
+else
+    export DARSHAN_RUNTIME_PATH=$DARSHAN_PATH
+fi
+export DARSHAN_TMP=$2
+export DARSHAN_PLATFORM=$3
+# the benchmark runs on a single process
+export DARSHAN_DEFAULT_NPROCS=1
+
+DARSHAN_TESTDIR=$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )
+export DARSHAN_TESTDIR
+
+HOTPATH_ITERS=${HOTPATH_ITERS:-100000}
+HOTPATH_THREADS=${HOTPATH_THREADS:-1,2,4,8}
+HOTPATH_DIR=${HOTPATH_DIR:-$DARSHAN_TMP}
+PROG=hotpath-bench
+
+# check darshan-runtime path
+if [ ! -x $DARSHAN_RUNTIME_PATH/bin/darshan-config ]; then
+    echo "Error: $DARSHAN_RUNTIME_PATH doesn't contain a valid Darshan-runtime install." 1>&2
+    exit 1
+fi
+
+# check and/or create tmp path
+mkdir -p $DARSHAN_TMP
+if [ ! -w $DARSHAN_TMP ]; then
+    echo "Error: unable to write to $DARSHAN_TMP" 1>&2
+    exit 1
+fi
+
+# make sure that we have sub-scripts for the specified platform
+if [ ! -d $DARSHAN_TESTDIR/$DARSHAN_PLATFORM ]; then
+    echo "Error: unable to find scripts for platform $DARSHAN_PLATFORM" 1>&2
+    exit 1
+fi
+
+# build an uninstrumented baseline before the platform environment is set up
+mpicc $DARSHAN_TESTDIR/test-cases/src/${PROG}.c -o $DARSHAN_TMP/${PROG}.none -lpthread
+if [ $? -ne 0 ]; then
+    echo "Error: failed to compile uninstrumented ${PROG}" 1>&2
+    exit 1
+fi
+BASELINE_RUNJOB="mpiexec -n 1"
+
+# set up environment for tests according to platform
+source $DARSHAN_TESTDIR/$DARSHAN_PLATFORM/env.sh
+
+$DARSHAN_CC $DARSHAN_TESTDIR/test-cases/src/${PROG}.c -o $DARSHAN_TMP/${PROG} -lpthread
+if [ $? -ne 0 ]; then
+    echo "Error: failed to compile ${PROG}" 1>&2
+    exit 1
+fi
+
+# Darshan runtime configurations to compare, as "<label> <env settings>"
+CONFIGS=(
+    "disabled DARSHAN_DISABLE=1"
+    "default"
+    "no-posix DARSHAN_MOD_DISABLE=POSIX"
+    "no-stdio DARSHAN_MOD_DISABLE=STDIO"
+    "no-mpiio DARSHAN_MOD_DISABLE=MPI-IO"
+    "no-heatmap DARSHAN_MOD_DISABLE=HEATMAP"
+    "dxt DXT_ENABLE_IO_TRACE=1"
+    "hugepages-transparent DARSHAN_HUGEPAGES=transparent"
+    "hugepages-explicit DARSHAN_HUGEPAGES=explicit"
+)
+if [ -n "$HOTPATH_LDMS" ]; then
+    CONFIGS+=("ldms DARSHAN_LDMS_ENABLE=1 DARSHAN_LDMS_ENABLE_ALL=1")
+fi
+
+export DARSHAN_LOGFILE=$DARSHAN_TMP/${PROG}.darshan
+OUTFILE=$DARSHAN_TMP/${PROG}.json
+RAWFILE=$DARSHAN_TMP/${PROG}.ndjson
+rm -f $RAWFILE
+
+env -u LD_PRELOAD $BASELINE_RUNJOB $DARSHAN_TMP/${PROG}.none $HOTPATH_DIR \
+    $HOTPATH_ITERS $HOTPATH_THREADS none >> $RAWFILE
+if [ $? -ne 0 ]; then
+    echo "Error: failed to execute uninstrumented ${PROG}" 1>&2
+    exit 1
+fi
+
+for config in "${CONFIGS[@]}"; do
+    label=`echo $config | cut -f1 -d' '`
+    settings=`echo $config | cut -s -f2- -d' '`
+    echo "Running ${PROG} ($label)..."
+    rm -f $DARSHAN_LOGFILE
+    env $settings $DARSHAN_RUNJOB $DARSHAN_TMP/${PROG} $HOTPATH_DIR \
+        $HOTPATH_ITERS $HOTPATH_THREADS $label >> $RAWFILE
+    if [ $? -ne 0 ]; then
+        echo "Error: failed to execute ${PROG} ($label)" 1>&2
+        exit 1
+    fi
+done
+
+# wrap the per-line results in a single JSON document
+(
+    echo "{\"platform\": \"$DARSHAN_PLATFORM\", \"results\": ["
+    sed -e '$!s/$/,/' $RAWFILE
+    echo "]}"
+) > $OUTFILE
+
+echo "Results written to $OUTFILE"
+exit 0
@@ -0,0 +1,98 @@
+#!/bin/bash
+
+PROG=overlap-test
+
+# set log file path; remove previous log if present
+export DARSHAN_LOGFILE=$DARSHAN_TMP/${PROG}.darshan
+rm -f ${DARSHAN_LOGFILE}
+
+# enable the OVERLAP module with the block size and extent limit that the
+# expected counters below are computed for
+export DARSHAN_MOD_ENABLE=OVERLAP
+export DARSHAN_OVERLAP_BLOCK_SIZE=4096
+export DARSHAN_OVERLAP_MAX_EXTENTS=16
+
+# compile
+$DARSHAN_CC $DARSHAN_TESTDIR/test-cases/src/${PROG}.c -o $DARSHAN_TMP/${PROG}
+if [ $? -ne 0 ]; then
+    echo "Error: failed to compile ${PROG}" 1>&2
+    exit 1
+fi
+
+# execute
+$DARSHAN_RUNJOB $DARSHAN_TMP/${PROG} -f $DARSHAN_TMP/${PROG}.tmp.dat
+if [ $? -ne 0 ]; then
+    echo "Error: failed to execute ${PROG}" 1>&2
+    exit 1
+fi
+
+# parse log
+$DARSHAN_UTIL_PATH/bin/darshan-parser $DARSHAN_LOGFILE > $DARSHAN_TMP/${PROG}.darshan.txt
+if [ $? -ne 0 ]; then
+    echo "Error: failed to parse ${DARSHAN_LOGFILE}" 1>&2
+    exit 1
+fi
+
+# check results
+# each file of the test program has a known pattern; see its source for
+# how the expected values are derived
+N=$DARSHAN_DEFAULT_NPROCS
+failed=0
+
+# usage: check_counter <file suffix> <expected rank> <counter> <expected value>
+check_counter() {
+    local file=$DARSHAN_TMP/${PROG}.tmp.dat.$1
+    local out
+    out=`grep -vE "^#" $DARSHAN_TMP/${PROG}.darshan.txt | \
+        awk -F'\t' -v f="$file" -v c="$3" '$1 == "OVERLAP" && $4 == c && $6 == f {print $2, $5}'`
+    if [ "$out" != "$2 $4" ]; then
+        echo "Error: $3 of $file is \"$out\", expected rank and value \"$2 $4\"" 1>&2
+        failed=1
+    fi
+}
+
+# block 0 is falsely shared, block 1 truly shared, blocks 2..N+1 unique
+check_counter shared -1 OVERLAP_WRITES $((3 * N + 1))
+check_counter shared -1 OVERLAP_BYTES_WRITTEN $((512 * N + 512 * N + 4096 * N + 512))
+check_counter shared -1 OVERLAP_UNIQUE_BYTES $((512 * N + 512 + 4096 * N))
+check_counter shared -1 OVERLAP_SHARED_BYTES 512
+check_counter shared -1 OVERLAP_REWRITE_BYTES 512
+check_counter shared -1 OVERLAP_BLOCKS $((N + 2))
+check_counter shared -1 OVERLAP_SHARED_BLOCKS 2
+check_counter shared -1 OVERLAP_FALSE_SHARED_BLOCKS 1
+check_counter shared -1 OVERLAP_WRITER_RANKS $N
+check_counter shared -1 OVERLAP_MAX_BLOCK_WRITERS $N
+check_counter shared -1 OVERLAP_BLOCK_WRITERS_1 $N
+check_counter shared -1 OVERLAP_COARSENED_BYTES 0
+
+# opened by all ranks, so merged even though only two of them wrote
+check_counter subset -1 OVERLAP_WRITES 2
+check_counter subset -1 OVERLAP_UNIQUE_BYTES 200
+check_counter subset -1 OVERLAP_SHARED_BYTES 0
+check_counter subset -1 OVERLAP_WRITER_RANKS 2
+check_counter subset -1 OVERLAP_SHARED_BLOCKS 1
+check_counter subset -1 OVERLAP_FALSE_SHARED_BLOCKS 1
+
+# interleaved strided runs: every block is falsely shared by all ranks
+check_counter strided -1 OVERLAP_WRITES $((256 * N))
+check_counter strided -1 OVERLAP_UNIQUE_BYTES $((4096 * N))
+check_counter strided -1 OVERLAP_SHARED_BYTES 0
+check_counter strided -1 OVERLAP_BLOCKS $N
+check_counter strided -1 OVERLAP_SHARED_BLOCKS $N
+check_counter strided -1 OVERLAP_FALSE_SHARED_BLOCKS $N
+check_counter strided -1 OVERLAP_MAX_BLOCK_WRITERS $N
+check_counter strided -1 OVERLAP_COARSENED_BYTES 0
+
+# the strided run is kept exactly; coarsening the 17 irregular extents
+# merges the first 10 of them (1000000..1009020, 150 bytes written)
+check_counter coarse 0 OVERLAP_WRITES 1017
+check_counter coarse 0 OVERLAP_BYTES_WRITTEN 10250
+check_counter coarse 0 OVERLAP_REWRITE_BYTES 0
+check_counter coarse 0 OVERLAP_COARSENED_BYTES 8870
+check_counter coarse 0 OVERLAP_UNIQUE_BYTES 19120
+
+if [ $failed -ne 0 ]; then
+    exit 1
+fi
+
+exit 0
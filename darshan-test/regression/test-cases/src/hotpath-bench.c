@@ -0,0 +1,362 @@
+/*
+ *  (C) 2026 by Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+/* The purpose of this benchmark is to measure the per-call overhead Darshan
+ * adds to small, cheap I/O operations (open/close, small reads and writes,
+ * stat, fopen/fwrite and independent MPI-IO), both single-threaded and with
+ * several threads hammering the same wrappers at once.
+ *
+ * Each operation is timed over a number of iterations in every thread; the
+ * reported ns/call is the mean latency seen by one thread, and calls/s is
+ * the aggregate rate across all threads.  Results are printed as one JSON
+ * object per line so that runs with different Darshan configurations (see
+ * run-hotpath-bench.sh) can be collected and compared automatically.
+ *
+ * Usage: hotpath-bench <dir> <iters> <thread_csv> <label>
+ *
+ * Files are created under <dir>, which should be on a local or in-memory
+ * file system so that the operations themselves are as cheap as possible.
+ *
+ * Multithreaded MPI-IO runs need MPI_THREAD_MULTIPLE to issue MPI calls
+ * concurrently.  With MPI_THREAD_SERIALIZED, the MPI calls of the threads
+ * are serialized with a mutex instead (reported as "serialized": true), and
+ * with lower thread levels multithreaded MPI-IO runs are skipped.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <mpi.h>
+
+#define BENCH_MAX_THREADS 256
+#define BENCH_ACCESS_SIZE 64
+
+enum bench_op
+{
+    BENCH_OPEN_CLOSE = 0,
+    BENCH_READ,
+    BENCH_WRITE,
+    BENCH_STAT,
+    BENCH_FOPEN_FCLOSE,
+    BENCH_FWRITE,
+    BENCH_MPIIO_WRITE_AT,
+    BENCH_MPIIO_READ_AT,
+    BENCH_OP_COUNT
+};
+
+static const char *bench_op_names[BENCH_OP_COUNT] =
+{
+    "open_close",
+    "read",
+    "write",
+    "stat",
+    "fopen_fclose",
+    "fwrite",
+    "mpiio_write_at",
+    "mpiio_read_at"
+};
+
+struct bench_thread
+{
+    pthread_t tid;
+    int index;
+    enum bench_op op;
+    long iters;
+    const char *dir;
+    double elapsed;
+    int err;
+};
+
+static pthread_barrier_t bench_barrier;
+
+/* set if the MPI calls of benchmark threads must not overlap */
+static int bench_mpi_serialize;
+static pthread_mutex_t bench_mpi_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+#define BENCH_MPI_LOCK() do { \
+    if(bench_mpi_serialize) pthread_mutex_lock(&bench_mpi_mutex); \
+} while(0)
+#define BENCH_MPI_UNLOCK() do { \
+    if(bench_mpi_serialize) pthread_mutex_unlock(&bench_mpi_mutex); \
+} while(0)
+
+/* threads may not be allowed to call MPI_Wtime(), so time them without MPI */
+static double bench_wtime(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return((double)ts.tv_sec + (double)ts.tv_nsec * 1.0e-9);
+}
+
+static void *bench_thread_fn(void *arg)
+{
+    struct bench_thread *bt = arg;
+    char path[4096];
+    char buf[BENCH_ACCESS_SIZE];
+    struct stat statbuf;
+    MPI_File fh = MPI_FILE_NULL;
+    FILE *fp = NULL;
+    int fd = -1;
+    long i;
+    double t1, t2;
+    int ret;
+
+    memset(buf, 'A', sizeof(buf));
+    snprintf(path, sizeof(path), "%s/hotpath-bench.%d.%d.dat", bt->dir,
+        (int)getpid(), bt->index);
+
+    /* set up a file handle for operations that work on an open file */
+    switch(bt->op)
+    {
+        case BENCH_READ:
+        case BENCH_WRITE:
+            fd = open(path, O_RDWR|O_CREAT|O_TRUNC, S_IRUSR|S_IWUSR);
+            if(fd < 0)
+                bt->err = 1;
+            else if(bt->op == BENCH_READ &&
+                pwrite(fd, buf, sizeof(buf), 0) != sizeof(buf))
+                bt->err = 1;
+            break;
+        case BENCH_FWRITE:
+            fp = fopen(path, "w");
+            if(!fp)
+                bt->err = 1;
+            break;
+        case BENCH_MPIIO_WRITE_AT:
+        case BENCH_MPIIO_READ_AT:
+            BENCH_MPI_LOCK();
+            ret = MPI_File_open(MPI_COMM_SELF, path,
+                MPI_MODE_RDWR|MPI_MODE_CREATE, MPI_INFO_NULL, &fh);
+            if(ret != MPI_SUCCESS)
+                bt->err = 1;
+            else if(bt->op == BENCH_MPIIO_READ_AT)
+                MPI_File_write_at(fh, 0, buf, sizeof(buf), MPI_BYTE,
+                    MPI_STATUS_IGNORE);
+            BENCH_MPI_UNLOCK();
+            break;
+        default:
+            fd = open(path, O_RDWR|O_CREAT|O_TRUNC, S_IRUSR|S_IWUSR);
+            if(fd < 0)
+                bt->err = 1;
+            else
+                close(fd);
+            fd = -1;
+            break;
+    }
+
+    pthread_barrier_wait(&bench_barrier);
+
+    t1 = bench_wtime();
+    for(i = 0; i < bt->iters && !bt->err; i++)
+    {
+        switch(bt->op)
+        {
+            case BENCH_OPEN_CLOSE:
+                fd = open(path, O_RDONLY);
+                if(fd < 0 || close(fd) < 0)
+                    bt->err = 1;
+                break;
+            case BENCH_READ:
+                if(pread(fd, buf, sizeof(buf), 0) < 0)
+                    bt->err = 1;
+                break;
+            case BENCH_WRITE:
+                if(pwrite(fd, buf, sizeof(buf), 0) < 0)
+                    bt->err = 1;
+                break;
+            case BENCH_STAT:
+                if(stat(path, &statbuf) < 0)
+                    bt->err = 1;
+                break;
+            case BENCH_FOPEN_FCLOSE:
+                fp = fopen(path, "r");
+                if(!fp || fclose(fp) != 0)
+                    bt->err = 1;
+                fp = NULL;
+                break;
+            case BENCH_FWRITE:
+                if(fwrite(buf, 1, sizeof(buf), fp) != sizeof(buf))
+                    bt->err = 1;
+                /* keep the file small; the rewind is instrumented too */
+                if((i % 1024) == 1023)
+                    rewind(fp);
+                break;
+            case BENCH_MPIIO_WRITE_AT:
+                BENCH_MPI_LOCK();
+                if(MPI_File_write_at(fh, 0, buf, sizeof(buf), MPI_BYTE,
+                    MPI_STATUS_IGNORE) != MPI_SUCCESS)
+                    bt->err = 1;
+                BENCH_MPI_UNLOCK();
+                break;
+            case BENCH_MPIIO_READ_AT:
+                BENCH_MPI_LOCK();
+                if(MPI_File_read_at(fh, 0, buf, sizeof(buf), MPI_BYTE,
+                    MPI_STATUS_IGNORE) != MPI_SUCCESS)
+                    bt->err = 1;
+                BENCH_MPI_UNLOCK();
+                break;
+            default:
+                assert(0);
+        }
+    }
+    t2 = bench_wtime();
+    bt->elapsed = t2 - t1;
+
+    if(fd >= 0)
+        close(fd);
+    if(fp)
+        fclose(fp);
+    if(fh != MPI_FILE_NULL)
+    {
+        BENCH_MPI_LOCK();
+        MPI_File_close(&fh);
+        BENCH_MPI_UNLOCK();
+    }
+    unlink(path);
+
+    return(NULL);
+}
+
+static int bench_run(enum bench_op op, int nthreads, long iters,
+    const char *dir, const char *label, int serialize)
+{
+    struct bench_thread threads[BENCH_MAX_THREADS];
+    double elapsed_sum = 0, elapsed_max = 0;
+    int i;
+    int err = 0;
+
+    bench_mpi_serialize = serialize;
+    pthread_barrier_init(&bench_barrier, NULL, nthreads);
+    for(i = 0; i < nthreads; i++)
+    {
+        memset(&threads[i], 0, sizeof(threads[i]));
+        threads[i].index = i;
+        threads[i].op = op;
+        threads[i].iters = iters;
+        threads[i].dir = dir;
+        /* a single thread runs on the main thread, which may always call
+         * MPI, whatever thread level was provided
+         */
+        if(nthreads > 1)
+            pthread_create(&threads[i].tid, NULL, bench_thread_fn, &threads[i]);
+    }
+    if(nthreads == 1)
+        bench_thread_fn(&threads[0]);
+    for(i = 0; i < nthreads; i++)
+    {
+        if(nthreads > 1)
+            pthread_join(threads[i].tid, NULL);
+        err |= threads[i].err;
+        elapsed_sum += threads[i].elapsed;
+        if(threads[i].elapsed > elapsed_max)
+            elapsed_max = threads[i].elapsed;
+    }
+    pthread_barrier_destroy(&bench_barrier);
+
+    if(err)
+    {
+        fprintf(stderr, "Error: %s failed with %d thread(s).\n",
+            bench_op_names[op], nthreads);
+        return(-1);
+    }
+
+    printf("{\"label\": \"%s\", \"op\": \"%s\", \"threads\": %d, "
+        "\"iters\": %ld, \"ns_per_call\": %.2f, \"calls_per_sec\": %.1f, "
+        "\"serialized\": %s}\n",
+        label, bench_op_names[op], nthreads, iters,
+        (elapsed_sum / (double)nthreads) * 1.0e9 / (double)iters,
+        ((double)iters * nthreads) / elapsed_max,
+        serialize ? "true" : "false");
+    fflush(stdout);
+
+    return(0);
+}
+
+int main(int argc, char **argv)
+{
+    int nthread_list[BENCH_MAX_THREADS];
+    int nthread_count = 0;
+    int provided;
+    int npes;
+    long iters;
+    char *csv, *tok, *saveptr;
+    int is_mpiio, serialize;
+    int i, j;
+    int ret = 0;
+
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+
+    if(argc != 5 || sscanf(argv[2], "%ld", &iters) != 1 || iters <= 0)
+    {
+        fprintf(stderr, "Usage: %s <dir> <iters> <thread_csv> <label>\n",
+            argv[0]);
+        MPI_Finalize();
+        return(-1);
+    }
+
+    MPI_Comm_size(MPI_COMM_WORLD, &npes);
+    if(npes != 1)
+    {
+        fprintf(stderr, "Error: one rank only please.\n");
+        MPI_Finalize();
+        return(-1);
+    }
+
+    csv = strdup(argv[3]);
+    assert(csv);
+    for(tok = strtok_r(csv, ",", &saveptr);
+        tok && nthread_count < BENCH_MAX_THREADS;
+        tok = strtok_r(NULL, ",", &saveptr))
+    {
+        nthread_list[nthread_count] = atoi(tok);
+        if(nthread_list[nthread_count] < 1 ||
+            nthread_list[nthread_count] > BENCH_MAX_THREADS)
+        {
+            fprintf(stderr, "Error: invalid thread count %s.\n", tok);
+            MPI_Finalize();
+            return(-1);
+        }
+        nthread_count++;
+    }
+    free(csv);
+
+    for(i = 0; i < BENCH_OP_COUNT && ret == 0; i++)
+    {
+        for(j = 0; j < nthread_count && ret == 0; j++)
+        {
+            /* concurrent MPI-IO from several threads needs full thread
+             * support; fall back to serialized MPI calls if the MPI library
+             * only allows one thread in MPI at a time, and skip the run if
+             * it only allows the main thread
+             */
+            is_mpiio = (i == BENCH_MPIIO_WRITE_AT || i == BENCH_MPIIO_READ_AT);
+            serialize = 0;
+            if(is_mpiio && nthread_list[j] > 1 && provided < MPI_THREAD_MULTIPLE)
+            {
+                if(provided < MPI_THREAD_SERIALIZED)
+                {
+                    fprintf(stderr, "Warning: skipping %s with %d threads, "
+                        "MPI_THREAD_SERIALIZED is not supported.\n",
+                        bench_op_names[i], nthread_list[j]);
+                    continue;
+                }
+                serialize = 1;
+            }
+            ret = bench_run(i, nthread_list[j], iters, argv[1], argv[4],
+                serialize);
+        }
+    }
+
+    MPI_Finalize();
+    return(ret);
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2026 University of Chicago.
+ * See COPYRIGHT notice in top-level directory.
+ *
+ */
+
+/* writes known patterns to four files so that the counters of Darshan's
+ * OVERLAP module can be checked exactly.  Expects a block size of 4096
+ * bytes, an extent limit of 16, and 2 to 8 ranks:
+ *
+ * <file>.shared:  every rank writes 512 bytes at rank*512 (block 0 is
+ *                 falsely shared), the same 512 bytes at 4096 (block 1 is
+ *                 truly shared) and block 2+rank on its own; rank 0 then
+ *                 rewrites its first 512 bytes
+ * <file>.subset:  opened by every rank, but only ranks 0 and 1 write 100
+ *                 bytes each at rank*100
+ * <file>.strided: rank r writes 256 extents of 16 bytes at (i*nprocs+r)*16,
+ *                 which interleave without overlapping
+ * <file>.coarse:  written by rank 0 only: 1000 strided extents that are
+ *                 stored as a single run, then 17 irregular extents that
+ *                 exceed the extent limit and get coarsened
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <mpi.h>
+#include <getopt.h>
+#include <sys/stat.h>
+
+#define BLOCK_SIZE 4096
+#define COARSE_BASE 1000000
+
+/* DEFAULT VALUES FOR OPTIONS */
+static char    opt_file[256] = "test.out";
+
+/* function prototypes */
+static int parse_args(int argc, char **argv);
+static void usage(void);
+static void file_path(const char *suffix, char *path, int len);
+static int open_file(const char *suffix);
+static int write_at(int fd, int len, off_t off);
+
+/* global vars */
+static int mynod = 0;
+static int nprocs = 1;
+
+int main(int argc, char **argv)
+{
+   char path[300];
+   const char *suffixes[] = {"shared", "subset", "strided", "coarse"};
+   int fd;
+   int i;
+
+   /* startup MPI and determine the rank of this process */
+   MPI_Init(&argc,&argv);
+   MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+   MPI_Comm_rank(MPI_COMM_WORLD, &mynod);
+
+   /* parse the command line arguments */
+   parse_args(argc, argv);
+
+   if(nprocs < 2 || nprocs > 8)
+   {
+      if(mynod == 0)
+         fprintf(stderr, "Error: overlap-test needs 2 to 8 ranks\n");
+      MPI_Abort(MPI_COMM_WORLD, 1);
+   }
+
+   /* remove the files of a previous run */
+   if(mynod == 0)
+   {
+      for(i = 0; i < 4; i++)
+      {
+         file_path(suffixes[i], path, sizeof(path));
+         unlink(path);
+      }
+   }
+   MPI_Barrier(MPI_COMM_WORLD);
+
+   fd = open_file("shared");
+   if(write_at(fd, 512, mynod * 512) < 0 ||
+      write_at(fd, 512, BLOCK_SIZE) < 0 ||
+      write_at(fd, BLOCK_SIZE, (off_t)(2 + mynod) * BLOCK_SIZE) < 0)
+      MPI_Abort(MPI_COMM_WORLD, 1);
+   if(mynod == 0 && write_at(fd, 512, 0) < 0)
+      MPI_Abort(MPI_COMM_WORLD, 1);
+   close(fd);
+
+   fd = open_file("subset");
+   if(mynod < 2 && write_at(fd, 100, mynod * 100) < 0)
+      MPI_Abort(MPI_COMM_WORLD, 1);
+   close(fd);
+
+   fd = open_file("strided");
+   for(i = 0; i < 256; i++)
+   {
+      if(write_at(fd, 16, (off_t)(i * nprocs + mynod) * 16) < 0)
+         MPI_Abort(MPI_COMM_WORLD, 1);
+   }
+   close(fd);
+
+   if(mynod == 0)
+   {
+      fd = open_file("coarse");
+      for(i = 0; i < 1000; i++)
+      {
+         if(write_at(fd, 10, (off_t)i * 100) < 0)
+            MPI_Abort(MPI_COMM_WORLD, 1);
+      }
+      /* alternating lengths keep these from forming a strided run */
+      for(i = 0; i < 17; i++)
+      {
+         if(write_at(fd, (i % 2) ? 20 : 10, COARSE_BASE + (off_t)i * 1000) < 0)
+            MPI_Abort(MPI_COMM_WORLD, 1);
+      }
+      close(fd);
+   }
+
+   MPI_Finalize();
+   return(0);
+}
+
+static void file_path(const char *suffix, char *path, int len)
+{
+   snprintf(path, len, "%s.%s", opt_file, suffix);
+}
+
+static int open_file(const char *suffix)
+{
+   char path[300];
+   int fd;
+
+   file_path(suffix, path, sizeof(path));
+   fd = open(path, O_WRONLY|O_CREAT, S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP);
+   if(fd < 0)
+   {
+      perror("open");
+      MPI_Abort(MPI_COMM_WORLD, 1);
+   }
+   return(fd);
+}
+
+static int write_at(int fd, int len, off_t off)
+{
+   char buffer[BLOCK_SIZE];
+   ssize_t ret;
+
+   memset(buffer, 'a' + mynod, len);
+   ret = pwrite(fd, buffer, len, off);
+   if(ret < 0)
+   {
+      perror("pwrite");
+      return(-1);
+   }
+   if(ret != len)
+   {
+      fprintf(stderr, "Short write: %zd\n", ret);
+      return(-1);
+   }
+   return(0);
+}
+
+static int parse_args(int argc, char **argv)
+{
+   int c;
+
+   while ((c = getopt(argc, argv, "f:")) != EOF) {
+      switch (c) {
+         case 'f': /* filename */
+            strncpy(opt_file, optarg, 255);
+            break;
+         case '?': /* unknown */
+            if (mynod == 0)
+                usage();
+            exit(1);
+         default:
+            break;
+      }
+   }
+   return(0);
+}
+
+static void usage(void)
+{
+    printf("Usage: overlap-test [<OPTIONS>...]\n");
+    printf("\n<OPTIONS> is one of\n");
+    printf(" -f       filename prefix [default: test.out]\n");
+    printf(" -h       print this help\n");
+}
+
+/*
+ * Local variables:
+ *  c-indent-level: 3
+ *  c-basic-offset: 3
+ *  tab-width: 3
+ *
+ * vim: ts=3
+ * End:
+ */
@@ -8,10 +8,17 @@
 # include "darshan-util-config.h"
 #endif
 
+#define _GNU_SOURCE
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include <errno.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <pthread.h>
 #include <ftw.h>
 #include <zlib.h>
 
@@ -22,6 +29,146 @@
 #define BUCKET3 0.60
 #define BUCKET4 0.80
 
+#define OPTION_OUTPUT 'o'
+#define OPTION_FORMAT 'f'
+#define OPTION_THREADS 'T'
+#define OPTION_CHECKPOINT 'c'
+#define OPTION_FILE_LIST 'l'
+
+/* Batch mode writes one row of job-level metrics per log.  Logs are
+ * analyzed by a pool of threads, each of which owns a range of the file
+ * list and steals half of another thread's remaining range when its own
+ * runs out.  Only the header, job region, and the regions of the modules
+ * in batch_mods are read from each log.
+ *
+ * Rows are written in batches of BATCH_ROWS, either as CSV or as blocks
+ * of the columnar format of darshan-parser (see darshan-parser-formats.c),
+ * using module id BATCH_BLOCK_MOD_ID and block name "JOBS".  After each
+ * batch, a hash of every log path in it is appended to the checkpoint
+ * file, followed by a line holding the output size ("@<bytes>").  A rerun
+ * with the same checkpoint drops any output past the last such line and
+ * only analyzes logs that are not in the checkpoint yet.
+ */
+#define BATCH_ROWS 4096
+#define BATCH_NAMES_LEN 512
+#define BATCH_MAX_COLS 64
+#define BATCH_COLUMNAR_MAGIC "DSHNCOL1"
+#define BATCH_COLUMNAR_BOM 0x01020304
+#define BATCH_BLOCK_MOD_ID 0xffffffff
+#define BATCH_BLOCK_NAME "JOBS"
+
+enum batch_format
+{
+    BATCH_FORMAT_CSV = 0,
+    BATCH_FORMAT_COLUMNAR
+};
+
+/* column types; values match the columnar format's type codes */
+enum batch_col_type
+{
+    BATCH_COL_INT64 = 0,
+    BATCH_COL_UINT64 = 1,
+    BATCH_COL_DOUBLE = 2,
+    BATCH_COL_STRING = 3
+};
+
+/* modules whose records are summarized through the accumulator API */
+static const int batch_mods[] = {DARSHAN_POSIX_MOD, DARSHAN_MPIIO_MOD, DARSHAN_STDIO_MOD};
+static const char *batch_mod_prefixes[] = {"posix", "mpiio", "stdio"};
+#define BATCH_NMODS (int)(sizeof(batch_mods) / sizeof(batch_mods[0]))
+
+struct batch_mod_metrics
+{
+    int64_t files;
+    int64_t shared_files;
+    int64_t bytes_read;
+    int64_t bytes_written;
+    double time_by_slowest;
+    double perf_by_slowest; /* MiB/s */
+};
+
+struct batch_row
+{
+    const char *log_path;
+    int64_t jobid;
+    int64_t uid;
+    int64_t nprocs;
+    int64_t start_time;
+    int64_t end_time;
+    double run_time;
+    /* space-separated names of the modules with data, and of those
+     * whose data is incomplete
+     */
+    char modules[BATCH_NAMES_LEN];
+    char partial_modules[BATCH_NAMES_LEN];
+    struct batch_mod_metrics mods[BATCH_NMODS];
+};
+
+struct batch_col
+{
+    char name[64];
+    enum batch_col_type type;
+    size_t offset;
+    int is_ptr; /* string column holding a pointer rather than an array */
+};
+
+/* range of the file list still to be analyzed by one thread */
+struct batch_queue
+{
+    pthread_mutex_t mutex;
+    int64_t head;
+    int64_t tail;
+};
+
+struct batch_state
+{
+    char **paths;
+    int64_t n_paths;
+    struct batch_queue *queues;
+    int n_queues;
+    /* rows waiting to be written, and the error flag that stops the
+     * workers, serialized by mutex
+     */
+    pthread_mutex_t mutex;
+    struct batch_row *rows;
+    int n_rows;
+    int64_t n_failed;
+    int err;
+    /* output, serialized by out_mutex */
+    pthread_mutex_t out_mutex;
+    enum batch_format format;
+    FILE *out;
+    FILE *ckpt;
+    int64_t n_written;
+};
+
+struct batch_worker_arg
+{
+    struct batch_state *bs;
+    int idx;
+};
+
+/* hash of log paths, implemented in lookup3.c */
+extern void hashlittle2(const void *key, size_t length, uint32_t *pc, uint32_t *pb);
+
+static struct batch_col batch_cols[BATCH_MAX_COLS];
+static int n_batch_cols;
+
+/* file list built by batch_tree_walk() */
+static char **batch_paths;
+static int64_t n_batch_paths;
+static int64_t batch_paths_size;
+static uint64_t *batch_done;
+static int64_t n_batch_done;
+static int64_t n_batch_skipped;
+
+static void usage(char *exename);
+static void parse_args(int argc, char **argv, char **out_path,
+    enum batch_format *format, int *n_threads, char **ckpt_path,
+    char **list_path);
+static int batch_run(char **inputs, int n_inputs, char *out_path,
+    enum batch_format format, int n_threads, char *ckpt_path, char *list_path);
+
 int total_shared = 0;
 int total_fpp    = 0;
 int total_mpio   = 0;
@@ -152,14 +299,25 @@ int main(int argc, char **argv)
 {
     char * base = NULL;
     int ret = 0;
+    char *out_path;
+    enum batch_format format;
+    int n_threads;
+    char *ckpt_path;
+    char *list_path;
+
+    parse_args(argc, argv, &out_path, &format, &n_threads, &ckpt_path, &list_path);
 
-    if(argc != 2)
+    if(out_path)
+        return(batch_run(&argv[optind], argc - optind, out_path, format,
+            n_threads, ckpt_path, list_path));
+
+    if(argc - optind != 1)
     {
         fprintf(stderr, "Error: directory of Darshan logs required as argument.\n");
         return(-1);
     }
 
-    base = argv[1];
+    base = argv[optind];
 
     ret = ftw(base, tree_walk, 512);
     if(ret != 0)
@@ -184,6 +342,803 @@ int main(int argc, char **argv)
     return 0;
 }
 
+static void usage(char *exename)
+{
+    fprintf(stderr, "Usage: %s <log directory>\n", exename);
+    fprintf(stderr, "       %s --output=<file> [options] [<log directory or file> ...]\n", exename);
+    fprintf(stderr, "Without --output, prints access pattern totals for the logs in a directory.\n");
+    fprintf(stderr, "With --output, writes one row of job-level metrics per log:\n");
+    fprintf(stderr, "    --output=<file> : table to write\n");
+    fprintf(stderr, "    --format=<fmt> : csv (default) or columnar\n");
+    fprintf(stderr, "    --threads=<n> : number of threads analyzing logs (default: online CPUs)\n");
+    fprintf(stderr, "    --checkpoint=<file> : record analyzed logs in <file>, and resume from it\n");
+    fprintf(stderr, "    --file-list=<file> : also analyze the logs listed in <file>, one per line\n");
+    fprintf(stderr, "                         (\"-\" for stdin)\n");
+
+    exit(1);
+}
+
+static void parse_args(int argc, char **argv, char **out_path,
+    enum batch_format *format, int *n_threads, char **ckpt_path,
+    char **list_path)
+{
+    int index;
+    char *check;
+    static struct option long_opts[] =
+    {
+        {"output", required_argument, NULL, OPTION_OUTPUT},
+        {"format", required_argument, NULL, OPTION_FORMAT},
+        {"threads", required_argument, NULL, OPTION_THREADS},
+        {"checkpoint", required_argument, NULL, OPTION_CHECKPOINT},
+        {"file-list", required_argument, NULL, OPTION_FILE_LIST},
+        {"help",  0, NULL, 0},
+        {0, 0, 0, 0}
+    };
+
+    *out_path = NULL;
+    *format = BATCH_FORMAT_CSV;
+    *n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if(*n_threads < 1)
+        *n_threads = 1;
+    *ckpt_path = NULL;
+    *list_path = NULL;
+
+    while(1)
+    {
+        int c = getopt_long(argc, argv, "", long_opts, &index);
+
+        if(c == -1) break;
+
+        switch(c)
+        {
+            case OPTION_OUTPUT:
+                *out_path = optarg;
+                break;
+            case OPTION_FORMAT:
+                if(strcmp(optarg, "csv") == 0)
+                    *format = BATCH_FORMAT_CSV;
+                else if(strcmp(optarg, "columnar") == 0)
+                    *format = BATCH_FORMAT_COLUMNAR;
+                else
+                {
+                    fprintf(stderr, "Error: invalid output format.\n");
+                    usage(argv[0]);
+                }
+                break;
+            case OPTION_THREADS:
+                *n_threads = strtol(optarg, &check, 10);
+                if(optarg == check || *check != '\0' || *n_threads < 1)
+                {
+                    fprintf(stderr, "Error: invalid number of threads.\n");
+                    usage(argv[0]);
+                }
+                break;
+            case OPTION_CHECKPOINT:
+                *ckpt_path = optarg;
+                break;
+            case OPTION_FILE_LIST:
+                *list_path = optarg;
+                break;
+            case 0:
+            case '?':
+            default:
+                usage(argv[0]);
+                break;
+        }
+    }
+
+    if(!(*out_path) && (*ckpt_path || *list_path))
+    {
+        fprintf(stderr, "Error: --checkpoint and --file-list require --output.\n");
+        usage(argv[0]);
+    }
+    if(*out_path && optind == argc && !(*list_path))
+        usage(argv[0]);
+
+    return;
+}
+
+/**** internal helper functions ****/
+
+static uint64_t batch_path_hash(const char *path)
+{
+    uint32_t h1 = 0, h2 = 0;
+
+    hashlittle2(path, strlen(path), &h1, &h2);
+    return(((uint64_t)h2 << 32) | h1);
+}
+
+static int batch_cmp_hash(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return((x > y) - (x < y));
+}
+
+static void batch_add_col(const char *name, enum batch_col_type type,
+    size_t offset, int is_ptr)
+{
+    struct batch_col *col = &batch_cols[n_batch_cols++];
+
+    assert(n_batch_cols <= BATCH_MAX_COLS);
+    snprintf(col->name, sizeof(col->name), "%s", name);
+    col->type = type;
+    col->offset = offset;
+    col->is_ptr = is_ptr;
+}
+
+static void batch_init_cols(void)
+{
+    char name[64];
+    size_t base;
+    int i;
+
+    batch_add_col("log", BATCH_COL_STRING, offsetof(struct batch_row, log_path), 1);
+    batch_add_col("jobid", BATCH_COL_INT64, offsetof(struct batch_row, jobid), 0);
+    batch_add_col("uid", BATCH_COL_INT64, offsetof(struct batch_row, uid), 0);
+    batch_add_col("nprocs", BATCH_COL_INT64, offsetof(struct batch_row, nprocs), 0);
+    batch_add_col("start_time", BATCH_COL_INT64, offsetof(struct batch_row, start_time), 0);
+    batch_add_col("end_time", BATCH_COL_INT64, offsetof(struct batch_row, end_time), 0);
+    batch_add_col("run_time", BATCH_COL_DOUBLE, offsetof(struct batch_row, run_time), 0);
+    batch_add_col("modules", BATCH_COL_STRING, offsetof(struct batch_row, modules), 0);
+    batch_add_col("partial_modules", BATCH_COL_STRING, offsetof(struct batch_row, partial_modules), 0);
+    for(i = 0; i < BATCH_NMODS; i++)
+    {
+        base = offsetof(struct batch_row, mods) + i * sizeof(struct batch_mod_metrics);
+#define BATCH_MOD_COL(__field, __type) \
+        snprintf(name, sizeof(name), "%s_%s", batch_mod_prefixes[i], #__field); \
+        batch_add_col(name, __type, base + offsetof(struct batch_mod_metrics, __field), 0)
+        BATCH_MOD_COL(files, BATCH_COL_INT64);
+        BATCH_MOD_COL(shared_files, BATCH_COL_INT64);
+        BATCH_MOD_COL(bytes_read, BATCH_COL_INT64);
+        BATCH_MOD_COL(bytes_written, BATCH_COL_INT64);
+        BATCH_MOD_COL(time_by_slowest, BATCH_COL_DOUBLE);
+        BATCH_MOD_COL(perf_by_slowest, BATCH_COL_DOUBLE);
+#undef BATCH_MOD_COL
+    }
+}
+
+static const char *batch_row_str(const struct batch_row *row, const struct batch_col *col)
+{
+    const char *field = (const char *)row + col->offset;
+
+    return(col->is_ptr ? *(const char * const *)field : field);
+}
+
+static int batch_tree_walk(const char *fpath, const struct stat *sb,
+    int typeflag, struct FTW *ftwbuf)
+{
+    char **tmp;
+    uint64_t hash;
+
+    (void)sb;
+    (void)ftwbuf;
+    if(typeflag != FTW_F) return(0);
+
+    /* skip logs that were analyzed by a previous run */
+    if(n_batch_done > 0)
+    {
+        hash = batch_path_hash(fpath);
+        if(bsearch(&hash, batch_done, n_batch_done, sizeof(*batch_done), batch_cmp_hash))
+        {
+            n_batch_skipped++;
+            return(0);
+        }
+    }
+
+    if(n_batch_paths == batch_paths_size)
+    {
+        batch_paths_size = batch_paths_size ? batch_paths_size * 2 : 1024;
+        tmp = realloc(batch_paths, batch_paths_size * sizeof(*batch_paths));
+        if(!tmp)
+            return(-1);
+        batch_paths = tmp;
+    }
+    batch_paths[n_batch_paths] = strdup(fpath);
+    if(!batch_paths[n_batch_paths])
+        return(-1);
+    n_batch_paths++;
+
+    return(0);
+}
+
+static int batch_read_file_list(const char *list_path)
+{
+    FILE *f;
+    char *line = NULL;
+    size_t line_size = 0;
+    ssize_t len;
+    int ret = 0;
+
+    f = strcmp(list_path, "-") == 0 ? stdin : fopen(list_path, "r");
+    if(!f)
+    {
+        fprintf(stderr, "Error: unable to open file list %s.\n", list_path);
+        return(-1);
+    }
+    while((len = getline(&line, &line_size, f)) > 0)
+    {
+        while(len > 0 && (line[len-1] == '\n' || line[len-1] == '\r'))
+            line[--len] = '\0';
+        if(len == 0)
+            continue;
+        if(batch_tree_walk(line, NULL, FTW_F, NULL) != 0)
+        {
+            ret = -1;
+            break;
+        }
+    }
+    free(line);
+    if(f != stdin)
+        fclose(f);
+
+    return(ret);
+}
+
+/* read the hashes of the logs whose rows made it into the output, and the
+ * output size at that point; anything recorded after the last complete
+ * batch is dropped from the checkpoint
+ */
+static int batch_load_checkpoint(const char *ckpt_path, int64_t *out_size)
+{
+    FILE *f;
+    char *line = NULL;
+    size_t line_size = 0;
+    int64_t n_hashes = 0, hashes_size = 0;
+    off_t ckpt_size = 0;
+    uint64_t *tmp;
+    char *check;
+    int ret = 0;
+
+    *out_size = -1;
+    f = fopen(ckpt_path, "r");
+    if(!f)
+        return(errno == ENOENT ? 0 : -1);
+
+    while(getline(&line, &line_size, f) > 0)
+    {
+        if(line[0] == '@')
+        {
+            *out_size = strtoll(line + 1, &check, 10);
+            if(check == line + 1 || *out_size < 0)
+            {
+                ret = -1;
+                break;
+            }
+            n_batch_done = n_hashes;
+            ckpt_size = ftello(f);
+            continue;
+        }
+        if(n_hashes == hashes_size)
+        {
+            hashes_size = hashes_size ? hashes_size * 2 : 4096;
+            tmp = realloc(batch_done, hashes_size * sizeof(*batch_done));
+            if(!tmp)
+            {
+                ret = -1;
+                break;
+            }
+            batch_done = tmp;
+        }
+        batch_done[n_hashes] = strtoull(line, &check, 16);
+        if(check == line)
+        {
+            ret = -1;
+            break;
+        }
+        n_hashes++;
+    }
+    free(line);
+    fclose(f);
+    if(ret < 0)
+        return(ret);
+
+    if(truncate(ckpt_path, ckpt_size) < 0)
+        return(-1);
+    qsort(batch_done, n_batch_done, sizeof(*batch_done), batch_cmp_hash);
+
+    return(0);
+}
+
+static void batch_write_csv_str(FILE *f, const char *str)
+{
+    if(!strpbrk(str, ",\"\n\r"))
+    {
+        fputs(str, f);
+        return;
+    }
+    fputc('"', f);
+    for(; *str; str++)
+    {
+        if(*str == '"')
+            fputc('"', f);
+        fputc(*str, f);
+    }
+    fputc('"', f);
+}
+
+static void batch_write_header(struct batch_state *bs)
+{
+    uint32_t bom = BATCH_COLUMNAR_BOM;
+    int i;
+
+    if(bs->format == BATCH_FORMAT_COLUMNAR)
+    {
+        fwrite(BATCH_COLUMNAR_MAGIC, 1, strlen(BATCH_COLUMNAR_MAGIC), bs->out);
+        fwrite(&bom, sizeof(bom), 1, bs->out);
+        return;
+    }
+
+    for(i = 0; i < n_batch_cols; i++)
+        fprintf(bs->out, "%s%s", i ? "," : "", batch_cols[i].name);
+    fputc('\n', bs->out);
+}
+
+static void batch_write_csv(struct batch_state *bs, struct batch_row *rows, int n_rows)
+{
+    const char *field;
+    int i, j;
+
+    for(i = 0; i < n_rows; i++)
+    {
+        for(j = 0; j < n_batch_cols; j++)
+        {
+            field = (const char *)&rows[i] + batch_cols[j].offset;
+            if(j > 0)
+                fputc(',', bs->out);
+            switch(batch_cols[j].type)
+            {
+                case BATCH_COL_INT64:
+                    fprintf(bs->out, "%" PRId64, *(const int64_t *)field);
+                    break;
+                case BATCH_COL_UINT64:
+                    fprintf(bs->out, "%" PRIu64, *(const uint64_t *)field);
+                    break;
+                case BATCH_COL_DOUBLE:
+                    fprintf(bs->out, "%.6f", *(const double *)field);
+                    break;
+                case BATCH_COL_STRING:
+                    batch_write_csv_str(bs->out, batch_row_str(&rows[i], &batch_cols[j]));
+                    break;
+            }
+        }
+        fputc('\n', bs->out);
+    }
+}
+
+static void batch_write_columnar(struct batch_state *bs, struct batch_row *rows, int n_rows)
+{
+    uint32_t mod_id = BATCH_BLOCK_MOD_ID;
+    uint32_t ncols = n_batch_cols;
+    uint64_t nrows = n_rows;
+    uint64_t end;
+    uint16_t name_len;
+    uint8_t type;
+    const char *str;
+    int i, j;
+
+    name_len = strlen(BATCH_BLOCK_NAME);
+    fwrite(&mod_id, sizeof(mod_id), 1, bs->out);
+    fwrite(&name_len, sizeof(name_len), 1, bs->out);
+    fwrite(BATCH_BLOCK_NAME, 1, name_len, bs->out);
+    fwrite(&ncols, sizeof(ncols), 1, bs->out);
+    fwrite(&nrows, sizeof(nrows), 1, bs->out);
+
+    for(j = 0; j < n_batch_cols; j++)
+    {
+        name_len = strlen(batch_cols[j].name);
+        type = batch_cols[j].type;
+        fwrite(&name_len, sizeof(name_len), 1, bs->out);
+        fwrite(batch_cols[j].name, 1, name_len, bs->out);
+        fwrite(&type, sizeof(type), 1, bs->out);
+
+        if(batch_cols[j].type != BATCH_COL_STRING)
+        {
+            /* all numeric columns are 8 bytes wide */
+            for(i = 0; i < n_rows; i++)
+                fwrite((const char *)&rows[i] + batch_cols[j].offset, 8, 1, bs->out);
+            continue;
+        }
+
+        /* string end offsets, then the string bytes */
+        end = 0;
+        for(i = 0; i < n_rows; i++)
+        {
+            end += strlen(batch_row_str(&rows[i], &batch_cols[j]));
+            fwrite(&end, sizeof(end), 1, bs->out);
+        }
+        for(i = 0; i < n_rows; i++)
+        {
+            str = batch_row_str(&rows[i], &batch_cols[j]);
+            fwrite(str, 1, strlen(str), bs->out);
+        }
+    }
+}
+
+/* write a batch of rows and record them in the checkpoint */
+static void batch_write_rows(struct batch_state *bs, struct batch_row *rows, int n_rows)
+{
+    off_t out_size;
+    int err = 0;
+    int i;
+
+    if(n_rows == 0)
+        return;
+
+    pthread_mutex_lock(&bs->out_mutex);
+    if(bs->format == BATCH_FORMAT_COLUMNAR)
+        batch_write_columnar(bs, rows, n_rows);
+    else
+        batch_write_csv(bs, rows, n_rows);
+    if(fflush(bs->out) != 0 || ferror(bs->out))
+        err = 1;
+    else if(bs->ckpt)
+    {
+        out_size = ftello(bs->out);
+        for(i = 0; i < n_rows; i++)
+            fprintf(bs->ckpt, "%016" PRIx64 "\n", batch_path_hash(rows[i].log_path));
+        fprintf(bs->ckpt, "@%" PRId64 "\n", (int64_t)out_size);
+        if(fflush(bs->ckpt) != 0 || ferror(bs->ckpt))
+            err = 1;
+    }
+    bs->n_written += n_rows;
+    pthread_mutex_unlock(&bs->out_mutex);
+
+    if(err)
+    {
+        pthread_mutex_lock(&bs->mutex);
+        bs->err = 1;
+        pthread_mutex_unlock(&bs->mutex);
+    }
+
+    return;
+}
+
+static void batch_add_row(struct batch_state *bs, struct batch_row *row)
+{
+    struct batch_row *full = NULL;
+    int n_full = 0;
+
+    pthread_mutex_lock(&bs->mutex);
+    bs->rows[bs->n_rows++] = *row;
+    if(bs->n_rows == BATCH_ROWS)
+    {
+        /* hand the full batch to this thread for writing */
+        full = bs->rows;
+        n_full = bs->n_rows;
+        bs->rows = malloc(BATCH_ROWS * sizeof(*bs->rows));
+        bs->n_rows = 0;
+        if(!bs->rows)
+        {
+            /* keep the full batch around, and stop the other threads */
+            bs->rows = full;
+            bs->n_rows = n_full;
+            bs->err = 1;
+            full = NULL;
+        }
+    }
+    pthread_mutex_unlock(&bs->mutex);
+
+    if(full)
+    {
+        batch_write_rows(bs, full, n_full);
+        free(full);
+    }
+
+    return;
+}
+
+/* gather the job metadata and per-module metrics of one log, reading only
+ * the header, the job region, and the regions of the modules in batch_mods
+ */
+static int batch_analyze_log(const char *path, struct batch_row *row,
+    char *rec_buf, char *agg_buf)
+{
+    darshan_fd fd;
+    struct darshan_job job;
+    darshan_accumulator acc;
+    struct darshan_derived_metrics metrics;
+    struct batch_mod_metrics *mm;
+    size_t len = 0, plen = 0;
+    int i, mod_id, ret;
+
+    memset(row, 0, sizeof(*row));
+    row->log_path = path;
+
+    fd = darshan_log_open(path);
+    if(!fd)
+        return(-1);
+
+    ret = darshan_log_get_job(fd, &job);
+    if(ret < 0)
+    {
+        fprintf(stderr, "Error: unable to read job data from %s.\n", path);
+        darshan_log_close(fd);
+        return(-1);
+    }
+    row->jobid = job.jobid;
+    row->uid = job.uid;
+    row->nprocs = job.nprocs;
+    row->start_time = job.start_time_sec;
+    row->end_time = job.end_time_sec;
+    darshan_log_get_job_runtime(fd, job, &row->run_time);
+
+    for(i = 0; i < DARSHAN_MAX_MODS; i++)
+    {
+        if(fd->mod_map[i].len == 0 || i >= DARSHAN_KNOWN_MODULE_COUNT)
+            continue;
+        len += snprintf(row->modules + len, BATCH_NAMES_LEN - len, "%s%s",
+            len ? " " : "", darshan_module_names[i]);
+        if(DARSHAN_MOD_FLAG_ISSET(fd->partial_flag, i))
+            plen += snprintf(row->partial_modules + plen, BATCH_NAMES_LEN - plen,
+                "%s%s", plen ? " " : "", darshan_module_names[i]);
+    }
+
+    for(i = 0; i < BATCH_NMODS; i++)
+    {
+        mod_id = batch_mods[i];
+        mm = &row->mods[i];
+        if(fd->mod_map[mod_id].len == 0 || !mod_logutils[mod_id])
+            continue;
+
+        if(darshan_accumulator_create(mod_id, job.nprocs, &acc) != 0)
+            continue;
+        while((ret = mod_logutils[mod_id]->log_get_record(fd, (void **)&rec_buf)) == 1)
+        {
+            darshan_accumulator_inject(acc, rec_buf, 1);
+            memset(rec_buf, 0, DEF_MOD_BUF_SIZE);
+        }
+        if(ret == 0)
+            ret = darshan_accumulator_emit(acc, &metrics, agg_buf);
+        darshan_accumulator_destroy(acc);
+        if(ret < 0)
+        {
+            fprintf(stderr, "Error: unable to read %s records from %s.\n",
+                darshan_module_names[mod_id], path);
+            darshan_log_close(fd);
+            return(-1);
+        }
+
+        mm->files = metrics.category_counters[DARSHAN_ALL_FILES].count;
+        mm->shared_files = metrics.category_counters[DARSHAN_SHARED_FILES].count;
+        mm->bytes_read = metrics.category_counters[DARSHAN_ALL_FILES].total_read_volume_bytes;
+        mm->bytes_written = metrics.category_counters[DARSHAN_ALL_FILES].total_write_volume_bytes;
+        mm->time_by_slowest = metrics.agg_time_by_slowest;
+        mm->perf_by_slowest = metrics.agg_perf_by_slowest;
+    }
+
+    darshan_log_close(fd);
+
+    return(0);
+}
+
+/* take the next log from this thread's range, or steal the upper half of
+ * the remaining range of another thread
+ */
+static int batch_next_log(struct batch_state *bs, int me, int64_t *idx)
+{
+    struct batch_queue *q = &bs->queues[me];
+    struct batch_queue *victim;
+    int64_t take = 0, start = 0;
+    int i;
+
+    pthread_mutex_lock(&q->mutex);
+    if(q->head < q->tail)
+    {
+        *idx = q->head++;
+        pthread_mutex_unlock(&q->mutex);
+        return(1);
+    }
+    pthread_mutex_unlock(&q->mutex);
+
+    for(i = 1; i < bs->n_queues && take == 0; i++)
+    {
+        victim = &bs->queues[(me + i) % bs->n_queues];
+        pthread_mutex_lock(&victim->mutex);
+        take = (victim->tail - victim->head + 1) / 2;
+        if(take > 0)
+        {
+            victim->tail -= take;
+            start = victim->tail;
+        }
+        pthread_mutex_unlock(&victim->mutex);
+    }
+    if(take == 0)
+        return(0);
+
+    pthread_mutex_lock(&q->mutex);
+    q->head = start + 1;
+    q->tail = start + take;
+    pthread_mutex_unlock(&q->mutex);
+    *idx = start;
+
+    return(1);
+}
+
+/* whether a worker has hit an error that stops the others */
+static int batch_stopped(struct batch_state *bs)
+{
+    int err;
+
+    pthread_mutex_lock(&bs->mutex);
+    err = bs->err;
+    pthread_mutex_unlock(&bs->mutex);
+
+    return(err);
+}
+
+static void *batch_worker(void *arg)
+{
+    struct batch_worker_arg *wa = (struct batch_worker_arg *)arg;
+    struct batch_state *bs = wa->bs;
+    struct batch_row row;
+    char *rec_buf, *agg_buf;
+    int64_t idx;
+
+    rec_buf = calloc(1, DEF_MOD_BUF_SIZE);
+    agg_buf = calloc(1, DEF_MOD_BUF_SIZE);
+    if(!rec_buf || !agg_buf)
+    {
+        pthread_mutex_lock(&bs->mutex);
+        bs->err = 1;
+        pthread_mutex_unlock(&bs->mutex);
+    }
+
+    while(rec_buf && agg_buf && !batch_stopped(bs) &&
+          batch_next_log(bs, wa->idx, &idx))
+    {
+        if(batch_analyze_log(bs->paths[idx], &row, rec_buf, agg_buf) == 0)
+            batch_add_row(bs, &row);
+        else
+        {
+            pthread_mutex_lock(&bs->mutex);
+            bs->n_failed++;
+            pthread_mutex_unlock(&bs->mutex);
+        }
+    }
+
+    free(rec_buf);
+    free(agg_buf);
+
+    return(NULL);
+}
+
+static int batch_run(char **inputs, int n_inputs, char *out_path,
+    enum batch_format format, int n_threads, char *ckpt_path, char *list_path)
+{
+    struct batch_state bs;
+    struct batch_worker_arg *args;
+    pthread_t *threads;
+    int64_t out_size = -1;
+    int n_started = 0;
+    int i, ret = 0;
+
+    memset(&bs, 0, sizeof(bs));
+    bs.format = format;
+    batch_init_cols();
+
+    if(ckpt_path && batch_load_checkpoint(ckpt_path, &out_size) < 0)
+    {
+        fprintf(stderr, "Error: unable to read checkpoint %s.\n", ckpt_path);
+        return(-1);
+    }
+
+    for(i = 0; i < n_inputs; i++)
+    {
+        if(nftw(inputs[i], batch_tree_walk, 512, FTW_PHYS) != 0)
+        {
+            fprintf(stderr, "Error: failed to walk path: %s\n", inputs[i]);
+            return(-1);
+        }
+    }
+    if(list_path && batch_read_file_list(list_path) < 0)
+        return(-1);
+
+    /* continue the output of the last run, or start a new one */
+    if(out_size >= 0)
+    {
+        if(truncate(out_path, out_size) < 0)
+        {
+            fprintf(stderr, "Error: unable to resume output %s: %s\n",
+                out_path, strerror(errno));
+            return(-1);
+        }
+        bs.out = fopen(out_path, "a");
+    }
+    else
+    {
+        bs.out = fopen(out_path, "w");
+        if(bs.out)
+            batch_write_header(&bs);
+    }
+    if(!bs.out)
+    {
+        fprintf(stderr, "Error: unable to open output %s.\n", out_path);
+        return(-1);
+    }
+    if(ckpt_path)
+    {
+        bs.ckpt = fopen(ckpt_path, "a");
+        if(!bs.ckpt)
+        {
+            fprintf(stderr, "Error: unable to open checkpoint %s.\n", ckpt_path);
+            fclose(bs.out);
+            return(-1);
+        }
+    }
+
+    bs.paths = batch_paths;
+    bs.n_paths = n_batch_paths;
+    if(n_threads > bs.n_paths)
+        n_threads = bs.n_paths > 0 ? bs.n_paths : 1;
+    bs.n_queues = n_threads;
+    bs.queues = calloc(n_threads, sizeof(*bs.queues));
+    bs.rows = malloc(BATCH_ROWS * sizeof(*bs.rows));
+    threads = malloc(n_threads * sizeof(*threads));
+    args = malloc(n_threads * sizeof(*args));
+    if(!bs.queues || !bs.rows || !threads || !args)
+    {
+        fprintf(stderr, "Error: unable to allocate batch state.\n");
+        ret = -1;
+        goto cleanup;
+    }
+    pthread_mutex_init(&bs.mutex, NULL);
+    pthread_mutex_init(&bs.out_mutex, NULL);
+    for(i = 0; i < n_threads; i++)
+    {
+        pthread_mutex_init(&bs.queues[i].mutex, NULL);
+        bs.queues[i].head = bs.n_paths * i / n_threads;
+        bs.queues[i].tail = bs.n_paths * (i + 1) / n_threads;
+        args[i].bs = &bs;
+        args[i].idx = i;
+    }
+
+    for(i = 0; i < n_threads; i++)
+    {
+        if(pthread_create(&threads[i], NULL, batch_worker, &args[i]) != 0)
+            break;
+        n_started++;
+    }
+    /* if no threads could be started, analyze the logs serially; the
+     * first worker steals from the ranges of the others
+     */
+    if(n_started == 0)
+        batch_worker(&args[0]);
+    for(i = 0; i < n_started; i++)
+        pthread_join(threads[i], NULL);
+
+    batch_write_rows(&bs, bs.rows, bs.n_rows);
+    if(bs.err)
+    {
+        fprintf(stderr, "Error: failed to write %s.\n", out_path);
+        ret = -1;
+    }
+
+    fprintf(stderr, "%" PRId64 " logs analyzed, %" PRId64 " failed, %" PRId64
+        " already in checkpoint\n", bs.n_written, bs.n_failed, n_batch_skipped);
+
+    for(i = 0; i < n_threads; i++)
+        pthread_mutex_destroy(&bs.queues[i].mutex);
+    pthread_mutex_destroy(&bs.mutex);
+    pthread_mutex_destroy(&bs.out_mutex);
+
+cleanup:
+    fclose(bs.out);
+    if(bs.ckpt)
+        fclose(bs.ckpt);
+    free(bs.queues);
+    free(bs.rows);
+    free(threads);
+    free(args);
+    for(i = 0; i < n_batch_paths; i++)
+        free(batch_paths[i]);
+    free(batch_paths);
+    free(batch_done);
+
+    return(ret);
+}
+
 /*
  * Local variables:
  *  c-indent-level: 4
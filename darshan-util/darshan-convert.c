@@ -183,6 +183,11 @@ void obfuscate_filenames(int key, struct darshan_name_record_ref *name_hash, str
     darshan_record_id tmp_id;
     const char *keep_list[] = {"<STDIN>", "<STDOUT>", "<STDERR>", "heatmap:"};
     int keep_list_len = sizeof(keep_list) / sizeof(keep_list[0]);
+    struct darshan_mnt_trie *mnt_trie;
+    struct darshan_mnt_info *mnt;
+
+    mnt_trie = darshan_mnt_trie_create(mnt_data_array, mount_count);
+    assert(mnt_trie);
 
     HASH_ITER(hlink, name_hash, ref, tmp)
     {
@@ -203,15 +208,9 @@ void obfuscate_filenames(int key, struct darshan_name_record_ref *name_hash, str
         char *mnt_pt = NULL;
 
         /* get mount point and fs type associated with this record */
-        for(j=0; j<mount_count; j++)
-        {
-            if(strncmp(mnt_data_array[j].mnt_path, ref->name_record->name,
-                strlen(mnt_data_array[j].mnt_path)) == 0)
-            {
-                mnt_pt = mnt_data_array[j].mnt_path;
-                break;
-            }
-        }
+        mnt = darshan_mnt_trie_lookup(mnt_trie, ref->name_record->name);
+        if(mnt)
+            mnt_pt = mnt->mnt_path;
 
         tmp_id = ref->name_record->id;
         hashed = darshan_hashlittle(ref->name_record->name,
@@ -232,6 +231,7 @@ void obfuscate_filenames(int key, struct darshan_name_record_ref *name_hash, str
         strcpy(ref->name_record->name, tmp_string);
     }
 
+    darshan_mnt_trie_destroy(mnt_trie);
     return;
 }
 
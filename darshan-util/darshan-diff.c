@@ -9,13 +9,39 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <inttypes.h>
 #include <sys/types.h>
 #include <assert.h>
+#include <getopt.h>
 
 #include "darshan-logutils.h"
 #include "uthash-1.9.2/src/uthash.h"
 
+/* default memory limit, per log file, for the records of a module that
+ * are sorted at once in --stream mode
+ */
+#define DIFF_DEF_STREAM_MEM (256 * 1024 * 1024)
+
+/* the first pass over a module tallies record sizes by the top bits of
+ * their ids, to plan the id ranges read by later passes
+ */
+#define DIFF_ID_BUCKET_BITS 16
+#define DIFF_ID_BUCKETS (1 << DIFF_ID_BUCKET_BITS)
+#define DIFF_ID_BUCKET(__id) ((__id) >> (64 - DIFF_ID_BUCKET_BITS))
+
+struct diff_opts
+{
+    /* merge-join records sorted by (id, rank) rather than hashing both logs */
+    int stream;
+    /* only print per-module and per-counter totals */
+    int summary;
+    /* numeric counters differing by no more than either tolerance match */
+    double abs_tol;
+    double rel_tol;
+    size_t mem_limit;
+};
+
 struct darshan_mod_record_ref
 {
     int rank;
@@ -31,8 +57,154 @@ struct darshan_file_record_ref
     UT_hash_handle hlink;
 };
 
+/* records of one log file whose ids fall in the id range being diffed */
+struct diff_partition
+{
+    void **recs;
+    int64_t nrecs;
+    int64_t max_recs;
+    size_t bytes;
+};
+
+/* a counter value captured from a module's log_print_record function */
+struct diff_counter
+{
+    size_t name;    /* offset of the counter name in the capture's strs */
+    enum darshan_counter_type type;
+    union darshan_counter_value val; /* strings hold an offset into strs */
+};
+
+struct diff_capture
+{
+    struct diff_counter *counters;
+    int ncounters;
+    int max_counters;
+    char *strs;
+    size_t strs_len;
+    size_t strs_size;
+    int err;
+};
+
+/* totals of a counter across all differing records of a module */
+struct diff_counter_summary
+{
+    char *name;
+    enum darshan_counter_type type;
+    int64_t ndiffs;
+    double max_abs_diff;
+    double max_rel_diff;
+    UT_hash_handle hlink;
+};
+
+struct diff_mod_summary
+{
+    int64_t matched;
+    int64_t differing;
+    int64_t only1;
+    int64_t only2;
+    struct diff_counter_summary *counters;
+};
+
 static int darshan_build_global_record_hash(
     darshan_fd fd, struct darshan_file_record_ref **rec_hash);
+static void free_name_hash(struct darshan_name_record_ref **name_hash);
+static int diff_stream_logs(char *logfile1, char *logfile2,
+    darshan_fd file1, darshan_fd file2,
+    struct darshan_name_record_ref *name_hash1,
+    struct darshan_name_record_ref *name_hash2,
+    struct diff_opts *opts);
+
+static void usage(char *exename)
+{
+    fprintf(stderr, "Usage: %s [options] <logfile1> <logfile2>\n", exename);
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "    --stream       : sort each module's records by record id and rank and\n");
+    fprintf(stderr, "                     diff them with a merge join, holding at most --mem\n");
+    fprintf(stderr, "                     of records from each log in memory\n");
+    fprintf(stderr, "    --mem=<MiB>    : memory limit per log for --stream (default %d MiB)\n",
+        DIFF_DEF_STREAM_MEM / (1024 * 1024));
+    fprintf(stderr, "    --abs-tol=<val>: treat numeric counters differing by at most <val> as equal\n");
+    fprintf(stderr, "    --rel-tol=<val>: treat numeric counters differing by at most <val> times\n");
+    fprintf(stderr, "                     the larger magnitude as equal\n");
+    fprintf(stderr, "    --summary      : only print the number of matched, differing and\n");
+    fprintf(stderr, "                     unmatched records, and of differences per counter\n");
+    fprintf(stderr, "All options other than --stream imply --stream. In --stream mode, the exit\n");
+    fprintf(stderr, "status is 1 if any module records differ and 0 otherwise.\n");
+
+    exit(1);
+}
+
+static void parse_args(int argc, char **argv, struct diff_opts *opts)
+{
+    int index;
+    char *check;
+    long mem_mib;
+    static struct option long_opts[] =
+    {
+        {"stream", no_argument, NULL, 's'},
+        {"summary", no_argument, NULL, 'S'},
+        {"abs-tol", required_argument, NULL, 'a'},
+        {"rel-tol", required_argument, NULL, 'r'},
+        {"mem", required_argument, NULL, 'm'},
+        {"help", no_argument, NULL, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    memset(opts, 0, sizeof(*opts));
+    opts->mem_limit = DIFF_DEF_STREAM_MEM;
+
+    while(1)
+    {
+        int c = getopt_long(argc, argv, "", long_opts, &index);
+
+        if(c == -1) break;
+
+        switch(c)
+        {
+            case 's':
+                opts->stream = 1;
+                break;
+            case 'S':
+                opts->stream = 1;
+                opts->summary = 1;
+                break;
+            case 'a':
+            case 'r':
+                opts->stream = 1;
+                if(c == 'a')
+                    opts->abs_tol = strtod(optarg, &check);
+                else
+                    opts->rel_tol = strtod(optarg, &check);
+                if(optarg == check || *check != '\0' ||
+                   opts->abs_tol < 0 || opts->rel_tol < 0)
+                {
+                    fprintf(stderr, "Error: invalid tolerance %s.\n", optarg);
+                    exit(1);
+                }
+                break;
+            case 'm':
+                opts->stream = 1;
+                mem_mib = strtol(optarg, &check, 10);
+                if(optarg == check || *check != '\0' || mem_mib < 1)
+                {
+                    fprintf(stderr, "Error: invalid memory limit %s.\n", optarg);
+                    exit(1);
+                }
+                opts->mem_limit = (size_t)mem_mib * 1024 * 1024;
+                break;
+            case 'h':
+            case '?':
+            default:
+                usage(argv[0]);
+                break;
+        }
+    }
+
+    if(argc - optind != 2)
+        usage(argv[0]);
+
+    return;
+}
 
 static void print_str_diff(char *prefix, char *arg1, char *arg2)
 {
@@ -62,17 +234,14 @@ int main(int argc, char *argv[])
     void *mod_buf1, *mod_buf2;
     struct darshan_base_record *base_rec1, *base_rec2;
     char *file_name1, *file_name2;
+    struct diff_opts opts;
     int i;
     int ret;
 
-    if(argc != 3)
-    {
-        fprintf(stderr, "Usage: darshan-diff <logfile1> <logfile2>\n");
-        return(-1);
-    }
+    parse_args(argc, argv, &opts);
 
-    logfile1 = argv[1];
-    logfile2 = argv[2];
+    logfile1 = argv[optind];
+    logfile2 = argv[optind + 1];
 
     file1 = darshan_log_open(logfile1);
     if(!file1)
@@ -144,23 +313,40 @@ int main(int argc, char *argv[])
                 (int64_t)(job1.end_time_sec - job1.start_time_sec + 1),
                 (int64_t)(job2.end_time_sec - job2.start_time_sec + 1));
 
-    /* get hash of record ids to file names for each log */
-    ret = darshan_log_get_namehash(file1, &name_hash1);
-    if(ret < 0)
+    /* get hash of record ids to file names for each log (names are not
+     * printed in summary mode)
+     */
+    if(!opts.summary)
     {
-        darshan_log_close(file1);
-        darshan_log_close(file2);
-        fprintf(stderr, "Error: unable to read record hash for darshan log file %s.\n", logfile1);
-        return(-1);
+        ret = darshan_log_get_namehash(file1, &name_hash1);
+        if(ret < 0)
+        {
+            darshan_log_close(file1);
+            darshan_log_close(file2);
+            fprintf(stderr, "Error: unable to read record hash for darshan log file %s.\n", logfile1);
+            return(-1);
+        }
+
+        ret = darshan_log_get_namehash(file2, &name_hash2);
+        if(ret < 0)
+        {
+            free_name_hash(&name_hash1);
+            darshan_log_close(file1);
+            darshan_log_close(file2);
+            fprintf(stderr, "Error: unable to read record hash for darshan log file %s.\n", logfile2);
+            return(-1);
+        }
     }
 
-    ret = darshan_log_get_namehash(file2, &name_hash2);
-    if(ret < 0)
+    if(opts.stream)
     {
+        ret = diff_stream_logs(logfile1, logfile2, file1, file2,
+            name_hash1, name_hash2, &opts);
+        free_name_hash(&name_hash1);
+        free_name_hash(&name_hash2);
         darshan_log_close(file1);
         darshan_log_close(file2);
-        fprintf(stderr, "Error: unable to read record hash for darshan log file %s.\n", logfile2);
-        return(-1);
+        return(ret);
     }
 
     /* build hash tables of all records opened by all modules for each darshan log file */
@@ -345,18 +531,8 @@ int main(int argc, char *argv[])
         free(rec_ref2);
     }
 
-    HASH_ITER(hlink, name_hash1, name_ref1, name_ref2)
-    {
-        HASH_DELETE(hlink, name_hash1, name_ref1);
-        free(name_ref1->name_record);
-        free(name_ref1);
-    }
-    HASH_ITER(hlink, name_hash2, name_ref2, name_ref1)
-    {
-        HASH_DELETE(hlink, name_hash2, name_ref2);
-        free(name_ref2->name_record);
-        free(name_ref2);
-    }
+    free_name_hash(&name_hash1);
+    free_name_hash(&name_hash2);
 
     darshan_log_close(file1);
     darshan_log_close(file2);
@@ -472,6 +648,744 @@ static int darshan_build_global_record_hash(
     return(0);
 }
 
+static void free_name_hash(struct darshan_name_record_ref **name_hash)
+{
+    struct darshan_name_record_ref *name_ref, *name_tmp;
+
+    HASH_ITER(hlink, *name_hash, name_ref, name_tmp)
+    {
+        HASH_DELETE(hlink, *name_hash, name_ref);
+        free(name_ref->name_record);
+        free(name_ref);
+    }
+
+    return;
+}
+
+static char *diff_lookup_name(struct darshan_name_record_ref *name_hash,
+    darshan_record_id id)
+{
+    struct darshan_name_record_ref *name_ref;
+
+    HASH_FIND(hlink, name_hash, &id, sizeof(darshan_record_id), name_ref);
+    if(!name_ref)
+        return("");
+
+    return(name_ref->name_record->name);
+}
+
+/* orders records by id, then by rank (shared records first) */
+static int diff_rec_cmp(const void *a, const void *b)
+{
+    const struct darshan_base_record *rec1 = *(const struct darshan_base_record **)a;
+    const struct darshan_base_record *rec2 = *(const struct darshan_base_record **)b;
+
+    if(rec1->id != rec2->id)
+        return((rec1->id < rec2->id) ? -1 : 1);
+    if(rec1->rank != rec2->rank)
+        return((rec1->rank < rec2->rank) ? -1 : 1);
+
+    return(0);
+}
+
+static size_t diff_sizeof_record(int mod_id, void *rec)
+{
+    size_t size = sizeof(void *);
+
+    if(mod_logutils[mod_id]->log_sizeof_record)
+        size += mod_logutils[mod_id]->log_sizeof_record(rec);
+    else
+        size += sizeof(struct darshan_base_record);
+
+    return(size);
+}
+
+/* drops the records of a partition whose ids are larger than 'last' */
+static void diff_partition_trim(int mod_id, struct diff_partition *part,
+    darshan_record_id last)
+{
+    struct darshan_base_record *base_rec;
+    int64_t i, n = 0;
+
+    for(i = 0; i < part->nrecs; i++)
+    {
+        base_rec = (struct darshan_base_record *)part->recs[i];
+        if(base_rec->id > last)
+        {
+            part->bytes -= diff_sizeof_record(mod_id, part->recs[i]);
+            free(part->recs[i]);
+        }
+        else
+            part->recs[n++] = part->recs[i];
+    }
+    part->nrecs = n;
+
+    return;
+}
+
+static void diff_partition_clear(struct diff_partition *part)
+{
+    int64_t i;
+
+    for(i = 0; i < part->nrecs; i++)
+        free(part->recs[i]);
+    part->nrecs = 0;
+    part->bytes = 0;
+
+    return;
+}
+
+/* reads the records of module 'mod_id' whose ids fall in [first, *last]
+ * into 'part', sorted by (id, rank).  Record ids are hashes of record names,
+ * so if the records exceed the memory limit, the id range is halved (and
+ * the records above it dropped from both 'part' and 'other', the partition
+ * already read from the other log) until they fit; the records above the
+ * range are read again by the next pass.  If 'bucket_bytes' is set, the
+ * size of every record is added to the bucket of its id.
+ */
+static int diff_load_partition(darshan_log_reader reader, int mod_id,
+    darshan_record_id first, darshan_record_id *last, size_t mem_limit,
+    struct diff_partition *part, struct diff_partition *other,
+    size_t *bucket_bytes)
+{
+    darshan_mod_iter iter;
+    struct darshan_base_record *base_rec;
+    void *rec;
+    void **tmp;
+    int ret;
+
+    iter = darshan_log_reader_mod_iter(reader, mod_id);
+    if(!iter)
+        return(-1);
+
+    while((ret = darshan_mod_iter_next(iter, &rec)) > 0)
+    {
+        base_rec = (struct darshan_base_record *)rec;
+        if(bucket_bytes)
+            bucket_bytes[DIFF_ID_BUCKET(base_rec->id)] +=
+                diff_sizeof_record(mod_id, rec);
+        if(base_rec->id < first || base_rec->id > *last)
+        {
+            free(rec);
+            continue;
+        }
+
+        if(part->nrecs == part->max_recs)
+        {
+            int64_t new_max = part->max_recs ? part->max_recs * 2 : 1024;
+
+            tmp = realloc(part->recs, new_max * sizeof(*tmp));
+            if(!tmp)
+            {
+                free(rec);
+                ret = -1;
+                break;
+            }
+            part->recs = tmp;
+            part->max_recs = new_max;
+        }
+        part->recs[part->nrecs++] = rec;
+        part->bytes += diff_sizeof_record(mod_id, rec);
+
+        while(part->bytes > mem_limit && *last > first)
+        {
+            *last = first + (*last - first) / 2;
+            diff_partition_trim(mod_id, part, *last);
+            if(other)
+                diff_partition_trim(mod_id, other, *last);
+        }
+    }
+    darshan_mod_iter_close(iter);
+    if(ret < 0)
+        return(-1);
+
+    qsort(part->recs, part->nrecs, sizeof(*part->recs), diff_rec_cmp);
+
+    return(0);
+}
+
+static void diff_capture_hook(void *ctx, const char *counter,
+    enum darshan_counter_type type, union darshan_counter_value val)
+{
+    struct diff_capture *cap = ctx;
+    struct diff_counter *c;
+    size_t name_len, val_len = 0;
+
+    if(cap->err)
+        return;
+
+    if(cap->ncounters == cap->max_counters)
+    {
+        int new_max = cap->max_counters ? cap->max_counters * 2 : 256;
+
+        c = realloc(cap->counters, new_max * sizeof(*c));
+        if(!c)
+        {
+            cap->err = 1;
+            return;
+        }
+        cap->counters = c;
+        cap->max_counters = new_max;
+    }
+
+    /* names and string values only live for the duration of the call */
+    name_len = strlen(counter) + 1;
+    if(type == DARSHAN_COUNTER_STRING)
+        val_len = strlen(val.s) + 1;
+    if(cap->strs_len + name_len + val_len > cap->strs_size)
+    {
+        char *tmp;
+        size_t new_size = cap->strs_size ? cap->strs_size : 4096;
+
+        while(cap->strs_len + name_len + val_len > new_size)
+            new_size *= 2;
+        tmp = realloc(cap->strs, new_size);
+        if(!tmp)
+        {
+            cap->err = 1;
+            return;
+        }
+        cap->strs = tmp;
+        cap->strs_size = new_size;
+    }
+
+    c = &cap->counters[cap->ncounters++];
+    c->name = cap->strs_len;
+    memcpy(&cap->strs[cap->strs_len], counter, name_len);
+    cap->strs_len += name_len;
+    c->type = type;
+    c->val = val;
+    if(type == DARSHAN_COUNTER_STRING)
+    {
+        c->val.u = cap->strs_len;
+        memcpy(&cap->strs[cap->strs_len], val.s, val_len);
+        cap->strs_len += val_len;
+    }
+
+    return;
+}
+
+/* captures the counters of a record through the module's log_print_record
+ * function
+ */
+static int diff_capture_record(int mod_id, void *rec, struct diff_capture *cap)
+{
+    char empty[] = "";
+
+    cap->ncounters = 0;
+    cap->strs_len = 0;
+    cap->err = 0;
+
+    darshan_log_print_record_with_hook(mod_id, rec, empty, empty, empty,
+        diff_capture_hook, cap);
+
+    return(cap->err ? -1 : 0);
+}
+
+static void diff_capture_free(struct diff_capture *cap)
+{
+    free(cap->counters);
+    free(cap->strs);
+    memset(cap, 0, sizeof(*cap));
+
+    return;
+}
+
+/* returns 1 if two captured counter values match within the tolerances,
+ * setting their absolute and relative difference if they are numeric
+ */
+static int diff_counter_match(struct diff_capture *cap1, struct diff_counter *c1,
+    struct diff_capture *cap2, struct diff_counter *c2, struct diff_opts *opts,
+    double *abs_diff, double *rel_diff)
+{
+    double val1, val2, mag;
+
+    *abs_diff = 0;
+    *rel_diff = 0;
+
+    switch(c1->type)
+    {
+        case DARSHAN_COUNTER_STRING:
+            return(strcmp(&cap1->strs[c1->val.u], &cap2->strs[c2->val.u]) == 0);
+        case DARSHAN_COUNTER_INT64:
+            if(c1->val.d == c2->val.d)
+                return(1);
+            val1 = c1->val.d;
+            val2 = c2->val.d;
+            break;
+        case DARSHAN_COUNTER_UINT64:
+            if(c1->val.u == c2->val.u)
+                return(1);
+            val1 = c1->val.u;
+            val2 = c2->val.u;
+            break;
+        case DARSHAN_COUNTER_DOUBLE:
+        default:
+            if(c1->val.f == c2->val.f)
+                return(1);
+            val1 = c1->val.f;
+            val2 = c2->val.f;
+            break;
+    }
+
+    *abs_diff = (val1 > val2) ? val1 - val2 : val2 - val1;
+    mag = (val1 < 0) ? -val1 : val1;
+    if(val2 > mag)
+        mag = val2;
+    else if(-val2 > mag)
+        mag = -val2;
+    if(mag > 0)
+        *rel_diff = *abs_diff / mag;
+
+    return(*abs_diff <= opts->abs_tol || *rel_diff <= opts->rel_tol);
+}
+
+static void diff_print_counter(const char *sign, int mod_id,
+    struct darshan_base_record *base_rec, char *file_name,
+    struct diff_capture *cap, struct diff_counter *c)
+{
+    char *name = &cap->strs[c->name];
+
+    printf("%s", sign);
+    switch(c->type)
+    {
+        case DARSHAN_COUNTER_INT64:
+            DARSHAN_D_COUNTER_PRINT(darshan_module_names[mod_id], base_rec->rank,
+                base_rec->id, name, c->val.d, file_name, "", "");
+            break;
+        case DARSHAN_COUNTER_UINT64:
+            DARSHAN_U_COUNTER_PRINT(darshan_module_names[mod_id], base_rec->rank,
+                base_rec->id, name, c->val.u, file_name, "", "");
+            break;
+        case DARSHAN_COUNTER_DOUBLE:
+            DARSHAN_F_COUNTER_PRINT(darshan_module_names[mod_id], base_rec->rank,
+                base_rec->id, name, c->val.f, file_name, "", "");
+            break;
+        case DARSHAN_COUNTER_STRING:
+            DARSHAN_S_COUNTER_PRINT(darshan_module_names[mod_id], base_rec->rank,
+                base_rec->id, name, &cap->strs[c->val.u], file_name, "", "");
+            break;
+    }
+
+    return;
+}
+
+/* prints every counter of a record that has no counterpart (or a
+ * counterpart with a different layout) in the other log
+ */
+static int diff_print_record(const char *sign, int mod_id, void *rec,
+    char *file_name, struct diff_capture *cap)
+{
+    int i;
+
+    if(diff_capture_record(mod_id, rec, cap) < 0)
+        return(-1);
+    for(i = 0; i < cap->ncounters; i++)
+        diff_print_counter(sign, mod_id, (struct darshan_base_record *)rec,
+            file_name, cap, &cap->counters[i]);
+
+    return(0);
+}
+
+static int diff_summarize_counter(struct diff_mod_summary *mod_sum,
+    const char *name, enum darshan_counter_type type,
+    double abs_diff, double rel_diff)
+{
+    struct diff_counter_summary *cnt_sum;
+
+    HASH_FIND(hlink, mod_sum->counters, name, strlen(name), cnt_sum);
+    if(!cnt_sum)
+    {
+        cnt_sum = calloc(1, sizeof(*cnt_sum));
+        if(!cnt_sum)
+            return(-1);
+        cnt_sum->name = strdup(name);
+        if(!cnt_sum->name)
+        {
+            free(cnt_sum);
+            return(-1);
+        }
+        cnt_sum->type = type;
+        HASH_ADD_KEYPTR(hlink, mod_sum->counters, cnt_sum->name,
+            strlen(cnt_sum->name), cnt_sum);
+    }
+
+    cnt_sum->ndiffs++;
+    if(abs_diff > cnt_sum->max_abs_diff)
+        cnt_sum->max_abs_diff = abs_diff;
+    if(rel_diff > cnt_sum->max_rel_diff)
+        cnt_sum->max_rel_diff = rel_diff;
+
+    return(0);
+}
+
+static struct diff_capture diff_cap1, diff_cap2;
+
+/* diffs two records with the same id and rank, returning 1 if any of
+ * their counters differ beyond the tolerances, 0 if not, and -1 on error
+ */
+static int diff_compare_records(int mod_id, void *rec1, char *name1,
+    void *rec2, char *name2, struct diff_opts *opts,
+    struct diff_mod_summary *mod_sum)
+{
+    struct darshan_base_record *base_rec1 = (struct darshan_base_record *)rec1;
+    struct darshan_base_record *base_rec2 = (struct darshan_base_record *)rec2;
+    struct diff_counter *c1, *c2;
+    double abs_diff, rel_diff;
+    int differ = 0;
+    int i;
+
+    if(diff_capture_record(mod_id, rec1, &diff_cap1) < 0 ||
+       diff_capture_record(mod_id, rec2, &diff_cap2) < 0)
+        return(-1);
+
+    /* records with a different layout (e.g., Lustre records with a
+     * different number of components) are printed in full
+     */
+    if(diff_cap1.ncounters != diff_cap2.ncounters)
+        differ = -1;
+    for(i = 0; !differ && i < diff_cap1.ncounters; i++)
+    {
+        c1 = &diff_cap1.counters[i];
+        c2 = &diff_cap2.counters[i];
+        if(c1->type != c2->type ||
+           strcmp(&diff_cap1.strs[c1->name], &diff_cap2.strs[c2->name]) != 0)
+            differ = -1;
+    }
+    if(differ)
+    {
+        if(!opts->summary)
+        {
+            printf("\n");
+            if(diff_print_record("- ", mod_id, rec1, name1, &diff_cap1) < 0 ||
+               diff_print_record("+ ", mod_id, rec2, name2, &diff_cap2) < 0)
+                return(-1);
+        }
+        return(1);
+    }
+
+    for(i = 0; i < diff_cap1.ncounters; i++)
+    {
+        c1 = &diff_cap1.counters[i];
+        c2 = &diff_cap2.counters[i];
+        if(diff_counter_match(&diff_cap1, c1, &diff_cap2, c2, opts,
+            &abs_diff, &rel_diff))
+            continue;
+
+        if(opts->summary)
+        {
+            if(diff_summarize_counter(mod_sum, &diff_cap1.strs[c1->name],
+                c1->type, abs_diff, rel_diff) < 0)
+                return(-1);
+        }
+        else
+        {
+            if(!differ)
+                printf("\n");
+            diff_print_counter("- ", mod_id, base_rec1, name1, &diff_cap1, c1);
+            diff_print_counter("+ ", mod_id, base_rec2, name2, &diff_cap2, c2);
+        }
+        differ = 1;
+    }
+
+    return(differ);
+}
+
+/* merge joins the sorted records of both logs in the current id range */
+static int diff_join_partitions(int mod_id,
+    struct diff_partition *part1, struct darshan_name_record_ref *name_hash1,
+    struct diff_partition *part2, struct darshan_name_record_ref *name_hash2,
+    struct diff_opts *opts, struct diff_mod_summary *mod_sum)
+{
+    struct darshan_base_record *base_rec1, *base_rec2;
+    char *name1 = NULL, *name2 = NULL;
+    int64_t i = 0, j = 0;
+    int cmp;
+    int ret;
+
+    while(i < part1->nrecs || j < part2->nrecs)
+    {
+        if(i == part1->nrecs)
+            cmp = 1;
+        else if(j == part2->nrecs)
+            cmp = -1;
+        else
+            cmp = diff_rec_cmp(&part1->recs[i], &part2->recs[j]);
+
+        base_rec1 = (cmp <= 0) ? part1->recs[i] : NULL;
+        base_rec2 = (cmp >= 0) ? part2->recs[j] : NULL;
+        if(!opts->summary)
+        {
+            if(base_rec1)
+                name1 = diff_lookup_name(name_hash1, base_rec1->id);
+            if(base_rec2)
+                name2 = diff_lookup_name(name_hash2, base_rec2->id);
+        }
+
+        if(cmp == 0)
+        {
+            mod_sum->matched++;
+            ret = diff_compare_records(mod_id, base_rec1, name1,
+                base_rec2, name2, opts, mod_sum);
+            if(ret < 0)
+                return(-1);
+            mod_sum->differing += ret;
+            i++;
+            j++;
+        }
+        else
+        {
+            /* the record only exists in one of the logs */
+            if(base_rec1)
+                mod_sum->only1++;
+            else
+                mod_sum->only2++;
+            if(!opts->summary)
+            {
+                printf("\n");
+                if(base_rec1)
+                    ret = diff_print_record("- ", mod_id, base_rec1, name1,
+                        &diff_cap1);
+                else
+                    ret = diff_print_record("+ ", mod_id, base_rec2, name2,
+                        &diff_cap2);
+                if(ret < 0)
+                    return(-1);
+            }
+            if(cmp < 0)
+                i++;
+            else
+                j++;
+        }
+    }
+
+    return(0);
+}
+
+/* returns the end of the largest id range starting at 'first' whose
+ * records fit in the memory limit, according to the bucket tallies of
+ * both logs (at least one bucket is always included)
+ */
+static darshan_record_id diff_plan_range(size_t *bucket_bytes1,
+    size_t *bucket_bytes2, darshan_record_id first, size_t mem_limit)
+{
+    size_t bytes1 = 0, bytes2 = 0;
+    uint64_t b = DIFF_ID_BUCKET(first);
+
+    while(1)
+    {
+        bytes1 += bucket_bytes1[b];
+        bytes2 += bucket_bytes2[b];
+        if(b == DIFF_ID_BUCKETS - 1)
+            return(UINT64_MAX);
+        if(bytes1 + bucket_bytes1[b + 1] > mem_limit ||
+           bytes2 + bucket_bytes2[b + 1] > mem_limit)
+            break;
+        b++;
+    }
+
+    return(((b + 1) << (64 - DIFF_ID_BUCKET_BITS)) - 1);
+}
+
+static int diff_stream_module(int mod_id, char *logfile1, char *logfile2,
+    darshan_log_reader reader1, darshan_log_reader reader2,
+    struct darshan_name_record_ref *name_hash1,
+    struct darshan_name_record_ref *name_hash2,
+    struct diff_opts *opts, struct diff_mod_summary *mod_sum)
+{
+    struct diff_partition part1, part2;
+    darshan_record_id first = 0, last = UINT64_MAX;
+    size_t *bucket_bytes1, *bucket_bytes2;
+    int pass;
+    int ret = 0;
+
+    memset(&part1, 0, sizeof(part1));
+    memset(&part2, 0, sizeof(part2));
+    bucket_bytes1 = calloc(DIFF_ID_BUCKETS, sizeof(*bucket_bytes1));
+    bucket_bytes2 = calloc(DIFF_ID_BUCKETS, sizeof(*bucket_bytes2));
+    if(!bucket_bytes1 || !bucket_bytes2)
+    {
+        free(bucket_bytes1);
+        free(bucket_bytes2);
+        return(-1);
+    }
+
+    /* each pass diffs the records in the largest id range starting at
+     * 'first' that fits in memory
+     */
+    for(pass = 0; ; pass++)
+    {
+        if(pass > 0)
+            last = diff_plan_range(bucket_bytes1, bucket_bytes2, first,
+                opts->mem_limit);
+        ret = diff_load_partition(reader1, mod_id, first, &last,
+            opts->mem_limit, &part1, NULL, pass ? NULL : bucket_bytes1);
+        if(ret < 0)
+        {
+            fprintf(stderr, "Error: unable to read module %s data from log file %s.\n",
+                darshan_module_names[mod_id], logfile1);
+            break;
+        }
+        ret = diff_load_partition(reader2, mod_id, first, &last,
+            opts->mem_limit, &part2, &part1, pass ? NULL : bucket_bytes2);
+        if(ret < 0)
+        {
+            fprintf(stderr, "Error: unable to read module %s data from log file %s.\n",
+                darshan_module_names[mod_id], logfile2);
+            break;
+        }
+
+        ret = diff_join_partitions(mod_id, &part1, name_hash1,
+            &part2, name_hash2, opts, mod_sum);
+        if(ret < 0)
+        {
+            fprintf(stderr, "Error: unable to diff module %s data.\n",
+                darshan_module_names[mod_id]);
+            break;
+        }
+
+        diff_partition_clear(&part1);
+        diff_partition_clear(&part2);
+        if(last == UINT64_MAX)
+            break;
+        first = last + 1;
+    }
+
+    diff_partition_clear(&part1);
+    diff_partition_clear(&part2);
+    free(part1.recs);
+    free(part2.recs);
+    free(bucket_bytes1);
+    free(bucket_bytes2);
+
+    return(ret);
+}
+
+static void diff_print_summary(struct diff_mod_summary *mod_sums)
+{
+    struct diff_counter_summary *cnt_sum, *tmp;
+    int i;
+
+    printf("\n# <module>\t<matched records>\t<differing records>"
+           "\t<records only in log 1>\t<records only in log 2>\n");
+    for(i = 0; i < DARSHAN_KNOWN_MODULE_COUNT; i++)
+    {
+        if(!mod_sums[i].matched && !mod_sums[i].only1 && !mod_sums[i].only2)
+            continue;
+        printf("%s\t%" PRId64 "\t%" PRId64 "\t%" PRId64 "\t%" PRId64 "\n",
+            darshan_module_names[i], mod_sums[i].matched,
+            mod_sums[i].differing, mod_sums[i].only1, mod_sums[i].only2);
+    }
+
+    printf("\n# <module>\t<counter>\t<differing records>"
+           "\t<max abs diff>\t<max rel diff>\n");
+    for(i = 0; i < DARSHAN_KNOWN_MODULE_COUNT; i++)
+    {
+        HASH_ITER(hlink, mod_sums[i].counters, cnt_sum, tmp)
+        {
+            if(cnt_sum->type == DARSHAN_COUNTER_STRING)
+                printf("%s\t%s\t%" PRId64 "\t-\t-\n", darshan_module_names[i],
+                    cnt_sum->name, cnt_sum->ndiffs);
+            else
+                printf("%s\t%s\t%" PRId64 "\t%g\t%g\n", darshan_module_names[i],
+                    cnt_sum->name, cnt_sum->ndiffs, cnt_sum->max_abs_diff,
+                    cnt_sum->max_rel_diff);
+        }
+    }
+
+    return;
+}
+
+/* diffs the module records of two logs one module at a time, in order of
+ * record id and rank, rather than holding every record of both logs in
+ * memory.  Returns 1 if any records differ, 0 if not, and -1 on error.
+ */
+static int diff_stream_logs(char *logfile1, char *logfile2,
+    darshan_fd file1, darshan_fd file2,
+    struct darshan_name_record_ref *name_hash1,
+    struct darshan_name_record_ref *name_hash2,
+    struct diff_opts *opts)
+{
+    darshan_log_reader reader1, reader2;
+    struct diff_mod_summary mod_sums[DARSHAN_KNOWN_MODULE_COUNT];
+    struct diff_counter_summary *cnt_sum, *tmp;
+    int differ = 0;
+    int ret = 0;
+    int i;
+
+    memset(mod_sums, 0, sizeof(mod_sums));
+
+    /* a reader thread per log decodes records ahead of the diff */
+    reader1 = darshan_log_reader_open(logfile1, 1);
+    reader2 = darshan_log_reader_open(logfile2, 1);
+    if(!reader1 || !reader2)
+    {
+        fprintf(stderr, "Error: unable to open log readers.\n");
+        if(reader1)
+            darshan_log_reader_close(reader1);
+        if(reader2)
+            darshan_log_reader_close(reader2);
+        return(-1);
+    }
+
+    for(i = 0; i < DARSHAN_KNOWN_MODULE_COUNT; i++)
+    {
+        /* skip the DXT modules -- we won't be diff'ing traces -- and
+         * modules that don't implement diffs
+         */
+        if(i == DXT_POSIX_MOD || i == DXT_MPIIO_MOD || !mod_logutils[i] ||
+           !mod_logutils[i]->log_print_diff)
+            continue;
+        if(file1->mod_map[i].len == 0 && file2->mod_map[i].len == 0)
+            continue;
+
+        /* records of older module versions are converted to the current
+         * record format as they are read, so modules with different format
+         * versions are still compared counter by counter; counters that the
+         * older version did not record are converted to -1 and show up as
+         * differences
+         */
+        if(file1->mod_map[i].len && file2->mod_map[i].len &&
+            (file1->mod_ver[i] != file2->mod_ver[i]))
+        {
+            fprintf(stderr, "Warning: %s module data have different format "
+                "versions (file1=%d, file2=%d); counters missing from the "
+                "older version are reported as -1.\n",
+                darshan_module_names[i], file1->mod_ver[i], file2->mod_ver[i]);
+        }
+
+        ret = diff_stream_module(i, logfile1, logfile2, reader1, reader2,
+            name_hash1, name_hash2, opts, &mod_sums[i]);
+        if(ret < 0)
+            break;
+
+        if(mod_sums[i].differing || mod_sums[i].only1 || mod_sums[i].only2)
+            differ = 1;
+    }
+
+    if(ret == 0 && opts->summary)
+        diff_print_summary(mod_sums);
+
+    for(i = 0; i < DARSHAN_KNOWN_MODULE_COUNT; i++)
+    {
+        HASH_ITER(hlink, mod_sums[i].counters, cnt_sum, tmp)
+        {
+            HASH_DELETE(hlink, mod_sums[i].counters, cnt_sum);
+            free(cnt_sum->name);
+            free(cnt_sum);
+        }
+    }
+    diff_capture_free(&diff_cap1);
+    diff_capture_free(&diff_cap2);
+    darshan_log_reader_close(reader1);
+    darshan_log_reader_close(reader2);
+
+    if(ret < 0)
+        return(-1);
+
+    return(differ);
+}
+
 /*
  * Local variables:
  *  c-indent-level: 4
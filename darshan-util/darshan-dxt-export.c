@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2026 University of Chicago.
+ * See COPYRIGHT notice in top-level directory.
+ *
+ */
+#ifdef HAVE_CONFIG_H
+# include "darshan-util-config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <limits.h>
+
+#include "darshan-logutils.h"
+
+#define OPTION_START_TIME 'S'
+#define OPTION_END_TIME 'E'
+#define OPTION_RANKS 'R'
+#define OPTION_THREADS 'T'
+
+static int usage (char *exename);
+static void parse_args (int argc, char **argv, char **log_path,
+    char **out_path, struct dxt_export_opts *opts);
+
+int main(int argc, char **argv)
+{
+    char *log_path;
+    char *out_path;
+    struct dxt_export_opts opts;
+    darshan_fd fd;
+    int64_t nsegs;
+    int i, ret;
+
+    parse_args(argc, argv, &log_path, &out_path, &opts);
+
+    fd = darshan_log_open(log_path);
+    if (!fd)
+        return(-1);
+    if (fd->mod_map[DXT_POSIX_MOD].len == 0 && fd->mod_map[DXT_MPIIO_MOD].len == 0)
+        fprintf(stderr, "Warning: %s does not contain DXT data.\n", log_path);
+    for (i = DXT_POSIX_MOD; i <= DXT_MPIIO_MOD; i++)
+    {
+        if (DARSHAN_MOD_FLAG_ISSET(fd->partial_flag, i))
+            fprintf(stderr, "Warning: %s module trace is incomplete; "
+                "the export only contains the segments in the log.\n",
+                darshan_module_names[i]);
+    }
+    darshan_log_close(fd);
+
+    ret = dxt_log_export(log_path, out_path, &opts, &nsegs);
+    if (ret < 0)
+        return(-1);
+
+    printf("%" PRId64 " segments written to %s\n", nsegs, out_path);
+
+    return(0);
+}
+
+static void parse_args (int argc, char **argv, char **log_path,
+    char **out_path, struct dxt_export_opts *opts)
+{
+    int index;
+    long threads;
+    char *check;
+    static struct option long_opts[] =
+    {
+        {"start-time", required_argument, NULL, OPTION_START_TIME},
+        {"end-time", required_argument, NULL, OPTION_END_TIME},
+        {"ranks", required_argument, NULL, OPTION_RANKS},
+        {"threads", required_argument, NULL, OPTION_THREADS},
+        {"help",  0, NULL, 0},
+        {0, 0, 0, 0}
+    };
+
+    memset(opts, 0, sizeof(*opts));
+    opts->end_time = -1;
+    opts->rank_max = -1;
+    /* leave one CPU for writing the export */
+    opts->nthreads = sysconf(_SC_NPROCESSORS_ONLN) - 1;
+    if (opts->nthreads < 0)
+        opts->nthreads = 0;
+
+    while(1)
+    {
+        int c = getopt_long(argc, argv, "", long_opts, &index);
+
+        if (c == -1) break;
+
+        switch(c)
+        {
+            case OPTION_START_TIME:
+                opts->start_time = strtod(optarg, &check);
+                if (optarg == check || *check != '\0' || opts->start_time < 0)
+                {
+                    fprintf(stderr, "Error: invalid start time.\n");
+                    usage(argv[0]);
+                }
+                break;
+            case OPTION_END_TIME:
+                opts->end_time = strtod(optarg, &check);
+                if (optarg == check || *check != '\0' || opts->end_time < 0)
+                {
+                    fprintf(stderr, "Error: invalid end time.\n");
+                    usage(argv[0]);
+                }
+                break;
+            case OPTION_RANKS:
+                /* a single rank or an inclusive range "<first>-<last>" */
+                opts->rank_min = strtoll(optarg, &check, 10);
+                opts->rank_max = opts->rank_min;
+                if (optarg != check && *check == '-')
+                {
+                    char *last = check + 1;
+                    opts->rank_max = strtoll(last, &check, 10);
+                    if (last == check)
+                        check = optarg;
+                }
+                if (optarg == check || *check != '\0' || opts->rank_min < 0 ||
+                    opts->rank_max < opts->rank_min)
+                {
+                    fprintf(stderr, "Error: invalid rank range.\n");
+                    usage(argv[0]);
+                }
+                break;
+            case OPTION_THREADS:
+                threads = strtol(optarg, &check, 10);
+                if (optarg == check || *check != '\0' || threads < 0 ||
+                    threads > INT_MAX)
+                {
+                    fprintf(stderr, "Error: invalid number of threads.\n");
+                    usage(argv[0]);
+                }
+                opts->nthreads = threads;
+                break;
+            case 0:
+            case '?':
+            default:
+                usage(argv[0]);
+                break;
+        }
+    }
+
+    if (opts->end_time >= 0 && opts->end_time < opts->start_time)
+    {
+        fprintf(stderr, "Error: end time is before start time.\n");
+        usage(argv[0]);
+    }
+
+    if (optind + 2 == argc)
+    {
+        *log_path = argv[optind];
+        *out_path = argv[optind + 1];
+    }
+    else
+    {
+        usage(argv[0]);
+    }
+
+    return;
+}
+
+static int usage (char *exename)
+{
+    fprintf(stderr, "Usage: %s [options] <log file> <output file>\n", exename);
+    fprintf(stderr, "    --start-time=<s> : only export segments ending at or after <s> seconds\n");
+    fprintf(stderr, "    --end-time=<s> : only export segments starting at or before <s> seconds\n");
+    fprintf(stderr, "    --ranks=<r>[-<r>] : only export segments of the given rank or range of ranks\n");
+    fprintf(stderr, "    --threads=<n> : number of threads decoding module data in the\n");
+    fprintf(stderr, "                    background (default: online CPUs - 1)\n");
+
+    exit(1);
+}
+
+/*
+ * Local variables:
+ *  c-indent-level: 4
+ *  c-basic-offset: 4
+ * End:
+ *
+ * vim: ts=8 sts=4 sw=4 expandtab
+ */
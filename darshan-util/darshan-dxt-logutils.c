@@ -36,6 +36,71 @@ static void dxt_log_print_mpiio_file_darshan(void *file_rec,
 static void dxt_swap_file_record(struct dxt_file_record *file_rec);
 static void dxt_swap_file_record(struct dxt_file_record *file_rec);
 
+/* DXT export files hold the segments of both DXT modules in chunks of
+ * DXT_EXPORT_CHUNK_ROWS rows, so they can be memory-mapped and scanned
+ * one column at a time.  All integers are in host byte order, which can be
+ * determined from the byte order mark, and every section starts 8-byte
+ * aligned:
+ *
+ *   file    := header chunk* names index footer
+ *   header  := "DSHNDXT1" u32 byte_order_mark(0x01020304) u32 ncols(7)
+ *   chunk   := u64 nrows stats[ncols] column[ncols] pad
+ *   stats   := min max (8 bytes each, in the column's type widened to
+ *              64 bits)
+ *   column  := nrows values, in this order:
+ *              record_id (u64), offset (i64), length (i64),
+ *              start_time (f64), end_time (f64), rank (i32),
+ *              op (u8, enum dxt_export_op)
+ *   names   := u64 count (u64 record_id u16 name_len name)* pad
+ *   index   := u64 chunk_offset[nchunks]
+ *   footer  := u64 names_offset u64 index_offset u64 nchunks "DSHNDXT1"
+ *
+ * Only the names of records that have segments in the file are stored.
+ */
+#define DXT_EXPORT_MAGIC "DSHNDXT1"
+#define DXT_EXPORT_BOM 0x01020304
+#define DXT_EXPORT_NCOLS 7
+#define DXT_EXPORT_CHUNK_ROWS 65536
+
+struct dxt_export_chunk
+{
+    uint64_t nrows;
+    uint64_t *record_id;
+    int64_t *offset;
+    int64_t *length;
+    double *start_time;
+    double *end_time;
+    int32_t *rank;
+    uint8_t *op;
+};
+
+struct dxt_export_state
+{
+    const struct dxt_export_opts *opts;
+    FILE *out;
+    uint64_t pos;
+    int err;
+    struct dxt_export_chunk chunk;
+    uint64_t *chunk_offsets;
+    uint64_t nchunks;
+    uint64_t chunk_offsets_size;
+    /* ids of the records that contributed segments */
+    darshan_record_id *ids;
+    uint64_t nids;
+    uint64_t ids_size;
+    int64_t nsegs;
+};
+
+static void dxt_export_write(struct dxt_export_state *state,
+    const void *ptr, size_t len);
+static void dxt_export_pad(struct dxt_export_state *state);
+static void dxt_export_record(struct dxt_export_state *state,
+    struct dxt_file_record *rec, int op_base);
+static void dxt_export_flush_chunk(struct dxt_export_state *state);
+static void dxt_export_names(struct dxt_export_state *state,
+    struct darshan_name_record_ref *name_hash);
+static int dxt_export_id_cmp(const void *a, const void *b);
+
 struct darshan_mod_logutil_funcs dxt_posix_logutils =
 {
     .log_get_record = &dxt_log_get_posix_file,
@@ -505,6 +570,321 @@ void dxt_log_print_mpiio_file(void *mpiio_file_rec, char *file_name,
     return;
 }
 
+int dxt_log_export(const char *log_path, const char *out_path,
+    const struct dxt_export_opts *opts, int64_t *nsegs)
+{
+    static const darshan_module_id mods[2] = {DXT_POSIX_MOD, DXT_MPIIO_MOD};
+    struct dxt_export_state state;
+    struct dxt_export_chunk *chunk = &state.chunk;
+    struct darshan_name_record_ref *name_hash = NULL;
+    struct darshan_name_record_ref *ref, *tmp;
+    darshan_log_reader reader = NULL;
+    darshan_mod_iter iters[2] = {NULL, NULL};
+    darshan_fd fd;
+    uint32_t hdr[2] = {DXT_EXPORT_BOM, DXT_EXPORT_NCOLS};
+    uint64_t footer[3];
+    void *buf;
+    int i, ret = -1;
+
+    memset(&state, 0, sizeof(state));
+    state.opts = opts;
+
+    fd = darshan_log_open(log_path);
+    if(!fd)
+        return(-1);
+    if(darshan_log_get_namehash(fd, &name_hash) < 0)
+        goto cleanup;
+
+    /* both modules are decoded through their own iterator, so MPIIO
+     * segments can be decoded while POSIX segments are written out
+     */
+    reader = darshan_log_reader_open(log_path, opts->nthreads);
+    if(!reader)
+        goto cleanup;
+    for(i = 0; i < 2; i++)
+    {
+        if(fd->mod_map[mods[i]].len == 0)
+            continue;
+        iters[i] = darshan_log_reader_mod_iter(reader, mods[i]);
+        if(!iters[i])
+            goto cleanup;
+    }
+
+    chunk->record_id = malloc(DXT_EXPORT_CHUNK_ROWS * sizeof(*chunk->record_id));
+    chunk->offset = malloc(DXT_EXPORT_CHUNK_ROWS * sizeof(*chunk->offset));
+    chunk->length = malloc(DXT_EXPORT_CHUNK_ROWS * sizeof(*chunk->length));
+    chunk->start_time = malloc(DXT_EXPORT_CHUNK_ROWS * sizeof(*chunk->start_time));
+    chunk->end_time = malloc(DXT_EXPORT_CHUNK_ROWS * sizeof(*chunk->end_time));
+    chunk->rank = malloc(DXT_EXPORT_CHUNK_ROWS * sizeof(*chunk->rank));
+    chunk->op = malloc(DXT_EXPORT_CHUNK_ROWS * sizeof(*chunk->op));
+    if(!chunk->record_id || !chunk->offset || !chunk->length ||
+       !chunk->start_time || !chunk->end_time || !chunk->rank || !chunk->op)
+        goto cleanup;
+
+    state.out = fopen(out_path, "w");
+    if(!state.out)
+    {
+        fprintf(stderr, "Error: unable to open output file %s.\n", out_path);
+        goto cleanup;
+    }
+    dxt_export_write(&state, DXT_EXPORT_MAGIC, 8);
+    dxt_export_write(&state, hdr, sizeof(hdr));
+
+    for(i = 0; i < 2 && !state.err; i++)
+    {
+        if(!iters[i])
+            continue;
+        while(!state.err && (ret = darshan_mod_iter_next(iters[i], &buf)) > 0)
+        {
+            dxt_export_record(&state, buf, 2 * i);
+            free(buf);
+        }
+        if(ret < 0)
+        {
+            fprintf(stderr, "Error: failed to read DXT record.\n");
+            goto cleanup;
+        }
+    }
+    dxt_export_flush_chunk(&state);
+
+    footer[0] = state.pos;
+    dxt_export_names(&state, name_hash);
+    footer[1] = state.pos;
+    dxt_export_write(&state, state.chunk_offsets,
+        state.nchunks * sizeof(*state.chunk_offsets));
+    footer[2] = state.nchunks;
+    dxt_export_write(&state, footer, sizeof(footer));
+    dxt_export_write(&state, DXT_EXPORT_MAGIC, 8);
+
+    if(fclose(state.out) != 0)
+        state.err = 1;
+    state.out = NULL;
+    if(state.err)
+    {
+        fprintf(stderr, "Error: failed to write DXT export file %s.\n", out_path);
+        goto cleanup;
+    }
+
+    if(nsegs)
+        *nsegs = state.nsegs;
+    ret = 0;
+
+cleanup:
+    if(ret != 0)
+        ret = -1;
+    if(state.out)
+        fclose(state.out);
+    darshan_log_reader_close(reader);
+    free(chunk->record_id);
+    free(chunk->offset);
+    free(chunk->length);
+    free(chunk->start_time);
+    free(chunk->end_time);
+    free(chunk->rank);
+    free(chunk->op);
+    free(state.chunk_offsets);
+    free(state.ids);
+    HASH_ITER(hlink, name_hash, ref, tmp)
+    {
+        HASH_DELETE(hlink, name_hash, ref);
+        free(ref->name_record);
+        free(ref);
+    }
+    darshan_log_close(fd);
+
+    return(ret);
+}
+
+static void dxt_export_write(struct dxt_export_state *state,
+    const void *ptr, size_t len)
+{
+    if(state->err || len == 0)
+        return;
+    if(fwrite(ptr, 1, len, state->out) != len)
+        state->err = 1;
+    state->pos += len;
+}
+
+static void dxt_export_pad(struct dxt_export_state *state)
+{
+    static const char zeros[8] = {0};
+
+    if(state->pos % 8)
+        dxt_export_write(state, zeros, 8 - (state->pos % 8));
+}
+
+/* appends the segments of a record that pass the filters to the current
+ * chunk; op_base is the write op of the record's module
+ */
+static void dxt_export_record(struct dxt_export_state *state,
+    struct dxt_file_record *rec, int op_base)
+{
+    const struct dxt_export_opts *opts = state->opts;
+    struct dxt_export_chunk *chunk = &state->chunk;
+    segment_info *segs = (segment_info *)(rec + 1);
+    darshan_record_id *tmp_ids;
+    int64_t nsegs = rec->write_count + rec->read_count;
+    int64_t i, kept = 0;
+    uint64_t row;
+
+    /* skip whole records of filtered ranks without touching the segments */
+    if(rec->base_rec.rank < opts->rank_min ||
+       (opts->rank_max >= 0 && rec->base_rec.rank > opts->rank_max))
+        return;
+
+    for(i = 0; i < nsegs && !state->err; i++)
+    {
+        if(segs[i].end_time < opts->start_time ||
+           (opts->end_time >= 0 && segs[i].start_time > opts->end_time))
+            continue;
+
+        row = chunk->nrows++;
+        chunk->record_id[row] = rec->base_rec.id;
+        chunk->offset[row] = segs[i].offset;
+        chunk->length[row] = segs[i].length;
+        chunk->start_time[row] = segs[i].start_time;
+        chunk->end_time[row] = segs[i].end_time;
+        chunk->rank[row] = (int32_t)rec->base_rec.rank;
+        chunk->op[row] = op_base + (i >= rec->write_count);
+        kept++;
+
+        if(chunk->nrows == DXT_EXPORT_CHUNK_ROWS)
+            dxt_export_flush_chunk(state);
+    }
+    if(kept == 0)
+        return;
+    state->nsegs += kept;
+
+    if(state->nids == state->ids_size)
+    {
+        state->ids_size = state->ids_size ? 2 * state->ids_size : 1024;
+        tmp_ids = realloc(state->ids, state->ids_size * sizeof(*state->ids));
+        if(!tmp_ids)
+        {
+            state->err = 1;
+            return;
+        }
+        state->ids = tmp_ids;
+    }
+    state->ids[state->nids++] = rec->base_rec.id;
+
+    return;
+}
+
+/* writes out the current chunk with per-column min/max statistics */
+static void dxt_export_flush_chunk(struct dxt_export_state *state)
+{
+    struct dxt_export_chunk *chunk = &state->chunk;
+    union
+    {
+        int64_t i;
+        uint64_t u;
+        double d;
+    } stats[DXT_EXPORT_NCOLS][2];
+    uint64_t *tmp_offsets;
+    uint64_t row, n = chunk->nrows;
+
+    if(n == 0 || state->err)
+        return;
+
+    if(state->nchunks == state->chunk_offsets_size)
+    {
+        state->chunk_offsets_size = state->chunk_offsets_size ?
+            2 * state->chunk_offsets_size : 64;
+        tmp_offsets = realloc(state->chunk_offsets,
+            state->chunk_offsets_size * sizeof(*state->chunk_offsets));
+        if(!tmp_offsets)
+        {
+            state->err = 1;
+            return;
+        }
+        state->chunk_offsets = tmp_offsets;
+    }
+    state->chunk_offsets[state->nchunks++] = state->pos;
+
+    stats[0][0].u = stats[0][1].u = chunk->record_id[0];
+    stats[1][0].i = stats[1][1].i = chunk->offset[0];
+    stats[2][0].i = stats[2][1].i = chunk->length[0];
+    stats[3][0].d = stats[3][1].d = chunk->start_time[0];
+    stats[4][0].d = stats[4][1].d = chunk->end_time[0];
+    stats[5][0].i = stats[5][1].i = chunk->rank[0];
+    stats[6][0].i = stats[6][1].i = chunk->op[0];
+    for(row = 1; row < n; row++)
+    {
+#define DXT_EXPORT_STAT(_col, _field, _val) do { \
+        if((_val) < stats[_col][0]._field) stats[_col][0]._field = (_val); \
+        if((_val) > stats[_col][1]._field) stats[_col][1]._field = (_val); \
+    } while(0)
+        DXT_EXPORT_STAT(0, u, chunk->record_id[row]);
+        DXT_EXPORT_STAT(1, i, chunk->offset[row]);
+        DXT_EXPORT_STAT(2, i, chunk->length[row]);
+        DXT_EXPORT_STAT(3, d, chunk->start_time[row]);
+        DXT_EXPORT_STAT(4, d, chunk->end_time[row]);
+        DXT_EXPORT_STAT(5, i, chunk->rank[row]);
+        DXT_EXPORT_STAT(6, i, chunk->op[row]);
+#undef DXT_EXPORT_STAT
+    }
+
+    dxt_export_write(state, &n, sizeof(n));
+    dxt_export_write(state, stats, sizeof(stats));
+    dxt_export_write(state, chunk->record_id, n * sizeof(*chunk->record_id));
+    dxt_export_write(state, chunk->offset, n * sizeof(*chunk->offset));
+    dxt_export_write(state, chunk->length, n * sizeof(*chunk->length));
+    dxt_export_write(state, chunk->start_time, n * sizeof(*chunk->start_time));
+    dxt_export_write(state, chunk->end_time, n * sizeof(*chunk->end_time));
+    dxt_export_write(state, chunk->rank, n * sizeof(*chunk->rank));
+    dxt_export_write(state, chunk->op, n * sizeof(*chunk->op));
+    dxt_export_pad(state);
+
+    chunk->nrows = 0;
+
+    return;
+}
+
+/* writes the names of all records that contributed segments */
+static void dxt_export_names(struct dxt_export_state *state,
+    struct darshan_name_record_ref *name_hash)
+{
+    struct darshan_name_record_ref *ref;
+    uint64_t i, count = 0;
+    uint16_t len;
+
+    qsort(state->ids, state->nids, sizeof(*state->ids), dxt_export_id_cmp);
+    for(i = 0; i < state->nids; i++)
+    {
+        if(count == 0 || state->ids[i] != state->ids[count - 1])
+            state->ids[count++] = state->ids[i];
+    }
+    state->nids = count;
+
+    dxt_export_write(state, &count, sizeof(count));
+    for(i = 0; i < state->nids; i++)
+    {
+        HASH_FIND(hlink, name_hash, &state->ids[i], sizeof(darshan_record_id), ref);
+        len = ref ? strlen(ref->name_record->name) : 0;
+        dxt_export_write(state, &state->ids[i], sizeof(state->ids[i]));
+        dxt_export_write(state, &len, sizeof(len));
+        if(ref)
+            dxt_export_write(state, ref->name_record->name, len);
+    }
+    dxt_export_pad(state);
+
+    return;
+}
+
+static int dxt_export_id_cmp(const void *a, const void *b)
+{
+    darshan_record_id id_a = *(const darshan_record_id *)a;
+    darshan_record_id id_b = *(const darshan_record_id *)b;
+
+    if(id_a < id_b)
+        return(-1);
+    else if(id_a > id_b)
+        return(1);
+    else
+        return(0);
+}
+
 /*
  * Local variables:
  *  c-indent-level: 4
@@ -16,4 +16,37 @@ void dxt_log_print_posix_file(void *file_rec, char *file_name,
 void dxt_log_print_mpiio_file(void *file_rec,
         char *file_name, char *mnt_pt, char *fs_type);
 
+/* operation of a segment in a DXT export file */
+enum dxt_export_op
+{
+    DXT_EXPORT_POSIX_WRITE = 0,
+    DXT_EXPORT_POSIX_READ,
+    DXT_EXPORT_MPIIO_WRITE,
+    DXT_EXPORT_MPIIO_READ
+};
+
+/* filters applied to segments while they are decoded */
+struct dxt_export_opts
+{
+    /* keep segments overlapping [start_time, end_time]; no upper bound
+     * if end_time < 0
+     */
+    double start_time;
+    double end_time;
+    /* keep records of ranks in [rank_min, rank_max]; no upper bound if
+     * rank_max < 0
+     */
+    int64_t rank_min;
+    int64_t rank_max;
+    /* background threads decoding DXT modules (see darshan_log_reader_open) */
+    int nthreads;
+};
+
+/* stream the DXT segments of a log into a columnar trace file (format
+ * described in darshan-dxt-logutils.c); the number of segments written
+ * is returned in nsegs if it is not NULL
+ */
+int dxt_log_export(const char *log_path, const char *out_path,
+        const struct dxt_export_opts *opts, int64_t *nsegs);
+
 #endif
@@ -24,15 +24,16 @@
 #include "darshan-logutils.h"
 
 #define OPTION_SHOW_INCOMPLETE  (1 << 7)  /* show what we have, even if log is incomplete */
+#define OPTION_THREADS 'T'
 
 static int usage (char *exename);
-static int parse_args (int argc, char **argv, char **filename);
+static int parse_args (int argc, char **argv, char **filename, int *n_threads);
 
 int main(int argc, char **argv)
 {
     int mask;
     int ret;
-    int i, j;
+    int i;
     char *filename;
     char *comp_str;
     char tmp_string[4096] = {0};
@@ -42,6 +43,8 @@ int main(int argc, char **argv)
     struct darshan_name_record_ref *ref, *tmp_ref;
     int mount_count;
     struct darshan_mnt_info *mnt_data_array;
+    struct darshan_mnt_trie *mnt_trie;
+    struct darshan_mnt_info *mnt;
     time_t tmp_time = 0;
     double run_time;
     char *token;
@@ -50,8 +53,15 @@ int main(int argc, char **argv)
     struct lustre_record_ref *lustre_rec_ref, *tmp_lustre_rec_ref;
     struct lustre_record_ref *lustre_rec_hash = NULL;
     char *mod_buf = NULL;
+    int n_threads;
+    int n_iters = 0;
+    darshan_log_reader reader = NULL;
+    darshan_mod_iter mod_iters[DARSHAN_KNOWN_MODULE_COUNT] = {0};
+    /* modules read by this utility, in the order they are parsed */
+    const darshan_module_id dxt_mods[] =
+        {DARSHAN_LUSTRE_MOD, DXT_POSIX_MOD, DXT_MPIIO_MOD};
 
-    mask = parse_args(argc, argv, &filename);
+    mask = parse_args(argc, argv, &filename, &n_threads);
 
     fd = darshan_log_open(filename);
     if (!fd)
@@ -80,6 +90,13 @@ int main(int argc, char **argv)
         darshan_log_close(fd);
         return(-1);
     }
+    mnt_trie = darshan_mnt_trie_create(mnt_data_array, mount_count);
+    if (!mnt_trie)
+    {
+        fprintf(stderr, "Error: unable to index mount table.\n");
+        darshan_log_close(fd);
+        return(-1);
+    }
 
     /* read hash of darshan records */
     ret = darshan_log_get_namehash(fd, &name_hash);
@@ -177,6 +194,36 @@ int main(int argc, char **argv)
         goto cleanup;
     }
 
+    /* decode the Lustre and DXT modules concurrently on background
+     * threads while records are printed here
+     */
+    for (i = 0; i < sizeof(dxt_mods) / sizeof(dxt_mods[0]); i++)
+    {
+        if (fd->mod_map[dxt_mods[i]].len > 0)
+            n_iters++;
+    }
+    reader = darshan_log_reader_open(filename,
+        (n_threads < n_iters) ? n_threads : n_iters);
+    if (!reader)
+    {
+        fprintf(stderr, "Error: unable to create log reader.\n");
+        ret = -1;
+        goto cleanup;
+    }
+    for (i = 0; i < sizeof(dxt_mods) / sizeof(dxt_mods[0]); i++)
+    {
+        if (fd->mod_map[dxt_mods[i]].len == 0)
+            continue;
+        mod_iters[dxt_mods[i]] = darshan_log_reader_mod_iter(reader, dxt_mods[i]);
+        if (!mod_iters[dxt_mods[i]])
+        {
+            fprintf(stderr, "Error: unable to read %s module data.\n",
+                darshan_module_names[dxt_mods[i]]);
+            ret = -1;
+            goto cleanup;
+        }
+    }
+
     for (i = 0; i < DARSHAN_MAX_MODS; i++)
     {
         struct darshan_base_record *base_rec;
@@ -259,10 +306,10 @@ int main(int argc, char **argv)
                 assert(lustre_rec_ref);
                 memset(lustre_rec_ref, 0, sizeof(*lustre_rec_ref));
 
-                ret = mod_logutils[i]->log_get_record(fd,
+                ret = darshan_mod_iter_next(mod_iters[i],
                         (void **)&(lustre_rec_ref->rec));
             } else {
-                ret = mod_logutils[i]->log_get_record(fd, (void **)&mod_buf);
+                ret = darshan_mod_iter_next(mod_iters[i], (void **)&mod_buf);
             }
 
             if (ret < 1)
@@ -293,15 +340,11 @@ int main(int argc, char **argv)
                 rec_name = ref->name_record->name;
 
                 /* get mount point and fs type associated with this record */
-                for (j = 0; j < mount_count; j++)
+                mnt = darshan_mnt_trie_lookup(mnt_trie, rec_name);
+                if (mnt)
                 {
-                    if(strncmp(mnt_data_array[j].mnt_path, rec_name,
-                        strlen(mnt_data_array[j].mnt_path)) == 0)
-                    {
-                        mnt_pt = mnt_data_array[j].mnt_path;
-                        fs_type = mnt_data_array[j].mnt_type;
-                        break;
-                    }
+                    mnt_pt = mnt->mnt_path;
+                    fs_type = mnt->mnt_type;
                 }
             }
 
@@ -330,6 +373,7 @@ int main(int argc, char **argv)
     ret = 0;
 
 cleanup:
+    darshan_log_reader_close(reader);
     darshan_log_close(fd);
 
     /* free record hash data */
@@ -349,6 +393,7 @@ cleanup:
     } 
 
     /* free mount info */
+    darshan_mnt_trie_destroy(mnt_trie);
     if (mount_count > 0)
     {
         free(mnt_data_array);
@@ -357,18 +402,24 @@ cleanup:
     return(ret);
 }
 
-static int parse_args (int argc, char **argv, char **filename)
+static int parse_args (int argc, char **argv, char **filename, int *n_threads)
 {
     int index;
     int mask;
+    char *check;
     static struct option long_opts[] =
     {
         {"show-incomplete", 0, NULL, OPTION_SHOW_INCOMPLETE},
+        {"threads", required_argument, NULL, OPTION_THREADS},
         {"help",  0, NULL, 0},
         {0, 0, 0, 0}
     };
 
     mask = 0;
+    /* leave one CPU for printing records */
+    *n_threads = sysconf(_SC_NPROCESSORS_ONLN) - 1;
+    if (*n_threads < 0)
+        *n_threads = 0;
 
     while(1)
     {
@@ -381,6 +432,14 @@ static int parse_args (int argc, char **argv, char **filename)
             case OPTION_SHOW_INCOMPLETE:
                 mask |= c;
                 break;
+            case OPTION_THREADS:
+                *n_threads = strtol(optarg, &check, 10);
+                if (optarg == check || *n_threads < 0)
+                {
+                    fprintf(stderr, "Error: invalid number of threads.\n");
+                    usage(argv[0]);
+                }
+                break;
             case 0:
             case '?':
             default:
@@ -405,6 +464,8 @@ static int usage (char *exename)
 {
     fprintf(stderr, "Usage: %s [options] <filename>\n", exename);
     fprintf(stderr, "    --show-incomplete : display results even if log is incomplete\n");
+    fprintf(stderr, "    --threads=<n> : number of threads decoding module data in the\n");
+    fprintf(stderr, "                    background (default: online CPUs - 1)\n");
 
     exit(1);
 }
@@ -52,6 +52,7 @@ static void darshan_log_print_hdf5_file_description(int ver);
 static void darshan_log_print_hdf5_file_diff(void *ds_rec1, char *ds_name1,
     void *ds_rec2, char *ds_name2);
 static void darshan_log_agg_hdf5_files(void *rec, void *agg_rec, int init_flag);
+static int darshan_log_sizeof_hdf5_file(void* hdf5_buf_p);
 
 static int darshan_log_get_hdf5_dataset(darshan_fd fd, void** hdf5_buf_p);
 static int darshan_log_put_hdf5_dataset(darshan_fd fd, void* hdf5_buf);
@@ -61,6 +62,7 @@ static void darshan_log_print_hdf5_dataset_description(int ver);
 static void darshan_log_print_hdf5_dataset_diff(void *ds_rec1, char *ds_name1,
     void *ds_rec2, char *ds_name2);
 static void darshan_log_agg_hdf5_datasets(void *rec, void *agg_rec, int init_flag);
+static int darshan_log_sizeof_hdf5_dataset(void* hdf5_buf_p);
 
 struct darshan_mod_logutil_funcs hdf5_file_logutils =
 {
@@ -69,9 +71,16 @@ struct darshan_mod_logutil_funcs hdf5_file_logutils =
     .log_print_record = &darshan_log_print_hdf5_file,
     .log_print_description = &darshan_log_print_hdf5_file_description,
     .log_print_diff = &darshan_log_print_hdf5_file_diff,
-    .log_agg_records = &darshan_log_agg_hdf5_files
+    .log_agg_records = &darshan_log_agg_hdf5_files,
+    .log_sizeof_record = &darshan_log_sizeof_hdf5_file
 };
 
+static int darshan_log_sizeof_hdf5_file(void* hdf5_buf_p)
+{
+    /* hdf5 file records have a fixed size */
+    return(sizeof(struct darshan_hdf5_file));
+}
+
 struct darshan_mod_logutil_funcs hdf5_dataset_logutils =
 {
     .log_get_record = &darshan_log_get_hdf5_dataset,
@@ -79,9 +88,16 @@ struct darshan_mod_logutil_funcs hdf5_dataset_logutils =
     .log_print_record = &darshan_log_print_hdf5_dataset,
     .log_print_description = &darshan_log_print_hdf5_dataset_description,
     .log_print_diff = &darshan_log_print_hdf5_dataset_diff,
-    .log_agg_records = &darshan_log_agg_hdf5_datasets
+    .log_agg_records = &darshan_log_agg_hdf5_datasets,
+    .log_sizeof_record = &darshan_log_sizeof_hdf5_dataset
 };
 
+static int darshan_log_sizeof_hdf5_dataset(void* hdf5_buf_p)
+{
+    /* hdf5 dataset records have a fixed size */
+    return(sizeof(struct darshan_hdf5_dataset));
+}
+
 static int darshan_log_get_hdf5_file(darshan_fd fd, void** hdf5_buf_p)
 {
     struct darshan_hdf5_file *file = *((struct darshan_hdf5_file **)hdf5_buf_p);
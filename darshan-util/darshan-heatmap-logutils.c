@@ -184,11 +184,37 @@ static int darshan_log_get_heatmap_record(darshan_fd fd, void** heatmap_buf_p)
 static int darshan_log_put_heatmap_record(darshan_fd fd, void* heatmap_buf)
 {
     struct darshan_heatmap_record *rec = (struct darshan_heatmap_record *)heatmap_buf;
+    struct darshan_heatmap_record hdr;
     int ret;
 
+    /* the bin pointers are only meaningful in memory; write them out as
+     * NULL so that identical records always compress the same way
+     */
+    memcpy(&hdr, rec, sizeof(hdr));
+    hdr.write_bins = NULL;
+    hdr.read_bins = NULL;
+
     /* append heatmap record to darshan log file */
-    ret = darshan_log_put_mod(fd, DARSHAN_HEATMAP_MOD, rec,
-        sizeof(struct darshan_heatmap_record) + rec->nbins*2*sizeof(int64_t), DARSHAN_HEATMAP_VER);
+    ret = darshan_log_put_mod(fd, DARSHAN_HEATMAP_MOD, &hdr,
+        sizeof(struct darshan_heatmap_record), DARSHAN_HEATMAP_VER);
+    if(ret < 0)
+        return(-1);
+
+    if(rec->write_bins && rec->read_bins)
+    {
+        /* bin arrays may not be contiguous if the bin count was corrected
+         * on read
+         */
+        ret = darshan_log_put_mod(fd, DARSHAN_HEATMAP_MOD, rec->write_bins,
+            rec->nbins*sizeof(int64_t), DARSHAN_HEATMAP_VER);
+        if(ret == 0)
+            ret = darshan_log_put_mod(fd, DARSHAN_HEATMAP_MOD, rec->read_bins,
+                rec->nbins*sizeof(int64_t), DARSHAN_HEATMAP_VER);
+    }
+    else
+        ret = darshan_log_put_mod(fd, DARSHAN_HEATMAP_MOD,
+            (void *)((uintptr_t)rec + sizeof(*rec)),
+            rec->nbins*2*sizeof(int64_t), DARSHAN_HEATMAP_VER);
     if(ret < 0)
         return(-1);
 
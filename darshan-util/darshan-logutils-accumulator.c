@@ -9,6 +9,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
 #include "darshan-logutils.h"
@@ -16,6 +17,27 @@
 
 #define max(a,b) (((a) > (b)) ? (a) : (b))
 
+/* per-file and per-rank entries are carved out of slabs rather than
+ * allocated one at a time; slabs start at ACC_POOL_MIN_SLAB entries and
+ * double in size up to ACC_POOL_MAX_SLAB entries
+ */
+#define ACC_POOL_MIN_SLAB 64
+#define ACC_POOL_MAX_SLAB 65536
+
+struct acc_pool_slab
+{
+    struct acc_pool_slab *next;
+    size_t count;  /* number of entries in this slab */
+    size_t used;   /* number of entries handed out so far */
+    double entries[]; /* aligned for the entry types below */
+};
+
+struct acc_pool
+{
+    size_t entry_size;
+    struct acc_pool_slab *slabs;
+};
+
 /* struct to track per-file metrics */
 typedef struct file_hash_entry_s
 {
@@ -27,6 +49,18 @@ typedef struct file_hash_entry_s
     int64_t nprocs;      /* nprocs that accessed it */
 } file_hash_entry_t;
 
+/* struct to track per-rank I/O time in non-shared files; only ranks that
+ * have records are tracked
+ */
+typedef struct rank_hash_entry_s
+{
+    UT_hash_handle hlink;
+    int64_t rank;
+    double io_total_time;
+    double rw_only_time;
+    double md_only_time;
+} rank_hash_entry_t;
+
 /* accumulator state */
 struct darshan_accumulator_st {
     darshan_module_id module_id;
@@ -34,6 +68,7 @@ struct darshan_accumulator_st {
     void* agg_record;
     int num_records;
     file_hash_entry_t *file_hash_table;
+    struct acc_pool file_pool;
 
     /* amount of time consumed by slowest rank in shared files, across all
      * shared files observed
@@ -42,11 +77,107 @@ struct darshan_accumulator_st {
     /* how many total bytes were read or written? */
     int64_t total_bytes;
     /* for non-shared files, how long did each rank spend in IO? */
-    double *rank_cumul_io_total_time;
-    double *rank_cumul_rw_only_time;
-    double *rank_cumul_md_only_time;
+    rank_hash_entry_t *rank_hash_table;
+    struct acc_pool rank_pool;
+    /* records are usually grouped by rank, so remember the last one */
+    rank_hash_entry_t *last_rank;
+    /* one sketch per darshan_common_value_set, if common values are
+     * tracked
+     */
+    struct darshan_common_value_sketch *sketches;
 };
 
+static void *acc_pool_alloc(struct acc_pool *pool)
+{
+    struct acc_pool_slab *slab = pool->slabs;
+    size_t count;
+
+    if(!slab || slab->used == slab->count) {
+        count = slab ? slab->count * 2 : ACC_POOL_MIN_SLAB;
+        if(count > ACC_POOL_MAX_SLAB)
+            count = ACC_POOL_MAX_SLAB;
+        slab = calloc(1, sizeof(*slab) + count * pool->entry_size);
+        if(!slab)
+            return(NULL);
+        slab->count = count;
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+    }
+
+    return((char *)slab->entries + pool->entry_size * slab->used++);
+}
+
+static void acc_pool_destroy(struct acc_pool *pool)
+{
+    struct acc_pool_slab *slab, *next;
+
+    for(slab = pool->slabs; slab; slab = next) {
+        next = slab->next;
+        free(slab);
+    }
+    pool->slabs = NULL;
+}
+
+/* find the entry of a file, adding a zeroed one if there is none yet */
+static file_hash_entry_t *acc_get_file(darshan_accumulator acc,
+                                       darshan_record_id rec_id)
+{
+    file_hash_entry_t *hfile = NULL;
+
+    HASH_FIND(hlink, acc->file_hash_table, &rec_id, sizeof(rec_id), hfile);
+    if(!hfile) {
+        /* first time we've seen this file in this accumulator */
+        hfile = acc_pool_alloc(&acc->file_pool);
+        if(!hfile)
+            return(NULL);
+
+        /* add to hash table */
+        hfile->rec_id = rec_id;
+        HASH_ADD(hlink, acc->file_hash_table, rec_id, sizeof(rec_id), hfile);
+    }
+
+    return(hfile);
+}
+
+/* find the entry of a rank, adding a zeroed one if there is none yet */
+static rank_hash_entry_t *acc_get_rank(darshan_accumulator acc, int64_t rank)
+{
+    rank_hash_entry_t *hrank = acc->last_rank;
+
+    if(hrank && hrank->rank == rank)
+        return(hrank);
+
+    HASH_FIND(hlink, acc->rank_hash_table, &rank, sizeof(rank), hrank);
+    if(!hrank) {
+        hrank = acc_pool_alloc(&acc->rank_pool);
+        if(!hrank)
+            return(NULL);
+        hrank->rank = rank;
+        HASH_ADD(hlink, acc->rank_hash_table, rank, sizeof(rank), hrank);
+    }
+    acc->last_rank = hrank;
+
+    return(hrank);
+}
+
+/* combine the metrics of one or more records of a file into its entry */
+static void acc_update_file(file_hash_entry_t *hfile, int64_t r_bytes,
+                            int64_t w_bytes, int64_t max_offset,
+                            int64_t nprocs)
+{
+    hfile->r_bytes += r_bytes;
+    hfile->w_bytes += w_bytes;
+    if(max_offset == -1 || hfile->max_offset == -1)
+        hfile->max_offset = -1; /* this module doesn't support this */
+    else
+        hfile->max_offset = max(hfile->max_offset, max_offset);
+    if(nprocs == -1 || hfile->nprocs == -1)
+        hfile->nprocs = -1; /* globally shared */
+    else
+        hfile->nprocs += nprocs; /* partially shared or unique, as far as we
+                                    know so far */
+}
+
 int darshan_accumulator_create(darshan_module_id id,
                                int64_t job_nprocs,
                                darshan_accumulator*   new_accumulator)
@@ -75,16 +206,8 @@ int darshan_accumulator_create(darshan_module_id id,
         *new_accumulator = NULL;
         return(-1);
     }
-    /* 3 arrays handled in one malloc */
-    (*new_accumulator)->rank_cumul_io_total_time = calloc(job_nprocs*3, sizeof(double));
-    if(!(*new_accumulator)->rank_cumul_io_total_time) {
-        free((*new_accumulator)->agg_record);
-        free(*new_accumulator);
-        *new_accumulator = NULL;
-        return(-1);
-    }
-    (*new_accumulator)->rank_cumul_rw_only_time = &((*new_accumulator)->rank_cumul_io_total_time[job_nprocs]);
-    (*new_accumulator)->rank_cumul_md_only_time = &((*new_accumulator)->rank_cumul_io_total_time[job_nprocs*2]);
+    (*new_accumulator)->file_pool.entry_size = sizeof(file_hash_entry_t);
+    (*new_accumulator)->rank_pool.entry_size = sizeof(rank_hash_entry_t);
 
     return(0);
 }
@@ -93,7 +216,7 @@ int darshan_accumulator_inject(darshan_accumulator acc,
                                void*               record_array,
                                int                 record_count)
 {
-    int i;
+    int i, j;
     void* new_record = record_array;
     uint64_t rec_id;
     int64_t r_bytes;
@@ -106,6 +229,7 @@ int darshan_accumulator_inject(darshan_accumulator acc,
     double rw_only_time;
     int ret;
     file_hash_entry_t *hfile = NULL;
+    rank_hash_entry_t *hrank = NULL;
 
     if(!mod_logutils[acc->module_id]->log_agg_records ||
        !mod_logutils[acc->module_id]->log_sizeof_record ||
@@ -122,6 +246,12 @@ int darshan_accumulator_inject(darshan_accumulator acc,
             mod_logutils[acc->module_id]->log_agg_records(new_record, acc->agg_record, 0);
         acc->num_records++;
 
+        if(acc->sketches) {
+            for(j = 0; j < DARSHAN_COMMON_VALUE_SET_MAX; j++)
+                darshan_common_value_sketch_add_record(&acc->sketches[j],
+                    acc->module_id, j, new_record);
+        }
+
         /* retrieve generic metrics from record */
         ret = mod_logutils[acc->module_id]->log_record_metrics( new_record,
             &rec_id, &r_bytes, &w_bytes, &max_offset, &io_total_time,
@@ -143,48 +273,126 @@ int darshan_accumulator_inject(darshan_accumulator acc,
              * each rank separately
              */
             assert(rank < acc->job_nprocs);
-            acc->rank_cumul_io_total_time[rank] += io_total_time;
-            acc->rank_cumul_rw_only_time[rank] += rw_only_time;
-            acc->rank_cumul_md_only_time[rank] += md_only_time;
+            hrank = acc_get_rank(acc, rank);
+            if(!hrank)
+                return(-1);
+            hrank->io_total_time += io_total_time;
+            hrank->rw_only_time += rw_only_time;
+            hrank->md_only_time += md_only_time;
         }
 
         /* track in hash table for per-file metrics; there may be multiple
          * records that refer to the same file */
-        HASH_FIND(hlink, acc->file_hash_table, &rec_id, sizeof(rec_id), hfile);
-        if(!hfile) {
-            /* first time we've seen this file in this accumulator */
-            hfile = calloc(1, sizeof(*hfile));
-            if(!hfile) {
-                return(-1);
-            }
+        hfile = acc_get_file(acc, rec_id);
+        if(!hfile)
+            return(-1);
+        acc_update_file(hfile, r_bytes, w_bytes, max_offset, nprocs);
+
+        /* advance to next record */
+        new_record += mod_logutils[acc->module_id]->log_sizeof_record(new_record);
+    }
+
+    return(0);
+}
+
+int darshan_accumulator_merge(darshan_accumulator dest,
+                              darshan_accumulator src)
+{
+    file_hash_entry_t *sfile, *dfile, *tmp_file;
+    rank_hash_entry_t *srank, *drank, *tmp_rank;
+    int i;
+
+    if(dest->module_id != src->module_id)
+        return(-1);
 
-            /* add to hash table */
-            hfile->rec_id = rec_id;
-            HASH_ADD(hlink, acc->file_hash_table, rec_id, sizeof(rec_id), hfile);
+    if(src->job_nprocs > dest->job_nprocs)
+        dest->job_nprocs = src->job_nprocs;
+    if(src->num_records == 0)
+        return(0);
+
+    /* combine aggregate records */
+    if(dest->num_records == 0)
+        memcpy(dest->agg_record, src->agg_record,
+            mod_logutils[src->module_id]->log_sizeof_record(src->agg_record));
+    else
+        mod_logutils[src->module_id]->log_agg_records(src->agg_record,
+            dest->agg_record, 0);
+    dest->num_records += src->num_records;
+
+    if(dest->sketches) {
+        for(i = 0; i < DARSHAN_COMMON_VALUE_SET_MAX; i++) {
+            if(src->sketches)
+                darshan_common_value_sketch_merge(&dest->sketches[i],
+                    &src->sketches[i]);
+            else
+                /* only the aggregate record's common values are known */
+                darshan_common_value_sketch_add_record(&dest->sketches[i],
+                    src->module_id, i, src->agg_record);
         }
+    }
 
-        /* we have hfile at this point (either existing or newly created);
-         * increment metrics
-         */
-        hfile->r_bytes += r_bytes;
-        hfile->w_bytes += w_bytes;
-        if(max_offset == -1)
-            hfile->max_offset = -1; /* this module doesn't support this */
-        else
-            hfile->max_offset = max(hfile->max_offset, max_offset);
-        if (nprocs == -1)
-            hfile->nprocs = -1; /* globally shared */
-        else
-            hfile->nprocs += nprocs; /* partially shared or unique, as far as we
-                                        know so far */
+    dest->total_bytes += src->total_bytes;
+    dest->shared_io_total_time_by_slowest += src->shared_io_total_time_by_slowest;
 
-        /* advance to next record */
-        new_record += mod_logutils[acc->module_id]->log_sizeof_record(new_record);
+    HASH_ITER(hlink, src->rank_hash_table, srank, tmp_rank)
+    {
+        drank = acc_get_rank(dest, srank->rank);
+        if(!drank)
+            return(-1);
+        drank->io_total_time += srank->io_total_time;
+        drank->rw_only_time += srank->rw_only_time;
+        drank->md_only_time += srank->md_only_time;
     }
 
+    HASH_ITER(hlink, src->file_hash_table, sfile, tmp_file)
+    {
+        dfile = acc_get_file(dest, sfile->rec_id);
+        if(!dfile)
+            return(-1);
+        acc_update_file(dfile, sfile->r_bytes, sfile->w_bytes,
+            sfile->max_offset, sfile->nprocs);
+    }
+
+    return(0);
+}
+
+int darshan_accumulator_track_common_values(darshan_accumulator acc)
+{
+    int i;
+
+    if(!mod_logutils[acc->module_id]->log_common_values ||
+       acc->num_records > 0)
+        return(-1);
+    if(acc->sketches)
+        return(0);
+
+    acc->sketches = malloc(DARSHAN_COMMON_VALUE_SET_MAX *
+        sizeof(*acc->sketches));
+    if(!acc->sketches)
+        return(-1);
+    for(i = 0; i < DARSHAN_COMMON_VALUE_SET_MAX; i++)
+        darshan_common_value_sketch_init(&acc->sketches[i]);
+
     return(0);
 }
 
+int darshan_accumulator_emit_common_values(darshan_accumulator acc,
+                                           int set,
+                                           struct darshan_common_value* top,
+                                           int n)
+{
+    int64_t *values, *counts;
+
+    if(!acc->sketches || set < 0 || set >= DARSHAN_COMMON_VALUE_SET_MAX)
+        return(-1);
+    /* make sure the module tracks this set at all */
+    if(mod_logutils[acc->module_id]->log_common_values(acc->agg_record, set,
+       &values, &counts) == 0)
+        return(-1);
+
+    return(darshan_common_value_sketch_top(&acc->sketches[set], top, n));
+}
+
 /* NOTE: use -1 for procs to indicate that the file was globally shared.
  * This will be marked in the category counters if we find a file hash that
  * was globally shared or if the proc value gets incremented to cover all
@@ -222,8 +430,10 @@ int darshan_accumulator_emit(darshan_accumulator             acc,
 {
     file_hash_entry_t *curr = NULL;
     file_hash_entry_t *tmp_file = NULL;
+    rank_hash_entry_t *curr_rank = NULL;
+    rank_hash_entry_t *tmp_rank = NULL;
     struct darshan_file_category_counters* cat_counters;
-    int64_t i;
+    int i;
 
     memset(metrics, 0, sizeof(*metrics));
 
@@ -257,22 +467,33 @@ int darshan_accumulator_emit(darshan_accumulator             acc,
 
     /* copy out aggregate record we have been accumulating so far */
     memcpy(summation_record, acc->agg_record, mod_logutils[acc->module_id]->log_sizeof_record(acc->agg_record));
+    if(acc->sketches && acc->num_records > 0) {
+        /* replace the running top 4 with the sketches' most common values */
+        for(i = 0; i < DARSHAN_COMMON_VALUE_SET_MAX; i++)
+            darshan_common_value_sketch_put_record(&acc->sketches[i],
+                acc->module_id, i, summation_record);
+    }
 
     /* calculate derived performance metrics */
     metrics->total_bytes = acc->total_bytes;
     metrics->shared_io_total_time_by_slowest
         = acc->shared_io_total_time_by_slowest;
-    /* determine which rank had the slowest path through unique files */
-    for (i = 0; i < acc->job_nprocs; i++) {
-        if (acc->rank_cumul_io_total_time[i]
-            > metrics->unique_io_total_time_by_slowest) {
+    /* determine which rank had the slowest path through unique files; on
+     * ties, the lowest rank wins
+     */
+    HASH_ITER(hlink, acc->rank_hash_table, curr_rank, tmp_rank)
+    {
+        if (curr_rank->io_total_time > metrics->unique_io_total_time_by_slowest ||
+            (curr_rank->io_total_time > 0 &&
+             curr_rank->io_total_time == metrics->unique_io_total_time_by_slowest &&
+             curr_rank->rank < metrics->unique_io_slowest_rank)) {
             metrics->unique_io_total_time_by_slowest
-                = acc->rank_cumul_io_total_time[i];
+                = curr_rank->io_total_time;
             metrics->unique_rw_only_time_by_slowest
-                = acc->rank_cumul_rw_only_time[i];
+                = curr_rank->rw_only_time;
             metrics->unique_md_only_time_by_slowest
-                = acc->rank_cumul_md_only_time[i];
-            metrics->unique_io_slowest_rank = i;
+                = curr_rank->md_only_time;
+            metrics->unique_io_slowest_rank = curr_rank->rank;
         }
     }
 
@@ -295,25 +516,21 @@ int darshan_accumulator_emit(darshan_accumulator             acc,
 
 int darshan_accumulator_destroy(darshan_accumulator acc)
 {
-    file_hash_entry_t *curr = NULL;
-    file_hash_entry_t *tmp_file = NULL;
-
     if(!acc)
         return(0);
 
-    /* three arrays, but handled by one malloc (see _create()) */
-    if(acc->rank_cumul_io_total_time)
-        free(acc->rank_cumul_io_total_time);
-
     if(acc->agg_record)
         free(acc->agg_record);
+    if(acc->sketches)
+        free(acc->sketches);
 
-    /* walk file hash table, freeing memory as we go */
-    HASH_ITER(hlink, acc->file_hash_table, curr, tmp_file)
-    {
-        HASH_DELETE(hlink, acc->file_hash_table, curr);
-        free(curr);
-    }
+    /* entries live in the pools, so only the hash tables' own memory needs
+     * to be released here
+     */
+    HASH_CLEAR(hlink, acc->file_hash_table);
+    HASH_CLEAR(hlink, acc->rank_hash_table);
+    acc_pool_destroy(&acc->file_pool);
+    acc_pool_destroy(&acc->rank_pool);
 
     free(acc);
 
@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) 2026 University of Chicago.
+ * See COPYRIGHT notice in top-level directory.
+ *
+ */
+
+/* This file implements the record id set (darshan_record_id_set*) and
+ * name filter (darshan_name_filter*) functions in darshan-logutils.h.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <regex.h>
+
+#include "darshan-logutils.h"
+
+#define ID_SET_MIN_SIZE 64
+
+/* open addressing hash table of record ids; record ids are already hashes,
+ * but are mixed again so that sets of similar ids spread out.  0 marks an
+ * empty slot, so the id 0 is tracked separately.
+ */
+struct darshan_record_id_set
+{
+    darshan_record_id *slots;
+    size_t size;  /* power of 2 */
+    int64_t count;
+    int has_zero;
+};
+
+/* a name pattern, which is either a plain string (possibly anchored at
+ * the start and/or end of the name) or a compiled regular expression
+ */
+struct name_pattern
+{
+    char *literal;
+    size_t literal_len;
+    int anchor_start;
+    int anchor_end;
+    int is_regex;
+    regex_t re;
+};
+
+struct darshan_name_filter
+{
+    int mode;
+    int n_patterns;
+    struct name_pattern *patterns;
+};
+
+static size_t id_set_slot(struct darshan_record_id_set *set,
+    darshan_record_id id)
+{
+    return((size_t)((id * 0x9E3779B97F4A7C15ULL) >> 32) & (set->size - 1));
+}
+
+static void id_set_insert(struct darshan_record_id_set *set,
+    darshan_record_id id)
+{
+    size_t i = id_set_slot(set, id);
+
+    while(set->slots[i] && set->slots[i] != id)
+        i = (i + 1) & (set->size - 1);
+    if(!set->slots[i])
+    {
+        set->slots[i] = id;
+        set->count++;
+    }
+}
+
+static int id_set_resize(struct darshan_record_id_set *set, size_t size)
+{
+    darshan_record_id *old_slots = set->slots;
+    size_t old_size = set->size;
+    size_t i;
+
+    set->slots = calloc(size, sizeof(*set->slots));
+    if(!set->slots)
+    {
+        set->slots = old_slots;
+        return(-1);
+    }
+    set->size = size;
+    set->count = set->has_zero;
+
+    for(i = 0; i < old_size; i++)
+        if(old_slots[i])
+            id_set_insert(set, old_slots[i]);
+    free(old_slots);
+
+    return(0);
+}
+
+struct darshan_record_id_set *darshan_record_id_set_create(
+    const darshan_record_id *ids, int64_t count)
+{
+    struct darshan_record_id_set *set;
+    size_t size = ID_SET_MIN_SIZE;
+    int64_t i;
+
+    set = calloc(1, sizeof(*set));
+    if(!set)
+        return(NULL);
+
+    /* keep the table at most half full */
+    while(size < 2 * (size_t)count)
+        size *= 2;
+    if(id_set_resize(set, size) < 0)
+    {
+        free(set);
+        return(NULL);
+    }
+
+    for(i = 0; i < count; i++)
+    {
+        if(darshan_record_id_set_add(set, ids[i]) < 0)
+        {
+            darshan_record_id_set_destroy(set);
+            return(NULL);
+        }
+    }
+
+    return(set);
+}
+
+int darshan_record_id_set_add(struct darshan_record_id_set *set,
+    darshan_record_id id)
+{
+    if(id == 0)
+    {
+        if(!set->has_zero)
+            set->count++;
+        set->has_zero = 1;
+        return(0);
+    }
+
+    if(2 * (size_t)(set->count + 1) > set->size &&
+       id_set_resize(set, set->size * 2) < 0)
+        return(-1);
+    id_set_insert(set, id);
+
+    return(0);
+}
+
+int darshan_record_id_set_contains(struct darshan_record_id_set *set,
+    darshan_record_id id)
+{
+    size_t i;
+
+    if(id == 0)
+        return(set->has_zero);
+
+    for(i = id_set_slot(set, id); set->slots[i];
+        i = (i + 1) & (set->size - 1))
+    {
+        if(set->slots[i] == id)
+            return(1);
+    }
+
+    return(0);
+}
+
+int64_t darshan_record_id_set_count(struct darshan_record_id_set *set)
+{
+    return(set->count);
+}
+
+void darshan_record_id_set_destroy(struct darshan_record_id_set *set)
+{
+    if(!set)
+        return;
+    free(set->slots);
+    free(set);
+}
+
+/* patterns without regular expression operators, other than escaped
+ * punctuation and anchors at either end, are matched as plain strings
+ *
+ * returns 1 if the pattern was set up as a plain string, 0 if it needs to
+ * be compiled, -1 on failure
+ */
+static int name_pattern_literal(const char *pattern, struct name_pattern *p)
+{
+    const char *c = pattern;
+    size_t len = 0;
+
+    p->literal = malloc(strlen(pattern) + 1);
+    if(!p->literal)
+        return(-1);
+
+    if(*c == '^')
+    {
+        p->anchor_start = 1;
+        c++;
+    }
+    while(*c)
+    {
+        if(*c == '\\')
+        {
+            /* escaped letters and digits are classes or back-references,
+             * and GNU regex treats some punctuation as word anchors
+             */
+            if(!c[1] || isalnum((unsigned char)c[1]) || strchr("<>`'", c[1]))
+                break;
+            p->literal[len++] = c[1];
+            c += 2;
+        }
+        else if(*c == '$' && c[1] == '\0')
+        {
+            p->anchor_end = 1;
+            c++;
+        }
+        else if(strchr(".[]()*+?{}|^$", *c))
+            break;
+        else
+            p->literal[len++] = *c++;
+    }
+
+    if(*c)
+    {
+        free(p->literal);
+        p->literal = NULL;
+        p->anchor_start = p->anchor_end = 0;
+        return(0);
+    }
+
+    p->literal[len] = '\0';
+    p->literal_len = len;
+    return(1);
+}
+
+static int name_pattern_match(struct name_pattern *p, const char *name)
+{
+    size_t name_len;
+
+    if(p->is_regex)
+        return(regexec(&p->re, name, 0, NULL, 0) == 0);
+
+    if(p->anchor_start && p->anchor_end)
+        return(strcmp(name, p->literal) == 0);
+    if(p->anchor_start)
+        return(strncmp(name, p->literal, p->literal_len) == 0);
+    if(p->anchor_end)
+    {
+        name_len = strlen(name);
+        return(name_len >= p->literal_len &&
+            memcmp(name + name_len - p->literal_len, p->literal,
+                p->literal_len) == 0);
+    }
+    return(strstr(name, p->literal) != NULL);
+}
+
+struct darshan_name_filter *darshan_name_filter_create(
+    const char **patterns, int n_patterns, int mode)
+{
+    struct darshan_name_filter *filter;
+    struct name_pattern *p;
+    int ret;
+    int i;
+
+    if(mode != DARSHAN_NAME_FILTER_EXCLUDE && mode != DARSHAN_NAME_FILTER_INCLUDE)
+        return(NULL);
+
+    filter = calloc(1, sizeof(*filter));
+    if(!filter)
+        return(NULL);
+    filter->mode = mode;
+    if(n_patterns > 0)
+    {
+        filter->patterns = calloc(n_patterns, sizeof(*filter->patterns));
+        if(!filter->patterns)
+        {
+            free(filter);
+            return(NULL);
+        }
+    }
+
+    for(i = 0; i < n_patterns; i++)
+    {
+        p = &filter->patterns[i];
+        ret = name_pattern_literal(patterns[i], p);
+        if(ret == 0)
+        {
+            if(regcomp(&p->re, patterns[i], REG_EXTENDED | REG_NOSUB) != 0)
+                ret = -1;
+            else
+                p->is_regex = 1;
+        }
+        if(ret < 0)
+        {
+            darshan_name_filter_destroy(filter);
+            return(NULL);
+        }
+        filter->n_patterns++;
+    }
+
+    return(filter);
+}
+
+int darshan_name_filter_match(struct darshan_name_filter *filter,
+    const char *name)
+{
+    int i;
+
+    if(filter->n_patterns == 0)
+        return(1);
+
+    for(i = 0; i < filter->n_patterns; i++)
+        if(name_pattern_match(&filter->patterns[i], name))
+            return(filter->mode == DARSHAN_NAME_FILTER_INCLUDE);
+
+    return(filter->mode == DARSHAN_NAME_FILTER_EXCLUDE);
+}
+
+void darshan_name_filter_destroy(struct darshan_name_filter *filter)
+{
+    int i;
+
+    if(!filter)
+        return;
+
+    for(i = 0; i < filter->n_patterns; i++)
+    {
+        if(filter->patterns[i].is_regex)
+            regfree(&filter->patterns[i].re);
+        free(filter->patterns[i].literal);
+    }
+    free(filter->patterns);
+    free(filter);
+}
+
+/*
+ * Local variables:
+ *  c-indent-level: 4
+ *  c-basic-offset: 4
+ * End:
+ *
+ * vim: ts=8 sts=4 sw=4 expandtab
+ */
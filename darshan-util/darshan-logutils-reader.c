@@ -0,0 +1,341 @@
+/*
+ * Copyright (C) 2026 University of Chicago.
+ * See COPYRIGHT notice in top-level directory.
+ *
+ */
+
+/* This file implements the parallel reader API (darshan_log_reader* and
+ * darshan_mod_iter*) functions in darshan-logutils.h.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "darshan-logutils.h"
+
+/* maximum number of decoded records buffered ahead of the caller per
+ * iterator
+ */
+#define DARSHAN_MOD_ITER_QUEUE_DEPTH 1024
+
+enum darshan_mod_iter_state
+{
+    DARSHAN_MOD_ITER_PENDING = 0, /* not yet decoded by anyone */
+    DARSHAN_MOD_ITER_PREFETCH,    /* being decoded by a reader thread */
+    DARSHAN_MOD_ITER_INLINE,      /* decoded by the caller of next() */
+    DARSHAN_MOD_ITER_DONE         /* reader thread finished decoding */
+};
+
+struct darshan_mod_iter_st
+{
+    struct darshan_log_reader_st *reader;
+    darshan_module_id mod_id;
+    /* private descriptor, so each iterator has its own file offset and
+     * decompression state
+     */
+    darshan_fd fd;
+    enum darshan_mod_iter_state state;
+    int status;     /* final log_get_record() return value when DONE */
+    int cancel;     /* set when the iterator is closed while prefetching */
+    /* ring of records decoded ahead of the caller */
+    void *queue[DARSHAN_MOD_ITER_QUEUE_DEPTH];
+    int head;
+    int count;
+    pthread_cond_t cond; /* signalled on queue and state changes */
+    struct darshan_mod_iter_st *next;
+};
+
+struct darshan_log_reader_st
+{
+    char *log_path;
+    int nthreads;
+    pthread_t *threads;
+    pthread_mutex_t mutex;      /* protects everything below and all iterators */
+    pthread_cond_t work_cond;   /* signalled on new iterators and shutdown */
+    struct darshan_mod_iter_st *iters; /* in creation order */
+    int shutdown;
+};
+
+static void *darshan_log_reader_worker(void *arg);
+static void darshan_mod_iter_prefetch(struct darshan_mod_iter_st *iter);
+
+darshan_log_reader darshan_log_reader_open(const char *name, int nthreads)
+{
+    struct darshan_log_reader_st *reader;
+    int i;
+
+    if(nthreads < 0)
+        return(NULL);
+
+    reader = calloc(1, sizeof(*reader));
+    if(!reader)
+        return(NULL);
+    reader->log_path = strdup(name);
+    if(!reader->log_path)
+    {
+        free(reader);
+        return(NULL);
+    }
+    pthread_mutex_init(&reader->mutex, NULL);
+    pthread_cond_init(&reader->work_cond, NULL);
+
+    if(nthreads > 0)
+    {
+        reader->threads = malloc(nthreads * sizeof(*reader->threads));
+        if(!reader->threads)
+        {
+            darshan_log_reader_close(reader);
+            return(NULL);
+        }
+        for(i = 0; i < nthreads; i++)
+        {
+            if(pthread_create(&reader->threads[i], NULL,
+                darshan_log_reader_worker, reader) != 0)
+            {
+                fprintf(stderr, "Error: unable to create log reader thread.\n");
+                darshan_log_reader_close(reader);
+                return(NULL);
+            }
+            reader->nthreads++;
+        }
+    }
+
+    return(reader);
+}
+
+darshan_mod_iter darshan_log_reader_mod_iter(darshan_log_reader reader,
+                                             darshan_module_id  mod_id)
+{
+    struct darshan_mod_iter_st *iter, **tail;
+
+    if(mod_id < 0 || mod_id >= DARSHAN_KNOWN_MODULE_COUNT || !mod_logutils[mod_id])
+        return(NULL);
+
+    iter = calloc(1, sizeof(*iter));
+    if(!iter)
+        return(NULL);
+    iter->fd = darshan_log_open(reader->log_path);
+    if(!iter->fd)
+    {
+        free(iter);
+        return(NULL);
+    }
+    iter->reader = reader;
+    iter->mod_id = mod_id;
+    iter->state = DARSHAN_MOD_ITER_PENDING;
+    pthread_cond_init(&iter->cond, NULL);
+
+    /* append, so reader threads work through modules in the order the
+     * caller is likely to consume them
+     */
+    pthread_mutex_lock(&reader->mutex);
+    for(tail = &reader->iters; *tail; tail = &(*tail)->next);
+    *tail = iter;
+    pthread_cond_signal(&reader->work_cond);
+    pthread_mutex_unlock(&reader->mutex);
+
+    return(iter);
+}
+
+int darshan_mod_iter_next(darshan_mod_iter iter, void **rec)
+{
+    struct darshan_log_reader_st *reader = iter->reader;
+    int ret;
+
+    *rec = NULL;
+
+    pthread_mutex_lock(&reader->mutex);
+    /* decode on this thread if no reader thread has claimed the module,
+     * rather than waiting for one to become available
+     */
+    if(iter->state == DARSHAN_MOD_ITER_PENDING)
+        iter->state = DARSHAN_MOD_ITER_INLINE;
+    if(iter->state == DARSHAN_MOD_ITER_INLINE)
+    {
+        pthread_mutex_unlock(&reader->mutex);
+        return(mod_logutils[iter->mod_id]->log_get_record(iter->fd, rec));
+    }
+
+    while(iter->count == 0 && iter->state != DARSHAN_MOD_ITER_DONE)
+        pthread_cond_wait(&iter->cond, &reader->mutex);
+    if(iter->count > 0)
+    {
+        *rec = iter->queue[iter->head];
+        iter->head = (iter->head + 1) % DARSHAN_MOD_ITER_QUEUE_DEPTH;
+        iter->count--;
+        /* the reader thread only waits on a full queue */
+        if(iter->count == DARSHAN_MOD_ITER_QUEUE_DEPTH - 1)
+            pthread_cond_broadcast(&iter->cond);
+        ret = 1;
+    }
+    else
+        ret = iter->status;
+    pthread_mutex_unlock(&reader->mutex);
+
+    return(ret);
+}
+
+int darshan_mod_iter_next_filtered(darshan_mod_iter iter, void **rec,
+                                   struct darshan_record_id_set *ids)
+{
+    int ret;
+
+    while((ret = darshan_mod_iter_next(iter, rec)) == 1)
+    {
+        if(!ids || darshan_record_id_set_contains(ids,
+           ((struct darshan_base_record *)*rec)->id))
+            break;
+        free(*rec);
+    }
+
+    return(ret);
+}
+
+void darshan_mod_iter_close(darshan_mod_iter iter)
+{
+    struct darshan_log_reader_st *reader;
+    struct darshan_mod_iter_st **prev;
+
+    if(!iter)
+        return;
+    reader = iter->reader;
+
+    pthread_mutex_lock(&reader->mutex);
+    /* wait for a reader thread to let go of this iterator */
+    if(iter->state == DARSHAN_MOD_ITER_PREFETCH)
+    {
+        iter->cancel = 1;
+        pthread_cond_broadcast(&iter->cond);
+        while(iter->state != DARSHAN_MOD_ITER_DONE)
+            pthread_cond_wait(&iter->cond, &reader->mutex);
+    }
+    for(prev = &reader->iters; *prev != iter; prev = &(*prev)->next)
+        assert(*prev);
+    *prev = iter->next;
+    pthread_mutex_unlock(&reader->mutex);
+
+    while(iter->count > 0)
+    {
+        free(iter->queue[iter->head]);
+        iter->head = (iter->head + 1) % DARSHAN_MOD_ITER_QUEUE_DEPTH;
+        iter->count--;
+    }
+    darshan_log_close(iter->fd);
+    pthread_cond_destroy(&iter->cond);
+    free(iter);
+
+    return;
+}
+
+void darshan_log_reader_close(darshan_log_reader reader)
+{
+    int i;
+
+    if(!reader)
+        return;
+
+    while(reader->iters)
+        darshan_mod_iter_close(reader->iters);
+
+    pthread_mutex_lock(&reader->mutex);
+    reader->shutdown = 1;
+    pthread_cond_broadcast(&reader->work_cond);
+    pthread_mutex_unlock(&reader->mutex);
+    for(i = 0; i < reader->nthreads; i++)
+        pthread_join(reader->threads[i], NULL);
+
+    pthread_cond_destroy(&reader->work_cond);
+    pthread_mutex_destroy(&reader->mutex);
+    free(reader->threads);
+    free(reader->log_path);
+    free(reader);
+
+    return;
+}
+
+/********************************************************
+ *             internal helper functions                *
+ ********************************************************/
+
+/* reader threads claim pending iterators in creation order and decode
+ * them until the reader is closed
+ */
+static void *darshan_log_reader_worker(void *arg)
+{
+    struct darshan_log_reader_st *reader = arg;
+    struct darshan_mod_iter_st *iter;
+
+    pthread_mutex_lock(&reader->mutex);
+    while(!reader->shutdown)
+    {
+        for(iter = reader->iters; iter; iter = iter->next)
+        {
+            if(iter->state == DARSHAN_MOD_ITER_PENDING)
+                break;
+        }
+        if(!iter)
+        {
+            pthread_cond_wait(&reader->work_cond, &reader->mutex);
+            continue;
+        }
+
+        iter->state = DARSHAN_MOD_ITER_PREFETCH;
+        darshan_mod_iter_prefetch(iter);
+    }
+    pthread_mutex_unlock(&reader->mutex);
+
+    return(NULL);
+}
+
+/* decodes all records of a claimed iterator into its queue; called and
+ * returns with the reader mutex held
+ */
+static void darshan_mod_iter_prefetch(struct darshan_mod_iter_st *iter)
+{
+    struct darshan_log_reader_st *reader = iter->reader;
+    void *rec;
+    int ret;
+
+    while(!iter->cancel)
+    {
+        pthread_mutex_unlock(&reader->mutex);
+        rec = NULL;
+        ret = mod_logutils[iter->mod_id]->log_get_record(iter->fd, &rec);
+        pthread_mutex_lock(&reader->mutex);
+        if(ret < 1)
+        {
+            iter->status = ret;
+            break;
+        }
+
+        while(iter->count == DARSHAN_MOD_ITER_QUEUE_DEPTH && !iter->cancel)
+            pthread_cond_wait(&iter->cond, &reader->mutex);
+        if(iter->cancel)
+        {
+            free(rec);
+            break;
+        }
+        iter->queue[(iter->head + iter->count) % DARSHAN_MOD_ITER_QUEUE_DEPTH] = rec;
+        iter->count++;
+        /* the caller only waits on an empty queue */
+        if(iter->count == 1)
+            pthread_cond_broadcast(&iter->cond);
+    }
+
+    iter->state = DARSHAN_MOD_ITER_DONE;
+    pthread_cond_broadcast(&iter->cond);
+
+    return;
+}
+
+/*
+ * Local variables:
+ *  c-indent-level: 4
+ *  c-basic-offset: 4
+ * End:
+ *
+ * vim: ts=8 sts=4 sw=4 expandtab
+ */
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2026 University of Chicago.
+ * See COPYRIGHT notice in top-level directory.
+ *
+ */
+
+/* This file implements the common value sketch API
+ * (darshan_common_value_sketch*) functions in darshan-logutils.h.
+ *
+ * Sketches use the space-saving algorithm (Metwally et al.) with weighted
+ * updates: a value that is not tracked yet replaces the value with the
+ * smallest count once the sketch is full, and inherits that count as its
+ * error.  Two sketches are merged as described by Agarwal et al.
+ * ("Mergeable Summaries"): a value missing from a full sketch may have
+ * occurred as often as that sketch's smallest count, so the smallest count
+ * is added to both the count and the error of such values before the
+ * largest counts are kept.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "darshan-logutils.h"
+
+/* order by decreasing count; ties are broken by larger value first, as in
+ * the common value counters of module records
+ */
+static int common_value_cmp(const void *a, const void *b)
+{
+    const struct darshan_common_value *va = a;
+    const struct darshan_common_value *vb = b;
+
+    if(va->count != vb->count)
+        return((va->count > vb->count) ? -1 : 1);
+    if(va->value != vb->value)
+        return((va->value > vb->value) ? -1 : 1);
+    return(0);
+}
+
+/* smallest count a value missing from the sketch could have */
+static int64_t sketch_min_count(struct darshan_common_value_sketch *sketch)
+{
+    int64_t min_count;
+    int i;
+
+    if(sketch->n_values < DARSHAN_COMMON_VALUE_SKETCH_SIZE)
+        return(0);
+
+    min_count = sketch->values[0].count;
+    for(i = 1; i < sketch->n_values; i++)
+        if(sketch->values[i].count < min_count)
+            min_count = sketch->values[i].count;
+
+    return(min_count);
+}
+
+void darshan_common_value_sketch_init(
+    struct darshan_common_value_sketch *sketch)
+{
+    memset(sketch, 0, sizeof(*sketch));
+}
+
+void darshan_common_value_sketch_add(
+    struct darshan_common_value_sketch *sketch,
+    int64_t value,
+    int64_t count)
+{
+    struct darshan_common_value *min = NULL;
+    int i;
+
+    if(count <= 0)
+        return;
+    sketch->total += count;
+
+    for(i = 0; i < sketch->n_values; i++)
+    {
+        if(sketch->values[i].value == value)
+        {
+            sketch->values[i].count += count;
+            return;
+        }
+        if(!min || sketch->values[i].count < min->count)
+            min = &sketch->values[i];
+    }
+
+    if(sketch->n_values < DARSHAN_COMMON_VALUE_SKETCH_SIZE)
+    {
+        min = &sketch->values[sketch->n_values++];
+        min->value = value;
+        min->count = count;
+        min->error = 0;
+        return;
+    }
+
+    /* evict the least common value */
+    min->value = value;
+    min->error = min->count;
+    min->count += count;
+}
+
+int darshan_common_value_sketch_add_record(
+    struct darshan_common_value_sketch *sketch,
+    darshan_module_id id,
+    int set,
+    void *rec)
+{
+    int64_t *values, *counts;
+    int n, i;
+
+    if(!mod_logutils[id]->log_common_values)
+        return(-1);
+    n = mod_logutils[id]->log_common_values(rec, set, &values, &counts);
+    if(n == 0)
+        return(-1);
+
+    for(i = 0; i < n; i++)
+        darshan_common_value_sketch_add(sketch, values[i], counts[i]);
+
+    return(0);
+}
+
+void darshan_common_value_sketch_merge(
+    struct darshan_common_value_sketch *dest,
+    struct darshan_common_value_sketch *src)
+{
+    struct darshan_common_value merged[2 * DARSHAN_COMMON_VALUE_SKETCH_SIZE];
+    int64_t dest_min = sketch_min_count(dest);
+    int64_t src_min = sketch_min_count(src);
+    char src_found[DARSHAN_COMMON_VALUE_SKETCH_SIZE] = {0};
+    int n = 0;
+    int i, j;
+
+    for(i = 0; i < dest->n_values; i++)
+    {
+        merged[n] = dest->values[i];
+        for(j = 0; j < src->n_values; j++)
+            if(src->values[j].value == dest->values[i].value)
+                break;
+        if(j < src->n_values)
+        {
+            merged[n].count += src->values[j].count;
+            merged[n].error += src->values[j].error;
+            src_found[j] = 1;
+        }
+        else
+        {
+            merged[n].count += src_min;
+            merged[n].error += src_min;
+        }
+        n++;
+    }
+    for(j = 0; j < src->n_values; j++)
+    {
+        if(src_found[j])
+            continue;
+        merged[n] = src->values[j];
+        merged[n].count += dest_min;
+        merged[n].error += dest_min;
+        n++;
+    }
+
+    /* keep the most common values */
+    qsort(merged, n, sizeof(merged[0]), common_value_cmp);
+    if(n > DARSHAN_COMMON_VALUE_SKETCH_SIZE)
+        n = DARSHAN_COMMON_VALUE_SKETCH_SIZE;
+    memcpy(dest->values, merged, n * sizeof(merged[0]));
+    dest->n_values = n;
+    dest->total += src->total;
+}
+
+int darshan_common_value_sketch_top(
+    struct darshan_common_value_sketch *sketch,
+    struct darshan_common_value *top,
+    int n)
+{
+    struct darshan_common_value sorted[DARSHAN_COMMON_VALUE_SKETCH_SIZE];
+
+    memcpy(sorted, sketch->values, sketch->n_values * sizeof(sorted[0]));
+    qsort(sorted, sketch->n_values, sizeof(sorted[0]), common_value_cmp);
+    if(n > sketch->n_values)
+        n = sketch->n_values;
+    if(n > 0)
+        memcpy(top, sorted, n * sizeof(sorted[0]));
+
+    return(n > 0 ? n : 0);
+}
+
+int darshan_common_value_sketch_put_record(
+    struct darshan_common_value_sketch *sketch,
+    darshan_module_id id,
+    int set,
+    void *rec)
+{
+    struct darshan_common_value top[DARSHAN_COMMON_VALUE_SKETCH_SIZE];
+    int64_t *values, *counts;
+    int n, n_top, i;
+
+    if(!mod_logutils[id]->log_common_values)
+        return(-1);
+    n = mod_logutils[id]->log_common_values(rec, set, &values, &counts);
+    if(n == 0)
+        return(-1);
+
+    n_top = darshan_common_value_sketch_top(sketch, top, n);
+    for(i = 0; i < n; i++)
+    {
+        values[i] = (i < n_top) ? top[i].value : 0;
+        counts[i] = (i < n_top) ? top[i].count : 0;
+    }
+
+    return(0);
+}
+
+/*
+ * Local variables:
+ *  c-indent-level: 4
+ *  c-basic-offset: 4
+ * End:
+ *
+ * vim: ts=8 sts=4 sw=4 expandtab
+ */
@@ -53,6 +53,15 @@ struct darshan_dz_state
     int prev_reg_id;
 };
 
+/* selects the name records that are read from a log; either field may be
+ * NULL
+ */
+struct darshan_namerec_filter
+{
+    struct darshan_name_filter *names;
+    struct darshan_record_id_set *ids;
+};
+
 /* internal fd data structure */
 struct darshan_fd_int_state
 {
@@ -72,7 +81,7 @@ struct darshan_fd_int_state
      * data from the log file
      */
     int (*get_namerecs)(void *, int, int, struct darshan_name_record_ref **,
-                        darshan_record_id *, int);
+                        struct darshan_namerec_filter *);
 
     /* compression/decompression stream read/write state */
     struct darshan_dz_state dz;
@@ -86,13 +95,26 @@ struct darshan_mod_logutil_funcs *mod_logutils[DARSHAN_KNOWN_MODULE_COUNT] =
 };
 #undef X
 
+/* destination for counters printed by log_print_record functions, set only
+ * during darshan_log_print_record_with_hook()
+ */
+__thread const struct darshan_counter_hook *darshan_cur_counter_hook = NULL;
+
 /* internal helper functions */
 static int darshan_mnt_info_cmp(const void *a, const void *b);
 static int darshan_log_get_namerecs(void *name_rec_buf, int buf_len,
     int swap_flag, struct darshan_name_record_ref **hash,
-    darshan_record_id *whitelist, int whitelist_count);
+    struct darshan_namerec_filter *filter);
+static int darshan_log_read_namehash(darshan_fd fd,
+    struct darshan_name_record_ref **hash,
+    struct darshan_namerec_filter *filter);
+static void darshan_log_namehash_to_info(struct darshan_name_record_ref **hash,
+    struct darshan_name_record_info **name_records, int *count);
 static int darshan_log_get_format_version(char *ver_str, int *maj_num, int *min_num);
 static int darshan_log_get_header(darshan_fd fd);
+static int darshan_log_decode_job(darshan_fd fd, char *job_buf, int job_buf_len,
+    struct darshan_job *job, char **trailing_data, int *trailing_data_size);
+static int darshan_log_peek_job(darshan_fd fd, char *job_buf, int len);
 static int darshan_log_put_header(darshan_fd fd);
 static int darshan_log_seek(darshan_fd fd, off_t offset);
 static int darshan_log_read(darshan_fd fd, void *buf, int len);
@@ -121,7 +143,7 @@ static int darshan_log_noz_read(darshan_fd fd, struct darshan_log_map map,
 /* backwards compatibility functions */
 static int darshan_log_get_namerecs_3_00(void *name_rec_buf, int buf_len,
     int swap_flag, struct darshan_name_record_ref **hash,
-    darshan_record_id *whitelist, int whitelist_count);
+    struct darshan_namerec_filter *filter);
 
 static char *darshan_util_lib_ver = PACKAGE_VERSION;
 
@@ -270,7 +292,6 @@ darshan_fd darshan_log_create(const char *name, enum darshan_comp_type comp_type
 int darshan_log_get_job(darshan_fd fd, struct darshan_job *job)
 {
     struct darshan_fd_int_state *state;
-    int log_ver_maj, log_ver_min;
     char job_buf[DARSHAN_JOB_RECORD_SIZE] = {0};
     int job_buf_sz = DARSHAN_JOB_RECORD_SIZE;
     char *trailing_data;
@@ -286,14 +307,6 @@ int darshan_log_get_job(darshan_fd fd, struct darshan_job *job)
     assert(state);
     assert(fd->job_map.len > 0 && fd->job_map.off > 0);
 
-    /* get major/minor version numbers */
-    ret = darshan_log_get_format_version(fd->version, &log_ver_maj, &log_ver_min);
-    if(ret < 0)
-    {
-        fprintf(stderr, "Error: unable to parse log file format version.\n");
-        return(-1);
-    }
-
     /* read the compressed job data from the log file */
     ret = darshan_log_dzread(fd, DARSHAN_JOB_REGION_ID, job_buf, job_buf_sz);
     if(ret <= (int)sizeof(*job))
@@ -302,47 +315,10 @@ int darshan_log_get_job(darshan_fd fd, struct darshan_job *job)
         return(-1);
     }
 
-    /* NOTE: job definition changed to include start/end time nsecs in ver 3.41 */
-    if(((log_ver_maj == 3) && (log_ver_min >= 41)) || (log_ver_maj > 3))
-    {
-        memcpy(job, job_buf, sizeof(*job));
-        trailing_data = &job_buf[sizeof(*job)];
-        trailing_data_size = DARSHAN_EXE_LEN+1;
-    }
-    else
-    {
-        /* backwards compatibility with prior of Darshan job struct,
-         * which does not have fields for start_time_nsec or
-         * end_time_nsec
-         */
-        int64_t *tmp_ptr = (int64_t *)job_buf;
-        job->uid = *(tmp_ptr++);
-        job->start_time_sec = *(tmp_ptr++);
-        job->start_time_nsec = 0;
-        job->end_time_sec = *(tmp_ptr++);
-        job->end_time_nsec = 0;
-        job->nprocs = *(tmp_ptr++);
-        job->jobid = *(tmp_ptr++);
-        memcpy(job->metadata, tmp_ptr, DARSHAN_JOB_METADATA_LEN);
-        trailing_data = (char *)tmp_ptr + DARSHAN_JOB_METADATA_LEN;
-        trailing_data_size = DARSHAN_EXE_LEN+1+(2*sizeof(int64_t));
-    }
-
-    if(fd->swap_flag)
-    {
-        /* swap bytes if necessary */
-        DARSHAN_BSWAP64(&job->uid);
-        DARSHAN_BSWAP64(&job->start_time_sec);
-        DARSHAN_BSWAP64(&job->end_time_sec);
-        /* don't byte swap fields explicitly set during up-conversion */
-        if(((log_ver_maj == 3) && (log_ver_min >= 41)) || (log_ver_maj > 3))
-        {
-            DARSHAN_BSWAP64(&job->start_time_nsec);
-            DARSHAN_BSWAP64(&job->end_time_nsec);
-        }
-        DARSHAN_BSWAP64(&job->nprocs);
-        DARSHAN_BSWAP64(&job->jobid);
-    }
+    ret = darshan_log_decode_job(fd, job_buf, ret, job, &trailing_data,
+        &trailing_data_size);
+    if(ret < 0)
+        return(-1);
 
     /* save trailing exe & mount information, so it can be retrieved later */
     if(!(state->exe_mnt_data))
@@ -605,6 +581,126 @@ int darshan_log_put_mounts(darshan_fd fd, struct darshan_mnt_info *mnt_data_arra
     return(0);
 }
 
+/* longest-prefix-match index over a mount table; one node per byte of
+ * mount path, children kept as a singly-linked sibling list
+ */
+struct darshan_mnt_trie_node
+{
+    int child;
+    int sibling;
+    int mnt_idx;    /* mount ending at this node, or -1 */
+    char c;
+};
+
+struct darshan_mnt_trie
+{
+    struct darshan_mnt_info *mnt_data_array;
+    struct darshan_mnt_trie_node *nodes;
+    int node_count;
+};
+
+/* darshan_mnt_trie_create()
+ *
+ * builds a lookup structure for matching file names against the given
+ * mount table. The table is referenced, not copied, and must outlive the
+ * returned trie. Matching follows the plain string prefix comparison the
+ * tools have always used (i.e., "/scratch1" matches "/scratch10/f"); if
+ * several entries have the same path, the first one in the table wins.
+ *
+ * returns the trie on success, NULL on failure
+ */
+struct darshan_mnt_trie *darshan_mnt_trie_create(
+    struct darshan_mnt_info *mnt_data_array, int count)
+{
+    struct darshan_mnt_trie *trie;
+    struct darshan_mnt_trie_node *node;
+    const char *c;
+    size_t max_nodes = 1;
+    int i, cur, next;
+
+    for(i = 0; i < count; i++)
+        max_nodes += strlen(mnt_data_array[i].mnt_path);
+
+    trie = malloc(sizeof(*trie));
+    if(!trie)
+        return(NULL);
+    trie->nodes = malloc(max_nodes * sizeof(*trie->nodes));
+    if(!trie->nodes)
+    {
+        free(trie);
+        return(NULL);
+    }
+    trie->mnt_data_array = mnt_data_array;
+    trie->nodes[0].child = trie->nodes[0].sibling = trie->nodes[0].mnt_idx = -1;
+    trie->nodes[0].c = '\0';
+    trie->node_count = 1;
+
+    for(i = 0; i < count; i++)
+    {
+        cur = 0;
+        for(c = mnt_data_array[i].mnt_path; *c; c++)
+        {
+            for(next = trie->nodes[cur].child; next >= 0;
+                next = trie->nodes[next].sibling)
+            {
+                if(trie->nodes[next].c == *c)
+                    break;
+            }
+            if(next < 0)
+            {
+                next = trie->node_count++;
+                node = &trie->nodes[next];
+                node->c = *c;
+                node->child = node->mnt_idx = -1;
+                node->sibling = trie->nodes[cur].child;
+                trie->nodes[cur].child = next;
+            }
+            cur = next;
+        }
+        if(trie->nodes[cur].mnt_idx < 0)
+            trie->nodes[cur].mnt_idx = i;
+    }
+
+    return(trie);
+}
+
+/* darshan_mnt_trie_lookup()
+ *
+ * returns the mount table entry with the longest path that is a prefix
+ * of the given file name, or NULL if no entry matches
+ */
+struct darshan_mnt_info *darshan_mnt_trie_lookup(struct darshan_mnt_trie *trie,
+    const char *path)
+{
+    struct darshan_mnt_trie_node *nodes = trie->nodes;
+    int cur = 0, match = nodes[0].mnt_idx;
+
+    for(; *path; path++)
+    {
+        for(cur = nodes[cur].child; cur >= 0; cur = nodes[cur].sibling)
+        {
+            if(nodes[cur].c == *path)
+                break;
+        }
+        if(cur < 0)
+            break;
+        if(nodes[cur].mnt_idx >= 0)
+            match = nodes[cur].mnt_idx;
+    }
+
+    if(match < 0)
+        return(NULL);
+    return(&trie->mnt_data_array[match]);
+}
+
+void darshan_mnt_trie_destroy(struct darshan_mnt_trie *trie)
+{
+    if(!trie)
+        return;
+    free(trie->nodes);
+    free(trie);
+}
+
 /* darshan_log_get_namehash()
  *
  * read the set of name records from the darshan log file and add to the
@@ -627,6 +723,45 @@ int darshan_log_get_namehash(darshan_fd fd, struct darshan_name_record_ref **has
 int darshan_log_get_filtered_namehash(darshan_fd fd, 
         struct darshan_name_record_ref **hash,
         darshan_record_id *whitelist, int whitelist_count)
+{
+    struct darshan_namerec_filter filter = {0};
+    int ret;
+
+    if(whitelist)
+    {
+        filter.ids = darshan_record_id_set_create(whitelist, whitelist_count);
+        if(!filter.ids)
+            return(-1);
+    }
+
+    ret = darshan_log_read_namehash(fd, hash, &filter);
+    darshan_record_id_set_destroy(filter.ids);
+
+    return(ret);
+}
+
+/* darshan_log_get_matching_namehash()
+ *
+ * read the name records from the darshan log file whose names pass the
+ * given name filter and whose ids are in the given set (either may be
+ * NULL) and add them to the given hash table; names that are filtered
+ * out are not copied out of the decompression buffer
+ *
+ * returns 0 on success, -1 on failure
+ */
+int darshan_log_get_matching_namehash(darshan_fd fd,
+        struct darshan_name_record_ref **hash,
+        struct darshan_name_filter *filter,
+        struct darshan_record_id_set *ids)
+{
+    struct darshan_namerec_filter namerec_filter = {filter, ids};
+
+    return(darshan_log_read_namehash(fd, hash, &namerec_filter));
+}
+
+static int darshan_log_read_namehash(darshan_fd fd,
+        struct darshan_name_record_ref **hash,
+        struct darshan_namerec_filter *filter)
 {
     struct darshan_fd_int_state *state;
     char *name_rec_buf;
@@ -676,7 +811,7 @@ int darshan_log_get_filtered_namehash(darshan_fd fd,
 
         /* extract any name records in the buffer */
         buf_processed = state->get_namerecs(name_rec_buf, buf_len, fd->swap_flag, hash,
-            whitelist, whitelist_count);
+            filter);
 
         /* copy any leftover data to beginning of buffer to parse next */
         memcpy(name_rec_buf, name_rec_buf + buf_processed, buf_len - buf_processed);
@@ -848,6 +983,29 @@ int darshan_log_put_mod(darshan_fd fd, darshan_module_id mod_id,
     return(0);
 }
 
+/* darshan_log_release_buffers()
+ *
+ * free the decompression buffers of a log opened for reading, while
+ * keeping it open; they are allocated again by the next read.  Must only
+ * be called once the last log region read has been read to its end.
+ *
+ */
+void darshan_log_release_buffers(darshan_fd fd)
+{
+    struct darshan_fd_int_state *state;
+
+    if(!fd)
+        return;
+    state = fd->state;
+    assert(state);
+
+    if(state->creat_flag)
+        return;
+
+    darshan_log_dzdestroy(fd);
+    return;
+}
+
 /* darshan_log_close()
  *
  * close an open darshan file descriptor, freeing any resources
@@ -957,10 +1115,234 @@ int darshan_log_get_job_runtime(darshan_fd fd, struct darshan_job job, double *r
     return(0);
 }
 
+/* darshan_log_peek()
+ *
+ * read the header and job record of a darshan log file, without setting up
+ * a file descriptor for reading the rest of the log: the compressed job data
+ * is only decompressed up to the end of the job record, so the exe and mount
+ * table that follow it are never decoded
+ *
+ * returns 0 on success, -1 on failure
+ */
+int darshan_log_peek(const char *name, struct darshan_log_peek_info *info)
+{
+    struct darshan_fd_s fd;
+    struct darshan_fd_int_state state;
+    char job_buf[sizeof(struct darshan_job)] = {0};
+    char *trailing_data;
+    int trailing_data_size;
+    int ret;
+
+    memset(&fd, 0, sizeof(fd));
+    memset(&state, 0, sizeof(state));
+    memset(info, 0, sizeof(*info));
+    fd.state = &state;
+
+    state.fildes = open(name, O_RDONLY);
+    if(state.fildes < 0)
+    {
+        fprintf(stderr, "Error: %s failed to open darshan log file %s: %s.\n", __func__,
+                name, strerror(errno));
+        return(-1);
+    }
+    strncpy(state.logfile_path, name, __DARSHAN_PATH_MAX - 1);
+
+    ret = darshan_log_get_header(&fd);
+    if(ret < 0)
+    {
+        fprintf(stderr, "Error: %s failed to read darshan log file header.\n",
+                __func__);
+        close(state.fildes);
+        return(-1);
+    }
+
+    ret = darshan_log_peek_job(&fd, job_buf, sizeof(job_buf));
+    if(ret >= 0)
+        ret = darshan_log_decode_job(&fd, job_buf, ret, &info->job,
+            &trailing_data, &trailing_data_size);
+    close(state.fildes);
+    if(ret < 0)
+    {
+        fprintf(stderr, "Error: failed to read darshan log file job data.\n");
+        return(-1);
+    }
+
+    memcpy(info->version, fd.version, sizeof(info->version));
+    info->version[sizeof(info->version)-1] = '\0';
+    darshan_log_get_job_runtime(&fd, info->job, &info->run_time);
+    info->partial_flag = fd.partial_flag;
+    for(ret = 0; ret < DARSHAN_MAX_MODS; ret++)
+    {
+        info->mod_len[ret] = fd.mod_map[ret].len;
+        info->mod_ver[ret] = fd.mod_ver[ret];
+    }
+
+    return(0);
+}
+
 /********************************************************
  *             internal helper functions                *
  ********************************************************/
 
+/* copy the job record at the start of the (decompressed) job region into
+ * job, converting records of older log versions and swapping bytes as
+ * needed, and point trailing_data at the exe & mount data following it
+ *
+ * returns 0 on success, -1 on failure
+ */
+static int darshan_log_decode_job(darshan_fd fd, char *job_buf, int job_buf_len,
+    struct darshan_job *job, char **trailing_data, int *trailing_data_size)
+{
+    int log_ver_maj, log_ver_min;
+    int ret;
+
+    /* get major/minor version numbers */
+    ret = darshan_log_get_format_version(fd->version, &log_ver_maj, &log_ver_min);
+    if(ret < 0)
+    {
+        fprintf(stderr, "Error: unable to parse log file format version.\n");
+        return(-1);
+    }
+
+    /* NOTE: job definition changed to include start/end time nsecs in ver 3.41 */
+    if(((log_ver_maj == 3) && (log_ver_min >= 41)) || (log_ver_maj > 3))
+    {
+        if(job_buf_len < (int)sizeof(*job))
+            return(-1);
+        memcpy(job, job_buf, sizeof(*job));
+        *trailing_data = &job_buf[sizeof(*job)];
+        *trailing_data_size = DARSHAN_EXE_LEN+1;
+    }
+    else
+    {
+        /* backwards compatibility with prior of Darshan job struct,
+         * which does not have fields for start_time_nsec or
+         * end_time_nsec
+         */
+        int64_t *tmp_ptr = (int64_t *)job_buf;
+        if(job_buf_len < (int)(5*sizeof(int64_t) + DARSHAN_JOB_METADATA_LEN))
+            return(-1);
+        job->uid = *(tmp_ptr++);
+        job->start_time_sec = *(tmp_ptr++);
+        job->start_time_nsec = 0;
+        job->end_time_sec = *(tmp_ptr++);
+        job->end_time_nsec = 0;
+        job->nprocs = *(tmp_ptr++);
+        job->jobid = *(tmp_ptr++);
+        memcpy(job->metadata, tmp_ptr, DARSHAN_JOB_METADATA_LEN);
+        *trailing_data = (char *)tmp_ptr + DARSHAN_JOB_METADATA_LEN;
+        *trailing_data_size = DARSHAN_EXE_LEN+1+(2*sizeof(int64_t));
+    }
+
+    if(fd->swap_flag)
+    {
+        /* swap bytes if necessary */
+        DARSHAN_BSWAP64(&job->uid);
+        DARSHAN_BSWAP64(&job->start_time_sec);
+        DARSHAN_BSWAP64(&job->end_time_sec);
+        /* don't byte swap fields explicitly set during up-conversion */
+        if(((log_ver_maj == 3) && (log_ver_min >= 41)) || (log_ver_maj > 3))
+        {
+            DARSHAN_BSWAP64(&job->start_time_nsec);
+            DARSHAN_BSWAP64(&job->end_time_nsec);
+        }
+        DARSHAN_BSWAP64(&job->nprocs);
+        DARSHAN_BSWAP64(&job->jobid);
+    }
+
+    return(0);
+}
+
+/* decompress the first len bytes of the job region into job_buf, reading
+ * compressed data in small pieces rather than through the staging buffer
+ * of darshan_log_dzread()
+ *
+ * returns the number of bytes decompressed on success, -1 on failure
+ */
+static int darshan_log_peek_job(darshan_fd fd, char *job_buf, int len)
+{
+    unsigned char in_buf[4096];
+    int64_t remaining = fd->job_map.len;
+    int total_bytes = 0;
+    int read_size;
+    int ret;
+
+    ret = darshan_log_seek(fd, fd->job_map.off);
+    if(ret < 0)
+        return(-1);
+
+    switch(fd->comp_type)
+    {
+        case DARSHAN_ZLIB_COMP:
+        {
+            z_stream zstrm;
+
+            memset(&zstrm, 0, sizeof(zstrm));
+            if(inflateInit(&zstrm) != Z_OK)
+                return(-1);
+            zstrm.avail_out = len;
+            zstrm.next_out = (unsigned char *)job_buf;
+            while(zstrm.avail_out && remaining > 0)
+            {
+                read_size = (remaining > (int64_t)sizeof(in_buf)) ?
+                    (int)sizeof(in_buf) : (int)remaining;
+                ret = darshan_log_read(fd, in_buf, read_size);
+                if(ret < read_size)
+                    break;
+                remaining -= read_size;
+                zstrm.avail_in = read_size;
+                zstrm.next_in = in_buf;
+                ret = inflate(&zstrm, Z_NO_FLUSH);
+                if(ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR)
+                    break;
+                if(ret == Z_STREAM_END)
+                    break;
+            }
+            total_bytes = len - zstrm.avail_out;
+            inflateEnd(&zstrm);
+            break;
+        }
+#ifdef HAVE_LIBBZ2
+        case DARSHAN_BZIP2_COMP:
+        {
+            bz_stream bzstrm;
+
+            memset(&bzstrm, 0, sizeof(bzstrm));
+            if(BZ2_bzDecompressInit(&bzstrm, 1, 0) != BZ_OK)
+                return(-1);
+            bzstrm.avail_out = len;
+            bzstrm.next_out = job_buf;
+            while(bzstrm.avail_out && remaining > 0)
+            {
+                read_size = (remaining > (int64_t)sizeof(in_buf)) ?
+                    (int)sizeof(in_buf) : (int)remaining;
+                ret = darshan_log_read(fd, in_buf, read_size);
+                if(ret < read_size)
+                    break;
+                remaining -= read_size;
+                bzstrm.avail_in = read_size;
+                bzstrm.next_in = (char *)in_buf;
+                ret = BZ2_bzDecompress(&bzstrm);
+                if(ret != BZ_OK)
+                    break;
+            }
+            total_bytes = len - bzstrm.avail_out;
+            BZ2_bzDecompressEnd(&bzstrm);
+            break;
+        }
+#endif
+        case DARSHAN_NO_COMP:
+            read_size = (remaining > len) ? len : (int)remaining;
+            total_bytes = darshan_log_read(fd, job_buf, read_size);
+            break;
+        default:
+            fprintf(stderr, "Error: invalid compression type.\n");
+            return(-1);
+    }
+
+    return(total_bytes);
+}
+
 static int darshan_mnt_info_cmp(const void *a, const void *b)
 {
     struct darshan_mnt_info *m_a = (struct darshan_mnt_info *)a;
@@ -974,26 +1356,23 @@ static int darshan_mnt_info_cmp(const void *a, const void *b)
         return(0);
 }
 
-/* whitelist_filter
- *
- * A simple filter function, that tests if a provided value is in 
+/* namerec_filter_match
  *
+ * returns 1 if the name record with the given id and name should be read
  */
-int whitelist_filter(darshan_record_id val, darshan_record_id *whitelist, int whitelist_count){
-    int i;
-    for(i = 0; i < whitelist_count; i++)
-    {
-        if (whitelist[i] == val)
-        {
-            return 1;
-        }
-    }
-    return 0;
+static int namerec_filter_match(struct darshan_namerec_filter *filter,
+    darshan_record_id id, const char *name)
+{
+    if(filter->ids && !darshan_record_id_set_contains(filter->ids, id))
+        return(0);
+    if(filter->names && !darshan_name_filter_match(filter->names, name))
+        return(0);
+    return(1);
 }
 
 static int darshan_log_get_namerecs(void *name_rec_buf, int buf_len,
     int swap_flag, struct darshan_name_record_ref **hash,
-    darshan_record_id *whitelist, int whitelist_count)
+    struct darshan_namerec_filter *filter)
 {
     struct darshan_name_record_ref *ref;
     struct darshan_name_record *name_rec;
@@ -1026,8 +1405,7 @@ static int darshan_log_get_namerecs(void *name_rec_buf, int buf_len,
         }
 
         HASH_FIND(hlink, *hash, &(name_rec->id), sizeof(darshan_record_id), ref);
-        if(!ref && (!whitelist ||
-            whitelist_filter(name_rec->id, whitelist, whitelist_count)))
+        if(!ref && namerec_filter_match(filter, name_rec->id, name_rec->name))
         {
             ref = malloc(sizeof(*ref));
             if(!ref)
@@ -1046,6 +1424,14 @@ static int darshan_log_get_namerecs(void *name_rec_buf, int buf_len,
             /* add this record to the hash */
             HASH_ADD(hlink, *hash, name_record->id, sizeof(darshan_record_id), ref);
         }
+        else if(ref && !strlen(ref->name_record->name) && strlen(name_rec->name) > 0 &&
+            !namerec_filter_match(filter, name_rec->id, name_rec->name))
+        {
+            /* the empty name passed the filter, but the actual one does not */
+            HASH_DELETE(hlink, *hash, ref);
+            free(ref->name_record);
+            free(ref);
+        }
         else if(ref && !strlen(ref->name_record->name) && strlen(name_rec->name) > 0)
         {
             free(ref->name_record);
@@ -1524,6 +1910,9 @@ static void darshan_log_dzdestroy(darshan_fd fd)
 {
     struct darshan_fd_int_state *state = fd->state;
 
+    if(!state->dz.comp_dat)
+        return;
+
     switch(fd->comp_type)
     {
         case DARSHAN_ZLIB_COMP:
@@ -1549,6 +1938,8 @@ static void darshan_log_dzdestroy(darshan_fd fd)
 
     free(state->dz.comp_dat);
     free(state->dz.buf);
+    state->dz.comp_dat = NULL;
+    state->dz.buf = NULL;
     return;
 }
 
@@ -1559,6 +1950,10 @@ static int darshan_log_dzread(darshan_fd fd, int region_id, void *buf, int len)
     int reset_strm_flag = 0;
     int ret;
 
+    /* buffers released by darshan_log_release_buffers() */
+    if(!state->dz.comp_dat && darshan_log_dzinit(fd) < 0)
+        return(-1);
+
     /* if new log region, we reload buffers and clear eor flag */
     if(region_id != state->dz.prev_reg_id)
     {
@@ -2023,11 +2418,12 @@ static int darshan_log_noz_read(darshan_fd fd, struct darshan_log_map map,
             if(ret < 0)
                 return(-1);
             assert(state->dz.size > 0);
+            *buf_off = 0;
         }
 
-        cp_size = (len > (state->dz.size - *buf_off)) ?
-            state->dz.size - *buf_off : len;
-        memcpy(buf, state->dz.buf + *buf_off, cp_size);
+        cp_size = ((len - total_bytes) > (state->dz.size - *buf_off)) ?
+            state->dz.size - *buf_off : len - total_bytes;
+        memcpy((char *)buf + total_bytes, state->dz.buf + *buf_off, cp_size);
         total_bytes += cp_size;
         *buf_off += cp_size;
     }
@@ -2101,7 +2497,7 @@ static int darshan_log_dzunload(darshan_fd fd, struct darshan_log_map *map_p)
 
 static int darshan_log_get_namerecs_3_00(void *name_rec_buf, int buf_len,
     int swap_flag, struct darshan_name_record_ref **hash,
-    darshan_record_id *whitelist, int whitelist_count)
+    struct darshan_namerec_filter *filter)
 {
     struct darshan_name_record_ref *ref;
     char *buf_ptr;
@@ -2141,8 +2537,8 @@ static int darshan_log_get_namerecs_3_00(void *name_rec_buf, int buf_len,
             DARSHAN_BSWAP64(rec_id_ptr);
 
         HASH_FIND(hlink, *hash, rec_id_ptr, sizeof(darshan_record_id), ref);
-        if(!ref && (!whitelist ||
-            whitelist_filter(*rec_id_ptr, whitelist, whitelist_count)))
+        if(!ref && (!filter->ids ||
+            darshan_record_id_set_contains(filter->ids, *rec_id_ptr)))
         {
             ref = malloc(sizeof(*ref));
             if(!ref)
@@ -2162,8 +2558,20 @@ static int darshan_log_get_namerecs_3_00(void *name_rec_buf, int buf_len,
             memcpy(ref->name_record->name, path_ptr, *path_len_ptr);
             ref->name_record->name[*path_len_ptr] = '\0';
 
-            /* add this record to the hash */
-            HASH_ADD(hlink, *hash, name_record->id, sizeof(darshan_record_id), ref);
+            /* names are not terminated in this format, so they can only be
+             * filtered once copied
+             */
+            if(filter->names &&
+               !darshan_name_filter_match(filter->names, ref->name_record->name))
+            {
+                free(ref->name_record);
+                free(ref);
+            }
+            else
+            {
+                /* add this record to the hash */
+                HASH_ADD(hlink, *hash, name_record->id, sizeof(darshan_record_id), ref);
+            }
         }
 
         buf_ptr += rec_len;
@@ -2292,8 +2700,6 @@ void darshan_log_get_filtered_name_records(darshan_fd fd,
 
     int ret;
     struct darshan_name_record_ref *name_hash = NULL;
-    struct darshan_name_record_ref *tmp = NULL;
-    struct darshan_name_record_ref *curr = NULL;
 
     /* read hash of darshan records */
     ret = darshan_log_get_filtered_namehash(fd, &name_hash, whitelist, whitelist_count);
@@ -2303,33 +2709,81 @@ void darshan_log_get_filtered_name_records(darshan_fd fd,
         return;
     }
 
-    int num = HASH_CNT(hlink, name_hash);
+    darshan_log_namehash_to_info(&name_hash, name_records, count);
+}
+
+/*
+ * darshan_log_get_matching_name_records
+ *
+ * Get the list of name records that pass a name filter and/or id set
+ * (either may be NULL), see darshan_log_get_matching_namehash()
+ *
+ * returns 0 on success, -1 on failure
+ */
+int darshan_log_get_matching_name_records(darshan_fd fd,
+                              struct darshan_name_filter *filter,
+                              struct darshan_record_id_set *ids,
+                              struct darshan_name_record_info **name_records,
+                              int* count)
+{
+    int ret;
+    struct darshan_name_record_ref *name_hash = NULL;
+    struct darshan_name_record_ref *tmp = NULL;
+    struct darshan_name_record_ref *curr = NULL;
+
+    *name_records = NULL;
+    *count = 0;
+
+    ret = darshan_log_get_matching_namehash(fd, &name_hash, filter, ids);
+    if(ret < 0)
+    {
+        HASH_ITER(hlink, name_hash, curr, tmp)
+        {
+            HASH_DELETE(hlink, name_hash, curr);
+            free(curr->name_record);
+            free(curr);
+        }
+        return(-1);
+    }
+
+    darshan_log_namehash_to_info(&name_hash, name_records, count);
+
+    return(0);
+}
+
+/* converts a hash of name records into an array of name record info,
+ * destroying the hash
+ */
+static void darshan_log_namehash_to_info(struct darshan_name_record_ref **hash,
+    struct darshan_name_record_info **name_records, int *count)
+{
+    struct darshan_name_record_ref *tmp = NULL;
+    struct darshan_name_record_ref *curr = NULL;
+
+    int num = HASH_CNT(hlink, *hash);
     *name_records = malloc(sizeof(**name_records) * num);
-    assert(*name_records);
+    assert(num == 0 || *name_records);
 
     int i = 0;
-    HASH_ITER(hlink, name_hash, curr, tmp)
+    HASH_ITER(hlink, *hash, curr, tmp)
     {
         (*name_records)[i].id = curr->name_record->id;
-        /* NOTE: darshan_log_get_filtered_namehash() call above returns a
-         * hash table that has allocated name record memory for records
-         * in the log file. This hash table is not exposed to callers,
-         * though, so it's this function's responsibility to destroy the
-         * table and free corresponding memory before returning, as is
-         * done below. This also requires that we strdup() record names
-         * that are returned to callers, who are then responsible for
-         * freeing this memory, just as they are responsible for freeing
-         * the name_records array allocated above.
+        /* NOTE: the name record hash is not exposed to callers, so it's
+         * this function's responsibility to destroy the table and free
+         * corresponding memory before returning, as is done below. This
+         * also requires that we strdup() record names that are returned to
+         * callers, who are then responsible for freeing this memory, just
+         * as they are responsible for freeing the name_records array
+         * allocated above.
          */
         (*name_records)[i].name = strdup(curr->name_record->name);
-        HASH_DELETE(hlink, name_hash, curr);
+        HASH_DELETE(hlink, *hash, curr);
         free(curr->name_record);
         free(curr);
         i++;
     }
  
     *count = num;
-
 }
 
 /*
@@ -2348,6 +2802,38 @@ int darshan_log_get_record(darshan_fd fd,
     return r;
 }
 
+/*
+ * darshan_log_get_filtered_record
+ *
+ * Like darshan_log_get_record(), but skips records whose ids are not in
+ * the given set (all records are returned if ids is NULL).  Skipped
+ * records are decoded into the caller's buffer, if one is given, and are
+ * otherwise freed right away.
+ */
+int darshan_log_get_filtered_record(darshan_fd fd,
+                                    int mod_idx,
+                                    void **buf,
+                                    struct darshan_record_id_set *ids)
+{
+    int caller_buf = (*buf != NULL);
+    int r;
+
+    while((r = mod_logutils[mod_idx]->log_get_record(fd, buf)) == 1)
+    {
+        if(!ids || darshan_record_id_set_contains(ids,
+           ((struct darshan_base_record *)*buf)->id))
+            break;
+        if(!caller_buf)
+        {
+            /* records may vary in size, so don't reuse the buffer */
+            free(*buf);
+            *buf = NULL;
+        }
+    }
+
+    return r;
+}
+
 /*
  * darshan_free
  *
@@ -2360,6 +2846,23 @@ void darshan_free(void *ptr)
     free(ptr);
 }
 
+void darshan_log_print_record_with_hook(int mod_id, void *rec,
+    char *file_name, char *mnt_pt, char *fs_type,
+    darshan_counter_hook_fn hook, void *hook_ctx)
+{
+    const struct darshan_counter_hook *prev_hook = darshan_cur_counter_hook;
+    struct darshan_counter_hook cur_hook = {hook, hook_ctx};
+
+    if(mod_id < 0 || mod_id >= DARSHAN_KNOWN_MODULE_COUNT || !mod_logutils[mod_id])
+        return;
+
+    darshan_cur_counter_hook = &cur_hook;
+    mod_logutils[mod_id]->log_print_record(rec, file_name, mnt_pt, fs_type);
+    darshan_cur_counter_hook = prev_hook;
+
+    return;
+}
+
 /*
  * Local variables:
  *  c-indent-level: 4
@@ -71,6 +71,21 @@ struct darshan_mnt_info
     char mnt_path[DARSHAN_EXE_LEN];
 };
 
+/* longest-prefix-match index over a mount table, see darshan_mnt_trie_create() */
+struct darshan_mnt_trie;
+
+/* hashed set of record ids, see darshan_record_id_set_create() */
+struct darshan_record_id_set;
+
+/* compiled set of record name patterns, see darshan_name_filter_create() */
+struct darshan_name_filter;
+
+enum darshan_name_filter_mode
+{
+    DARSHAN_NAME_FILTER_EXCLUDE = 0, /* keep names matching no pattern */
+    DARSHAN_NAME_FILTER_INCLUDE      /* keep names matching any pattern */
+};
+
 struct darshan_mod_info
 {
     const char *name;
@@ -80,6 +95,21 @@ struct darshan_mod_info
     int partial_flag;
 };
 
+/* header and job record of a log, see darshan_log_peek() */
+struct darshan_log_peek_info
+{
+    char version[8];
+    struct darshan_job job;
+    double run_time;
+    /* bit-field indicating whether modules contain incomplete data */
+    uint64_t partial_flag;
+    /* compressed size and log-format version of each module's data; a
+     * module is present in the log if its size is non-zero
+     */
+    int64_t mod_len[DARSHAN_MAX_MODS];
+    uint32_t mod_ver[DARSHAN_MAX_MODS];
+};
+
 struct darshan_name_record_info
 {
     darshan_record_id id;
@@ -88,6 +118,14 @@ struct darshan_name_record_info
 
 
 
+/* sets of common values that modules may track per record */
+enum darshan_common_value_set
+{
+    DARSHAN_COMMON_ACCESS_SIZES = 0,
+    DARSHAN_COMMON_STRIDES,
+    DARSHAN_COMMON_VALUE_SET_MAX
+};
+
 /* functions to be implemented by each module for integration with
  * darshan log file utilities (e.g., parser & convert tools)
  */
@@ -171,6 +209,17 @@ struct darshan_mod_logutil_funcs
         double* rw_only_time,  /* time spent in read/write fns, if known */
         int64_t* rank,        /* rank associated with record (-1 for shared) */
         int64_t* nprocs);     /* nprocs that accessed it */
+    /* locate the common value slots of a record (e.g., its 4 most common
+     * access sizes) for the given darshan_common_value_set; 'values' and
+     * 'counts' are pointed at the slots in the record, so that they may
+     * also be updated in place.  returns the number of slots, or 0 if the
+     * module does not track the given set
+     */
+    int (*log_common_values)(
+        void *rec,
+        int set,
+        int64_t **values,
+        int64_t **counts);
 };
 
 extern struct darshan_mod_logutil_funcs *mod_logutils[];
@@ -186,6 +235,7 @@ extern struct darshan_mod_logutil_funcs *mod_logutils[];
 #include "darshan-mdhim-logutils.h"
 #include "darshan-dfs-logutils.h"
 #include "darshan-daos-logutils.h"
+#include "darshan-overlap-logutils.h"
 
 /* DXT */
 #include "darshan-dxt-logutils.h"
@@ -208,18 +258,28 @@ int darshan_log_get_mounts(darshan_fd fd, struct darshan_mnt_info **mnt_data_arr
     int* count);
 int darshan_log_put_mounts(darshan_fd fd, struct darshan_mnt_info *mnt_data_array,
     int count);
+struct darshan_mnt_trie *darshan_mnt_trie_create(
+    struct darshan_mnt_info *mnt_data_array, int count);
+struct darshan_mnt_info *darshan_mnt_trie_lookup(struct darshan_mnt_trie *trie,
+    const char *path);
+void darshan_mnt_trie_destroy(struct darshan_mnt_trie *trie);
 int darshan_log_get_namehash(darshan_fd fd, struct darshan_name_record_ref **hash);
 int darshan_log_get_filtered_namehash(darshan_fd fd, struct darshan_name_record_ref **hash,
     darshan_record_id *whitelist, int whitelist_count);
+int darshan_log_get_matching_namehash(darshan_fd fd,
+    struct darshan_name_record_ref **hash, struct darshan_name_filter *filter,
+    struct darshan_record_id_set *ids);
 int darshan_log_put_namehash(darshan_fd fd, struct darshan_name_record_ref *hash);
 int darshan_log_get_mod(darshan_fd fd, darshan_module_id mod_id,
     void *mod_buf, int mod_buf_sz);
 int darshan_log_put_mod(darshan_fd fd, darshan_module_id mod_id,
     void *mod_buf, int mod_buf_sz, int ver);
 void darshan_log_close(darshan_fd file);
+void darshan_log_release_buffers(darshan_fd fd);
 void darshan_log_print_version_warnings(const char *version_string);
 char *darshan_log_get_lib_version(void);
 int darshan_log_get_job_runtime(darshan_fd fd, struct darshan_job job, double *runtime);
+int darshan_log_peek(const char *name, struct darshan_log_peek_info *info);
 void darshan_log_get_modules(darshan_fd fd, struct darshan_mod_info **mods,
     int* count);
 void darshan_log_get_name_records(darshan_fd fd,
@@ -227,10 +287,69 @@ void darshan_log_get_name_records(darshan_fd fd,
 void darshan_log_get_filtered_name_records(darshan_fd fd,
     struct darshan_name_record_info **mods, int* count,
     darshan_record_id *whitelist, int whitelist_count);
+int darshan_log_get_matching_name_records(darshan_fd fd,
+    struct darshan_name_filter *filter, struct darshan_record_id_set *ids,
+    struct darshan_name_record_info **name_records, int* count);
 int darshan_log_get_record(darshan_fd fd, int mod_idx, void **buf);
+int darshan_log_get_filtered_record(darshan_fd fd, int mod_idx, void **buf,
+    struct darshan_record_id_set *ids);
 void darshan_free(void *ptr);
 
 
+/* types of counter values handed to a darshan_counter_hook_fn */
+enum darshan_counter_type
+{
+    DARSHAN_COUNTER_INT64 = 0,
+    DARSHAN_COUNTER_UINT64,
+    DARSHAN_COUNTER_DOUBLE,
+    DARSHAN_COUNTER_STRING
+};
+
+union darshan_counter_value
+{
+    int64_t d;
+    uint64_t u;
+    double f;
+    const char *s;
+};
+
+/* a function receiving the counters of a record from the counter print
+ * macros below, rather than having them printed, so that utilities can emit
+ * module records in other formats using the modules' log_print_record
+ * functions.  'ctx' is the context passed to
+ * darshan_log_print_record_with_hook(); the counter name and string values
+ * are only valid for the duration of the call.
+ */
+typedef void (*darshan_counter_hook_fn)(void *ctx, const char *counter,
+    enum darshan_counter_type type, union darshan_counter_value val);
+
+struct darshan_counter_hook
+{
+    darshan_counter_hook_fn fn;
+    void *ctx;
+};
+
+/* hook of the darshan_log_print_record_with_hook() call in progress on the
+ * calling thread, if any; only for use by the counter print macros
+ */
+extern __thread const struct darshan_counter_hook *darshan_cur_counter_hook;
+
+/* hands each counter of record 'rec' of module 'mod_id', as printed by the
+ * module's log_print_record function, to 'hook' along with 'hook_ctx'.
+ * Calls may be made concurrently from different threads and for different
+ * logs.
+ */
+void darshan_log_print_record_with_hook(int mod_id, void *rec,
+    char *file_name, char *mnt_pt, char *fs_type,
+    darshan_counter_hook_fn hook, void *hook_ctx);
+
+#define DARSHAN_COUNTER_HOOK(__counter, __type, __field, __counter_val) do { \
+    union darshan_counter_value __hook_val; \
+    __hook_val.__field = __counter_val; \
+    darshan_cur_counter_hook->fn(darshan_cur_counter_hook->ctx, \
+        __counter, __type, __hook_val); \
+} while(0)
+
 /* convenience macros for printing Darshan counters */
 #define DARSHAN_PRINT_HEADER() \
     printf("\n#<module>\t<rank>\t<record id>\t<counter>\t<value>" \
@@ -239,41 +358,56 @@ void darshan_free(void *ptr);
 #define DARSHAN_D_COUNTER_PRINT(__mod_name, __rank, __file_id, \
                               __counter, __counter_val, __file_name, \
                               __mnt_pt, __fs_type) do { \
-    printf("%s\t%" PRId64 "\t%" PRIu64 "\t%s\t%" PRId64 "\t%s\t%s\t%s\n", \
-        __mod_name, __rank, __file_id, __counter, __counter_val, \
-        __file_name, __mnt_pt, __fs_type); \
+    if(darshan_cur_counter_hook) \
+        DARSHAN_COUNTER_HOOK(__counter, DARSHAN_COUNTER_INT64, d, __counter_val); \
+    else \
+        printf("%s\t%" PRId64 "\t%" PRIu64 "\t%s\t%" PRId64 "\t%s\t%s\t%s\n", \
+            __mod_name, __rank, __file_id, __counter, __counter_val, \
+            __file_name, __mnt_pt, __fs_type); \
 } while(0)
 
 #define DARSHAN_U_COUNTER_PRINT(__mod_name, __rank, __file_id, \
                               __counter, __counter_val, __file_name, \
                               __mnt_pt, __fs_type) do { \
-    printf("%s\t%" PRId64 "\t%" PRIu64 "\t%s\t%" PRIu64 "\t%s\t%s\t%s\n", \
-        __mod_name, __rank, __file_id, __counter, __counter_val, \
-        __file_name, __mnt_pt, __fs_type); \
+    if(darshan_cur_counter_hook) \
+        DARSHAN_COUNTER_HOOK(__counter, DARSHAN_COUNTER_UINT64, u, __counter_val); \
+    else \
+        printf("%s\t%" PRId64 "\t%" PRIu64 "\t%s\t%" PRIu64 "\t%s\t%s\t%s\n", \
+            __mod_name, __rank, __file_id, __counter, __counter_val, \
+            __file_name, __mnt_pt, __fs_type); \
 } while(0)
 
 #define DARSHAN_I_COUNTER_PRINT(__mod_name, __rank, __file_id, \
                               __counter, __counter_val, __file_name, \
                               __mnt_pt, __fs_type) do { \
-    printf("%s\t%" PRId64 "\t%" PRIu64 "\t%s\t%d\t%s\t%s\t%s\n", \
-        __mod_name, __rank, __file_id, __counter, __counter_val, \
-        __file_name, __mnt_pt, __fs_type); \
+    if(darshan_cur_counter_hook) \
+        DARSHAN_COUNTER_HOOK(__counter, DARSHAN_COUNTER_INT64, d, __counter_val); \
+    else \
+        printf("%s\t%" PRId64 "\t%" PRIu64 "\t%s\t%d\t%s\t%s\t%s\n", \
+            __mod_name, __rank, __file_id, __counter, __counter_val, \
+            __file_name, __mnt_pt, __fs_type); \
 } while(0)
 
 #define DARSHAN_F_COUNTER_PRINT(__mod_name, __rank, __file_id, \
                                 __counter, __counter_val, __file_name, \
                                 __mnt_pt, __fs_type) do { \
-    printf("%s\t%" PRId64 "\t%" PRIu64 "\t%s\t%f\t%s\t%s\t%s\n", \
-        __mod_name, __rank, __file_id, __counter, __counter_val, \
-        __file_name, __mnt_pt, __fs_type); \
+    if(darshan_cur_counter_hook) \
+        DARSHAN_COUNTER_HOOK(__counter, DARSHAN_COUNTER_DOUBLE, f, __counter_val); \
+    else \
+        printf("%s\t%" PRId64 "\t%" PRIu64 "\t%s\t%f\t%s\t%s\t%s\n", \
+            __mod_name, __rank, __file_id, __counter, __counter_val, \
+            __file_name, __mnt_pt, __fs_type); \
 } while(0)
 
 #define DARSHAN_S_COUNTER_PRINT(__mod_name, __rank, __file_id, \
                               __counter, __counter_val, __file_name, \
                               __mnt_pt, __fs_type) do { \
-    printf("%s\t%" PRId64 "\t%" PRIu64 "\t%s\t%s\t%s\t%s\t%s\n", \
-        __mod_name, __rank, __file_id, __counter, __counter_val, \
-        __file_name, __mnt_pt, __fs_type); \
+    if(darshan_cur_counter_hook) \
+        DARSHAN_COUNTER_HOOK(__counter, DARSHAN_COUNTER_STRING, s, __counter_val); \
+    else \
+        printf("%s\t%" PRId64 "\t%" PRIu64 "\t%s\t%s\t%s\t%s\t%s\n", \
+            __mod_name, __rank, __file_id, __counter, __counter_val, \
+            __file_name, __mnt_pt, __fs_type); \
 } while(0)
 
 /* naive byte swap implementation */
@@ -321,6 +455,123 @@ void darshan_free(void *ptr);
     memcpy(__ptr, __dst_char, 4); \
 } while(0)
 
+/*****************************************************************
+ * The functions in this section select records by id or by name.  Record
+ * id sets give constant-time membership tests, and name filters are
+ * compiled once and then applied to names while the name table of a log
+ * is decoded, so that names (and records) that are filtered out are never
+ * allocated.
+ */
+
+/* Create a set holding the given record ids (ids may be NULL if count is
+ * 0).  Returns NULL on failure.
+ */
+struct darshan_record_id_set *darshan_record_id_set_create(
+    const darshan_record_id *ids, int64_t count);
+
+/* add a record id to a set; returns 0 on success, -1 on failure */
+int darshan_record_id_set_add(struct darshan_record_id_set *set,
+    darshan_record_id id);
+
+/* returns 1 if the set holds the given record id, 0 otherwise */
+int darshan_record_id_set_contains(struct darshan_record_id_set *set,
+    darshan_record_id id);
+
+/* returns the number of record ids in a set */
+int64_t darshan_record_id_set_count(struct darshan_record_id_set *set);
+
+void darshan_record_id_set_destroy(struct darshan_record_id_set *set);
+
+/* Compile a filter from POSIX extended regular expressions, which are
+ * searched for anywhere in a name.  Depending on mode, names matching any
+ * of the patterns are kept (DARSHAN_NAME_FILTER_INCLUDE) or dropped
+ * (DARSHAN_NAME_FILTER_EXCLUDE); a filter without patterns keeps every
+ * name.  Returns NULL if a pattern is invalid or on failure.
+ */
+struct darshan_name_filter *darshan_name_filter_create(
+    const char **patterns, int n_patterns, int mode);
+
+/* returns 1 if a filter keeps the given name, 0 otherwise */
+int darshan_name_filter_match(struct darshan_name_filter *filter,
+    const char *name);
+
+void darshan_name_filter_destroy(struct darshan_name_filter *filter);
+
+/*****************************************************************/
+
+/*****************************************************************
+ * The functions in this section implement a mergeable heavy-hitter
+ * ("space-saving") sketch of common values, such as the access sizes or
+ * strides reported by a module's common value counters.  A sketch tracks
+ * up to DARSHAN_COMMON_VALUE_SKETCH_SIZE distinct values, and counts are
+ * exact as long as no more distinct values than that are added.  Beyond
+ * that, the count of each tracked value may overestimate the number of
+ * occurrences by at most its error, and every value that occurred more
+ * than total / DARSHAN_COMMON_VALUE_SKETCH_SIZE times is still tracked.
+ */
+
+#define DARSHAN_COMMON_VALUE_SKETCH_SIZE 64
+
+struct darshan_common_value
+{
+    int64_t value;
+    int64_t count;  /* upper bound on the number of occurrences */
+    int64_t error;  /* count - error is a lower bound */
+};
+
+struct darshan_common_value_sketch
+{
+    int64_t total;  /* sum of all counts added to the sketch */
+    int n_values;
+    struct darshan_common_value values[DARSHAN_COMMON_VALUE_SKETCH_SIZE];
+};
+
+/* reset a sketch to hold no values */
+void darshan_common_value_sketch_init(
+    struct darshan_common_value_sketch *sketch);
+
+/* add count occurrences of value to a sketch */
+void darshan_common_value_sketch_add(
+    struct darshan_common_value_sketch *sketch,
+    int64_t value,
+    int64_t count);
+
+/* add the common values of the given set held by a module record to a
+ * sketch; returns -1 if the module does not track that set
+ */
+int darshan_common_value_sketch_add_record(
+    struct darshan_common_value_sketch *sketch,
+    darshan_module_id id,
+    int set,
+    void *rec);
+
+/* merge the src sketch into dest, as if all values added to src had been
+ * added to dest
+ */
+void darshan_common_value_sketch_merge(
+    struct darshan_common_value_sketch *dest,
+    struct darshan_common_value_sketch *src);
+
+/* store up to n of the most common values of a sketch in top, ordered by
+ * decreasing count; returns the number of values stored
+ */
+int darshan_common_value_sketch_top(
+    struct darshan_common_value_sketch *sketch,
+    struct darshan_common_value *top,
+    int n);
+
+/* replace the common values of the given set held by a module record with
+ * the most common values of a sketch; returns -1 if the module does not
+ * track that set
+ */
+int darshan_common_value_sketch_put_record(
+    struct darshan_common_value_sketch *sketch,
+    darshan_module_id id,
+    int set,
+    void *rec);
+
+/*****************************************************************/
+
 /*****************************************************************
  * The functions in this section make up the accumulator API, which is a
  * mechanism for aggregating records to produce derived metrics and
@@ -346,6 +597,37 @@ int darshan_accumulator_inject(darshan_accumulator accumulator,
                                void*               record_array,
                                int                 record_count);
 
+/* Merge the state of the src accumulator into dest, as if the records
+ * injected into src had been injected into dest.  Both accumulators must be
+ * for the same module; src is left unchanged.  Accumulators may be filled
+ * independently (e.g., by separate threads, or for separate logs) and
+ * merged afterwards.  Ranks are not renumbered, so when merging
+ * accumulators of different jobs, per-rank times of equal rank numbers are
+ * combined.
+ */
+int darshan_accumulator_merge(darshan_accumulator dest,
+                              darshan_accumulator src);
+
+/* Track the common values (access sizes and strides) of injected records
+ * in sketches rather than only in the 4 slots of the aggregate record, so
+ * that values that are common across many records but rarely in any
+ * single record's top 4 are not lost.  Must be called before any records
+ * are injected; returns -1 if the module has no common values.  Once
+ * enabled, the aggregate record produced by darshan_accumulator_emit()
+ * holds the most common values of the sketches.
+ */
+int darshan_accumulator_track_common_values(darshan_accumulator accumulator);
+
+/* Store up to n of the most common values of the given
+ * darshan_common_value_set in top, ordered by decreasing count and with
+ * error bounds.  Returns the number of values stored, or -1 if common
+ * values are not tracked for that set.
+ */
+int darshan_accumulator_emit_common_values(darshan_accumulator accumulator,
+                                           int set,
+                                           struct darshan_common_value* top,
+                                           int n);
+
 struct darshan_file_category_counters {
     int64_t count;                   /* number of files in this category */
     int64_t total_read_volume_bytes; /* total read traffic volume */
@@ -419,4 +701,55 @@ int darshan_accumulator_destroy(darshan_accumulator accumulator);
 
 /*****************************************************************/
 
+/*****************************************************************
+ * The functions in this section make up the parallel reader API. A log's
+ * module regions are independently compressed streams, so each module
+ * iterator decodes its region through a private log file descriptor.
+ * Iterators may be used concurrently from different threads, and the
+ * reader can also decode them ahead of the caller on a pool of background
+ * threads.
+ */
+
+/* opaque reader and module iterator references */
+struct darshan_log_reader_st;
+typedef struct darshan_log_reader_st* darshan_log_reader;
+struct darshan_mod_iter_st;
+typedef struct darshan_mod_iter_st* darshan_mod_iter;
+
+/* Open a reader for the given log file. With nthreads > 0, up to nthreads
+ * module regions are decoded in the background, in the order their
+ * iterators were created. With nthreads == 0, records are only decoded when
+ * requested, on the calling thread.
+ */
+darshan_log_reader darshan_log_reader_open(const char *name, int nthreads);
+
+/* Create an iterator over the records of the given module. Returns NULL
+ * if the module is unknown or the log could not be opened.
+ */
+darshan_mod_iter darshan_log_reader_mod_iter(darshan_log_reader reader,
+                                             darshan_module_id  mod_id);
+
+/* Retrieve the next record of the iterator's module. On success, *rec
+ * points to a newly allocated record that the caller must free. Returns 1
+ * on success, 0 when there are no more records, and -1 on error.
+ * Each iterator must only be used by one thread at a time.
+ */
+int darshan_mod_iter_next(darshan_mod_iter iter, void **rec);
+
+/* Like darshan_mod_iter_next(), but skips records whose ids are not in
+ * the given set (all records are returned if ids is NULL).
+ */
+int darshan_mod_iter_next_filtered(darshan_mod_iter iter, void **rec,
+                                   struct darshan_record_id_set *ids);
+
+/* frees resources associated with an iterator, discarding any records
+ * not yet retrieved
+ */
+void darshan_mod_iter_close(darshan_mod_iter iter);
+
+/* closes any remaining iterators and stops the reader's threads */
+void darshan_log_reader_close(darshan_log_reader reader);
+
+/*****************************************************************/
+
 #endif
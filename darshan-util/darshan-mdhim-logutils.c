@@ -43,6 +43,7 @@ static void darshan_log_print_mdhim_description(int ver);
 static void darshan_log_print_mdhim_record_diff(void *file_rec1, char *file_name1,
     void *file_rec2, char *file_name2);
 static void darshan_log_agg_mdhim_records(void *rec, void *agg_rec, int init_flag);
+static int darshan_log_sizeof_mdhim_record(void* mdhim_buf_p);
 
 /* structure storing each function needed for implementing the darshan
  * logutil interface. these functions are used for reading, writing, and
@@ -55,9 +56,18 @@ struct darshan_mod_logutil_funcs mdhim_logutils =
     .log_print_record = &darshan_log_print_mdhim_record,
     .log_print_description = &darshan_log_print_mdhim_description,
     .log_print_diff = &darshan_log_print_mdhim_record_diff,
-    .log_agg_records = &darshan_log_agg_mdhim_records
+    .log_agg_records = &darshan_log_agg_mdhim_records,
+    .log_sizeof_record = &darshan_log_sizeof_mdhim_record
 };
 
+static int darshan_log_sizeof_mdhim_record(void* mdhim_buf_p)
+{
+    struct darshan_mdhim_record *mdhim_rec = (struct darshan_mdhim_record *)mdhim_buf_p;
+
+    /* mdhim records are sized by their number of servers */
+    return(MDHIM_RECORD_SIZE(mdhim_rec->counters[MDHIM_SERVERS]));
+}
+
 /* retrieve a MDHIM record from log file descriptor 'fd', storing the
  * data in the buffer address pointed to by 'mdhim_buf_p'. Return 1 on
  * successful record read, 0 on no more data, and -1 on error.
@@ -4,23 +4,95 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 #include <fcntl.h>
 #include <string.h>
 #include <getopt.h>
 #include <glob.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
 
 #include "uthash-1.9.2/src/uthash.h"
 
 #include "darshan-logutils.h"
 
+/* number of independently locked partitions of each module's shared
+ * record count table
+ */
+#define MERGE_SHARED_HASH_SHARDS 64
+
 struct darshan_shared_record_ref
 {
     darshan_record_id id;
     int ref_cnt;
     char agg_rec[DEF_MOD_BUF_SIZE];
+    /* common values of every process's record, if sketched */
+    struct darshan_common_value_sketch sketches[DARSHAN_COMMON_VALUE_SET_MAX];
     UT_hash_handle hlink;
 };
 
+/* number of times a record id has been seen across all input logs */
+struct merge_shared_count
+{
+    darshan_record_id id;
+    int ref_cnt;
+    UT_hash_handle hlink;
+};
+
+struct merge_shared_shard
+{
+    pthread_mutex_t mutex;
+    struct merge_shared_count *hash;
+};
+
+/* all records a single input log holds for one module */
+struct merge_mod_records
+{
+    void **recs;
+    int count;
+    int size;
+};
+
+struct merge_input
+{
+    char *path;
+    /* the input log, if it is kept open between modules */
+    darshan_fd fd;
+    struct darshan_job job;
+    struct darshan_name_record_ref *name_hash;
+    /* modules with data in this log */
+    uint64_t mod_flags;
+    /* records of the module currently being merged */
+    struct merge_mod_records mod_recs;
+    int64_t bytes;
+};
+
+struct merge_state
+{
+    struct merge_input *inputs;
+    int n_inputs;
+    int shared_redux;
+    int common_values;
+    /* whether inputs are kept open rather than reopened for each module */
+    int keep_open;
+    /* module whose records are being read, or -1 while reading each input's
+     * job data and name records
+     */
+    int cur_mod;
+    char exe[DARSHAN_EXE_LEN+1];
+    struct darshan_mnt_info *mnt_array;
+    int mnt_count;
+    struct merge_shared_shard shared_counts[DARSHAN_KNOWN_MODULE_COUNT][MERGE_SHARED_HASH_SHARDS];
+    /* protects the fields below */
+    pthread_mutex_t mutex;
+    int next_input;
+    int err;
+    int64_t total_bytes;
+    int64_t total_recs;
+};
+
 void usage(char *exename)
 {
     fprintf(stderr, "Usage: %s --output <output_path> [options] <input_log_glob>\n", exename);
@@ -29,13 +101,17 @@ void usage(char *exename)
     fprintf(stderr, "Options:\n");
     fprintf(stderr, "\t--output\t(REQUIRED) Full path of the output darshan log file.\n");
     fprintf(stderr, "\t--shared-redux\tReduce globally shared records into a single record.\n");
+    fprintf(stderr, "\t--common-values\tWith --shared-redux, sketch the common access sizes and strides of all\n\t\t\tprocesses rather than combining each process's top 4.\n");
     fprintf(stderr, "\t--job-end-time\tSet the output log's job end time (requires argument of seconds since Epoch).\n");
+    fprintf(stderr, "\t--threads\tNumber of threads used to read input logs (default: number of online CPUs).\n");
+    fprintf(stderr, "\t--quiet\t\tDo not report merge throughput on stderr.\n");
 
     exit(1);
 }
 
 void parse_args(int argc, char **argv, char ***infile_list, int *n_files,
-    char **outlog_path, int *shared_redux, int64_t *job_end_time)
+    char **outlog_path, int *shared_redux, int *common_values,
+    int64_t *job_end_time, int *n_threads, int *quiet)
 {
     int index;
     char *check;
@@ -43,13 +119,21 @@ void parse_args(int argc, char **argv, char ***infile_list, int *n_files,
     {
         {"output", required_argument, NULL, 'o'},
         {"shared-redux", no_argument, NULL, 's'},
+        {"common-values", no_argument, NULL, 'c'},
         {"job-end-time", required_argument, NULL, 'e'},
+        {"threads", required_argument, NULL, 't'},
+        {"quiet", no_argument, NULL, 'q'},
         {0, 0, 0, 0}
     };
 
     *shared_redux = 0;
+    *common_values = 0;
     *outlog_path = NULL;
     *job_end_time = 0;
+    *n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    if(*n_threads < 1)
+        *n_threads = 1;
+    *quiet = 0;
 
     while(1)
     {
@@ -62,6 +146,9 @@ void parse_args(int argc, char **argv, char ***infile_list, int *n_files,
             case 's':
                 *shared_redux = 1;
                 break;
+            case 'c':
+                *common_values = 1;
+                break;
             case 'o':
                 *outlog_path = optarg;
                 break;
@@ -73,6 +160,17 @@ void parse_args(int argc, char **argv, char ***infile_list, int *n_files,
                     exit(1);
                 }
                 break;
+            case 't':
+                *n_threads = strtol(optarg, &check, 10);
+                if(optarg == check || *n_threads < 1)
+                {
+                    fprintf(stderr, "Error: invalid number of threads.\n");
+                    exit(1);
+                }
+                break;
+            case 'q':
+                *quiet = 1;
+                break;
             case '?':
             default:
                 usage(argv[0]);
@@ -91,155 +189,527 @@ void parse_args(int argc, char **argv, char ***infile_list, int *n_files,
     return;
 }
 
-int build_mod_shared_rec_hash(char **infile_list, int n_infiles,
-    darshan_module_id mod_id, int nprocs, char *mod_buf,
-    struct darshan_shared_record_ref **shared_rec_hash)
+/* count another occurrence of a record id in the given module's
+ * shared record count table
+ */
+static int merge_count_shared_rec(struct merge_state *ms,
+    darshan_module_id mod_id, darshan_record_id id)
 {
+    struct merge_shared_shard *shard =
+        &(ms->shared_counts[mod_id][id % MERGE_SHARED_HASH_SHARDS]);
+    struct merge_shared_count *cnt;
+
+    pthread_mutex_lock(&shard->mutex);
+    HASH_FIND(hlink, shard->hash, &id, sizeof(darshan_record_id), cnt);
+    if(!cnt)
+    {
+        cnt = malloc(sizeof(*cnt));
+        if(!cnt)
+        {
+            pthread_mutex_unlock(&shard->mutex);
+            return(-1);
+        }
+        cnt->id = id;
+        cnt->ref_cnt = 0;
+        HASH_ADD(hlink, shard->hash, id, sizeof(darshan_record_id), cnt);
+    }
+    cnt->ref_cnt++;
+    pthread_mutex_unlock(&shard->mutex);
+
+    return(0);
+}
+
+static int merge_get_shared_count(struct merge_state *ms,
+    darshan_module_id mod_id, darshan_record_id id)
+{
+    struct merge_shared_shard *shard =
+        &(ms->shared_counts[mod_id][id % MERGE_SHARED_HASH_SHARDS]);
+    struct merge_shared_count *cnt;
+
+    /* only called once all input logs have been read */
+    HASH_FIND(hlink, shard->hash, &id, sizeof(darshan_record_id), cnt);
+    return(cnt ? cnt->ref_cnt : 0);
+}
+
+static void merge_free_shared_counts(struct merge_state *ms,
+    darshan_module_id mod_id)
+{
+    struct merge_shared_count *cnt, *tmp;
+    int i;
+
+    for(i = 0; i < MERGE_SHARED_HASH_SHARDS; i++)
+    {
+        HASH_ITER(hlink, ms->shared_counts[mod_id][i].hash, cnt, tmp)
+        {
+            HASH_DELETE(hlink, ms->shared_counts[mod_id][i].hash, cnt);
+            free(cnt);
+        }
+    }
+
+    return;
+}
+
+/* read the job data and name records of a single input log; module
+ * records are read later, one module at a time
+ */
+static int merge_read_input(struct merge_state *ms, int idx)
+{
+    struct merge_input *in = &(ms->inputs[idx]);
+    struct stat statbuf;
     darshan_fd in_fd;
-    struct darshan_base_record *base_rec;
-    struct darshan_shared_record_ref *ref, *tmp;
-    int init_rank = -1;
     int ret;
     int i;
 
-    /* if this module has no method for aggregating shared records, do nothing */
-    if(!(mod_logutils[mod_id]->log_agg_records))
+    if(stat(in->path, &statbuf) == 0)
+        in->bytes = statbuf.st_size;
+
+    in_fd = darshan_log_open(in->path);
+    if(in_fd == NULL)
+    {
+        fprintf(stderr,
+            "Error: unable to open input Darshan log file %s.\n",
+            in->path);
+        return(-1);
+    }
+
+    /* read job-level metadata from the input file */
+    ret = darshan_log_get_job(in_fd, &in->job);
+    if(ret < 0)
+    {
+        fprintf(stderr,
+            "Error: unable to read job data from input Darshan log file %s.\n",
+            in->path);
+        darshan_log_close(in_fd);
+        return(-1);
+    }
+
+    if(idx == 0)
+    {
+        /* get exe & mounts directly from the first input log */
+        ret = darshan_log_get_exe(in_fd, ms->exe);
+        if(ret < 0)
+        {
+            fprintf(stderr,
+                "Error: unable to read exe string from input Darshan log file %s.\n",
+                in->path);
+            darshan_log_close(in_fd);
+            return(-1);
+        }
+
+        ret = darshan_log_get_mounts(in_fd, &ms->mnt_array, &ms->mnt_count);
+        if(ret < 0)
+        {
+            fprintf(stderr,
+                "Error: unable to read mount info from input Darshan log file %s.\n",
+                in->path);
+            darshan_log_close(in_fd);
+            return(-1);
+        }
+    }
+
+    /* read the hash of ids->names for the input log */
+    ret = darshan_log_get_namehash(in_fd, &in->name_hash);
+    if(ret < 0)
+    {
+        fprintf(stderr,
+            "Error: unable to read job data from input Darshan log file %s.\n",
+            in->path);
+        darshan_log_close(in_fd);
+        return(-1);
+    }
+
+    for(i = 0; i < DARSHAN_KNOWN_MODULE_COUNT; i++)
+    {
+        if(in_fd->mod_map[i].len > 0)
+            in->mod_flags |= (1ULL << i);
+    }
+
+    if(ms->keep_open)
+    {
+        /* only the descriptor is held between modules, not the 1 MiB
+         * decompression buffer and stream state
+         */
+        darshan_log_release_buffers(in_fd);
+        in->fd = in_fd;
+    }
+    else
+        darshan_log_close(in_fd);
+
+    pthread_mutex_lock(&ms->mutex);
+    ms->total_bytes += in->bytes;
+    pthread_mutex_unlock(&ms->mutex);
+
+    return(0);
+}
+
+/* decode the records an input log holds for the module being merged */
+static int merge_read_input_module(struct merge_state *ms, int idx)
+{
+    struct merge_input *in = &(ms->inputs[idx]);
+    struct merge_mod_records *mrecs = &(in->mod_recs);
+    struct darshan_base_record *base_rec;
+    darshan_module_id mod_id = ms->cur_mod;
+    darshan_fd in_fd;
+    void *rec = NULL;
+    int ret;
+
+    if(!(in->mod_flags & (1ULL << mod_id)))
         return(0);
 
-    /* loop over each input log file */
-    for(i = 0; i < n_infiles; i++)
+    in_fd = in->fd;
+    if(!in_fd)
     {
-        in_fd = darshan_log_open(infile_list[i]);
+        in_fd = darshan_log_open(in->path);
         if(in_fd == NULL)
         {
             fprintf(stderr,
                 "Error: unable to open input Darshan log file %s.\n",
-                infile_list[i]);
+                in->path);
             return(-1);
         }
+    }
 
-        while((ret = mod_logutils[mod_id]->log_get_record(in_fd, (void **)&mod_buf)) == 1)
+    while((ret = mod_logutils[mod_id]->log_get_record(in_fd, &rec)) == 1)
+    {
+        if(mrecs->count == mrecs->size)
         {
-            base_rec = (struct darshan_base_record *)mod_buf;
-            if(init_rank == -1)
-                init_rank = base_rec->rank;
+            void **tmp_recs;
+            int new_size = mrecs->size ? mrecs->size * 2 : 64;
 
-            /* initialize the hash with the first rank's records */
-            if(base_rec->rank == init_rank)
+            tmp_recs = realloc(mrecs->recs, new_size * sizeof(*tmp_recs));
+            if(!tmp_recs)
             {
-                struct darshan_base_record *agg_base;
+                free(rec);
+                ret = -1;
+                break;
+            }
+            mrecs->recs = tmp_recs;
+            mrecs->size = new_size;
+        }
+        mrecs->recs[mrecs->count++] = rec;
 
-                /* create a new ref and add to the hash */
-                ref = malloc(sizeof(*ref));
-                if(!ref)
-                {
-                    darshan_log_close(in_fd);
-                    return(-1);
-                }
-                memset(ref, 0, sizeof(*ref));
+        if(ms->shared_redux && mod_logutils[mod_id]->log_agg_records)
+        {
+            base_rec = (struct darshan_base_record *)rec;
+            if(merge_count_shared_rec(ms, mod_id, base_rec->id) < 0)
+            {
+                ret = -1;
+                break;
+            }
+        }
+        rec = NULL;
+    }
+    if(!in->fd)
+        darshan_log_close(in_fd);
+    else
+        darshan_log_release_buffers(in_fd);
+    if(ret < 0)
+    {
+        fprintf(stderr,
+            "Error: unable to read %s module record from input log file %s.\n",
+            darshan_module_names[mod_id], in->path);
+        return(-1);
+    }
+
+    pthread_mutex_lock(&ms->mutex);
+    ms->total_recs += mrecs->count;
+    pthread_mutex_unlock(&ms->mutex);
+
+    return(0);
+}
+
+/* release the records of the module being merged that are still held for
+ * an input log
+ */
+static void merge_free_input_module(struct merge_input *in)
+{
+    struct merge_mod_records *mrecs = &(in->mod_recs);
+    int k;
+
+    for(k = 0; k < mrecs->count; k++)
+        free(mrecs->recs[k]);
+    free(mrecs->recs);
+    memset(mrecs, 0, sizeof(*mrecs));
+
+    return;
+}
+
+static void *merge_read_worker(void *arg)
+{
+    struct merge_state *ms = (struct merge_state *)arg;
+    int idx;
+    int ret;
+
+    while(1)
+    {
+        pthread_mutex_lock(&ms->mutex);
+        if(ms->err || ms->next_input >= ms->n_inputs)
+        {
+            pthread_mutex_unlock(&ms->mutex);
+            break;
+        }
+        idx = ms->next_input++;
+        pthread_mutex_unlock(&ms->mutex);
+
+        if(ms->cur_mod < 0)
+            ret = merge_read_input(ms, idx);
+        else
+            ret = merge_read_input_module(ms, idx);
+        if(ret < 0)
+        {
+            pthread_mutex_lock(&ms->mutex);
+            ms->err = 1;
+            pthread_mutex_unlock(&ms->mutex);
+            break;
+        }
+    }
+
+    return(NULL);
+}
+
+/* read the job data and name records of every input log, or the records
+ * of module ms->cur_mod, using a pool of n_threads threads
+ */
+static int merge_read_inputs(struct merge_state *ms, int n_threads)
+{
+    pthread_t *threads;
+    int n_started = 0;
+    int i;
+
+    ms->next_input = 0;
+
+    if(n_threads > ms->n_inputs)
+        n_threads = ms->n_inputs;
+
+    threads = malloc(n_threads * sizeof(*threads));
+    if(!threads)
+        return(-1);
 
+    for(i = 0; i < n_threads; i++)
+    {
+        if(pthread_create(&threads[i], NULL, merge_read_worker, ms) != 0)
+            break;
+        n_started++;
+    }
+    /* if no threads could be started, just read the logs serially */
+    if(n_started == 0)
+        merge_read_worker(ms);
+
+    for(i = 0; i < n_started; i++)
+        pthread_join(threads[i], NULL);
+    free(threads);
+
+    return(ms->err ? -1 : 0);
+}
+
+/* build the hash of records shared globally by a module, aggregating
+ * the records of every process into a single record
+ */
+static int build_mod_shared_rec_hash(struct merge_state *ms,
+    darshan_module_id mod_id, int nprocs,
+    struct darshan_shared_record_ref **shared_rec_hash)
+{
+    struct merge_mod_records *mrecs = &(ms->inputs[0].mod_recs);
+    struct darshan_base_record *base_rec, *agg_base;
+    struct darshan_shared_record_ref *ref, *tmp;
+    int64_t init_rank;
+    int i, j, k;
+
+    /* if this module has no method for aggregating shared records, do nothing */
+    if(!(mod_logutils[mod_id]->log_agg_records) || mrecs->count == 0)
+        return(0);
+
+    /* candidate shared records are the first rank's records that were seen
+     * once for every process in the job
+     */
+    init_rank = ((struct darshan_base_record *)mrecs->recs[0])->rank;
+    for(i = 0; i < mrecs->count; i++)
+    {
+        base_rec = (struct darshan_base_record *)mrecs->recs[i];
+        if(base_rec->rank != init_rank)
+            continue;
+
+        HASH_FIND(hlink, *shared_rec_hash, &(base_rec->id),
+            sizeof(darshan_record_id), ref);
+        if(ref || merge_get_shared_count(ms, mod_id, base_rec->id) != nprocs)
+            continue;
+
+        ref = malloc(sizeof(*ref));
+        if(!ref)
+            return(-1);
+        memset(ref, 0, sizeof(*ref));
+        ref->id = base_rec->id;
+        HASH_ADD(hlink, *shared_rec_hash, id, sizeof(darshan_record_id), ref);
+    }
+
+    /* aggregate each process's record into the shared record, in input order */
+    for(j = 0; j < ms->n_inputs && *shared_rec_hash; j++)
+    {
+        mrecs = &(ms->inputs[j].mod_recs);
+        for(i = 0; i < mrecs->count; i++)
+        {
+            base_rec = (struct darshan_base_record *)mrecs->recs[i];
+            HASH_FIND(hlink, *shared_rec_hash, &(base_rec->id),
+                sizeof(darshan_record_id), ref);
+            if(!ref)
+                continue;
+
+            if(ref->ref_cnt == 0)
+            {
                 /* initialize the aggregate record with this rank's record */
-                mod_logutils[mod_id]->log_agg_records(mod_buf, ref->agg_rec, 1);
+                mod_logutils[mod_id]->log_agg_records(base_rec, ref->agg_rec, 1);
                 agg_base = (struct darshan_base_record *)ref->agg_rec;
                 agg_base->id = base_rec->id;
                 agg_base->rank = -1;
-
-                ref->id = base_rec->id;
-                ref->ref_cnt = 1;
-                HASH_ADD(hlink, *shared_rec_hash, id, sizeof(darshan_record_id), ref);
             }
             else
-           {
-                /* search for this record in shared record hash */
-                HASH_FIND(hlink, *shared_rec_hash, &(base_rec->id),
-                    sizeof(darshan_record_id), ref);
-                if(ref)
-                {
-                    /* if found, aggregate this rank's record into the shared record */
-                    mod_logutils[mod_id]->log_agg_records(mod_buf, ref->agg_rec, 0);
-                    ref->ref_cnt++;
-                }
+                mod_logutils[mod_id]->log_agg_records(base_rec, ref->agg_rec, 0);
+            ref->ref_cnt++;
+
+            if(ms->common_values)
+            {
+                for(k = 0; k < DARSHAN_COMMON_VALUE_SET_MAX; k++)
+                    darshan_common_value_sketch_add_record(&ref->sketches[k],
+                        mod_id, k, base_rec);
             }
         }
-        if(ret < 0)
-        {
-            fprintf(stderr,
-                "Error: unable to read %s module record from input log file %s.\n",
-                darshan_module_names[mod_id], infile_list[i]);
-            darshan_log_close(in_fd);
-            return(-1);
-        }
-
-        darshan_log_close(in_fd);
     }
 
-    /* prune any non-shared records from the hash one last time */
-    HASH_ITER(hlink, *shared_rec_hash, ref, tmp)
+    /* replace the aggregate records' common values with the most common
+     * values of all processes
+     */
+    if(ms->common_values && mod_logutils[mod_id]->log_common_values)
     {
-        if(ref->ref_cnt != nprocs)
+        HASH_ITER(hlink, *shared_rec_hash, ref, tmp)
         {
-            HASH_DELETE(hlink, *shared_rec_hash, ref);
-            free(ref);
+            for(k = 0; k < DARSHAN_COMMON_VALUE_SET_MAX; k++)
+                darshan_common_value_sketch_put_record(&ref->sketches[k],
+                    mod_id, k, ref->agg_rec);
         }
     }
 
     return(0);
 }
 
+static void merge_free_inputs(struct merge_state *ms)
+{
+    int i, j;
+
+    for(j = 0; j < ms->n_inputs; j++)
+    {
+        merge_free_input_module(&ms->inputs[j]);
+        if(ms->inputs[j].fd)
+            darshan_log_close(ms->inputs[j].fd);
+    }
+    free(ms->inputs);
+
+    for(i = 0; i < DARSHAN_KNOWN_MODULE_COUNT; i++)
+    {
+        merge_free_shared_counts(ms, i);
+        for(j = 0; j < MERGE_SHARED_HASH_SHARDS; j++)
+            pthread_mutex_destroy(&(ms->shared_counts[i][j].mutex));
+    }
+    pthread_mutex_destroy(&ms->mutex);
+
+    return;
+}
+
 int main(int argc, char *argv[])
 {
     char **infile_list;
     int n_infiles;
     int shared_redux;
+    int common_values;
+    int n_threads;
+    int quiet;
     int64_t job_end_time = 0;
     char *outlog_path;
-    darshan_fd in_fd, merge_fd;
-    struct darshan_job in_job, merge_job;
-    char merge_exe[DARSHAN_EXE_LEN+1] = {0};
-    struct darshan_mnt_info *merge_mnt_array;
-    int merge_mnt_count = 0;
-    struct darshan_name_record_ref *in_hash = NULL;
+    darshan_fd merge_fd;
+    struct darshan_job *in_job, merge_job;
+    struct merge_state *ms;
+    struct merge_mod_records *mrecs;
     struct darshan_name_record_ref *merge_hash = NULL;
     struct darshan_name_record_ref *ref, *tmp, *found;
     struct darshan_shared_record_ref *shared_rec_hash = NULL;
     struct darshan_shared_record_ref *sref, *stmp;
     struct darshan_base_record *base_rec;
-    char *mod_buf;
-    int i, j;
+    struct timespec start, end;
+    struct rlimit nofile;
+    uint64_t mod_flags = 0;
+    double elapsed;
+    int i, j, k;
     int ret;
 
     /* grab command line arguments */
-    parse_args(argc, argv, &infile_list, &n_infiles, &outlog_path, &shared_redux, &job_end_time);
+    parse_args(argc, argv, &infile_list, &n_infiles, &outlog_path, &shared_redux,
+        &common_values, &job_end_time, &n_threads, &quiet);
 
-    memset(&merge_job, 0, sizeof(struct darshan_job));
+    if(n_infiles < 1)
+    {
+        fprintf(stderr, "Error: no input Darshan log files given.\n");
+        return(-1);
+    }
 
-    /* first pass at merging together logs:
-     *      - compose output job-level metadata structure (including exe & mount data)
-     *      - compose output record_id->file_name mapping 
-     */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    ms = malloc(sizeof(*ms));
+    if(!ms)
+    {
+        fprintf(stderr, "Error: unable to allocate merge state.\n");
+        return(-1);
+    }
+    memset(ms, 0, sizeof(*ms));
+    ms->inputs = calloc(n_infiles, sizeof(*ms->inputs));
+    if(!ms->inputs)
+    {
+        fprintf(stderr, "Error: unable to allocate merge state.\n");
+        free(ms);
+        return(-1);
+    }
+    ms->n_inputs = n_infiles;
+    ms->shared_redux = shared_redux;
+    ms->common_values = common_values;
+    ms->cur_mod = -1;
     for(i = 0; i < n_infiles; i++)
+        ms->inputs[i].path = infile_list[i];
+    /* keep inputs open between modules, raising the soft limit on file
+     * descriptors as far as the hard limit allows; inputs are only
+     * reopened for each module if the hard limit is too low
+     */
+    if(getrlimit(RLIMIT_NOFILE, &nofile) == 0)
     {
-        memset(&in_job, 0, sizeof(struct darshan_job));
-
-        in_fd = darshan_log_open(infile_list[i]);
-        if(in_fd == NULL)
+        if(nofile.rlim_cur == RLIM_INFINITY ||
+           (rlim_t)n_infiles + 64 <= nofile.rlim_cur)
+            ms->keep_open = 1;
+        else if(nofile.rlim_max == RLIM_INFINITY ||
+                (rlim_t)n_infiles + 64 <= nofile.rlim_max)
         {
-            fprintf(stderr,
-                "Error: unable to open input Darshan log file %s.\n",
-                infile_list[i]);
-            return(-1);
+            nofile.rlim_cur = (rlim_t)n_infiles + 64;
+            if(setrlimit(RLIMIT_NOFILE, &nofile) == 0)
+                ms->keep_open = 1;
         }
+    }
+    pthread_mutex_init(&ms->mutex, NULL);
+    for(i = 0; i < DARSHAN_KNOWN_MODULE_COUNT; i++)
+        for(j = 0; j < MERGE_SHARED_HASH_SHARDS; j++)
+            pthread_mutex_init(&(ms->shared_counts[i][j].mutex), NULL);
 
-        /* read job-level metadata from the input file */
-        ret = darshan_log_get_job(in_fd, &in_job);
-        if(ret < 0)
-        {
-            fprintf(stderr,
-                "Error: unable to read job data from input Darshan log file %s.\n",
-                infile_list[i]);
-            darshan_log_close(in_fd);
-            return(-1);
-        }
+    /* read the job data and name records of every input log, in parallel */
+    ret = merge_read_inputs(ms, n_threads);
+    if(ret < 0)
+    {
+        merge_free_inputs(ms);
+        free(ms);
+        return(-1);
+    }
+
+    /* compose output job-level metadata structure and the output
+     * record_id->file_name mapping
+     */
+    memcpy(&merge_job, &ms->inputs[0].job, sizeof(struct darshan_job));
+    for(i = 0; i < n_infiles; i++)
+    {
+        in_job = &ms->inputs[i].job;
 
 #if 0
         /* XXX: the darshan_shutdown tag is never set in darshan-core, currently */
@@ -248,75 +718,37 @@ int main(int argc, char *argv[])
          * shutdown procedure was started, then it's possible the log has
          * incomplete or corrupt data, so we just throw out the data for now.
          */
-        if(strstr(in_job.metadata, "darshan_shutdown=yes"))
+        if(strstr(in_job->metadata, "darshan_shutdown=yes"))
         {
             fprintf(stderr,
                 "Error: potentially corrupt data found in input log file %s.\n",
                 infile_list[i]);
-            darshan_log_close(in_fd);
+            merge_free_inputs(ms);
+            free(ms);
             return(-1);
         }
 #endif
 
-        if(i == 0)
+        /* potentially update job timestamps using remaining logs */
+        if((in_job->start_time_sec < merge_job.start_time_sec) ||
+           ((in_job->start_time_sec == merge_job.start_time_sec) &&
+            (in_job->start_time_nsec < merge_job.start_time_nsec)))
         {
-            /* get job data, exe, & mounts directly from the first input log */
-            memcpy(&merge_job, &in_job, sizeof(struct darshan_job));
-
-            ret = darshan_log_get_exe(in_fd, merge_exe);
-            if(ret < 0)
-            {
-                fprintf(stderr,
-                    "Error: unable to read exe string from input Darshan log file %s.\n",
-                    infile_list[i]);
-                darshan_log_close(in_fd);
-                return(-1);
-            }
-
-            ret = darshan_log_get_mounts(in_fd, &merge_mnt_array, &merge_mnt_count);
-            if(ret < 0)
-            {
-                fprintf(stderr,
-                    "Error: unable to read mount info from input Darshan log file %s.\n",
-                    infile_list[i]);
-                darshan_log_close(in_fd);
-                return(-1);
-            }
+            merge_job.start_time_sec = in_job->start_time_sec;
+            merge_job.start_time_nsec = in_job->start_time_nsec;
         }
-        else
+        if((in_job->end_time_sec > merge_job.end_time_sec) ||
+           ((in_job->end_time_sec == merge_job.end_time_sec) &&
+            (in_job->end_time_nsec > merge_job.end_time_nsec)))
         {
-            /* potentially update job timestamps using remaining logs */
-            if((in_job.start_time_sec < merge_job.start_time_sec) ||
-               ((in_job.start_time_sec == merge_job.start_time_sec) &&
-                (in_job.start_time_nsec < merge_job.start_time_nsec)))
-            {
-                merge_job.start_time_sec = in_job.start_time_sec;
-                merge_job.start_time_nsec = in_job.start_time_nsec;
-            }
-            if((in_job.end_time_sec > merge_job.end_time_sec) ||
-               ((in_job.end_time_sec == merge_job.end_time_sec) &&
-                (in_job.end_time_nsec > merge_job.end_time_nsec)))
-            {
-                merge_job.end_time_sec = in_job.end_time_sec;
-                merge_job.end_time_nsec = in_job.end_time_nsec;
-            }
-        }
-
-        /* read the hash of ids->names for the input log */
-        ret = darshan_log_get_namehash(in_fd, &in_hash);
-        if(ret < 0)
-        {
-            fprintf(stderr,
-                "Error: unable to read job data from input Darshan log file %s.\n",
-                infile_list[i]);
-            darshan_log_close(in_fd);
-            return(-1);
+            merge_job.end_time_sec = in_job->end_time_sec;
+            merge_job.end_time_nsec = in_job->end_time_nsec;
         }
 
         /* iterate the input hash, copying over record id->name mappings
          * that have not already been copied to the output hash
          */
-        HASH_ITER(hlink, in_hash, ref, tmp)
+        HASH_ITER(hlink, ms->inputs[i].name_hash, ref, tmp)
         {
             HASH_FIND(hlink, merge_hash, &(ref->name_record->id),
                 sizeof(darshan_record_id), found);
@@ -329,12 +761,11 @@ int main(int argc, char *argv[])
             {
                 fprintf(stderr,
                     "Error: invalid Darshan record table entry.\n");
-                darshan_log_close(in_fd);
+                merge_free_inputs(ms);
+                free(ms);
                 return(-1);
             }
         }
-
-        darshan_log_close(in_fd);
     }
 
     /* if a job end time was passed in, apply it to the output job */
@@ -349,6 +780,8 @@ int main(int argc, char *argv[])
     if(merge_fd == NULL)
     {
         fprintf(stderr, "Error: unable to create output darshan log.\n");
+        merge_free_inputs(ms);
+        free(ms);
         return(-1);
     }
 
@@ -357,27 +790,21 @@ int main(int argc, char *argv[])
     if(ret < 0)
     {
         fprintf(stderr, "Error: unable to write job data to output darshan log.\n");
-        darshan_log_close(merge_fd);
-        unlink(outlog_path);
-        return(-1);
+        goto merge_fail;
     }
 
-    ret = darshan_log_put_exe(merge_fd, merge_exe);
+    ret = darshan_log_put_exe(merge_fd, ms->exe);
     if(ret < 0)
     {
         fprintf(stderr, "Error: unable to write exe string to output darshan log.\n");
-        darshan_log_close(merge_fd);
-        unlink(outlog_path);
-        return(-1);
+        goto merge_fail;
     }
 
-    ret = darshan_log_put_mounts(merge_fd, merge_mnt_array, merge_mnt_count);
+    ret = darshan_log_put_mounts(merge_fd, ms->mnt_array, ms->mnt_count);
     if(ret < 0)
     {
         fprintf(stderr, "Error: unable to write mount data to output darshan log.\n");
-        darshan_log_close(merge_fd);
-        unlink(outlog_path);
-        return(-1);
+        goto merge_fail;
     }
 
     /* write the merged table of records to output file */
@@ -385,114 +812,79 @@ int main(int argc, char *argv[])
     if(ret < 0)
     {
         fprintf(stderr, "Error: unable to write record table to output darshan log.\n");
-        darshan_log_close(merge_fd);
-        unlink(outlog_path);
-        return(-1);
+        goto merge_fail;
     }
 
-    mod_buf = malloc(DEF_MOD_BUF_SIZE);
-    if(!mod_buf)
-    {
-        fprintf(stderr, "Error: unable to write record table to output darshan log.\n");
-        darshan_log_close(merge_fd);
-        unlink(outlog_path);
-        return(-1);
-    }
+    for(j = 0; j < n_infiles; j++)
+        mod_flags |= ms->inputs[j].mod_flags;
 
-    /* iterate over active darshan modules and gather module data to write
-     * to the merged output log
+    /* iterate over active darshan modules, reading, merging and writing
+     * one module at a time so that only a single module's records are
+     * held in memory
      */
     for(i = 0; i < DARSHAN_KNOWN_MODULE_COUNT; i++)
     {
-        if(!mod_logutils[i]) continue;
+        if(!mod_logutils[i] || !(mod_flags & (1ULL << i))) continue;
+
+        /* decode this module's records from every input log, in parallel */
+        ms->cur_mod = i;
+        ret = merge_read_inputs(ms, n_threads);
+        if(ret < 0)
+            goto merge_fail;
 
         if(shared_redux)
         {
             /* build the hash of records shared globally by this module */
-            ret = build_mod_shared_rec_hash(infile_list, n_infiles, i,
-                merge_job.nprocs, mod_buf, &shared_rec_hash);
+            ret = build_mod_shared_rec_hash(ms, i, merge_job.nprocs,
+                &shared_rec_hash);
             if(ret < 0)
             {
                 fprintf(stderr,
                     "Error: unable to build list of %s module's shared records.\n",
                     darshan_module_names[i]);
-                darshan_log_close(merge_fd);
-                unlink(outlog_path);
-                free(mod_buf);
-                return(-1);
+                goto merge_fail;
             }
 
+            /* write out the shared records first */
+            HASH_ITER(hlink, shared_rec_hash, sref, stmp)
+            {
+                ret = mod_logutils[i]->log_put_record(merge_fd, sref->agg_rec);
+                if(ret < 0)
+                {
+                    fprintf(stderr,
+                        "Error: unable to write %s module record to output darshan log.\n",
+                        darshan_module_names[i]);
+                    goto merge_fail;
+                }
+            }
         }
 
+        /* loop over module records and write them to output file */
         for(j = 0; j < n_infiles; j++)
         {
-            in_fd = darshan_log_open(infile_list[j]);
-            if(in_fd == NULL)
+            mrecs = &(ms->inputs[j].mod_recs);
+            for(k = 0; k < mrecs->count; k++)
             {
-                fprintf(stderr,
-                    "Error: unable to open input Darshan log file %s.\n",
-                    infile_list[j]);
-                darshan_log_close(merge_fd);
-                unlink(outlog_path);
-                free(mod_buf);
-                return(-1);
-            }
+                base_rec = (struct darshan_base_record *)mrecs->recs[k];
 
-            if(j == 0 && shared_rec_hash)
-            {
-                /* write out the shared records first */
-                HASH_ITER(hlink, shared_rec_hash, sref, stmp)
+                HASH_FIND(hlink, shared_rec_hash, &(base_rec->id), sizeof(darshan_record_id), sref);
+                if(!sref)
                 {
-                    ret = mod_logutils[i]->log_put_record(merge_fd, sref->agg_rec);
+                    ret = mod_logutils[i]->log_put_record(merge_fd, mrecs->recs[k]);
                     if(ret < 0)
                     {
                         fprintf(stderr,
-                            "Error: unable to write %s module record to output darshan log.\n",
-                            darshan_module_names[i]);
-                        darshan_log_close(in_fd);
-                        darshan_log_close(merge_fd);
-                        unlink(outlog_path);
-                        free(mod_buf);
-                        return(-1);
+                            "Error: unable to write %s module record to output log file %s.\n",
+                            darshan_module_names[i], infile_list[j]);
+                        goto merge_fail;
                     }
                 }
-            }
-
-            /* loop over module records and write them to output file */
-            while((ret = mod_logutils[i]->log_get_record(in_fd, (void **)&mod_buf)) == 1)
-            {
-                base_rec = (struct darshan_base_record *)mod_buf;
-
-                HASH_FIND(hlink, shared_rec_hash, &(base_rec->id), sizeof(darshan_record_id), sref);
-                if(sref)
-                    continue; /* skip shared records */
 
-                ret = mod_logutils[i]->log_put_record(merge_fd, mod_buf);
-                if(ret < 0)
-                {
-                    fprintf(stderr,
-                        "Error: unable to write %s module record to output log file %s.\n",
-                        darshan_module_names[i], infile_list[j]);
-                    darshan_log_close(in_fd);
-                    darshan_log_close(merge_fd);
-                    unlink(outlog_path);
-                    free(mod_buf);
-                    return(-1);
-                }
-            }
-            if(ret < 0)
-            {
-                fprintf(stderr,
-                    "Error: unable to read %s module record from input log file %s.\n",
-                    darshan_module_names[i], infile_list[j]);
-                darshan_log_close(in_fd);
-                darshan_log_close(merge_fd);
-                unlink(outlog_path);
-                free(mod_buf);
-                return(-1);
+                /* records are released as soon as they are written out */
+                free(mrecs->recs[k]);
+                mrecs->recs[k] = NULL;
             }
-
-            darshan_log_close(in_fd);
+            merge_free_input_module(&ms->inputs[j]);
         }
 
         /* clear the shared record hash for the next module */
@@ -503,14 +895,41 @@ int main(int argc, char *argv[])
                 HASH_DELETE(hlink, shared_rec_hash, sref);
                 free(sref);
             }
+            merge_free_shared_counts(ms, i);
         }
     }
 
-    free(mod_buf);
-
     darshan_log_close(merge_fd);
 
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    elapsed = (end.tv_sec - start.tv_sec) +
+        ((end.tv_nsec - start.tv_nsec) / 1.0e9);
+    if(!quiet)
+    {
+        fprintf(stderr, "# merged %d log files (%.2f MiB, %" PRId64 " records) in %.3f seconds using %d threads\n",
+            n_infiles, ms->total_bytes / (1024.0 * 1024.0), ms->total_recs,
+            elapsed, (n_threads < n_infiles) ? n_threads : n_infiles);
+        fprintf(stderr, "# throughput: %.2f MiB/s, %.2f records/s\n",
+            (elapsed > 0) ? (ms->total_bytes / (1024.0 * 1024.0)) / elapsed : 0.0,
+            (elapsed > 0) ? ms->total_recs / elapsed : 0.0);
+    }
+
+    merge_free_inputs(ms);
+    free(ms);
+
     return(0);
+
+merge_fail:
+    HASH_ITER(hlink, shared_rec_hash, sref, stmp)
+    {
+        HASH_DELETE(hlink, shared_rec_hash, sref);
+        free(sref);
+    }
+    darshan_log_close(merge_fd);
+    unlink(outlog_path);
+    merge_free_inputs(ms);
+    free(ms);
+    return(-1);
 }
 
 /*
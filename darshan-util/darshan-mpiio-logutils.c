@@ -56,6 +56,8 @@ static int darshan_log_record_metrics_mpiio_file(void*    mpiio_buf_p,
                                                  double* rw_only_time,
                                                  int64_t* rank,
                                                  int64_t* nprocs);
+static int darshan_log_common_values_mpiio_file(void* mpiio_buf_p, int set,
+    int64_t** values, int64_t** counts);
 
 struct darshan_mod_logutil_funcs mpiio_logutils =
 {
@@ -66,7 +68,8 @@ struct darshan_mod_logutil_funcs mpiio_logutils =
     .log_print_diff = &darshan_log_print_mpiio_file_diff,
     .log_agg_records = &darshan_log_agg_mpiio_files,
     .log_sizeof_record = &darshan_log_sizeof_mpiio_file,
-    .log_record_metrics = &darshan_log_record_metrics_mpiio_file
+    .log_record_metrics = &darshan_log_record_metrics_mpiio_file,
+    .log_common_values = &darshan_log_common_values_mpiio_file
 };
 
 static int darshan_log_sizeof_mpiio_file(void* mpiio_buf_p)
@@ -128,6 +131,20 @@ static int darshan_log_record_metrics_mpiio_file(void*    mpiio_buf_p,
     return(0);
 }
 
+static int darshan_log_common_values_mpiio_file(void* mpiio_buf_p, int set,
+    int64_t** values, int64_t** counts)
+{
+    struct darshan_mpiio_file *mpiio_rec = (struct darshan_mpiio_file *)mpiio_buf_p;
+
+    /* the mpiio module only tracks common access sizes */
+    if(set != DARSHAN_COMMON_ACCESS_SIZES)
+        return(0);
+
+    *values = &mpiio_rec->counters[MPIIO_ACCESS1_ACCESS];
+    *counts = &mpiio_rec->counters[MPIIO_ACCESS1_COUNT];
+    return(4);
+}
+
 static int darshan_log_get_mpiio_file(darshan_fd fd, void** mpiio_buf_p)
 {
     struct darshan_mpiio_file *file = *((struct darshan_mpiio_file **)mpiio_buf_p);
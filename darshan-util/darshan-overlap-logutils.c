@@ -0,0 +1,370 @@
+/*
+ * Copyright (C) 2026 University of Chicago.
+ * See COPYRIGHT notice in top-level directory.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "darshan-util-config.h"
+#endif
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include "darshan-logutils.h"
+
+/* counter name strings for the OVERLAP module */
+#define X(a) #a,
+char *overlap_counter_names[] = {
+    OVERLAP_COUNTERS
+};
+
+char *overlap_f_counter_names[] = {
+    OVERLAP_F_COUNTERS
+};
+#undef X
+
+static int darshan_log_get_overlap_file(darshan_fd fd, void** overlap_buf_p);
+static int darshan_log_put_overlap_file(darshan_fd fd, void* overlap_buf);
+static void darshan_log_print_overlap_file(void *file_rec,
+    char *file_name, char *mnt_pt, char *fs_type);
+static void darshan_log_print_overlap_description(int ver);
+static void darshan_log_print_overlap_file_diff(void *file_rec1, char *file_name1,
+    void *file_rec2, char *file_name2);
+static void darshan_log_agg_overlap_files(void *rec, void *agg_rec, int init_flag);
+static int darshan_log_sizeof_overlap_file(void* overlap_buf_p);
+static int darshan_log_record_metrics_overlap_file(void* overlap_buf_p,
+    uint64_t* rec_id, int64_t* r_bytes, int64_t* w_bytes, int64_t* max_offset,
+    double* io_total_time, double* md_only_time, double* rw_only_time,
+    int64_t* rank, int64_t* nprocs);
+
+struct darshan_mod_logutil_funcs overlap_logutils =
+{
+    .log_get_record = &darshan_log_get_overlap_file,
+    .log_put_record = &darshan_log_put_overlap_file,
+    .log_print_record = &darshan_log_print_overlap_file,
+    .log_print_description = &darshan_log_print_overlap_description,
+    .log_print_diff = &darshan_log_print_overlap_file_diff,
+    .log_agg_records = &darshan_log_agg_overlap_files,
+    .log_sizeof_record = &darshan_log_sizeof_overlap_file,
+    .log_record_metrics = &darshan_log_record_metrics_overlap_file
+};
+
+static int darshan_log_sizeof_overlap_file(void* overlap_buf_p)
+{
+    /* overlap records have a fixed size */
+    return(sizeof(struct darshan_overlap_file));
+}
+
+static int darshan_log_record_metrics_overlap_file(void* overlap_buf_p,
+                                         uint64_t* rec_id,
+                                         int64_t* r_bytes,
+                                         int64_t* w_bytes,
+                                         int64_t* max_offset,
+                                         double* io_total_time,
+                                         double* md_only_time,
+                                         double* rw_only_time,
+                                         int64_t* rank,
+                                         int64_t* nprocs)
+{
+    struct darshan_overlap_file *overlap_rec =
+        (struct darshan_overlap_file *)overlap_buf_p;
+
+    *rec_id = overlap_rec->base_rec.id;
+    *r_bytes = 0;
+    *w_bytes = overlap_rec->counters[OVERLAP_BYTES_WRITTEN];
+
+    /* the overlap module doesn't report these; timing is left to the
+     * POSIX module
+     */
+    *max_offset = -1;
+    *io_total_time = 0;
+    *md_only_time = 0;
+    *rw_only_time = 0;
+
+    *rank = overlap_rec->base_rec.rank;
+    /* shared records report the number of ranks that wrote the file */
+    if(overlap_rec->base_rec.rank < 0)
+        *nprocs = overlap_rec->counters[OVERLAP_WRITER_RANKS];
+    else
+        *nprocs = 1;
+
+    return(0);
+}
+
+static int darshan_log_get_overlap_file(darshan_fd fd, void** overlap_buf_p)
+{
+    struct darshan_overlap_file *file =
+        *((struct darshan_overlap_file **)overlap_buf_p);
+    int i;
+    int ret;
+
+    if(fd->mod_map[DARSHAN_OVERLAP_MOD].len == 0)
+        return(0);
+
+    if(fd->mod_ver[DARSHAN_OVERLAP_MOD] == 0 ||
+        fd->mod_ver[DARSHAN_OVERLAP_MOD] > DARSHAN_OVERLAP_VER)
+    {
+        fprintf(stderr, "Error: Invalid OVERLAP module version number (got %d)\n",
+            fd->mod_ver[DARSHAN_OVERLAP_MOD]);
+        return(-1);
+    }
+
+    if(*overlap_buf_p == NULL)
+    {
+        file = malloc(sizeof(*file));
+        if(!file)
+            return(-1);
+    }
+
+    ret = darshan_log_get_mod(fd, DARSHAN_OVERLAP_MOD, file,
+        sizeof(struct darshan_overlap_file));
+
+    if(*overlap_buf_p == NULL)
+    {
+        if(ret == sizeof(struct darshan_overlap_file))
+            *overlap_buf_p = file;
+        else
+            free(file);
+    }
+
+    if(ret < 0)
+        return(-1);
+    else if(ret < sizeof(struct darshan_overlap_file))
+        return(0);
+    else
+    {
+        /* if the read was successful, do any necessary byte-swapping */
+        if(fd->swap_flag)
+        {
+            DARSHAN_BSWAP64(&(file->base_rec.id));
+            DARSHAN_BSWAP64(&(file->base_rec.rank));
+            for(i=0; i<OVERLAP_NUM_INDICES; i++)
+                DARSHAN_BSWAP64(&file->counters[i]);
+            for(i=0; i<OVERLAP_F_NUM_INDICES; i++)
+                DARSHAN_BSWAP64(&file->fcounters[i]);
+        }
+
+        return(1);
+    }
+}
+
+static int darshan_log_put_overlap_file(darshan_fd fd, void* overlap_buf)
+{
+    struct darshan_overlap_file *file = (struct darshan_overlap_file *)overlap_buf;
+    int ret;
+
+    ret = darshan_log_put_mod(fd, DARSHAN_OVERLAP_MOD, file,
+        sizeof(struct darshan_overlap_file), DARSHAN_OVERLAP_VER);
+    if(ret < 0)
+        return(-1);
+
+    return(0);
+}
+
+static void darshan_log_print_overlap_file(void *file_rec, char *file_name,
+    char *mnt_pt, char *fs_type)
+{
+    int i;
+    struct darshan_overlap_file *overlap_file_rec =
+        (struct darshan_overlap_file *)file_rec;
+
+    for(i=0; i<OVERLAP_NUM_INDICES; i++)
+    {
+        DARSHAN_D_COUNTER_PRINT(darshan_module_names[DARSHAN_OVERLAP_MOD],
+            overlap_file_rec->base_rec.rank, overlap_file_rec->base_rec.id,
+            overlap_counter_names[i], overlap_file_rec->counters[i],
+            file_name, mnt_pt, fs_type);
+    }
+
+    for(i=0; i<OVERLAP_F_NUM_INDICES; i++)
+    {
+        DARSHAN_F_COUNTER_PRINT(darshan_module_names[DARSHAN_OVERLAP_MOD],
+            overlap_file_rec->base_rec.rank, overlap_file_rec->base_rec.id,
+            overlap_f_counter_names[i], overlap_file_rec->fcounters[i],
+            file_name, mnt_pt, fs_type);
+    }
+
+    return;
+}
+
+static void darshan_log_print_overlap_description(int ver)
+{
+    printf("\n# description of OVERLAP counters:\n");
+    printf("#   OVERLAP_WRITES: number of POSIX write operations.\n");
+    printf("#   OVERLAP_BYTES_WRITTEN: total bytes written.\n");
+    printf("#   OVERLAP_UNIQUE_BYTES: number of distinct bytes written.\n");
+    printf("#   OVERLAP_REWRITE_BYTES: bytes written more than once by the same rank.\n");
+    printf("#   OVERLAP_SHARED_BYTES: distinct bytes written by more than one rank.\n");
+    printf("#   OVERLAP_WRITER_RANKS: number of ranks that wrote to the file.\n");
+    printf("#   OVERLAP_BLOCK_SIZE: size of the blocks (lock or stripe units) used for the block counters.\n");
+    printf("#   OVERLAP_BLOCKS: number of blocks written.\n");
+    printf("#   OVERLAP_SHARED_BLOCKS: number of blocks written by more than one rank.\n");
+    printf("#   OVERLAP_FALSE_SHARED_BLOCKS: shared blocks without any byte written by more than one rank.\n");
+    printf("#   OVERLAP_MAX_BLOCK_WRITERS: largest number of ranks that wrote to a single block.\n");
+    printf("#   OVERLAP_BLOCK_WRITERS_*: histogram of the number of ranks that wrote to each block.\n");
+    printf("#   OVERLAP_COARSENED_BYTES: unwritten bytes counted as written after the extents\n");
+    printf("#       of a rank were coarsened to bound memory use (the other counters are\n");
+    printf("#       approximate if this is not 0).\n");
+    printf("#   OVERLAP_F_MEAN_BLOCK_WRITERS: mean number of ranks that wrote to each written block.\n");
+    printf("#   NOTE: counters are -1 if the extents of a shared file were too large to merge.\n");
+
+    return;
+}
+
+static void darshan_log_print_overlap_file_diff(void *file_rec1, char *file_name1,
+    void *file_rec2, char *file_name2)
+{
+    struct darshan_overlap_file *file1 = (struct darshan_overlap_file *)file_rec1;
+    struct darshan_overlap_file *file2 = (struct darshan_overlap_file *)file_rec2;
+    int i;
+
+    /* NOTE: we assume that both input records are the same module format version */
+
+    for(i=0; i<OVERLAP_NUM_INDICES; i++)
+    {
+        if(!file2)
+        {
+            printf("- ");
+            DARSHAN_D_COUNTER_PRINT(darshan_module_names[DARSHAN_OVERLAP_MOD],
+                file1->base_rec.rank, file1->base_rec.id, overlap_counter_names[i],
+                file1->counters[i], file_name1, "", "");
+
+        }
+        else if(!file1)
+        {
+            printf("+ ");
+            DARSHAN_D_COUNTER_PRINT(darshan_module_names[DARSHAN_OVERLAP_MOD],
+                file2->base_rec.rank, file2->base_rec.id, overlap_counter_names[i],
+                file2->counters[i], file_name2, "", "");
+        }
+        else if(file1->counters[i] != file2->counters[i])
+        {
+            printf("- ");
+            DARSHAN_D_COUNTER_PRINT(darshan_module_names[DARSHAN_OVERLAP_MOD],
+                file1->base_rec.rank, file1->base_rec.id, overlap_counter_names[i],
+                file1->counters[i], file_name1, "", "");
+            printf("+ ");
+            DARSHAN_D_COUNTER_PRINT(darshan_module_names[DARSHAN_OVERLAP_MOD],
+                file2->base_rec.rank, file2->base_rec.id, overlap_counter_names[i],
+                file2->counters[i], file_name2, "", "");
+        }
+    }
+
+    for(i=0; i<OVERLAP_F_NUM_INDICES; i++)
+    {
+        if(!file2)
+        {
+            printf("- ");
+            DARSHAN_F_COUNTER_PRINT(darshan_module_names[DARSHAN_OVERLAP_MOD],
+                file1->base_rec.rank, file1->base_rec.id, overlap_f_counter_names[i],
+                file1->fcounters[i], file_name1, "", "");
+
+        }
+        else if(!file1)
+        {
+            printf("+ ");
+            DARSHAN_F_COUNTER_PRINT(darshan_module_names[DARSHAN_OVERLAP_MOD],
+                file2->base_rec.rank, file2->base_rec.id, overlap_f_counter_names[i],
+                file2->fcounters[i], file_name2, "", "");
+        }
+        else if(file1->fcounters[i] != file2->fcounters[i])
+        {
+            printf("- ");
+            DARSHAN_F_COUNTER_PRINT(darshan_module_names[DARSHAN_OVERLAP_MOD],
+                file1->base_rec.rank, file1->base_rec.id, overlap_f_counter_names[i],
+                file1->fcounters[i], file_name1, "", "");
+            printf("+ ");
+            DARSHAN_F_COUNTER_PRINT(darshan_module_names[DARSHAN_OVERLAP_MOD],
+                file2->base_rec.rank, file2->base_rec.id, overlap_f_counter_names[i],
+                file2->fcounters[i], file_name2, "", "");
+        }
+    }
+
+    return;
+}
+
+/* NOTE: the extents behind the byte and block counters are not stored in
+ * the log, so aggregated records sum them up.  This is exact for records
+ * of different files, but ignores any overlap between records of the same
+ * file written by different ranks.
+ */
+static void darshan_log_agg_overlap_files(void *rec, void *agg_rec, int init_flag)
+{
+    struct darshan_overlap_file *overlap_rec = (struct darshan_overlap_file *)rec;
+    struct darshan_overlap_file *agg_overlap_rec = (struct darshan_overlap_file *)agg_rec;
+    double writer_sum;
+    int i;
+
+    if(init_flag)
+    {
+        /* when initializing, just copy over the first record */
+        memcpy(agg_overlap_rec, overlap_rec, sizeof(struct darshan_overlap_file));
+        return;
+    }
+
+    /* if the rank values of the two records don't match, set the
+     * aggregate rank to -1 to indicate a shared record
+     */
+    if(overlap_rec->base_rec.rank != agg_overlap_rec->base_rec.rank)
+        agg_overlap_rec->base_rec.rank = -1;
+
+    writer_sum =
+        agg_overlap_rec->fcounters[OVERLAP_F_MEAN_BLOCK_WRITERS] *
+        agg_overlap_rec->counters[OVERLAP_BLOCKS] +
+        overlap_rec->fcounters[OVERLAP_F_MEAN_BLOCK_WRITERS] *
+        overlap_rec->counters[OVERLAP_BLOCKS];
+
+    for(i = 0; i < OVERLAP_NUM_INDICES; i++)
+    {
+        switch(i)
+        {
+            case OVERLAP_WRITER_RANKS:
+            case OVERLAP_MAX_BLOCK_WRITERS:
+                /* max */
+                if(overlap_rec->counters[i] > agg_overlap_rec->counters[i])
+                    agg_overlap_rec->counters[i] = overlap_rec->counters[i];
+                break;
+            case OVERLAP_BLOCK_SIZE:
+                /* set to -1 if the block sizes differ */
+                if(overlap_rec->counters[i] != agg_overlap_rec->counters[i])
+                    agg_overlap_rec->counters[i] = -1;
+                break;
+            default:
+                /* sum, keeping invalid counters -1 */
+                if(overlap_rec->counters[i] < 0 ||
+                   agg_overlap_rec->counters[i] < 0)
+                    agg_overlap_rec->counters[i] = -1;
+                else
+                    agg_overlap_rec->counters[i] += overlap_rec->counters[i];
+                break;
+        }
+    }
+
+    if(overlap_rec->fcounters[OVERLAP_F_MEAN_BLOCK_WRITERS] < 0 ||
+       agg_overlap_rec->fcounters[OVERLAP_F_MEAN_BLOCK_WRITERS] < 0)
+        agg_overlap_rec->fcounters[OVERLAP_F_MEAN_BLOCK_WRITERS] = -1;
+    else if(agg_overlap_rec->counters[OVERLAP_BLOCKS] > 0)
+        agg_overlap_rec->fcounters[OVERLAP_F_MEAN_BLOCK_WRITERS] =
+            writer_sum / agg_overlap_rec->counters[OVERLAP_BLOCKS];
+
+    return;
+}
+
+/*
+ * Local variables:
+ *  c-indent-level: 4
+ *  c-basic-offset: 4
+ * End:
+ *
+ * vim: ts=8 sts=4 sw=4 expandtab
+ */
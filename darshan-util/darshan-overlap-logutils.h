@@ -0,0 +1,15 @@
+/*
+ * Copyright (C) 2026 University of Chicago.
+ * See COPYRIGHT notice in top-level directory.
+ *
+ */
+
+#ifndef __DARSHAN_OVERLAP_LOG_UTILS_H
+#define __DARSHAN_OVERLAP_LOG_UTILS_H
+
+extern char *overlap_counter_names[];
+extern char *overlap_f_counter_names[];
+
+extern struct darshan_mod_logutil_funcs overlap_logutils;
+
+#endif
@@ -0,0 +1,946 @@
+/*
+ * Copyright (C) 2026 University of Chicago.
+ * See COPYRIGHT notice in top-level directory.
+ *
+ */
+
+/* Machine-readable output formats for darshan-parser.
+ *
+ * Rather than printing one line per counter, these formats emit one row per
+ * record with the record's counters as columns.  Counters are collected from
+ * each module's log_print_record function with
+ * darshan_log_print_record_with_hook(), and all output is formatted into a
+ * large buffer that is written to stdout in chunks.
+ *
+ * The column set ("schema") of a row is the ordered list of counter names
+ * (and types) the module printed for the record.  It is the same for every
+ * record of a module except for modules with variable length records (e.g.,
+ * HEATMAP bins or LUSTRE OST lists).  Whenever it changes, the CSV output
+ * starts a new header row and the columnar output starts a new block.
+ *
+ * The columnar format is laid out as follows; all integers are in host byte
+ * order, which can be determined from the byte order mark:
+ *
+ *   file   := "DSHNCOL1" u32 byte_order_mark(0x01020304) block*
+ *   block  := u32 module_id u16 name_len name u32 ncols u64 nrows column*
+ *   column := u16 name_len name u8 type data
+ *   data   := nrows 8-byte values (type 0: int64, 1: uint64, 2: double)
+ *           | nrows u64 end offsets, then the string bytes (type 3: string)
+ *
+ * Every block starts with rank, record_id, file_name, mount_pt, and fs_type
+ * columns, followed by the module's counters.  Blocks hold at most
+ * FMT_BLOCK_ROWS rows.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include "darshan-util-config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+
+#include "darshan-logutils.h"
+#include "darshan-parser-formats.h"
+
+#define FMT_BUF_SIZE (1024*1024)
+#define FMT_BLOCK_ROWS 65536
+#define FMT_FIXED_COLS 5
+
+#define FMT_COLUMNAR_MAGIC "DSHNCOL1"
+#define FMT_COLUMNAR_BOM 0x01020304
+
+struct fmt_column
+{
+    char *name;
+    enum darshan_counter_type type;
+    int selected;
+};
+
+/* counters printed for the record currently being formatted */
+struct fmt_row
+{
+    int mod_id;
+    int64_t rank;
+    darshan_record_id id;
+    char *file_name;
+    char *mnt_pt;
+    char *fs_type;
+    /* string values hold an offset into the str buffer */
+    union darshan_counter_value *vals;
+    int nvals;
+    int vals_size;
+    char *str;
+    size_t str_len;
+    size_t str_size;
+};
+
+/* columns (and values) of a block of columnar output */
+struct fmt_coldata
+{
+    union darshan_counter_value *vals;
+    char *str;
+    size_t str_len;
+    size_t str_size;
+};
+
+struct fmt_block
+{
+    int mod_id;
+    int ncols;
+    int alloc_cols;
+    struct fmt_column *cols;
+    int *row_idx;
+    struct fmt_coldata *data;
+    uint64_t nrows;
+};
+
+static struct darshan_parser_fmt_opts *fmt_opts;
+static char *fmt_buf;
+static size_t fmt_buf_len;
+static struct fmt_column *fmt_schema;
+static int fmt_schema_ncols;
+static int fmt_schema_size;
+static int fmt_schema_mod_id = -1;
+static int fmt_schema_changed;
+static struct fmt_row fmt_row;
+static struct fmt_block fmt_block;
+static int fmt_err;
+
+static void fmt_flush(void);
+static void fmt_write(const void *ptr, size_t len);
+static void fmt_putc(char c);
+static void fmt_puts(const char *str);
+static void fmt_put_u64(uint64_t val);
+static void fmt_put_i64(int64_t val);
+static void fmt_put_double(double val, int json);
+static void fmt_put_csv_str(const char *str);
+static void fmt_put_json_str(const char *str);
+static void fmt_schema_truncate(int ncols);
+static int fmt_schema_add(const char *counter, enum darshan_counter_type type);
+static void fmt_counter_hook(void *ctx, const char *counter,
+    enum darshan_counter_type type, union darshan_counter_value val);
+static const char *fmt_row_str(int idx);
+static void fmt_emit_csv_header(void);
+static void fmt_emit_csv_row(void);
+static void fmt_emit_ndjson_row(void);
+static void fmt_block_flush(void);
+static int fmt_block_init(void);
+static int fmt_block_append(void);
+static void fmt_block_free(void);
+
+int darshan_parser_fmt_parse(const char *str, enum darshan_parser_format *format)
+{
+    if(strcmp(str, "text") == 0)
+        *format = PARSER_FORMAT_TEXT;
+    else if(strcmp(str, "csv-wide") == 0)
+        *format = PARSER_FORMAT_CSV_WIDE;
+    else if(strcmp(str, "ndjson") == 0)
+        *format = PARSER_FORMAT_NDJSON;
+    else if(strcmp(str, "columnar") == 0)
+        *format = PARSER_FORMAT_COLUMNAR;
+    else
+        return(-1);
+
+    return(0);
+}
+
+int darshan_parser_fmt_parse_modules(char *str, struct darshan_parser_fmt_opts *opts)
+{
+    char *tok, *save;
+    int i;
+
+    opts->mod_filter = 1;
+    for(tok = strtok_r(str, ",", &save); tok; tok = strtok_r(NULL, ",", &save))
+    {
+        for(i = 0; i < DARSHAN_KNOWN_MODULE_COUNT; i++)
+        {
+            if(strcmp(tok, darshan_module_names[i]) == 0)
+                break;
+        }
+        if(i == DARSHAN_KNOWN_MODULE_COUNT)
+        {
+            fprintf(stderr, "Error: unknown module %s.\n", tok);
+            return(-1);
+        }
+        opts->mod_selected[i] = 1;
+    }
+
+    return(0);
+}
+
+int darshan_parser_fmt_parse_counters(char *str, struct darshan_parser_fmt_opts *opts)
+{
+    char *tok, *save;
+    char **tmp;
+
+    for(tok = strtok_r(str, ",", &save); tok; tok = strtok_r(NULL, ",", &save))
+    {
+        tmp = realloc(opts->counters, (opts->n_counters + 1) * sizeof(*tmp));
+        if(!tmp)
+            return(-1);
+        opts->counters = tmp;
+        opts->counters[opts->n_counters++] = tok;
+    }
+
+    return(0);
+}
+
+int darshan_parser_fmt_print_records(darshan_fd fd,
+    struct darshan_parser_fmt_opts *opts,
+    struct darshan_name_record_ref *name_hash,
+    struct darshan_mnt_trie *mnt_trie,
+    darshan_mod_iter *mod_iters)
+{
+    struct darshan_mnt_info *mnt;
+    struct darshan_name_record_ref *ref;
+    struct darshan_base_record *base_rec;
+    void *mod_buf = NULL;
+    uint32_t bom = FMT_COLUMNAR_BOM;
+    int ret = 0;
+    int i;
+
+    fmt_opts = opts;
+    fmt_buf = malloc(FMT_BUF_SIZE);
+    if(!fmt_buf)
+        return(-1);
+    fmt_buf_len = 0;
+
+    if(opts->format == PARSER_FORMAT_COLUMNAR)
+    {
+        fmt_write(FMT_COLUMNAR_MAGIC, strlen(FMT_COLUMNAR_MAGIC));
+        fmt_write(&bom, sizeof(bom));
+    }
+
+    for(i = 0; i < DARSHAN_MAX_MODS && ret == 0; i++)
+    {
+        /* check each module for any data */
+        if(fd->mod_map[i].len == 0)
+        {
+            if(!DARSHAN_MOD_FLAG_ISSET(fd->partial_flag, i))
+                continue;
+        }
+        /* skip modules that this version of Darshan can't parse */
+        else if(i >= DARSHAN_KNOWN_MODULE_COUNT)
+        {
+            fprintf(stderr, "# Warning: module id %d is unknown. You may need "
+                            "a newer version of the Darshan utilities to parse it.\n", i);
+            continue;
+        }
+        /* skip modules with no logutil definitions */
+        else if(!mod_logutils[i])
+        {
+            fprintf(stderr, "# Warning: no log utility handlers defined "
+                "for module %s, SKIPPING.\n", darshan_module_names[i]);
+            continue;
+        }
+        /* always ignore DXT modules -- those have a standalone parsing utility */
+        else if(i == DXT_POSIX_MOD || i == DXT_MPIIO_MOD)
+            continue;
+
+        /* skip modules the user did not ask for */
+        if(opts->mod_filter && (i >= DARSHAN_KNOWN_MODULE_COUNT || !opts->mod_selected[i]))
+            continue;
+
+        if(DARSHAN_MOD_FLAG_ISSET(fd->partial_flag, i))
+        {
+            if(!opts->show_incomplete)
+            {
+                fprintf(stderr, "Error: the %s module contains incomplete data "
+                    "(use --show-incomplete to display it anyway).\n",
+                    darshan_module_names[i]);
+                ret = -1;
+                break;
+            }
+            if(fd->mod_map[i].len == 0)
+                continue;
+        }
+
+        while((ret = darshan_mod_iter_next(mod_iters[i], &mod_buf)) == 1)
+        {
+            base_rec = (struct darshan_base_record *)mod_buf;
+
+            fmt_row.mod_id = i;
+            fmt_row.rank = base_rec->rank;
+            fmt_row.id = base_rec->id;
+            fmt_row.file_name = NULL;
+            fmt_row.mnt_pt = "UNKNOWN";
+            fmt_row.fs_type = "UNKNOWN";
+            fmt_row.nvals = 0;
+            fmt_row.str_len = 0;
+
+            /* get the pathname, mount point and fs type for this record */
+            HASH_FIND(hlink, name_hash, &(base_rec->id), sizeof(darshan_record_id), ref);
+            if(ref)
+            {
+                fmt_row.file_name = ref->name_record->name;
+                mnt = darshan_mnt_trie_lookup(mnt_trie, fmt_row.file_name);
+                if(mnt)
+                {
+                    fmt_row.mnt_pt = mnt->mnt_path;
+                    fmt_row.fs_type = mnt->mnt_type;
+                }
+            }
+            else if(i == DARSHAN_BGQ_MOD)
+                fmt_row.file_name = "darshan-bgq-record";
+
+            if(fmt_schema_mod_id != i)
+            {
+                fmt_schema_truncate(0);
+                fmt_schema_mod_id = i;
+                fmt_schema_changed = 1;
+            }
+
+            /* collect this record's counters through the counter hook */
+            darshan_log_print_record_with_hook(i, mod_buf, fmt_row.file_name,
+                fmt_row.mnt_pt, fmt_row.fs_type, fmt_counter_hook, NULL);
+            if(fmt_err)
+            {
+                ret = -1;
+                break;
+            }
+            if(fmt_row.nvals < fmt_schema_ncols)
+            {
+                fmt_schema_truncate(fmt_row.nvals);
+                fmt_schema_changed = 1;
+            }
+            if(!fmt_row.file_name)
+                fmt_row.file_name = "(null)";
+
+            switch(opts->format)
+            {
+                case PARSER_FORMAT_CSV_WIDE:
+                    if(fmt_schema_changed)
+                        fmt_emit_csv_header();
+                    fmt_emit_csv_row();
+                    break;
+                case PARSER_FORMAT_NDJSON:
+                    fmt_emit_ndjson_row();
+                    break;
+                case PARSER_FORMAT_COLUMNAR:
+                    if(fmt_schema_changed || fmt_block.nrows == FMT_BLOCK_ROWS)
+                    {
+                        fmt_block_flush();
+                        if(fmt_block_init() < 0)
+                            fmt_err = 1;
+                    }
+                    if(!fmt_err && fmt_block_append() < 0)
+                        fmt_err = 1;
+                    break;
+                default:
+                    fmt_err = 1;
+                    break;
+            }
+            fmt_schema_changed = 0;
+            if(fmt_err)
+            {
+                ret = -1;
+                break;
+            }
+            free(mod_buf);
+        }
+        /* record left over if we stopped early */
+        free(mod_buf);
+        mod_buf = NULL;
+        if(ret < 0)
+        {
+            fprintf(stderr, "Error: failed to parse %s module record.\n",
+                darshan_module_names[i]);
+            break;
+        }
+    }
+
+    if(ret == 0)
+        fmt_block_flush();
+    fmt_flush();
+    fflush(stdout);
+
+    fmt_block_free();
+    fmt_schema_truncate(0);
+    free(fmt_schema);
+    fmt_schema = NULL;
+    fmt_schema_size = 0;
+    fmt_schema_mod_id = -1;
+    free(fmt_row.vals);
+    free(fmt_row.str);
+    memset(&fmt_row, 0, sizeof(fmt_row));
+    free(fmt_buf);
+    fmt_buf = NULL;
+
+    return(ret);
+}
+
+/*********************************************************
+ * Internal functions for formatting output              *
+ *********************************************************/
+
+static void fmt_flush(void)
+{
+    if(fmt_buf_len)
+        fwrite(fmt_buf, 1, fmt_buf_len, stdout);
+    fmt_buf_len = 0;
+
+    return;
+}
+
+static void fmt_write(const void *ptr, size_t len)
+{
+    if(fmt_buf_len + len > FMT_BUF_SIZE)
+    {
+        fmt_flush();
+        if(len > FMT_BUF_SIZE)
+        {
+            fwrite(ptr, 1, len, stdout);
+            return;
+        }
+    }
+    memcpy(&fmt_buf[fmt_buf_len], ptr, len);
+    fmt_buf_len += len;
+
+    return;
+}
+
+static void fmt_putc(char c)
+{
+    if(fmt_buf_len == FMT_BUF_SIZE)
+        fmt_flush();
+    fmt_buf[fmt_buf_len++] = c;
+
+    return;
+}
+
+static void fmt_puts(const char *str)
+{
+    fmt_write(str, strlen(str));
+
+    return;
+}
+
+static void fmt_put_u64(uint64_t val)
+{
+    char tmp[20];
+    int i = sizeof(tmp);
+
+    do
+    {
+        tmp[--i] = '0' + (val % 10);
+        val /= 10;
+    } while(val);
+    fmt_write(&tmp[i], sizeof(tmp) - i);
+
+    return;
+}
+
+static void fmt_put_i64(int64_t val)
+{
+    if(val < 0)
+    {
+        fmt_putc('-');
+        fmt_put_u64(-(uint64_t)val);
+    }
+    else
+        fmt_put_u64(val);
+
+    return;
+}
+
+/* doubles are printed with 6 decimal places, like printf's %f */
+static void fmt_put_double(double val, int json)
+{
+    char tmp[32];
+    uint64_t scaled, frac;
+    int i;
+
+    if(!isfinite(val))
+    {
+        if(json)
+            fmt_puts("null");
+        else
+            fmt_puts(isnan(val) ? "nan" : (val < 0 ? "-inf" : "inf"));
+        return;
+    }
+    if(fabs(val) >= 1.0e12)
+    {
+        i = snprintf(tmp, sizeof(tmp), "%f", val);
+        fmt_write(tmp, i);
+        return;
+    }
+
+    scaled = (uint64_t)llround(fabs(val) * 1.0e6);
+    if(val < 0 && scaled)
+        fmt_putc('-');
+    fmt_put_u64(scaled / 1000000);
+    frac = scaled % 1000000;
+    tmp[0] = '.';
+    for(i = 6; i > 0; i--)
+    {
+        tmp[i] = '0' + (frac % 10);
+        frac /= 10;
+    }
+    fmt_write(tmp, 7);
+
+    return;
+}
+
+static void fmt_put_csv_str(const char *str)
+{
+    const char *p;
+
+    if(!strpbrk(str, ",\"\r\n"))
+    {
+        fmt_puts(str);
+        return;
+    }
+
+    fmt_putc('"');
+    for(p = str; *p; p++)
+    {
+        if(*p == '"')
+            fmt_putc('"');
+        fmt_putc(*p);
+    }
+    fmt_putc('"');
+
+    return;
+}
+
+static void fmt_put_json_str(const char *str)
+{
+    static const char hex[] = "0123456789abcdef";
+    const unsigned char *p;
+
+    fmt_putc('"');
+    for(p = (const unsigned char *)str; *p; p++)
+    {
+        if(*p == '"' || *p == '\\')
+        {
+            fmt_putc('\\');
+            fmt_putc(*p);
+        }
+        else if(*p < 0x20)
+        {
+            fmt_puts("\\u00");
+            fmt_putc(hex[*p >> 4]);
+            fmt_putc(hex[*p & 0xf]);
+        }
+        else
+            fmt_putc(*p);
+    }
+    fmt_putc('"');
+
+    return;
+}
+
+static void fmt_schema_truncate(int ncols)
+{
+    while(fmt_schema_ncols > ncols)
+        free(fmt_schema[--fmt_schema_ncols].name);
+
+    return;
+}
+
+static int fmt_schema_add(const char *counter, enum darshan_counter_type type)
+{
+    struct fmt_column *col;
+    int i;
+
+    if(fmt_schema_ncols == fmt_schema_size)
+    {
+        int new_size = fmt_schema_size ? fmt_schema_size * 2 : 256;
+
+        col = realloc(fmt_schema, new_size * sizeof(*col));
+        if(!col)
+            return(-1);
+        fmt_schema = col;
+        fmt_schema_size = new_size;
+    }
+
+    col = &fmt_schema[fmt_schema_ncols];
+    col->name = strdup(counter);
+    if(!col->name)
+        return(-1);
+    col->type = type;
+
+    /* apply the counter projection, if any */
+    col->selected = (fmt_opts->n_counters == 0);
+    for(i = 0; i < fmt_opts->n_counters && !col->selected; i++)
+    {
+        if(strcmp(fmt_opts->counters[i], counter) == 0)
+            col->selected = 1;
+    }
+
+    fmt_schema_ncols++;
+    return(0);
+}
+
+static void fmt_counter_hook(void *ctx, const char *counter,
+    enum darshan_counter_type type, union darshan_counter_value val)
+{
+    int k = fmt_row.nvals;
+    size_t len;
+
+    /* the row being built is kept in fmt_row */
+    (void)ctx;
+
+    if(fmt_err)
+        return;
+
+    /* a counter that does not match the current schema starts a new one */
+    if(k >= fmt_schema_ncols || fmt_schema[k].type != type ||
+        strcmp(fmt_schema[k].name, counter) != 0)
+    {
+        fmt_schema_truncate(k);
+        if(fmt_schema_add(counter, type) < 0)
+        {
+            fmt_err = 1;
+            return;
+        }
+        fmt_schema_changed = 1;
+    }
+
+    if(fmt_row.nvals == fmt_row.vals_size)
+    {
+        union darshan_counter_value *tmp;
+        int new_size = fmt_row.vals_size ? fmt_row.vals_size * 2 : 256;
+
+        tmp = realloc(fmt_row.vals, new_size * sizeof(*tmp));
+        if(!tmp)
+        {
+            fmt_err = 1;
+            return;
+        }
+        fmt_row.vals = tmp;
+        fmt_row.vals_size = new_size;
+    }
+
+    if(type == DARSHAN_COUNTER_STRING)
+    {
+        /* string values may not outlive the hook call, so keep a copy */
+        len = strlen(val.s) + 1;
+        if(fmt_row.str_len + len > fmt_row.str_size)
+        {
+            char *tmp;
+            size_t new_size = fmt_row.str_size ? fmt_row.str_size : 4096;
+
+            while(fmt_row.str_len + len > new_size)
+                new_size *= 2;
+            tmp = realloc(fmt_row.str, new_size);
+            if(!tmp)
+            {
+                fmt_err = 1;
+                return;
+            }
+            fmt_row.str = tmp;
+            fmt_row.str_size = new_size;
+        }
+        memcpy(&fmt_row.str[fmt_row.str_len], val.s, len);
+        val.u = fmt_row.str_len;
+        fmt_row.str_len += len;
+    }
+
+    fmt_row.vals[fmt_row.nvals++] = val;
+
+    return;
+}
+
+static const char *fmt_row_str(int idx)
+{
+    return(&fmt_row.str[fmt_row.vals[idx].u]);
+}
+
+static void fmt_emit_csv_header(void)
+{
+    int i;
+
+    fmt_puts("module,rank,record_id,file_name,mount_pt,fs_type");
+    for(i = 0; i < fmt_schema_ncols; i++)
+    {
+        if(!fmt_schema[i].selected)
+            continue;
+        fmt_putc(',');
+        fmt_put_csv_str(fmt_schema[i].name);
+    }
+    fmt_putc('\n');
+
+    return;
+}
+
+static void fmt_emit_csv_row(void)
+{
+    int i;
+
+    fmt_put_csv_str(darshan_module_names[fmt_row.mod_id]);
+    fmt_putc(',');
+    fmt_put_i64(fmt_row.rank);
+    fmt_putc(',');
+    fmt_put_u64(fmt_row.id);
+    fmt_putc(',');
+    fmt_put_csv_str(fmt_row.file_name);
+    fmt_putc(',');
+    fmt_put_csv_str(fmt_row.mnt_pt);
+    fmt_putc(',');
+    fmt_put_csv_str(fmt_row.fs_type);
+    for(i = 0; i < fmt_row.nvals; i++)
+    {
+        if(!fmt_schema[i].selected)
+            continue;
+        fmt_putc(',');
+        switch(fmt_schema[i].type)
+        {
+            case DARSHAN_COUNTER_INT64:
+                fmt_put_i64(fmt_row.vals[i].d);
+                break;
+            case DARSHAN_COUNTER_UINT64:
+                fmt_put_u64(fmt_row.vals[i].u);
+                break;
+            case DARSHAN_COUNTER_DOUBLE:
+                fmt_put_double(fmt_row.vals[i].f, 0);
+                break;
+            case DARSHAN_COUNTER_STRING:
+                fmt_put_csv_str(fmt_row_str(i));
+                break;
+        }
+    }
+    fmt_putc('\n');
+
+    return;
+}
+
+static void fmt_emit_ndjson_row(void)
+{
+    int i;
+
+    fmt_puts("{\"module\":");
+    fmt_put_json_str(darshan_module_names[fmt_row.mod_id]);
+    fmt_puts(",\"rank\":");
+    fmt_put_i64(fmt_row.rank);
+    fmt_puts(",\"record_id\":");
+    fmt_put_u64(fmt_row.id);
+    fmt_puts(",\"file_name\":");
+    fmt_put_json_str(fmt_row.file_name);
+    fmt_puts(",\"mount_pt\":");
+    fmt_put_json_str(fmt_row.mnt_pt);
+    fmt_puts(",\"fs_type\":");
+    fmt_put_json_str(fmt_row.fs_type);
+    for(i = 0; i < fmt_row.nvals; i++)
+    {
+        if(!fmt_schema[i].selected)
+            continue;
+        fmt_putc(',');
+        fmt_put_json_str(fmt_schema[i].name);
+        fmt_putc(':');
+        switch(fmt_schema[i].type)
+        {
+            case DARSHAN_COUNTER_INT64:
+                fmt_put_i64(fmt_row.vals[i].d);
+                break;
+            case DARSHAN_COUNTER_UINT64:
+                fmt_put_u64(fmt_row.vals[i].u);
+                break;
+            case DARSHAN_COUNTER_DOUBLE:
+                fmt_put_double(fmt_row.vals[i].f, 1);
+                break;
+            case DARSHAN_COUNTER_STRING:
+                fmt_put_json_str(fmt_row_str(i));
+                break;
+        }
+    }
+    fmt_puts("}\n");
+
+    return;
+}
+
+/* write out the current block of columnar output, if it holds any rows */
+static void fmt_block_flush(void)
+{
+    struct fmt_column *col;
+    struct fmt_coldata *data;
+    uint32_t u32;
+    uint16_t u16;
+    uint8_t u8;
+    uint64_t u64;
+    int i;
+
+    if(fmt_block.nrows == 0)
+        return;
+
+    u32 = fmt_block.mod_id;
+    fmt_write(&u32, sizeof(u32));
+    u16 = strlen(darshan_module_names[fmt_block.mod_id]);
+    fmt_write(&u16, sizeof(u16));
+    fmt_write(darshan_module_names[fmt_block.mod_id], u16);
+    u32 = fmt_block.ncols;
+    fmt_write(&u32, sizeof(u32));
+    u64 = fmt_block.nrows;
+    fmt_write(&u64, sizeof(u64));
+
+    for(i = 0; i < fmt_block.ncols; i++)
+    {
+        col = &fmt_block.cols[i];
+        data = &fmt_block.data[i];
+
+        u16 = strlen(col->name);
+        fmt_write(&u16, sizeof(u16));
+        fmt_write(col->name, u16);
+        u8 = col->type;
+        fmt_write(&u8, sizeof(u8));
+        fmt_write(data->vals, fmt_block.nrows * sizeof(*data->vals));
+        if(col->type == DARSHAN_COUNTER_STRING)
+            fmt_write(data->str, data->str_len);
+        data->str_len = 0;
+    }
+
+    fmt_block.nrows = 0;
+    return;
+}
+
+/* start a new block of columnar output using the current schema */
+static int fmt_block_init(void)
+{
+    static const char *fixed_names[FMT_FIXED_COLS] =
+        {"rank", "record_id", "file_name", "mount_pt", "fs_type"};
+    static const enum darshan_counter_type fixed_types[FMT_FIXED_COLS] =
+        {DARSHAN_COUNTER_INT64, DARSHAN_COUNTER_UINT64, DARSHAN_COUNTER_STRING,
+         DARSHAN_COUNTER_STRING, DARSHAN_COUNTER_STRING};
+    int ncols = FMT_FIXED_COLS;
+    int i;
+
+    fmt_block_free();
+
+    for(i = 0; i < fmt_schema_ncols; i++)
+    {
+        if(fmt_schema[i].selected)
+            ncols++;
+    }
+
+    fmt_block.cols = calloc(ncols, sizeof(*fmt_block.cols));
+    fmt_block.row_idx = calloc(ncols, sizeof(*fmt_block.row_idx));
+    fmt_block.data = calloc(ncols, sizeof(*fmt_block.data));
+    if(!fmt_block.cols || !fmt_block.row_idx || !fmt_block.data)
+        return(-1);
+    fmt_block.alloc_cols = ncols;
+    fmt_block.mod_id = fmt_row.mod_id;
+
+    for(i = 0; i < ncols; i++)
+    {
+        fmt_block.data[i].vals = malloc(FMT_BLOCK_ROWS * sizeof(*fmt_block.data[i].vals));
+        if(!fmt_block.data[i].vals)
+            return(-1);
+    }
+
+    for(i = 0; i < FMT_FIXED_COLS; i++)
+    {
+        fmt_block.cols[i].name = strdup(fixed_names[i]);
+        if(!fmt_block.cols[i].name)
+            return(-1);
+        fmt_block.cols[i].type = fixed_types[i];
+        fmt_block.row_idx[i] = -1;
+        fmt_block.ncols++;
+    }
+    for(i = 0; i < fmt_schema_ncols; i++)
+    {
+        if(!fmt_schema[i].selected)
+            continue;
+        fmt_block.cols[fmt_block.ncols].name = strdup(fmt_schema[i].name);
+        if(!fmt_block.cols[fmt_block.ncols].name)
+            return(-1);
+        fmt_block.cols[fmt_block.ncols].type = fmt_schema[i].type;
+        fmt_block.row_idx[fmt_block.ncols] = i;
+        fmt_block.ncols++;
+    }
+
+    return(0);
+}
+
+static int fmt_block_append(void)
+{
+    struct fmt_coldata *data;
+    const char *str;
+    size_t len;
+    uint64_t r = fmt_block.nrows;
+    int i;
+
+    for(i = 0; i < fmt_block.ncols; i++)
+    {
+        data = &fmt_block.data[i];
+
+        switch(i)
+        {
+            case 0:
+                data->vals[r].d = fmt_row.rank;
+                continue;
+            case 1:
+                data->vals[r].u = fmt_row.id;
+                continue;
+            case 2:
+                str = fmt_row.file_name;
+                break;
+            case 3:
+                str = fmt_row.mnt_pt;
+                break;
+            case 4:
+                str = fmt_row.fs_type;
+                break;
+            default:
+                if(fmt_block.cols[i].type != DARSHAN_COUNTER_STRING)
+                {
+                    data->vals[r] = fmt_row.vals[fmt_block.row_idx[i]];
+                    continue;
+                }
+                str = fmt_row_str(fmt_block.row_idx[i]);
+                break;
+        }
+
+        /* string columns store the end offset of each row's value */
+        len = strlen(str);
+        if(data->str_len + len > data->str_size)
+        {
+            char *tmp;
+            size_t new_size = data->str_size ? data->str_size : 65536;
+
+            while(data->str_len + len > new_size)
+                new_size *= 2;
+            tmp = realloc(data->str, new_size);
+            if(!tmp)
+                return(-1);
+            data->str = tmp;
+            data->str_size = new_size;
+        }
+        memcpy(&data->str[data->str_len], str, len);
+        data->str_len += len;
+        data->vals[r].u = data->str_len;
+    }
+
+    fmt_block.nrows++;
+    return(0);
+}
+
+static void fmt_block_free(void)
+{
+    int i;
+
+    for(i = 0; i < fmt_block.ncols; i++)
+        free(fmt_block.cols[i].name);
+    for(i = 0; i < fmt_block.alloc_cols; i++)
+    {
+        free(fmt_block.data[i].vals);
+        free(fmt_block.data[i].str);
+    }
+    free(fmt_block.cols);
+    free(fmt_block.row_idx);
+    free(fmt_block.data);
+    memset(&fmt_block, 0, sizeof(fmt_block));
+
+    return;
+}
+
+/*
+ * Local variables:
+ *  c-indent-level: 4
+ *  c-basic-offset: 4
+ * End:
+ *
+ * vim: ts=8 sts=4 sw=4 expandtab
+ */
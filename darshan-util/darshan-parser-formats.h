@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2026 University of Chicago.
+ * See COPYRIGHT notice in top-level directory.
+ *
+ */
+
+#ifndef __DARSHAN_PARSER_FORMATS_H
+#define __DARSHAN_PARSER_FORMATS_H
+
+#include "darshan-logutils.h"
+
+/* output formats supported by darshan-parser */
+enum darshan_parser_format
+{
+    PARSER_FORMAT_TEXT = 0,     /* one line per counter (default) */
+    PARSER_FORMAT_CSV_WIDE,     /* one CSV row per record */
+    PARSER_FORMAT_NDJSON,       /* one JSON object per record */
+    PARSER_FORMAT_COLUMNAR      /* binary, column-oriented blocks of records */
+};
+
+struct darshan_parser_fmt_opts
+{
+    enum darshan_parser_format format;
+    /* modules to parse; all modules if mod_filter is not set */
+    int mod_filter;
+    int mod_selected[DARSHAN_MAX_MODS];
+    /* counters to output; all counters if n_counters is 0 */
+    char **counters;
+    int n_counters;
+    /* show data for modules that stored incomplete data */
+    int show_incomplete;
+};
+
+int darshan_parser_fmt_parse(const char *str, enum darshan_parser_format *format);
+int darshan_parser_fmt_parse_modules(char *str, struct darshan_parser_fmt_opts *opts);
+int darshan_parser_fmt_parse_counters(char *str, struct darshan_parser_fmt_opts *opts);
+
+/* print the records of every selected module in the requested (non-text)
+ * format to stdout, reading them through the per-module iterators given
+ */
+int darshan_parser_fmt_print_records(darshan_fd fd,
+    struct darshan_parser_fmt_opts *opts,
+    struct darshan_name_record_ref *name_hash,
+    struct darshan_mnt_trie *mnt_trie,
+    darshan_mod_iter *mod_iters);
+
+#endif /* __DARSHAN_PARSER_FORMATS_H */
@@ -23,6 +23,7 @@
 #include "uthash-1.9.2/src/uthash.h"
 
 #include "darshan-logutils.h"
+#include "darshan-parser-formats.h"
 
 /*
  * Options
@@ -31,6 +32,7 @@
 #define OPTION_TOTAL (1 << 1)  /* aggregated fields */
 #define OPTION_PERF  (1 << 2)  /* derived performance */
 #define OPTION_FILE  (1 << 3)  /* file count totals */
+#define OPTION_COMMON (1 << 4) /* sketched common access sizes and strides */
 #define OPTION_SHOW_INCOMPLETE  (1 << 7)  /* show what we have, even if log is incomplete */
 #define OPTION_ALL (\
   OPTION_BASE|\
@@ -39,12 +41,21 @@
   OPTION_FILE|\
   OPTION_SHOW_INCOMPLETE)
 
+/* options taking an argument */
+#define OPTION_FORMAT   'F'
+#define OPTION_MODULES  'M'
+#define OPTION_COUNTERS 'C'
+#define OPTION_THREADS  'T'
+
 #define FILETYPE_SHARED (1 << 0)
 #define FILETYPE_UNIQUE (1 << 1)
 #define FILETYPE_PARTSHARED (1 << 2)
 
 #define max(a,b) (((a) > (b)) ? (a) : (b))
 
+/* number of common values printed per set */
+#define PARSER_COMMON_VALUES 10
+
 /*
  * Prototypes
  */
@@ -53,6 +64,9 @@ void mpiio_print_total_file(struct darshan_mpiio_file *mfile, int mpiio_ver);
 void stdio_print_total_file(struct darshan_stdio_file *pfile, int stdio_ver);
 void dfs_print_total_file(struct darshan_dfs_file *pfile, int dfs_ver);
 void daos_print_total_file(struct darshan_daos_object *pfile, int daos_ver);
+void print_overhead(char *metadata, int64_t nprocs, double run_time);
+int parser_mod_selected(darshan_fd fd, int mod, int mask,
+    struct darshan_parser_fmt_opts *fmt_opts);
 
 int usage (char *exename)
 {
@@ -62,15 +76,26 @@ int usage (char *exename)
     fprintf(stderr, "    --file  : total file counts\n");
     fprintf(stderr, "    --perf  : derived perf data\n");
     fprintf(stderr, "    --total : aggregated darshan field data\n");
+    fprintf(stderr, "    --common : most common access sizes and strides across all\n");
+    fprintf(stderr, "               records, with error bounds (also used for --total)\n");
     fprintf(stderr, "    --show-incomplete : display results even if log is incomplete\n");
+    fprintf(stderr, "    --format=<fmt> : output format for records: text [default],\n");
+    fprintf(stderr, "                     csv-wide, ndjson, or columnar (binary)\n");
+    fprintf(stderr, "    --modules=<list> : comma-separated list of modules to parse\n");
+    fprintf(stderr, "    --counters=<list> : comma-separated list of counters to output\n");
+    fprintf(stderr, "                        (csv-wide, ndjson, and columnar formats only)\n");
+    fprintf(stderr, "    --threads=<n> : number of threads decoding module data in the\n");
+    fprintf(stderr, "                    background (default: online CPUs - 1)\n");
 
     exit(1);
 }
 
-int parse_args (int argc, char **argv, char **filename)
+int parse_args (int argc, char **argv, char **filename,
+    struct darshan_parser_fmt_opts *fmt_opts, int *n_threads)
 {
     int index;
     int mask;
+    char *check;
     static struct option long_opts[] =
     {
         {"all",   0, NULL, OPTION_ALL},
@@ -78,12 +103,21 @@ int parse_args (int argc, char **argv, char **filename)
         {"file",  0, NULL, OPTION_FILE},
         {"perf",  0, NULL, OPTION_PERF},
         {"total", 0, NULL, OPTION_TOTAL},
+        {"common", 0, NULL, OPTION_COMMON},
         {"show-incomplete", 0, NULL, OPTION_SHOW_INCOMPLETE},
+        {"format", required_argument, NULL, OPTION_FORMAT},
+        {"modules", required_argument, NULL, OPTION_MODULES},
+        {"counters", required_argument, NULL, OPTION_COUNTERS},
+        {"threads", required_argument, NULL, OPTION_THREADS},
         {"help",  0, NULL, 0},
         {0, 0, 0, 0}
     };
 
     mask = 0;
+    /* leave one CPU for printing records */
+    *n_threads = sysconf(_SC_NPROCESSORS_ONLN) - 1;
+    if(*n_threads < 0)
+        *n_threads = 0;
 
     while(1)
     {
@@ -98,9 +132,33 @@ int parse_args (int argc, char **argv, char **filename)
             case OPTION_FILE:
             case OPTION_PERF:
             case OPTION_TOTAL:
+            case OPTION_COMMON:
             case OPTION_SHOW_INCOMPLETE:
                 mask |= c;
                 break;
+            case OPTION_FORMAT:
+                if(darshan_parser_fmt_parse(optarg, &fmt_opts->format) < 0)
+                {
+                    fprintf(stderr, "Error: unknown output format %s.\n", optarg);
+                    usage(argv[0]);
+                }
+                break;
+            case OPTION_MODULES:
+                if(darshan_parser_fmt_parse_modules(optarg, fmt_opts) < 0)
+                    usage(argv[0]);
+                break;
+            case OPTION_COUNTERS:
+                if(darshan_parser_fmt_parse_counters(optarg, fmt_opts) < 0)
+                    usage(argv[0]);
+                break;
+            case OPTION_THREADS:
+                *n_threads = strtol(optarg, &check, 10);
+                if(optarg == check || *n_threads < 0)
+                {
+                    fprintf(stderr, "Error: invalid number of threads.\n");
+                    usage(argv[0]);
+                }
+                break;
             case 0:
             case '?':
             default:
@@ -124,6 +182,21 @@ int parse_args (int argc, char **argv, char **filename)
         mask |= OPTION_BASE;
     }
 
+    /* the record-oriented formats only output base log fields */
+    if(fmt_opts->format != PARSER_FORMAT_TEXT &&
+        (mask & ~OPTION_SHOW_INCOMPLETE) != OPTION_BASE)
+    {
+        fprintf(stderr, "Error: --total, --perf, --file, and --common are only "
+            "supported with --format=text.\n");
+        usage(argv[0]);
+    }
+    if(fmt_opts->format == PARSER_FORMAT_TEXT && fmt_opts->n_counters)
+    {
+        fprintf(stderr, "Error: --counters is not supported with --format=text.\n");
+        usage(argv[0]);
+    }
+    fmt_opts->show_incomplete = (mask & OPTION_SHOW_INCOMPLETE) ? 1 : 0;
+
     return mask;
 }
 
@@ -131,16 +204,19 @@ int main(int argc, char **argv)
 {
     int ret;
     int mask;
-    int i, j;
+    int i, j, k;
     char *filename;
     char *comp_str;
     char tmp_string[4096] = {0};
+    char ovh_metadata[DARSHAN_JOB_METADATA_LEN];
     darshan_fd fd;
     struct darshan_job job;
     struct darshan_name_record_ref *name_hash = NULL;
     struct darshan_name_record_ref *ref, *tmp_ref;
     int mount_count;
     struct darshan_mnt_info *mnt_data_array;
+    struct darshan_mnt_trie *mnt_trie = NULL;
+    struct darshan_mnt_info *mnt;
     time_t tmp_time = 0;
     double run_time;
     char *token;
@@ -148,11 +224,20 @@ int main(int argc, char **argv)
     char buffer[DARSHAN_JOB_METADATA_LEN];
     int empty_mods = 0;
     char *mod_buf;
+    void *rec_buf;
+    int n_threads;
+    int n_iters = 0;
+    darshan_log_reader reader = NULL;
+    darshan_mod_iter mod_iters[DARSHAN_KNOWN_MODULE_COUNT] = {0};
 
     darshan_accumulator acc = NULL;
     struct darshan_derived_metrics metrics;
+    struct darshan_common_value common[PARSER_COMMON_VALUES];
+    int n_common;
+    struct darshan_parser_fmt_opts fmt_opts;
 
-    mask = parse_args(argc, argv, &filename);
+    memset(&fmt_opts, 0, sizeof(fmt_opts));
+    mask = parse_args(argc, argv, &filename, &fmt_opts, &n_threads);
 
     fd = darshan_log_open(filename);
     if(!fd)
@@ -181,6 +266,13 @@ int main(int argc, char **argv)
         darshan_log_close(fd);
         return(-1);
     }
+    mnt_trie = darshan_mnt_trie_create(mnt_data_array, mount_count);
+    if(!mnt_trie)
+    {
+        fprintf(stderr, "Error: unable to index mount table.\n");
+        darshan_log_close(fd);
+        return(-1);
+    }
 
     /* read hash of darshan records */
     ret = darshan_log_get_namehash(fd, &name_hash);
@@ -190,6 +282,44 @@ int main(int argc, char **argv)
         return(-1);
     }
 
+    /* decode the modules we are going to print on background threads,
+     * each through its own iterator, while records are printed here
+     */
+    for(i = 0; i < DARSHAN_KNOWN_MODULE_COUNT; i++)
+    {
+        if(parser_mod_selected(fd, i, mask, &fmt_opts))
+            n_iters++;
+    }
+    reader = darshan_log_reader_open(filename,
+        (n_threads < n_iters) ? n_threads : n_iters);
+    if(!reader)
+    {
+        fprintf(stderr, "Error: unable to create log reader.\n");
+        ret = -1;
+        goto cleanup;
+    }
+    for(i = 0; i < DARSHAN_KNOWN_MODULE_COUNT; i++)
+    {
+        if(!parser_mod_selected(fd, i, mask, &fmt_opts))
+            continue;
+        mod_iters[i] = darshan_log_reader_mod_iter(reader, i);
+        if(!mod_iters[i])
+        {
+            fprintf(stderr, "Error: unable to read %s module data.\n",
+                darshan_module_names[i]);
+            ret = -1;
+            goto cleanup;
+        }
+    }
+
+    /* record-oriented formats only output module records */
+    if(fmt_opts.format != PARSER_FORMAT_TEXT)
+    {
+        ret = darshan_parser_fmt_print_records(fd, &fmt_opts, name_hash,
+            mnt_trie, mod_iters);
+        goto cleanup;
+    }
+
     /* print any warnings related to this log file version */
     darshan_log_print_version_warnings(fd->version);
 
@@ -218,6 +348,9 @@ int main(int argc, char **argv)
     printf("# nprocs: %" PRId64 "\n", job.nprocs);
     darshan_log_get_job_runtime(fd, job, &run_time);
     printf("# run time: %.4lf\n", run_time);
+    /* keep a copy of the metadata, which is tokenized in place below */
+    memcpy(ovh_metadata, job.metadata, DARSHAN_JOB_METADATA_LEN);
+    ovh_metadata[DARSHAN_JOB_METADATA_LEN-1] = '\0';
     for(token=strtok_r(job.metadata, "\n", &save);
         token != NULL;
         token=strtok_r(NULL, "\n", &save))
@@ -238,6 +371,7 @@ int main(int argc, char **argv)
         value++;
         printf("# metadata: %s = %s\n", key, value);
     }
+    print_overhead(ovh_metadata, job.nprocs, run_time);
 
     /* print breakdown of each log file region's contribution to file size */
     printf("\n# log file regions\n");
@@ -320,6 +454,9 @@ int main(int argc, char **argv)
         /* always ignore DXT modules -- those have a standalone parsing utility */
         else if (i == DXT_POSIX_MOD || i == DXT_MPIIO_MOD)
             continue;
+        /* skip modules the user did not ask for */
+        else if(fmt_opts.mod_filter && !fmt_opts.mod_selected[i])
+            continue;
         /* currently only POSIX, MPIIO, STDIO, and DAOS modules support non-base
          * parsing
          */
@@ -349,7 +486,9 @@ int main(int argc, char **argv)
                        "\n# To avoid this error, consult the darshan-runtime\n"
                        "# documentation and consider setting the\n"
                        "# DARSHAN_EXCLUDE_DIRS environment variable to prevent\n"
-                       "# Darshan from instrumenting unecessary files.\n");
+                       "# Darshan from instrumenting unecessary files, or\n"
+                       "# raising the DARSHAN_MODMEM_MAX and\n"
+                       "# DARSHAN_NAMEMEM_MAX limits on Darshan's memory.\n");
                 if(fd->mod_map[i].len == 0)
                     continue; // no data to parse
             }
@@ -365,7 +504,9 @@ int main(int argc, char **argv)
                        "\n# To avoid this error, consult the darshan-runtime\n"
                        "# documentation and consider setting the\n"
                        "# DARSHAN_EXCLUDE_DIRS environment variable to prevent\n"
-                       "# Darshan from instrumenting unecessary files.\n");
+                       "# Darshan from instrumenting unecessary files, or\n"
+                       "# raising the DARSHAN_MODMEM_MAX and\n"
+                       "# DARSHAN_NAMEMEM_MAX limits on Darshan's memory.\n");
                 fprintf(stderr,
                         "\n# You can display the (incomplete) data that is\n"
                         "# present in this log using the --show-incomplete\n"
@@ -387,6 +528,8 @@ int main(int argc, char **argv)
         /* create an accumulator, if supported */
         /* no explicit error checking; we will just skip injecting if null */
         darshan_accumulator_create(i, job.nprocs, &acc);
+        if(acc && (mask & OPTION_COMMON))
+            darshan_accumulator_track_common_values(acc);
 
         /* loop over each of this module's records and print them */
         while(1)
@@ -395,7 +538,7 @@ int main(int argc, char **argv)
             char *fs_type = NULL;
             char *rec_name = NULL;
 
-            ret = mod_logutils[i]->log_get_record(fd, (void **)&mod_buf);
+            ret = darshan_mod_iter_next(mod_iters[i], &rec_buf);
             if(ret < 1)
             {
                 if(ret == -1)
@@ -405,7 +548,7 @@ int main(int argc, char **argv)
                 }
                 break;
             }
-            base_rec = (struct darshan_base_record *)mod_buf;
+            base_rec = (struct darshan_base_record *)rec_buf;
 
             /* get the pathname for this record */
             HASH_FIND(hlink, name_hash, &(base_rec->id), sizeof(darshan_record_id), ref);
@@ -415,15 +558,11 @@ int main(int argc, char **argv)
                 rec_name = ref->name_record->name;
 
                 /* get mount point and fs type associated with this record */
-                for(j=0; j<mount_count; j++)
+                mnt = darshan_mnt_trie_lookup(mnt_trie, rec_name);
+                if(mnt)
                 {
-                    if(strncmp(mnt_data_array[j].mnt_path, rec_name,
-                        strlen(mnt_data_array[j].mnt_path)) == 0)
-                    {
-                        mnt_pt = mnt_data_array[j].mnt_path;
-                        fs_type = mnt_data_array[j].mnt_type;
-                        break;
-                    }
+                    mnt_pt = mnt->mnt_path;
+                    fs_type = mnt->mnt_type;
                 }
             }
             else
@@ -440,13 +579,14 @@ int main(int argc, char **argv)
             if(mask & OPTION_BASE)
             {
                 /* print the corresponding module data for this record */
-                mod_logutils[i]->log_print_record(mod_buf, rec_name,
+                mod_logutils[i]->log_print_record(rec_buf, rec_name,
                     mnt_pt, fs_type);
             }
 
             /* accumulated and derived metrics, if supported */
             if(acc)
-                darshan_accumulator_inject(acc, mod_buf, 1);
+                darshan_accumulator_inject(acc, rec_buf, 1);
+            free(rec_buf);
         }
         if(ret == -1)
             continue; /* move on to the next module if there was an error with this one */
@@ -562,6 +702,24 @@ int main(int argc, char **argv)
             printf("# agg_perf_by_slowest: %lf # MiB/s\n", metrics.agg_perf_by_slowest);
         }
 
+        /* Common value Calc */
+        if((mask & OPTION_COMMON) && acc && mod_logutils[i]->log_common_values)
+        {
+            printf("\n# common values\n");
+            printf("# -------------\n");
+            printf("# <set>: <value> <count> <error>: most common values across all records;\n");
+            printf("#    count may overestimate the number of occurrences by up to error\n");
+            for(j = 0; j < DARSHAN_COMMON_VALUE_SET_MAX; j++)
+            {
+                n_common = darshan_accumulator_emit_common_values(acc, j,
+                    common, PARSER_COMMON_VALUES);
+                for(k = 0; k < n_common; k++)
+                    printf("# %s: %" PRId64 " %" PRId64 " %" PRId64 "\n",
+                        (j == DARSHAN_COMMON_ACCESS_SIZES) ? "access_size" : "stride",
+                        common[k].value, common[k].count, common[k].error);
+            }
+        }
+
         if(acc) {
             darshan_accumulator_destroy(acc);
             acc = NULL;
@@ -571,9 +729,12 @@ int main(int argc, char **argv)
     if(empty_mods == DARSHAN_MAX_MODS)
         printf("\n# no module data available.\n");
     ret = 0;
+    free(mod_buf);
 
+cleanup:
+    darshan_log_reader_close(reader);
     darshan_log_close(fd);
-    free(mod_buf);
+    free(fmt_opts.counters);
 
     /* free record hash data */
     HASH_ITER(hlink, name_hash, ref, tmp_ref)
@@ -584,6 +745,7 @@ int main(int argc, char **argv)
     }
 
     /* free mount info */
+    darshan_mnt_trie_destroy(mnt_trie);
     if(mount_count > 0)
     {
         free(mnt_data_array);
@@ -592,6 +754,27 @@ int main(int argc, char **argv)
     return(ret);
 }
 
+/* returns 1 if the records of the given module are going to be parsed,
+ * following the same rules as the module loop in main()
+ */
+int parser_mod_selected(darshan_fd fd, int mod, int mask,
+    struct darshan_parser_fmt_opts *fmt_opts)
+{
+    if(fd->mod_map[mod].len == 0 || !mod_logutils[mod])
+        return(0);
+    if(mod == DXT_POSIX_MOD || mod == DXT_MPIIO_MOD)
+        return(0);
+    if(fmt_opts->mod_filter && !fmt_opts->mod_selected[mod])
+        return(0);
+    if(fmt_opts->format == PARSER_FORMAT_TEXT && !(mask & OPTION_BASE) &&
+        (mod != DARSHAN_POSIX_MOD) && (mod != DARSHAN_MPIIO_MOD) &&
+        (mod != DARSHAN_STDIO_MOD) && (mod != DARSHAN_DFS_MOD) &&
+        (mod != DARSHAN_DAOS_MOD))
+        return(0);
+
+    return(1);
+}
+
 void stdio_print_total_file(struct darshan_stdio_file *pfile, int stdio_ver)
 {
     int i;
@@ -687,6 +870,55 @@ void daos_print_total_file(struct darshan_daos_object *pfile, int daos_ver)
     return;
 }
 
+/* print a table of instrumentation overhead stored in the job metadata by
+ * the Darshan library's overhead accounting mode (if enabled), expressed
+ * as a fraction of the total process run time, along with the memory
+ * high-water mark of module arenas
+ */
+void print_overhead(char *metadata, int64_t nprocs, double run_time)
+{
+    char *token;
+    char *save;
+    char name[64];
+    double total_time, max_time, lock_wait;
+    double calls, contended;
+    double total_bytes, max_bytes;
+    double proc_time = (double)nprocs * run_time;
+    int header_printed = 0;
+
+    for(token=strtok_r(metadata, "\n", &save);
+        token != NULL;
+        token=strtok_r(NULL, "\n", &save))
+    {
+        if(header_printed && sscanf(token, "arena_%63[^=]=%lf,%lf", name,
+            &total_bytes, &max_bytes) == 3)
+        {
+            printf("# %s\tarena memory high-water mark: %.0lf bytes "
+                "(max process %.0lf bytes)\n", name, total_bytes, max_bytes);
+            continue;
+        }
+        if(sscanf(token, "overhead_%63[^=]=%lf,%lf,%lf,%lf,%lf", name,
+            &total_time, &max_time, &calls, &contended, &lock_wait) != 6)
+            continue;
+
+        if(!header_printed)
+        {
+            printf("\n# instrumentation overhead\n");
+            printf("# -------------------------------------------------------\n");
+            printf("# <module>\t<total time (s)>\t<max process time (s)>\t"
+                "<%% of run time>\t<calls>\t<lock contended>\t"
+                "<lock wait (s)>\n");
+            header_printed = 1;
+        }
+        printf("# %s\t%.6lf\t%.6lf\t%.4lf\t%.0lf\t%.0lf\t%.6lf\n", name,
+            total_time, max_time,
+            (proc_time > 0) ? (total_time / proc_time * 100.0) : 0.0,
+            calls, contended, lock_wait);
+    }
+
+    return;
+}
+
 /*
  * Local variables:
  *  c-indent-level: 4
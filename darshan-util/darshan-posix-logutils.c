@@ -58,6 +58,8 @@ static int darshan_log_record_metrics_posix_file(void*    posix_buf_p,
                                                  double* rw_only_time,
                                                  int64_t* rank,
                                                  int64_t* nprocs);
+static int darshan_log_common_values_posix_file(void* posix_buf_p, int set,
+    int64_t** values, int64_t** counts);
 
 struct darshan_mod_logutil_funcs posix_logutils =
 {
@@ -68,7 +70,8 @@ struct darshan_mod_logutil_funcs posix_logutils =
     .log_print_diff = &darshan_log_print_posix_file_diff,
     .log_agg_records = &darshan_log_agg_posix_files,
     .log_sizeof_record = &darshan_log_sizeof_posix_file,
-    .log_record_metrics = &darshan_log_record_metrics_posix_file
+    .log_record_metrics = &darshan_log_record_metrics_posix_file,
+    .log_common_values = &darshan_log_common_values_posix_file
 };
 
 static int darshan_log_sizeof_posix_file(void* posix_buf_p)
@@ -129,6 +132,26 @@ static int darshan_log_record_metrics_posix_file(void*    posix_buf_p,
     return(0);
 }
 
+static int darshan_log_common_values_posix_file(void* posix_buf_p, int set,
+    int64_t** values, int64_t** counts)
+{
+    struct darshan_posix_file *psx_rec = (struct darshan_posix_file *)posix_buf_p;
+
+    switch(set)
+    {
+        case DARSHAN_COMMON_ACCESS_SIZES:
+            *values = &psx_rec->counters[POSIX_ACCESS1_ACCESS];
+            *counts = &psx_rec->counters[POSIX_ACCESS1_COUNT];
+            return(4);
+        case DARSHAN_COMMON_STRIDES:
+            *values = &psx_rec->counters[POSIX_STRIDE1_STRIDE];
+            *counts = &psx_rec->counters[POSIX_STRIDE1_COUNT];
+            return(4);
+        default:
+            return(0);
+    }
+}
+
 static int darshan_log_get_posix_file(darshan_fd fd, void** posix_buf_p)
 {
     struct darshan_posix_file *file = *((struct darshan_posix_file **)posix_buf_p);
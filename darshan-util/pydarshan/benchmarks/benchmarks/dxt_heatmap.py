@@ -1,6 +1,7 @@
 import os
 import importlib
 
+import numpy as np
 import pandas as pd
 
 import darshan
@@ -74,3 +75,30 @@ class GetHeatMapDf:
 
     def peakmem_get_heatmap_df(self, unique_ranks, bin_count, density):
         heatmap_handling.get_heatmap_df(self.agg_df, xbins=bin_count, nprocs=unique_ranks)
+
+
+class GetHeatMapDfLarge:
+    # synthetic traces at the scale of large DXT logs; segment durations
+    # vary from well within a bin to spanning many bins
+    params = [[1_000_000, 10_000_000], [100, 1000]]
+    param_names = ['n_segments', 'bin_count']
+    timeout = 300
+
+
+    def setup(self, n_segments, bin_count):
+        rng = np.random.default_rng(42)
+        self.nprocs = 1024
+        start_times = rng.random(n_segments) * 600.0
+        self.agg_df = pd.DataFrame({'length': rng.integers(1, 1 << 24, n_segments),
+                                    'start_time': start_times,
+                                    'end_time': start_times + rng.exponential(2.0, n_segments),
+                                    'rank': rng.integers(0, self.nprocs, n_segments),
+                                   })
+
+
+    def time_get_heatmap_df_large(self, n_segments, bin_count):
+        heatmap_handling.get_heatmap_df(self.agg_df, xbins=bin_count, nprocs=self.nprocs)
+
+
+    def peakmem_get_heatmap_df_large(self, n_segments, bin_count):
+        heatmap_handling.get_heatmap_df(self.agg_df, xbins=bin_count, nprocs=self.nprocs)
@@ -3,6 +3,7 @@ import os
 
 example_logs = importlib.import_module("darshan.examples.example_logs")
 from darshan.tests.input import test_data_files_dxt, test_data_files
+from darshan.log_utils import get_log_path
 import darshan
 
 
@@ -96,3 +97,36 @@ class RecordCollectionToDF:
 
     def time_record_collection_to_df(self, darshan_logfile, mod, attach):
         self.record_collection.to_df(attach=attach)
+
+
+class ReportOperations:
+    # filtered, reduced and merged reports are views of the records of
+    # their parent reports, so peak memory should stay close to that of
+    # the parent report alone
+
+    params = [["ior_hdf5_example.darshan",
+               "sample-dxt-simple.darshan",
+               "sample.darshan",
+              ],
+              ["filter", "filter_reduce", "merge", "merge_filter"],
+              ]
+    param_names = ['darshan_logfile', 'operation']
+
+    def setup(self, darshan_logfile, operation):
+        darshan.enable_experimental()
+        self.report = darshan.DarshanReport(get_log_path(darshan_logfile))
+
+    def _run(self, operation):
+        if operation == "filter":
+            return self.report.filter(mods=["POSIX", "STDIO"])
+        elif operation == "filter_reduce":
+            return self.report.filter(mods=["POSIX", "STDIO"]).reduce()
+        elif operation == "merge":
+            return self.report + self.report
+        return (self.report + self.report).filter(mods=["POSIX", "STDIO"])
+
+    def time_report_operation(self, darshan_logfile, operation):
+        self._run(operation)
+
+    def peakmem_report_operation(self, darshan_logfile, operation):
+        self._run(operation)
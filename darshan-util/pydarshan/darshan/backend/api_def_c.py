@@ -47,6 +47,13 @@ struct darshan_mod_info
     int partial_flag;
 };
 
+struct darshan_common_value
+{
+    int64_t value;
+    int64_t count;
+    int64_t error;
+};
+
 /* opaque accumulator reference */
 struct darshan_accumulator_st;
 typedef struct darshan_accumulator_st* darshan_accumulator;
@@ -59,6 +66,9 @@ typedef struct darshan_accumulator_st* darshan_accumulator;
 int darshan_accumulator_create(int darshan_module_id, int64_t, darshan_accumulator*);
 int darshan_accumulator_inject(darshan_accumulator, void*, int);
 int darshan_accumulator_emit(darshan_accumulator, struct darshan_derived_metrics*, void* aggregation_record);
+int darshan_accumulator_merge(darshan_accumulator, darshan_accumulator);
+int darshan_accumulator_track_common_values(darshan_accumulator);
+int darshan_accumulator_emit_common_values(darshan_accumulator, int, struct darshan_common_value*, int);
 int darshan_accumulator_destroy(darshan_accumulator);
 
 /* from darshan-log-format.h */
@@ -76,6 +86,16 @@ struct darshan_job
     char metadata[1024];
 };
 
+struct darshan_log_peek_info
+{
+    char version[8];
+    struct darshan_job job;
+    double run_time;
+    uint64_t partial_flag;
+    int64_t mod_len[64];
+    uint32_t mod_ver[64];
+};
+
 struct darshan_base_record
 {
     darshan_record_id id;
@@ -115,6 +135,13 @@ struct darshan_daos_object
     uint64_t oid_lo;
 };
 
+struct darshan_overlap_file
+{
+    struct darshan_base_record base_rec;
+    int64_t counters[18];
+    double fcounters[1];
+};
+
 struct darshan_stdio_file
 {
     struct darshan_base_record base_rec;
@@ -227,6 +254,8 @@ extern char *dfs_counter_names[];
 extern char *dfs_f_counter_names[];
 extern char *daos_counter_names[];
 extern char *daos_f_counter_names[];
+extern char *overlap_counter_names[];
+extern char *overlap_f_counter_names[];
 extern char *stdio_counter_names[];
 extern char *stdio_f_counter_names[];
 
@@ -236,16 +265,47 @@ int darshan_log_get_job(void *, struct darshan_job *);
 void darshan_log_close(void*);
 int darshan_log_get_exe(void*, char *);
 int darshan_log_get_mounts(void*, struct darshan_mnt_info **, int*);
+struct darshan_mnt_trie *darshan_mnt_trie_create(struct darshan_mnt_info *, int);
+struct darshan_mnt_info *darshan_mnt_trie_lookup(struct darshan_mnt_trie *, const char *);
+void darshan_mnt_trie_destroy(struct darshan_mnt_trie *);
 void darshan_log_get_modules(void*, struct darshan_mod_info **, int*);
+struct darshan_record_id_set;
+struct darshan_name_filter;
 int darshan_log_get_record(void*, int, void **);
+void* darshan_log_reader_open(const char *, int);
+void* darshan_log_reader_mod_iter(void *, int);
+int darshan_mod_iter_next(void *, void **);
+int darshan_mod_iter_next_filtered(void *, void **, struct darshan_record_id_set *);
+void darshan_mod_iter_close(void *);
+void darshan_log_reader_close(void *);
+
+struct dxt_export_opts {
+    double start_time;
+    double end_time;
+    int64_t rank_min;
+    int64_t rank_max;
+    int nthreads;
+};
+int dxt_log_export(const char *, const char *, const struct dxt_export_opts *, int64_t *);
 char* darshan_log_get_lib_version(void);
 int darshan_log_get_job_runtime(void *, struct darshan_job job, double *runtime);
+int darshan_log_peek(const char *, struct darshan_log_peek_info *);
 void darshan_free(void *);
 
 int darshan_log_get_namehash(void*, struct darshan_name_record_ref **hash);
 
 void darshan_log_get_name_records(void*, struct darshan_name_record **, int*);
 void darshan_log_get_filtered_name_records(void*, struct darshan_name_record **, int*, darshan_record_id*, int);
+int darshan_log_get_matching_name_records(void*, struct darshan_name_filter *, struct darshan_record_id_set *, struct darshan_name_record **, int*);
+int darshan_log_get_filtered_record(void*, int, void **, struct darshan_record_id_set *);
+
+struct darshan_record_id_set *darshan_record_id_set_create(const darshan_record_id *, int64_t);
+int darshan_record_id_set_contains(struct darshan_record_id_set *, darshan_record_id);
+int64_t darshan_record_id_set_count(struct darshan_record_id_set *);
+void darshan_record_id_set_destroy(struct darshan_record_id_set *);
+struct darshan_name_filter *darshan_name_filter_create(const char **, int, int);
+int darshan_name_filter_match(struct darshan_name_filter *, const char *);
+void darshan_name_filter_destroy(struct darshan_name_filter *);
 
 """
 
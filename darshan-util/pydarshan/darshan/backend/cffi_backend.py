@@ -5,6 +5,8 @@ and is interfaced via the python CFFI module.
 """
 
 import functools
+import os
+import re
 
 import cffi
 import ctypes
@@ -52,6 +54,13 @@ libdutil = find_utils(ffi, libdutil)
 
 check_version(ffi, libdutil)
 
+# DarshanReport closes its log from __del__, which the garbage collector may
+# run while cffi holds its (non-reentrant) lock to parse a type; bind the
+# functions needed for closing up front, as the first lookup of a library
+# function takes that lock too
+_darshan_log_close = libdutil.darshan_log_close
+_darshan_log_reader_close = libdutil.darshan_log_reader_close
+
 
 _mod_names = [
     "NULL",
@@ -72,6 +81,7 @@ _mod_names = [
     "HEATMAP",
     "DFS",
     "DAOS",
+    "OVERLAP",
 ]
 def mod_name_to_idx(mod_name):
     return _mod_names.index(mod_name)
@@ -90,6 +100,7 @@ _structdefs = {
     "POSIX": "struct darshan_posix_file **",
     "DFS": "struct darshan_dfs_file **",
     "DAOS": "struct darshan_daos_object **",
+    "OVERLAP": "struct darshan_overlap_file **",
     "STDIO": "struct darshan_stdio_file **",
     "APXC-HEADER": "struct darshan_apxc_header_record **",
     "APXC-PERF": "struct darshan_apxc_perf_record **",
@@ -127,7 +138,9 @@ def log_open(filename):
     """
     b_fname = filename.encode()
     handle = libdutil.darshan_log_open(b_fname)
-    log = {"handle": handle, 'modules': None, 'name_records': None}
+    log = {"handle": handle, 'modules': None, 'name_records': None,
+           'filename': filename, 'reader': None, 'iters': {},
+           'record_filter': None}
 
     return log
 
@@ -136,28 +149,41 @@ def log_close(log):
     """
     Closes the logfile and releases allocated memory.
     """
-    libdutil.darshan_log_close(log['handle'])
+    log_reader_close(log)
+    _darshan_log_close(log['handle'])
     #modules = {}
     return
 
 
+def _job_to_dict(jobrec):
+    job = {}
+    job['uid'] = jobrec.uid
+    job['start_time_sec'] = jobrec.start_time_sec
+    job['start_time_nsec'] = jobrec.start_time_nsec
+    job['end_time_sec'] = jobrec.end_time_sec
+    job['end_time_nsec'] = jobrec.end_time_nsec
+    job['nprocs'] = jobrec.nprocs
+    job['jobid'] = jobrec.jobid
+
+    mstr = ffi.string(jobrec.metadata).decode("utf-8")
+    md = {}
+
+    for kv in mstr.split('\n')[:-1]:
+        k,v = kv.split('=', maxsplit=1)
+        md[k] = v
+
+    job['metadata'] = md
+    return job
+
+
 def log_get_job(log):
     """
     Returns a dictionary with information about the current job.
     """
 
-    job = {}
-
     jobrec = ffi.new("struct darshan_job *")
     libdutil.darshan_log_get_job(log['handle'], jobrec)
-
-    job['uid'] = jobrec[0].uid
-    job['start_time_sec'] = jobrec[0].start_time_sec
-    job['start_time_nsec'] = jobrec[0].start_time_nsec
-    job['end_time_sec'] = jobrec[0].end_time_sec
-    job['end_time_nsec'] = jobrec[0].end_time_nsec
-    job['nprocs'] = jobrec[0].nprocs
-    job['jobid'] = jobrec[0].jobid
+    job = _job_to_dict(jobrec[0])
 
     runtime = ffi.new("double *")
     libdutil.darshan_log_get_job_runtime(log['handle'], jobrec[0], runtime)
@@ -168,15 +194,41 @@ def log_get_job(log):
     # pointer as a string...
     job['log_ver'] = ffi.string(ffi.cast("char *", log['handle'])).decode("utf-8")
 
-    mstr = ffi.string(jobrec[0].metadata).decode("utf-8")
-    md = {}
+    return job
 
-    for kv in mstr.split('\n')[:-1]:
-        k,v = kv.split('=', maxsplit=1)
-        md[k] = v
 
-    job['metadata'] = md
-    return job
+def log_peek(filename):
+    """
+    Reads only the header and job record of a darshan logfile, which is
+    much cheaper than opening the log when only job-level metadata and the
+    list of modules are needed (e.g., to scan a large number of logs).
+
+    Args:
+        filename (str): Path to a darshan log file
+
+    Return:
+        dict: 'job', in the form returned by log_get_job(), and 'modules',
+        in the form returned by log_get_modules()
+
+    Raises:
+        RuntimeError: the log could not be read
+    """
+    info = ffi.new("struct darshan_log_peek_info *")
+    if libdutil.darshan_log_peek(filename.encode(), info) != 0:
+        raise RuntimeError(f"Failed to read header of {filename}")
+
+    job = _job_to_dict(info.job)
+    job['run_time'] = info.run_time
+    job['log_ver'] = ffi.string(info.version).decode("utf-8")
+
+    modules = {}
+    for idx, name in enumerate(_mod_names):
+        if info.mod_len[idx] > 0:
+            modules[name] = {'len': info.mod_len[idx], 'ver': info.mod_ver[idx],
+                             'idx': idx,
+                             'partial_flag': bool(info.partial_flag & (1 << idx))}
+
+    return {'job': job, 'modules': modules}
 
 
 def log_get_exe(log):
@@ -216,6 +268,52 @@ def log_get_mounts(log):
     return mntlst
 
 
+def log_lookup_mounts(log, names):
+    """
+    Find the mount point and file system type of each of the given record
+    names, using the longest mount path that is a prefix of the name.
+
+    Args:
+        log: handle returned by darshan.open
+        names: iterable of record names (typically file paths)
+
+    Return:
+        dict: name -> (mount path, fs type), or None if no mount matches
+    """
+
+    mounts = {}
+    mnts = ffi.new("struct darshan_mnt_info **")
+    cnt = ffi.new("int *")
+    libdutil.darshan_log_get_mounts(log['handle'], mnts, cnt)
+    if cnt[0] == 0:
+        return {name: None for name in names}
+
+    trie = libdutil.darshan_mnt_trie_create(mnts[0], cnt[0])
+    if trie == ffi.NULL:
+        libdutil.darshan_free(mnts[0])
+        raise MemoryError("unable to index mount table")
+
+    # resolve each matched entry to python strings only once
+    entries = {}
+    for name in names:
+        if name in mounts:
+            continue
+        mnt = libdutil.darshan_mnt_trie_lookup(trie, name.encode("utf-8"))
+        if mnt == ffi.NULL:
+            mounts[name] = None
+            continue
+        addr = int(ffi.cast("uintptr_t", mnt))
+        if addr not in entries:
+            entries[addr] = (ffi.string(mnt.mnt_path).decode("utf-8"),
+                ffi.string(mnt.mnt_type).decode("utf-8"))
+        mounts[name] = entries[addr]
+
+    libdutil.darshan_mnt_trie_destroy(trie)
+    libdutil.darshan_free(mnts[0])
+
+    return mounts
+
+
 def log_get_modules(log):
     """
     Return a dictionary containing available modules including information 
@@ -320,16 +418,162 @@ def log_lookup_name_records(log, ids=[]):
     return name_records
 
 
+# Python regex syntax that POSIX extended regular expressions lack or
+# interpret differently: escaped letters and digits (classes such as \d,
+# back-references), groups such as (?:...) and non-greedy quantifiers
+_NON_POSIX_REGEX = re.compile(r"\\[0-9A-Za-z]|\(\?|[*+?}]\?")
 
 
+def _posix_regex_compatible(pattern):
+    """
+    Returns True if a Python regex pattern matches the same names when
+    compiled as a POSIX extended regular expression.
+    """
+    if not pattern.isascii():
+        return False
+    # backslashes are not escapes inside POSIX bracket expressions
+    if "[" in pattern and "\\" in pattern:
+        return False
+    # escaped backslashes are literal, and may precede any character
+    return not _NON_POSIX_REGEX.search(pattern.replace("\\\\", ""))
 
-def log_get_record(log, mod, dtype='numpy'):
+
+def log_get_matching_name_records(log, filter_patterns, filter_mode="exclude"):
+    """
+    Return the name records whose names pass a name filter, which is
+    applied by darshan-util while the name records are decoded.
+
+    Args:
+        log: handle returned by darshan.open
+        filter_patterns (list of str): regex patterns to match names against
+        filter_mode (str): whether to "exclude" or "include" matching names
+
+    Return:
+        dict: the name records, or None if the patterns cannot be applied by
+        darshan-util (they use regex syntax POSIX regular expressions lack)
+    """
+    if not all(_posix_regex_compatible(p) for p in filter_patterns):
+        return None
+
+    patterns = [ffi.new("char[]", p.encode()) for p in filter_patterns]
+    mode = 1 if filter_mode == "include" else 0
+    name_filter = libdutil.darshan_name_filter_create(
+            ffi.new("const char *[]", patterns), len(patterns), mode)
+    if name_filter == ffi.NULL:
+        return None
+
+    name_records = {}
+    nrecs = ffi.new("struct darshan_name_record **")
+    cnt = ffi.new("int *")
+    try:
+        ret = libdutil.darshan_log_get_matching_name_records(
+                log['handle'], name_filter, ffi.NULL, nrecs, cnt)
+    finally:
+        libdutil.darshan_name_filter_destroy(name_filter)
+    if ret < 0:
+        raise RuntimeError("Failed to read name records.")
+
+    for i in range(0, cnt[0]):
+        name_records[nrecs[0][i].id] = ffi.string(nrecs[0][i].name).decode("utf-8")
+        libdutil.darshan_free(nrecs[0][i].name)
+    libdutil.darshan_free(nrecs[0])
+
+    return name_records
+
+
+def log_set_record_filter(log, ids):
+    """
+    Restrict the records returned by log_get_generic_record() to the given
+    record ids. Records of other ids are skipped by darshan-util, without
+    being converted to Python objects.
+
+    Args:
+        log: handle returned by darshan.open
+        ids (iterable): record ids to keep, or None to keep all records
+    """
+    if ids is None:
+        log['record_filter'] = None
+        return
+    id_arr = np.fromiter(ids, dtype=np.uint64)
+    id_set = libdutil.darshan_record_id_set_create(
+            ffi.cast("darshan_record_id *", ffi.from_buffer(id_arr)), len(id_arr))
+    if id_set == ffi.NULL:
+        raise RuntimeError("Failed to create record id set.")
+    log['record_filter'] = ffi.gc(id_set, libdutil.darshan_record_id_set_destroy)
+
+
+def log_reader_open(log, mod_names, nthreads=None):
+    """
+    Decode the records of the given modules concurrently on background
+    threads, each module through its own iterator. Until log_reader_close()
+    is called, records of these modules are read from the iterators rather
+    than the log handle.
+
+    Args:
+        log: handle returned by darshan.open
+        mod_names (list): names of the modules, in the order they will be read
+        nthreads (int): number of background threads (default: one less
+            than the number of CPUs, at most one per module)
+    """
+    log_reader_close(log)
+
+    modules = log_get_modules(log)
+    mod_names = [mod for mod in mod_names if mod in modules]
+    if nthreads is None:
+        nthreads = min(len(mod_names), (os.cpu_count() or 1) - 1)
+
+    reader = libdutil.darshan_log_reader_open(log['filename'].encode(), max(nthreads, 0))
+    if reader == ffi.NULL:
+        raise RuntimeError("Failed to create log reader.")
+    log['reader'] = reader
+    for mod in mod_names:
+        it = libdutil.darshan_log_reader_mod_iter(reader, modules[mod]['idx'])
+        # modules without log utilities keep using the log handle
+        if it != ffi.NULL:
+            log['iters'][modules[mod]['idx']] = it
+
+
+def log_reader_close(log):
+    """
+    Stops a reader started with log_reader_open(), discarding any records
+    that were not read.
+
+    Args:
+        log: handle returned by darshan.open
+    """
+    if log.get('reader') is None:
+        return
+    _darshan_log_reader_close(log['reader'])
+    log['reader'] = None
+    log['iters'] = {}
+
+
+def _log_get_record(log, mod_idx, buf, filtered=False):
+    """
+    Reads the next record of a module, through its reader iterator if one
+    is active. With filtered set, records not selected by
+    log_set_record_filter() are skipped.
+    """
+    ids = log.get('record_filter') if filtered else None
+    it = log.get('iters', {}).get(mod_idx)
+    if ids is not None:
+        if it is not None:
+            return libdutil.darshan_mod_iter_next_filtered(it, buf, ids)
+        return libdutil.darshan_log_get_filtered_record(log['handle'], mod_idx, buf, ids)
+    if it is not None:
+        return libdutil.darshan_mod_iter_next(it, buf)
+    return libdutil.darshan_log_get_record(log['handle'], mod_idx, buf)
+
+
+def log_get_record(log, mod, dtype=None):
     """
     Standard entry point fetch records via mod string.
 
     Args:
         log: Handle returned by darshan.open
         mod_name (str): Name of the Darshan module
+        dtype (str): format of the record, defaults to 'dict' for DXT
+            modules and 'numpy' for all others
 
     Return:
         log record of type dtype
@@ -337,13 +581,13 @@ def log_get_record(log, mod, dtype='numpy'):
     """
 
     if mod in ['LUSTRE']:
-        rec = _log_get_lustre_record(log, dtype=dtype)
+        rec = _log_get_lustre_record(log, dtype=dtype or 'numpy')
     elif mod in ['HEATMAP']:
         rec = _log_get_heatmap_record(log)
     elif mod in ['DXT_POSIX', 'DXT_MPIIO']:
-        rec = log_get_dxt_record(log, mod, dtype=dtype)
+        rec = log_get_dxt_record(log, mod, dtype=dtype or 'dict')
     else:
-        rec = log_get_generic_record(log, mod, dtype=dtype)
+        rec = log_get_generic_record(log, mod, dtype=dtype or 'numpy')
 
     return rec
 
@@ -375,7 +619,7 @@ def log_get_generic_record(log, mod_name, dtype='numpy'):
     mod_type = _structdefs[mod_name]
 
     buf = ffi.new("void **")
-    r = libdutil.darshan_log_get_record(log['handle'], modules[mod_name]['idx'], buf)
+    r = _log_get_record(log, modules[mod_name]['idx'], buf, filtered=True)
     if r < 1:
         return None
     rbuf = ffi.cast(mod_type, buf)
@@ -385,19 +629,79 @@ def log_get_generic_record(log, mod_name, dtype='numpy'):
 
     return rec
 
+def log_get_generic_columns(log, mod_name):
+    """
+    Reads all remaining records of a generic module into columnar arrays.
+
+    Args:
+        log: Handle returned by darshan.open
+        mod_name (str): Name of the Darshan module
+
+    Return:
+        dict: 'id' (uint64) and 'rank' (int64) arrays with one entry per
+        record, 'counters' and 'fcounters' arrays with one row per record,
+        and 'file_rec_id' (uint64) for modules that have it; None if the
+        module is not in the log.
+    """
+    modules = log_get_modules(log)
+    if mod_name not in modules:
+        return None
+    mod_type = _structdefs[mod_name]
+    has_file_rec = mod_name == 'H5D' or mod_name == 'PNETCDF_VAR'
+
+    ids, ranks, file_rec_ids, counters, fcounters = [], [], [], [], []
+    buf = ffi.new("void **")
+    while _log_get_record(log, modules[mod_name]['idx'], buf) > 0:
+        rbuf = ffi.cast(mod_type, buf)
+        ids.append(rbuf[0].base_rec.id)
+        ranks.append(rbuf[0].base_rec.rank)
+        if has_file_rec:
+            file_rec_ids.append(rbuf[0].file_rec_id)
+        counters.append(ffi.buffer(rbuf[0].counters)[:])
+        fcounters.append(ffi.buffer(rbuf[0].fcounters)[:])
+        libdutil.darshan_free(buf[0])
+        # darshan_log_get_record() would reuse a non-NULL buffer
+        buf[0] = ffi.NULL
+
+    ncounters = len(counter_names(mod_name))
+    nfcounters = len(fcounter_names(mod_name))
+    cols = {
+        'id': np.array(ids, dtype=np.uint64),
+        'rank': np.array(ranks, dtype=np.int64),
+        'counters': np.frombuffer(bytearray().join(counters), dtype=np.int64).reshape(-1, ncounters),
+        'fcounters': np.frombuffer(bytearray().join(fcounters), dtype=np.float64).reshape(-1, nfcounters),
+    }
+    if has_file_rec:
+        cols['file_rec_id'] = np.array(file_rec_ids, dtype=np.uint64)
+    return cols
+
 def _make_generic_record(rbuf, mod_name, dtype='numpy'):
     """
     Returns a record dictionary for an input record buffer for a given module.
     """
-    rec = {}
-    rec['id'] = rbuf[0].base_rec.id
-    rec['rank'] = rbuf[0].base_rec.rank
+    file_rec_id = None
     if mod_name == 'H5D' or mod_name == 'PNETCDF_VAR':
-        rec['file_rec_id'] = rbuf[0].file_rec_id
+        file_rec_id = rbuf[0].file_rec_id
 
     clst = np.copy(np.frombuffer(ffi.buffer(rbuf[0].counters), dtype=np.int64))
     flst = np.copy(np.frombuffer(ffi.buffer(rbuf[0].fcounters), dtype=np.float64))
 
+    return make_generic_record(rbuf[0].base_rec.id, rbuf[0].base_rec.rank,
+                               clst, flst, mod_name, dtype, file_rec_id)
+
+def make_generic_record(rec_id, rank, clst, flst, mod_name, dtype='numpy',
+                        file_rec_id=None):
+    """
+    Returns a record dictionary for the given counter and fcounter arrays of
+    a record of the given module. With dtype 'numpy' the arrays are used
+    as they are, not copied.
+    """
+    rec = {}
+    rec['id'] = rec_id
+    rec['rank'] = rank
+    if file_rec_id is not None:
+        rec['file_rec_id'] = file_rec_id
+
     c_cols = counter_names(mod_name)
     fc_cols = fcounter_names(mod_name)
 
@@ -504,7 +808,7 @@ def _log_get_lustre_record(log, dtype='numpy'):
 
     rec = {}
     buf = ffi.new("void **")
-    r = libdutil.darshan_log_get_record(log['handle'], modules['LUSTRE']['idx'], buf)
+    r = _log_get_record(log, modules['LUSTRE']['idx'], buf)
     if r < 1:
         return None
     rbuf = ffi.cast("struct darshan_lustre_record **", buf)
@@ -566,6 +870,93 @@ def _log_get_lustre_record(log, dtype='numpy'):
 
 
 
+def log_dxt_export(filename, out_path, start_time=None, end_time=None,
+                   ranks=None, nthreads=None):
+    """
+    Streams the DXT segments of a log into a columnar trace file, without
+    creating Python objects for the segments. The file can be opened with
+    darshan.datatypes.dxt_trace.DXTTrace.
+
+    Args:
+        filename (str): path to the darshan log
+        out_path (str): path of the trace file to write
+        start_time (float): only keep segments ending at or after this time
+        end_time (float): only keep segments starting at or before this time
+        ranks (int or tuple): only keep segments of this rank, or of the
+            inclusive (first, last) range of ranks
+        nthreads (int): number of background decoding threads (default: one
+            less than the number of CPUs)
+
+    Return:
+        int: number of segments written
+    """
+    opts = ffi.new("struct dxt_export_opts *")
+    opts.start_time = start_time if start_time is not None else 0.0
+    opts.end_time = end_time if end_time is not None else -1.0
+    if ranks is None:
+        opts.rank_min, opts.rank_max = 0, -1
+    elif isinstance(ranks, int):
+        opts.rank_min = opts.rank_max = ranks
+    else:
+        opts.rank_min, opts.rank_max = ranks
+    if nthreads is None:
+        nthreads = max((os.cpu_count() or 1) - 1, 0)
+    opts.nthreads = nthreads
+
+    nsegs = ffi.new("int64_t *")
+    r = libdutil.dxt_log_export(filename.encode(), out_path.encode(), opts, nsegs)
+    if r < 0:
+        raise RuntimeError(f"Failed to export DXT data of {filename}.")
+    return nsegs[0]
+
+
+# layout of struct segment_info, so DXT segments can be viewed in place
+_dxt_segment_dtype = np.dtype([
+    ("offset", np.int64),
+    ("length", np.int64),
+    ("start_time", np.float64),
+    ("end_time", np.float64),
+])
+
+# segments of all records of a module, see log_read_all_dxt_records()
+_dxt_bulk_dtype = np.dtype([
+    ("id", np.uint64),
+    ("rank", np.int64),
+] + _dxt_segment_dtype.descr)
+
+
+def _dxt_free(buf, lib=libdutil):
+    # bind the library, so it outlives record buffers collected at exit
+    lib.darshan_free(buf)
+
+
+def _log_get_dxt_buf(log, mod_name):
+    """
+    Reads the next DXT record of a module and returns its header along with
+    a structured array of all of its segments (writes first, then reads).
+
+    The array is a view of the record buffer returned by the C library,
+    which is freed once the array (and any views of it) are collected.
+    """
+    modules = log_get_modules(log)
+    if mod_name not in modules:
+        return None, None
+
+    buf = ffi.new("void **")
+    r = _log_get_record(log, modules[mod_name]['idx'], buf)
+    if r < 1:
+        return None, None
+
+    filerec = ffi.cast("struct dxt_file_record *", buf[0])
+    nsegs = filerec.write_count + filerec.read_count
+    size_of = ffi.sizeof("struct dxt_file_record")
+    # the buffer object keeps the gc'ed pointer (and the record) alive
+    owner = ffi.gc(ffi.cast("char *", buf[0]), _dxt_free)
+    segments = np.frombuffer(ffi.buffer(owner, size_of + nsegs * _dxt_segment_dtype.itemsize),
+                             dtype=_dxt_segment_dtype, count=nsegs, offset=size_of)
+    return filerec, segments
+
+
 def log_get_dxt_record(log, mod_name, reads=True, writes=True, dtype='dict'):
     """
     Returns a dictionary holding a dxt darshan log record.
@@ -573,7 +964,9 @@ def log_get_dxt_record(log, mod_name, reads=True, writes=True, dtype='dict'):
     Args:
         log: Handle returned by darshan.open
         mod_name (str): Name of the Darshan module
-        mod_type (str): String containing the C type
+        dtype (str): 'dict' for lists of segment dictionaries, 'numpy' for
+            structured arrays (viewing the record buffer without copying),
+            'pandas' for DataFrames
 
     Return:
         dict: generic log record
@@ -583,71 +976,86 @@ def log_get_dxt_record(log, mod_name, reads=True, writes=True, dtype='dict'):
     The typical darshan log record provides two arrays, on for integer counters
     and one for floating point counters:
 
-    >>> darshan.log_get_dxt_record(log, "DXT_POSIX", "struct dxt_file_record **")
+    >>> darshan.log_get_dxt_record(log, "DXT_POSIX", dtype="numpy")
     {'rank': 0, 'read_count': 11, 'read_segments': array([...]), ...}
 
 
     """
 
-    modules = log_get_modules(log)
-    if mod_name not in modules:
+    filerec, segments = _log_get_dxt_buf(log, mod_name)
+    if filerec is None:
         return None
-    mod_type = _structdefs[mod_name]
-    #name_records = log_get_name_records(log)
 
     rec = {}
-    buf = ffi.new("void **")
-    r = libdutil.darshan_log_get_record(log['handle'], modules[mod_name]['idx'], buf)
-    if r < 1:
-        return None
-    filerec = ffi.cast(mod_type, buf)
+    rec['id'] = filerec.base_rec.id
+    rec['rank'] = filerec.base_rec.rank
+    rec['hostname'] = ffi.string(filerec.hostname).decode("utf-8")
 
-    rec['id'] = filerec[0].base_rec.id
-    rec['rank'] = filerec[0].base_rec.rank
-    rec['hostname'] = ffi.string(filerec[0].hostname).decode("utf-8")
-    #rec['filename'] = name_records[rec['id']]
-
-    wcnt = filerec[0].write_count
-    rcnt = filerec[0].read_count
+    wcnt = filerec.write_count
+    rcnt = filerec.read_count
 
     rec['write_count'] = wcnt
     rec['read_count'] = rcnt
- 
-    rec['write_segments'] = []
-    rec['read_segments'] = []
-
-
-    size_of = ffi.sizeof("struct dxt_file_record")
-    segments = ffi.cast("struct segment_info *", buf[0] + size_of  )
 
+    if dtype == "dict":
+        rec['write_segments'] = [dict(zip(_dxt_segment_dtype.names, seg))
+                                 for seg in segments[:wcnt].tolist()]
+        rec['read_segments'] = [dict(zip(_dxt_segment_dtype.names, seg))
+                                for seg in segments[wcnt:].tolist()]
+    elif dtype == "pandas":
+        rec['write_segments'] = pd.DataFrame(segments[:wcnt])
+        rec['read_segments'] = pd.DataFrame(segments[wcnt:])
+    else:
+        rec['write_segments'] = segments[:wcnt]
+        rec['read_segments'] = segments[wcnt:]
 
-    for i in range(wcnt):
-        seg = {
-            "offset": segments[i].offset,
-            "length": segments[i].length,
-            "start_time": segments[i].start_time,
-            "end_time": segments[i].end_time
-        }
-        rec['write_segments'].append(seg)
+    return rec
 
 
-    for i in range(rcnt):
-        i = i + wcnt
-        seg = {
-            "offset": segments[i].offset,
-            "length": segments[i].length,
-            "start_time": segments[i].start_time,
-            "end_time": segments[i].end_time
-        }
-        rec['read_segments'].append(seg)
+def log_read_all_dxt_records(log, mod_name, dtype='numpy'):
+    """
+    Reads all remaining records of a DXT module and returns their segments
+    concatenated across records and ranks.
 
+    Args:
+        log: Handle returned by darshan.open
+        mod_name (str): Name of the Darshan module
+        dtype (str): 'numpy' for structured arrays, 'pandas' for DataFrames
 
-    if dtype == "pandas":
-        rec['read_segments'] = pd.DataFrame(rec['read_segments'])
-        rec['write_segments'] = pd.DataFrame(rec['write_segments'])
+    Return:
+        dict: 'write' and 'read' segments, each with 'id', 'rank',
+        'offset', 'length', 'start_time' and 'end_time' columns, in log
+        order
+    """
+    segs = {"write": [], "read": []}
+    counts = {"write": [], "read": []}
+    ids, ranks = [], []
 
-    libdutil.darshan_free(buf[0])
-    return rec
+    while True:
+        filerec, segments = _log_get_dxt_buf(log, mod_name)
+        if filerec is None:
+            break
+        wcnt = filerec.write_count
+        ids.append(filerec.base_rec.id)
+        ranks.append(filerec.base_rec.rank)
+        segs["write"].append(segments[:wcnt])
+        segs["read"].append(segments[wcnt:])
+        counts["write"].append(wcnt)
+        counts["read"].append(filerec.read_count)
+
+    ret = {}
+    for op in ("write", "read"):
+        n = sum(counts[op])
+        out = np.empty(n, dtype=_dxt_bulk_dtype)
+        if n:
+            out["id"] = np.repeat(np.array(ids, dtype=np.uint64), counts[op])
+            out["rank"] = np.repeat(np.array(ranks, dtype=np.int64), counts[op])
+            op_segs = np.concatenate(segs[op])
+            for name in _dxt_segment_dtype.names:
+                out[name] = op_segs[name]
+        ret[op] = pd.DataFrame(out) if dtype == "pandas" else out
+
+    return ret
 
 
 def _log_get_heatmap_record(log):
@@ -671,7 +1079,7 @@ def _log_get_heatmap_record(log):
 
     rec = {}
     buf = ffi.new("void **")
-    r = libdutil.darshan_log_get_record(log['handle'], modules[mod_name]['idx'], buf)
+    r = _log_get_record(log, modules[mod_name]['idx'], buf)
     if r < 1:
         return None
     
@@ -752,6 +1160,9 @@ def _df_to_rec(rec_dict, mod_name, rec_index_of_interest=None):
     return buf
 
 
+# return type of accumulate_records()
+AccumulatedRecords = namedtuple("AccumulatedRecords", ['derived_metrics', 'summary_record'])
+
 def accumulate_records(rec_dict, mod_name, nprocs):
     """
     Passes a set of records (in pandas format) to the Darshan accumulator
@@ -804,6 +1215,62 @@ def accumulate_records(rec_dict, mod_name, nprocs):
 
     summary_rec = _make_generic_record(summary_rbuf, mod_name, dtype='pandas')
 
-    # create namedtuple type to hold return values
-    AccumulatedRecords = namedtuple("AccumulatedRecords", ['derived_metrics', 'summary_record'])
     return AccumulatedRecords(derived_metrics, summary_rec)
+
+
+# darshan_common_value_set values and the names they are reported under
+_COMMON_VALUE_SETS = ["access_size", "stride"]
+
+
+def accumulate_common_values(rec_dict, mod_name, nprocs, n=10):
+    """
+    Passes a set of records (in pandas format) to the Darshan accumulator
+    interface with common value tracking enabled, and returns the most
+    common access sizes and strides across all records.
+
+    Unlike the 4 common value counters of the summary record returned by
+    accumulate_records(), which only keep values that were among the top 4
+    while records were combined one by one, values are counted in a sketch,
+    so a value that is common overall but rarely among the top 4 of any
+    single record is still found.
+
+    Parameters:
+        rec_dict: Dictionary containing the counter and fcounter dataframes.
+        mod_name: Name of the Darshan module.
+        nprocs: Number of processes participating in accumulation.
+        n: Maximum number of values reported per set.
+
+    Returns:
+        DataFrame with a row per value, ordered by decreasing count within
+        each set, and the columns set, value, count and error. count may
+        overestimate the number of occurrences by up to error.
+    """
+    mod_idx = mod_name_to_idx(mod_name)
+    darshan_accumulator = ffi.new("darshan_accumulator *")
+    r = libdutil.darshan_accumulator_create(mod_idx, nprocs, darshan_accumulator)
+    if r != 0:
+        raise RuntimeError("A nonzero exit code was received from "
+                           "darshan_accumulator_create() at the C level. "
+                           f"This could mean that the {mod_name} module does not "
+                           "support derived metric calculation.")
+    acc = darshan_accumulator[0]
+    try:
+        if libdutil.darshan_accumulator_track_common_values(acc) != 0:
+            raise RuntimeError(f"The {mod_name} module does not track common values.")
+
+        num_recs = rec_dict["fcounters"].shape[0]
+        record_array = _df_to_rec(rec_dict, mod_name)
+        if libdutil.darshan_accumulator_inject(acc, record_array, num_recs) != 0:
+            raise RuntimeError("A nonzero exit code was received from "
+                               "darshan_accumulator_inject() at the C level.")
+
+        top = ffi.new("struct darshan_common_value[]", n)
+        rows = []
+        for set_idx, set_name in enumerate(_COMMON_VALUE_SETS):
+            count = libdutil.darshan_accumulator_emit_common_values(acc, set_idx, top, n)
+            for i in range(max(count, 0)):
+                rows.append((set_name, top[i].value, top[i].count, top[i].error))
+    finally:
+        libdutil.darshan_accumulator_destroy(acc)
+
+    return pd.DataFrame(rows, columns=["set", "value", "count", "error"])
@@ -0,0 +1,329 @@
+"""
+Sidecar cache of decoded log data for repeated analysis of the same log.
+
+The first read of a log with the cache enabled stores the name records,
+the records of generic modules (as columnar arrays) and accumulator results
+in a file next to the log (``<log>.idx``) or in a cache directory; later
+reads memory-map that file instead of decoding the log again.
+
+File layout (all integers little-endian)::
+
+    magic "DSHNIDX1"
+    arrays, each starting at a multiple of 64 bytes
+    table of contents (JSON)
+    footer: u64 toc offset, u64 toc length, magic "DSHNIDX1"
+
+The table of contents records the size, mtime and CRC-32 of the log the
+cache was built from and the offset, dtype and shape of every array. New
+entries are appended in place of the old table of contents, so arrays that
+are already mapped never move, and the file never shrinks. Appends hold an
+exclusive ``flock`` on the file and readers a shared one while reading the
+table of contents, so that several processes can use the same cache.
+"""
+
+import fcntl
+import hashlib
+import json
+import logging
+import os
+import zlib
+
+import numpy as np
+
+import darshan
+from darshan.backend.cffi_backend import (ffi, AccumulatedRecords,
+                                          make_generic_record)
+
+logger = logging.getLogger(__name__)
+
+_MAGIC = b"DSHNIDX1"
+_VERSION = 1
+_ALIGN = 64
+_FOOTER = np.dtype([("toc_offset", "<u8"), ("toc_len", "<u8"), ("magic", "S8")])
+
+
+def cache_path(log_path, cache_dir=None):
+    """
+    Returns the path of the cache file of a log: next to the log, or in
+    cache_dir if given.
+    """
+    if cache_dir is None:
+        return log_path + ".idx"
+    return os.path.join(cache_dir, os.path.basename(log_path) + ".idx")
+
+
+def _read_toc(f):
+    # returns the offset, length and contents of the table of contents of
+    # an open cache file
+    f.seek(0)
+    if f.read(len(_MAGIC)) != _MAGIC:
+        raise ValueError("not a log cache file")
+    size = f.seek(0, os.SEEK_END)
+    if size < len(_MAGIC) + _FOOTER.itemsize:
+        raise ValueError("incomplete log cache file")
+    f.seek(size - _FOOTER.itemsize)
+    footer = np.frombuffer(f.read(_FOOTER.itemsize), dtype=_FOOTER)[0]
+    if footer["magic"] != _MAGIC:
+        raise ValueError("incomplete log cache file")
+    toc_offset = int(footer["toc_offset"])
+    toc_len = int(footer["toc_len"])
+    f.seek(toc_offset)
+    return toc_offset, toc_len, json.loads(f.read(toc_len))
+
+
+def _log_crc32(path):
+    crc = 0
+    with open(path, "rb") as f:
+        for block in iter(lambda: f.read(1 << 20), b""):
+            crc = zlib.crc32(block, crc)
+    return crc
+
+
+class LogCache():
+    """
+    Cache file of a single log.
+
+    Entries that cannot be found return None. A missing, corrupt or stale
+    cache file is rebuilt; errors writing it are logged and otherwise
+    ignored, so enabling the cache never makes a log unreadable.
+    """
+
+    def __init__(self, log_path, path=None):
+        self.log_path = log_path
+        self.path = path if path else cache_path(log_path)
+
+        st = os.stat(log_path)
+        self._log = {"size": st.st_size, "mtime_ns": st.st_mtime_ns, "crc32": None}
+        self._arrays = {}
+        self._meta = {}
+        # (offset, dtype, shape) of the arrays in the file
+        self._layout = {}
+        # where the table of contents starts in the file, None if there
+        # is no valid cache file yet
+        self._toc_offset = None
+        self._pending = {}
+        self._writable = True
+
+        try:
+            self._load()
+        except FileNotFoundError:
+            pass
+        except (OSError, ValueError, KeyError, TypeError) as e:
+            logger.info(f"Rebuilding log cache {self.path}: {e}")
+            self._arrays = {}
+            self._meta = {}
+            self._layout = {}
+            self._toc_offset = None
+
+    def __repr__(self):
+        type_ = type(self)
+        return f"<{type_.__module__}.{type_.__qualname__} ({self.path})>"
+
+    def _load(self):
+        with open(self.path, "rb") as f:
+            # keep appends by other processes out while the table of
+            # contents is read; the arrays it lists never change
+            fcntl.flock(f, fcntl.LOCK_SH)
+            toc_offset, _, toc = _read_toc(f)
+            # a private (copy-on-write) mapping, so callers may modify the
+            # arrays
+            mm = np.memmap(f, dtype=np.uint8, mode="c")
+            # the mapping holds a duplicate of the descriptor, which would
+            # otherwise keep the lock
+            fcntl.flock(f, fcntl.LOCK_UN)
+
+        if (toc["version"] != _VERSION or toc["darshan"] != darshan.__version__ or
+                toc["derived_metrics_size"] != ffi.sizeof("struct darshan_derived_metrics")):
+            raise ValueError("cache was written by a different version")
+        log = toc["log"]
+        if log["size"] != self._log["size"]:
+            raise ValueError("log has changed")
+        refresh = False
+        if log["mtime_ns"] != self._log["mtime_ns"]:
+            # the log may just have been copied without preserving its mtime
+            self._log["crc32"] = _log_crc32(self.log_path)
+            if log["crc32"] != self._log["crc32"]:
+                raise ValueError("log has changed")
+            refresh = True
+        self._log["crc32"] = log["crc32"]
+
+        for name, (offset, dtype, shape) in toc["arrays"].items():
+            count = int(np.prod(shape))
+            self._arrays[name] = np.frombuffer(mm, dtype=np.dtype(dtype), count=count,
+                                               offset=offset).reshape(shape)
+        self._meta = toc["meta"]
+        self._layout = toc["arrays"]
+        self._toc_offset = toc_offset
+
+        if refresh:
+            # store the new mtime so the checksum is not needed next time
+            self._flush()
+
+    def _put(self, arrays, meta):
+        for name, arr in arrays.items():
+            arr = np.ascontiguousarray(arr)
+            self._arrays[name] = arr
+            self._pending[name] = arr
+        self._meta.update(meta)
+        self._flush()
+
+    def _flush(self):
+        if not self._writable:
+            return
+        try:
+            if self._toc_offset is None:
+                self._create()
+            else:
+                self._update()
+        except (OSError, ValueError, KeyError) as e:
+            logger.warning(f"Unable to write log cache {self.path}: {e}")
+            self._writable = False
+        self._pending = {}
+
+    def _create(self):
+        if self._log["crc32"] is None:
+            self._log["crc32"] = _log_crc32(self.log_path)
+        # write all arrays to a new file, and only replace an old cache
+        # file once the new one is complete
+        self._pending = dict(self._arrays)
+        self._layout = {}
+        tmp_path = f"{self.path}.{os.getpid()}.tmp"
+        try:
+            os.makedirs(os.path.dirname(os.path.abspath(self.path)), exist_ok=True)
+            with open(tmp_path, "wb") as f:
+                f.write(_MAGIC)
+                self._append(f, len(_MAGIC))
+            os.replace(tmp_path, self.path)
+        except OSError:
+            if os.path.exists(tmp_path):
+                os.remove(tmp_path)
+            raise
+
+    def _update(self):
+        # append the pending arrays to the cache file, after any entries
+        # other processes have appended since it was loaded
+        while True:
+            with open(self.path, "r+b") as f:
+                fcntl.flock(f, fcntl.LOCK_EX)
+                if os.fstat(f.fileno()).st_ino != os.stat(self.path).st_ino:
+                    # the file was rebuilt in the meantime, lock the new one
+                    continue
+                toc_offset, toc_len, toc = _read_toc(f)
+                if toc["log"]["crc32"] != self._log["crc32"]:
+                    raise ValueError("cache was rebuilt for a different log")
+                for name in toc["arrays"]:
+                    self._pending.pop(name, None)
+                self._layout = toc["arrays"]
+                self._meta = {**toc["meta"], **self._meta}
+                self._append(f, toc_offset, toc_len)
+                return
+
+    def _append(self, f, offset, min_toc_len=0):
+        # write the pending arrays and a new table of contents at offset,
+        # padding the table of contents to at least min_toc_len bytes
+        f.seek(offset)
+        toc = {"version": _VERSION,
+               "darshan": darshan.__version__,
+               "derived_metrics_size": ffi.sizeof("struct darshan_derived_metrics"),
+               "log": self._log,
+               "arrays": self._layout,
+               "meta": self._meta}
+        for name, arr in self._pending.items():
+            pad = -offset % _ALIGN
+            f.write(b"\0" * pad)
+            offset += pad
+            self._layout[name] = [offset, arr.dtype.str, list(arr.shape)]
+            f.write(arr.data if arr.size else b"")
+            offset += arr.nbytes
+        toc_bytes = json.dumps(toc).encode("utf-8").ljust(min_toc_len)
+        f.write(toc_bytes)
+        footer = np.array([(offset, len(toc_bytes), _MAGIC)], dtype=_FOOTER)
+        f.write(footer.tobytes())
+        f.truncate()
+        self._toc_offset = offset
+
+    def get_name_records(self):
+        """
+        Returns the name records (record id -> name) of the log, or None.
+        """
+        if "names/id" not in self._arrays:
+            return None
+        ids = self._arrays["names/id"].tolist()
+        ends = self._arrays["names/end"].tolist()
+        blob = self._arrays["names/blob"].tobytes()
+        name_records = {}
+        start = 0
+        for rec_id, end in zip(ids, ends):
+            name_records[rec_id] = blob[start:end].decode("utf-8")
+            start = end
+        return name_records
+
+    def put_name_records(self, name_records):
+        """
+        Stores the name records of the log.
+        """
+        names = [name.encode("utf-8") for name in name_records.values()]
+        self._put({"names/id": np.fromiter(name_records.keys(), dtype=np.uint64,
+                                           count=len(name_records)),
+                   "names/end": np.cumsum([len(n) for n in names], dtype=np.int64),
+                   "names/blob": np.frombuffer(b"".join(names), dtype=np.uint8)}, {})
+
+    def get_records(self, mod_name):
+        """
+        Returns the records of a generic module in the columnar form of
+        backend.log_get_generic_columns(), or None.
+        """
+        prefix = f"records/{mod_name}/"
+        cols = {name[len(prefix):]: arr for name, arr in self._arrays.items()
+                if name.startswith(prefix)}
+        return cols if cols else None
+
+    def put_records(self, mod_name, cols):
+        """
+        Stores the records of a generic module, given as returned by
+        backend.log_get_generic_columns().
+        """
+        self._put({f"records/{mod_name}/{col}": arr for col, arr in cols.items()}, {})
+
+    @staticmethod
+    def _accumulated_key(mod_name, filter_patterns, filter_mode):
+        # accumulator results depend on the records that were accumulated,
+        # i.e. on the name filter used to select them
+        key = json.dumps([filter_patterns or [], filter_mode if filter_patterns else None])
+        return f"accumulated/{mod_name}/{hashlib.sha1(key.encode()).hexdigest()[:16]}"
+
+    def get_accumulated(self, mod_name, filter_patterns=None, filter_mode="exclude"):
+        """
+        Returns the result of backend.accumulate_records() for the records
+        of a module selected by the given name filter, or None.
+        """
+        prefix = self._accumulated_key(mod_name, filter_patterns, filter_mode)
+        if prefix not in self._meta:
+            return None
+        derived_metrics = ffi.new("struct darshan_derived_metrics *")
+        ffi.memmove(derived_metrics, self._arrays[f"{prefix}/derived_metrics"],
+                    ffi.sizeof("struct darshan_derived_metrics"))
+        meta = self._meta[prefix]
+        summary_rec = make_generic_record(meta["id"], meta["rank"],
+                                          self._arrays[f"{prefix}/counters"],
+                                          self._arrays[f"{prefix}/fcounters"],
+                                          mod_name, dtype="pandas",
+                                          file_rec_id=meta.get("file_rec_id"))
+        return AccumulatedRecords(derived_metrics, summary_rec)
+
+    def put_accumulated(self, mod_name, acc, filter_patterns=None, filter_mode="exclude"):
+        """
+        Stores the result of backend.accumulate_records() for the records
+        of a module selected by the given name filter.
+        """
+        prefix = self._accumulated_key(mod_name, filter_patterns, filter_mode)
+        rec = acc.summary_record
+        meta = {"id": int(rec["counters"]["id"].iloc[0]),
+                "rank": int(rec["counters"]["rank"].iloc[0])}
+        if "file_rec_id" in rec:
+            meta["file_rec_id"] = int(rec["file_rec_id"])
+        dm = ffi.buffer(acc.derived_metrics)
+        self._put({f"{prefix}/derived_metrics": np.frombuffer(dm, dtype=np.uint8).copy(),
+                   f"{prefix}/counters": rec["counters"].iloc[0, 2:].to_numpy(dtype=np.int64),
+                   f"{prefix}/fcounters": rec["fcounters"].iloc[0, 2:].to_numpy(dtype=np.float64)},
+                  {prefix: meta})
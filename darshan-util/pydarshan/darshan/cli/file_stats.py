@@ -4,7 +4,6 @@ import argparse
 from pathlib import Path
 import darshan
 import darshan.cli
-from darshan.backend.cffi_backend import accumulate_records
 from typing import Any, Union, Callable
 from humanize import naturalsize
 import concurrent.futures
@@ -13,7 +12,7 @@ from functools import partial
 from rich.console import Console
 from rich.table import Table
 
-def process_logfile(log_path, mod, filter_patterns, filter_mode):
+def process_logfile(log_path, mod, filter_patterns, filter_mode, cache=False):
     """
     Save relevant file statisitcs from a single Darshan log file to a DataFrame.
 
@@ -23,6 +22,7 @@ def process_logfile(log_path, mod, filter_patterns, filter_mode):
     mod : a string, the module name
     filter_patterns: regex patterns for names to exclude/include
     filter_mode: whether to "exclude" or "include" the filter patterns
+    cache: whether to use a log cache, see darshan.DarshanReport
 
     Returns
     -------
@@ -34,7 +34,7 @@ def process_logfile(log_path, mod, filter_patterns, filter_mode):
         if filter_patterns:
             extra_options["filter_patterns"] = filter_patterns
             extra_options["filter_mode"] = filter_mode
-        report = darshan.DarshanReport(log_path, read_all=False)
+        report = darshan.DarshanReport(log_path, read_all=False, cache=cache)
         if mod not in report.modules:
             return pd.DataFrame()
         report.mod_read_all_records(mod, **extra_options)
@@ -234,6 +234,17 @@ def setup_parser(parser: argparse.ArgumentParser):
         action='append',
         help="regex patterns for file record names to include in stats"
     )
+    parser.add_argument(
+        "--cache",
+        action="store_true",
+        help="keep decoded log data in a sidecar cache file next to each log "
+             "and reuse it on later runs"
+    )
+    parser.add_argument(
+        "--cache_dir",
+        type=str,
+        help="keep the cache files (see --cache) in this directory instead"
+    )
 
 def get_input_logs(args):
     if args.log_paths_file:
@@ -274,7 +285,8 @@ def main(args: Union[Any, None] = None):
     elif args.include_names:
         filter_patterns = args.include_names
         filter_mode = "include"
-    process_logfile_with_args = partial(process_logfile, mod=mod, filter_patterns=filter_patterns, filter_mode=filter_mode)
+    process_logfile_with_args = partial(process_logfile, mod=mod, filter_patterns=filter_patterns, filter_mode=filter_mode,
+                                        cache=args.cache_dir or args.cache)
     with concurrent.futures.ProcessPoolExecutor() as executor:
         results = list(executor.map(process_logfile_with_args, log_paths, chunksize=32))
     list_dfs = [df for df in results if not df.empty]
@@ -4,7 +4,7 @@ import argparse
 from pathlib import Path
 import darshan
 import darshan.cli
-from darshan.backend.cffi_backend import accumulate_records
+from darshan.backend.cffi_backend import log_peek
 from typing import Any, Union, Callable
 from datetime import datetime
 from humanize import naturalsize
@@ -14,7 +14,7 @@ from functools import partial
 from rich.console import Console
 from rich.table import Table
 
-def process_logfile(log_path, mod, filter_patterns, filter_mode):
+def process_logfile(log_path, mod, filter_patterns, filter_mode, cache=False):
     """
     Save the statistical data from a single Darshan log file to a DataFrame.
 
@@ -24,6 +24,7 @@ def process_logfile(log_path, mod, filter_patterns, filter_mode):
     mod : a string, the Darshan module name
     filter_patterns: regex patterns for names to exclude/include
     filter_mode: whether to "exclude" or "include" the filter patterns
+    cache: whether to use a log cache, see darshan.DarshanReport
 
     Returns
     -------
@@ -35,14 +36,15 @@ def process_logfile(log_path, mod, filter_patterns, filter_mode):
         if filter_patterns:
             extra_options["filter_patterns"] = filter_patterns
             extra_options["filter_mode"] = filter_mode
-        report = darshan.DarshanReport(log_path, read_all=False)
-        if mod not in report.modules:
+        # logs without the module are skipped after reading only their
+        # header and job record
+        if mod not in log_peek(log_path)['modules']:
             return pd.DataFrame()
+        report = darshan.DarshanReport(log_path, read_all=False, cache=cache)
         report.mod_read_all_records(mod, **extra_options)
         if len(report.records[mod]) == 0:
             return pd.DataFrame()
-        recs = report.records[mod].to_df()
-        acc_rec = accumulate_records(recs, mod, report.metadata['job']['nprocs'])
+        acc_rec = report.accumulate_records(mod)
         dict_acc_rec = {}
         dict_acc_rec['log_file'] = log_path.split('/')[-1]
         dict_acc_rec['exe'] = report.metadata['exe']
@@ -214,6 +216,17 @@ def setup_parser(parser: argparse.ArgumentParser):
         action='append',
         help="regex patterns for file record names to include in stats"
      )
+    parser.add_argument(
+        "--cache",
+        action="store_true",
+        help="keep decoded log data in a sidecar cache file next to each log "
+             "and reuse it on later runs"
+    )
+    parser.add_argument(
+        "--cache_dir",
+        type=str,
+        help="keep the cache files (see --cache) in this directory instead"
+    )
 
 def get_input_logs(args):
     if args.log_paths_file:
@@ -254,7 +267,8 @@ def main(args: Union[Any, None] = None):
     elif args.include_names:
         filter_patterns = args.include_names
         filter_mode = "include"
-    process_logfile_with_args = partial(process_logfile, mod=mod, filter_patterns=filter_patterns, filter_mode=filter_mode)
+    process_logfile_with_args = partial(process_logfile, mod=mod, filter_patterns=filter_patterns, filter_mode=filter_mode,
+                                        cache=args.cache_dir or args.cache)
     with concurrent.futures.ProcessPoolExecutor() as executor:
         results = list(executor.map(process_logfile_with_args, log_paths, chunksize=32))
     list_dfs = [df for df in results if not df.empty]
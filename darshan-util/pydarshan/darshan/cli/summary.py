@@ -14,8 +14,11 @@ from mako.template import Template
 
 import darshan
 import darshan.cli
-from darshan.backend.cffi_backend import accumulate_records
-from darshan.lib.accum import log_file_count_summary_table, log_module_overview_table
+from darshan.lib.accum import (
+    log_file_count_summary_table,
+    log_module_overview_table,
+    log_overhead_table,
+)
 from darshan.experimental.plots import (
     plot_dxt_heatmap,
     plot_io_cost,
@@ -139,15 +142,18 @@ class ReportData:
     enable_dxt_heatmap: flag indicating whether DXT heatmaps should be enabled
     filter_patterns: regex patterns for names to exclude/include
     filter_mode: whether to "exclude" or "include" the filter patterns
+    cache: whether to use a log cache (True, or the cache directory),
+        see darshan.DarshanReport
 
     """
     def __init__(self, log_path: str, enable_dxt_heatmap: bool = False,
-                 filter_patterns: Optional[List[str]] = None, filter_mode: str = "exclude"):
+                 filter_patterns: Optional[List[str]] = None, filter_mode: str = "exclude",
+                 cache: Union[bool, str] = False):
         # store the log path and use it to generate the report
         self.log_path = log_path
         self.enable_dxt_heatmap = enable_dxt_heatmap
         # store the report
-        self.report = darshan.DarshanReport(log_path, read_all=False)
+        self.report = darshan.DarshanReport(log_path, read_all=False, cache=cache)
         # read only generic module data and heatmap data by default
         self.report.read_all_generic_records(filter_patterns=filter_patterns, filter_mode=filter_mode)
         if "HEATMAP" in self.report.data['modules']:
@@ -519,8 +525,7 @@ class ReportData:
                     # get the module's record dataframe and then pass to
                     # Darshan accumulator interface to generate a cumulative
                     # record and derived metrics
-                    rec_dict = self.report.records[mod].to_df()
-                    acc = accumulate_records(rec_dict, mod, self.report.metadata['job']['nprocs'])
+                    acc = self.report.accumulate_records(mod)
 
                     mod_overview_fig = ReportFigure(
                             section_title=sect_title,
@@ -634,6 +639,29 @@ class ReportData:
             )
             self.figures.append(data_access_by_cat_fig)
 
+        #########################
+        # Instrumentation Overhead
+        job_data = self.report.metadata["job"]
+        if any(k.startswith("overhead_") for k in job_data["metadata"]):
+            overhead_description = (
+                "Time spent in Darshan instrumentation (outside of the "
+                "instrumented calls themselves) by each module, summed "
+                "across processes, as recorded by the runtime library "
+                "with DARSHAN_OVERHEAD_ACCOUNTING enabled. The percentage "
+                "is relative to the total run time of all processes. Time "
+                "for DXT and HEATMAP is also included in the time of the "
+                "module that triggered it."
+            )
+            overhead_fig = ReportFigure(
+                section_title="Darshan Instrumentation Overhead",
+                fig_title="",
+                fig_func=log_overhead_table,
+                fig_args=dict(job_data=job_data),
+                fig_description=overhead_description,
+                fig_width=805,
+            )
+            self.figures.append(overhead_fig)
+
 
 
     def build_sections(self):
@@ -695,6 +723,17 @@ def setup_parser(parser: argparse.ArgumentParser):
         action='append',
         help="regex patterns for file record names to include in summary report"
      )
+    parser.add_argument(
+        "--cache",
+        action="store_true",
+        help="Keep decoded log data in a sidecar cache file next to the log "
+             "and reuse it on later runs."
+    )
+    parser.add_argument(
+        "--cache_dir",
+        type=str,
+        help="Keep the cache file (see --cache) in this directory instead."
+    )
 
 
 def main(args: Union[Any, None] = None):
@@ -738,7 +777,8 @@ def main(args: Union[Any, None] = None):
         log_path=log_path,
         enable_dxt_heatmap=enable_dxt_heatmap,
         filter_patterns=filter_patterns,
-        filter_mode=filter_mode
+        filter_mode=filter_mode,
+        cache=args.cache_dir or args.cache
     )
 
     with importlib_resources.path(darshan.cli, "base.html") as base_path:
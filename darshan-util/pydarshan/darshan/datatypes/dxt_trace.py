@@ -0,0 +1,151 @@
+"""
+Reader for the columnar DXT trace files written by darshan-dxt-export
+(or darshan.backend.cffi_backend.log_dxt_export). The file is memory-mapped
+and its columns are exposed as numpy arrays without copying; the layout is
+described in darshan-dxt-logutils.c.
+"""
+
+from typing import Dict, Iterator, Optional, Tuple
+
+import numpy as np
+import pandas as pd
+
+_MAGIC = b"DSHNDXT1"
+_BOM = 0x01020304
+
+# columns in the order they are stored in each chunk
+_COLUMNS = [
+    ("record_id", np.uint64),
+    ("offset", np.int64),
+    ("length", np.int64),
+    ("start_time", np.float64),
+    ("end_time", np.float64),
+    ("rank", np.int32),
+    ("op", np.uint8),
+]
+
+# values of the op column
+OPS = ["POSIX_WRITE", "POSIX_READ", "MPIIO_WRITE", "MPIIO_READ"]
+
+
+class DXTTrace():
+    """
+    A memory-mapped DXT trace file.
+
+    Segments are stored in chunks with the min/max of every column, so
+    chunks() can skip chunks that cannot match a time or rank range.
+
+    Example:
+
+    >>> trace = DXTTrace("trace.dxt")
+    >>> for chunk in trace.chunks(start_time=10.0, end_time=20.0):
+    ...     total += chunk["length"].sum()
+    """
+
+    def __init__(self, path: str):
+        self._mm = np.memmap(path, dtype=np.uint8, mode="r")
+        if (len(self._mm) < 48 or bytes(self._mm[:8]) != _MAGIC or
+                bytes(self._mm[-8:]) != _MAGIC):
+            raise ValueError(f"{path} is not a DXT trace file.")
+
+        # the file is written in the byte order of the host that wrote it
+        self._order = "="
+        if self._read(np.uint32, 8) != _BOM:
+            self._order = "S"
+
+        names_offset, index_offset, nchunks = self._read(np.uint64, len(self._mm) - 32, 3)
+        self._chunk_offsets = self._read(np.uint64, int(index_offset), int(nchunks))
+
+        self.names: Dict[int, str] = {}
+        pos = int(names_offset)
+        count = int(self._read(np.uint64, pos))
+        pos += 8
+        for _ in range(count):
+            rec_id = int(self._read(np.uint64, pos))
+            name_len = int(self._read(np.uint16, pos + 8))
+            pos += 10
+            self.names[rec_id] = bytes(self._mm[pos:pos + name_len]).decode("utf-8")
+            pos += name_len
+
+    def __repr__(self):
+        type_ = type(self)
+        return (f"<{type_.__module__}.{type_.__qualname__} "
+                f"(segments={len(self)}, chunks={len(self._chunk_offsets)})>")
+
+    def __len__(self):
+        return sum(int(self._read(np.uint64, int(off))) for off in self._chunk_offsets)
+
+    def _dtype(self, dtype):
+        return np.dtype(dtype).newbyteorder(self._order)
+
+    def _read(self, dtype, offset, count=None):
+        arr = np.frombuffer(self._mm, dtype=self._dtype(dtype),
+                            count=1 if count is None else count, offset=offset)
+        return arr[0] if count is None else arr
+
+    def _chunk_stats(self, offset: int) -> Dict[str, Tuple]:
+        # stats are stored as 64-bit values of the column's kind
+        stats = {}
+        pos = offset + 8
+        for name, dtype in _COLUMNS:
+            kind = np.dtype(dtype).kind
+            wide = np.float64 if kind == "f" else (np.uint64 if kind == "u" else np.int64)
+            stats[name] = tuple(self._read(wide, pos, 2))
+            pos += 16
+        return stats
+
+    def _chunk_columns(self, offset: int) -> Dict[str, np.ndarray]:
+        nrows = int(self._read(np.uint64, offset))
+        pos = offset + 8 + 16 * len(_COLUMNS)
+        cols = {}
+        for name, dtype in _COLUMNS:
+            cols[name] = self._read(dtype, pos, nrows)
+            pos += nrows * np.dtype(dtype).itemsize
+        return cols
+
+    def chunks(self, start_time: Optional[float] = None,
+               end_time: Optional[float] = None,
+               ranks: Optional[Tuple[int, int]] = None) -> Iterator[Dict[str, np.ndarray]]:
+        """
+        Iterate over the chunks of the trace as dicts of column arrays
+        (views of the mapped file).
+
+        Chunks whose statistics show that none of their segments overlap
+        [start_time, end_time] or the inclusive (first, last) range of ranks
+        are skipped; segments of the remaining chunks are not filtered.
+        """
+        for offset in self._chunk_offsets:
+            stats = self._chunk_stats(int(offset))
+            if start_time is not None and stats["end_time"][1] < start_time:
+                continue
+            if end_time is not None and stats["start_time"][0] > end_time:
+                continue
+            if ranks is not None and (stats["rank"][1] < ranks[0] or
+                                      stats["rank"][0] > ranks[1]):
+                continue
+            yield self._chunk_columns(int(offset))
+
+    def column(self, name: str) -> np.ndarray:
+        """
+        Return one column of the whole trace. This is a view of the mapped
+        file if the trace has a single chunk, and a copy otherwise.
+        """
+        cols = [chunk[name] for chunk in self.chunks()]
+        if len(cols) == 1:
+            return cols[0]
+        if not cols:
+            return np.empty(0, dtype=dict(_COLUMNS)[name])
+        return np.concatenate(cols)
+
+    def to_dataframe(self, **kwargs) -> pd.DataFrame:
+        """
+        Return the segments of the chunks selected by ``kwargs`` (see
+        chunks()) as a DataFrame, with the op column as a categorical.
+        """
+        frames = [pd.DataFrame(chunk) for chunk in self.chunks(**kwargs)]
+        if frames:
+            df = pd.concat(frames, ignore_index=True)
+        else:
+            df = pd.DataFrame({name: np.empty(0, dtype=dtype) for name, dtype in _COLUMNS})
+        df["op"] = pd.Categorical.from_codes(df["op"].astype(np.int8), categories=OPS)
+        return df
@@ -10,8 +10,9 @@ def create_dxttimeline(self, group_by='rank', mode="append"):
     """
 
     
-    self.mod_read_all_dxt_records("DXT_POSIX")
-    self.mod_read_all_dxt_records("DXT_MPIIO")
+    # segments are updated in place below, so read them as dicts
+    self.mod_read_all_dxt_records("DXT_POSIX", dtype="dict")
+    self.mod_read_all_dxt_records("DXT_MPIIO", dtype="dict")
 
 
 
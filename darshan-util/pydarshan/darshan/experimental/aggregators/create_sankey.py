@@ -25,10 +25,9 @@ def create_sankey(self, mode="append"):
     edges = {}
 
 
-    # build mnt list
-    mnts = []
-    for mnt in self.data['mounts']:
-        mnts.append(mnt[0])
+    # map each file to its mount point
+    mnts = backend.log_lookup_mounts(self.log,
+        [nrecs[rec['id']] for rec in recs['POSIX']])
 
 
     # collect records
@@ -40,12 +39,8 @@ def create_sankey(self, mode="append"):
         fnr = nrecs[fnr]
 
         # determine mount point
-        mnt = None
-        for curr in mnts:
-            if re.search(curr, fnr):
-                mnt = curr
-                break
-        mnt = "m_%s" % mnt
+        mnt = mnts[fnr]
+        mnt = "m_%s" % (mnt[0] if mnt else None)
 
        
         nodes[rnk] = {'name': rnk}
@@ -1,7 +1,6 @@
 from darshan.report import *
 
 import sys
-import copy
 import re
 
 
@@ -9,6 +8,11 @@ def filter(self, mods=None, name_records=None, pattern=None, regex=None):
     """
     Return filtered list of records.
 
+    The filtered report is a view of this report: its records are selected
+    by index rather than copied, and are shared with this report. Use
+    copy.deepcopy() on the result to get an independent report, which
+    copies only the selected records.
+
     Args:
         mods:           Name(s) of modules to preserve 
         name_records:   Id(s)/Name(s) of name_records to preserve
@@ -18,7 +22,7 @@ def filter(self, mods=None, name_records=None, pattern=None, regex=None):
     """
 
     
-    r = copy.deepcopy(self)
+    r = self._derive()
 
 
     # convienience
@@ -41,7 +45,7 @@ def filter(self, mods=None, name_records=None, pattern=None, regex=None):
     
     # whitelist all mods
     if mods == None:
-        mods = r.records.keys()
+        mods = self.records.keys()
 
 
     if pattern != None:
@@ -79,23 +83,22 @@ def filter(self, mods=None, name_records=None, pattern=None, regex=None):
 
 
     if name_records != None:
+        name_records = set(name_records)
+
         # aggragate
-        for mod, recs in r.records.items():
+        for mod, recs in self.records.items():
 
             if mod not in mods:
                 continue
 
-            for rec in recs:
-                nrec = rec['id'] 
-
-                if nrec in name_records:
-                    if mod not in ctx:
-                        ctx[mod] = DarshanRecordCollection(mod=mod, report=r)
+            index = [i for i, rec in enumerate(recs._iter_records())
+                     if rec['id'] in name_records]
 
-                    ctx[mod].append(rec._records[0])
+            if index:
+                ctx[mod] = DarshanRecordCollection._view(mod, r, [(recs, index)])
 
 
-    r.records = ctx
+    r.records.update(ctx)
 
 
     return r
@@ -51,15 +51,16 @@ def merge(self, other, reduce_first=False):
     update_metadata(other)
 
 
-    # copy over records (references, under assumption single records are not altered)
+    # records are views of the records of both reports (references, under
+    # assumption single records are not altered)
+    parts = {}
     for report in [self, other]:
         for key, records in report.data['records'].items():
-            #print(report, key)
-            if key not in nr.records:
-                nr.records[key] = copy.copy(records)
-            else:
-                nr.records[key]._records = nr.records[key]._records + copy.copy(records._records)
+            parts.setdefault(key, []).append((records, None))
+    for key, mod_parts in parts.items():
+        nr.records[key] = DarshanRecordCollection._view(key, nr, mod_parts)
 
+    for report in [self, other]:
         for key, mod in report.modules.items():
             if key not in nr.modules:
                 nr.modules[key] = copy.copy(mod)
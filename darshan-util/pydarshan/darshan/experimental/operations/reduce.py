@@ -17,7 +17,8 @@ def reduce(self, operation="sum", mods=None, name_records=None, mode='append', d
     """
 
 
-    r = copy.deepcopy(self)
+    # the reduced records are new, everything else is shared with this report
+    r = self._derive()
 
 
     # convienience
@@ -46,7 +47,7 @@ def reduce(self, operation="sum", mods=None, name_records=None, mode='append', d
 
     # change inputs to whitelists
     if mods is None:
-        mods = r.records.keys()
+        mods = self.records.keys()
 
 
     if name_records is None:
@@ -73,12 +74,14 @@ def reduce(self, operation="sum", mods=None, name_records=None, mode='append', d
 
 
     if name_records is not None:
+        name_records = set(name_records)
+
         # aggragate
-        for mod, recs in r.records.items():
+        for mod, recs in self.records.items():
             if mod not in mods:
                 continue
 
-            for i, rec in enumerate(recs):
+            for i, rec in enumerate(recs._iter_records()):
                 nrec = rec['id'] 
 
                 if nrec in name_records:
@@ -95,11 +98,11 @@ def reduce(self, operation="sum", mods=None, name_records=None, mode='append', d
                         if nrec_pattern not in ctx[mod]:
                             ctx[mod][nrec_pattern] = {}
 
-                        if counters not in rec._records[0]:
+                        if counters not in rec:
                             continue
 
                         if counters not in ctx[mod][nrec_pattern]:
-                            ctx[mod][nrec_pattern][counters] = rec[counters]
+                            ctx[mod][nrec_pattern][counters] = np.array(rec[counters])
                         else:
                             ctx[mod][nrec_pattern][counters] = np.add(ctx[mod][nrec_pattern][counters], rec[counters])
 
@@ -117,6 +120,6 @@ def reduce(self, operation="sum", mods=None, name_records=None, mode='append', d
 
             result[mod].append(rec)
 
-    r.records = result
+    r.records.update(result)
 
     return r
@@ -321,96 +321,128 @@ def get_heatmap_df(agg_df: pd.DataFrame,
     if max_time is None:
         max_time = agg_df["end_time"].max()
     bin_edge_data = np.linspace(0.0, max_time, xbins + 1)
-    # create dummy variables for start/end time data, where dataframe columns
-    # are the x-axis bin ranges
-    # pin dtype here because of pandas 2.0+ change--see:
-    # gh-909 and
-    # https://github.com/pandas-dev/pandas/pull/48022#issuecomment-1448755561
-    cats_start = pd.get_dummies(
-        pd.cut(agg_df["start_time"], bin_edge_data, precision=16),
-        dtype=np.uint8,
+    hmap_data = bin_segments(
+        ranks=agg_df["rank"].to_numpy(),
+        start_times=agg_df["start_time"].to_numpy(),
+        end_times=agg_df["end_time"].to_numpy(),
+        lengths=agg_df["length"].to_numpy(),
+        bin_edges=bin_edge_data,
+        nprocs=nprocs,
     )
-    cats_end = pd.get_dummies(pd.cut(agg_df["end_time"], bin_edge_data, precision=16))
-    # get series for the elapsed times for each dxt segment
-    elapsed_times_dxt_segments = agg_df["end_time"] - agg_df["start_time"]
-    # calculate the time interval spanned by each bin
-    bin_size = bin_edge_data[1] - bin_edge_data[0]
-    # get the ratio of the bin time interval over the dxt segment elapsed times
-    true_fraction_of_dxt_segment_in_a_bin = bin_size / elapsed_times_dxt_segments
-    # create a version of the above series where any ratio above 1 is set to 1
-    fraction_of_dxt_segment_in_a_bin = true_fraction_of_dxt_segment_in_a_bin.copy()
-    fraction_of_dxt_segment_in_a_bin.mask(
-        fraction_of_dxt_segment_in_a_bin > 1, 1, inplace=True
+    hmap_df = pd.DataFrame(
+        hmap_data,
+        index=pd.RangeIndex(nprocs, name="rank"),
+        columns=pd.IntervalIndex.from_breaks(bin_edge_data),
     )
-    # create a dataframe of binned dxt start events where occupied bins contain
-    # the start time and unoccupied bins are populated with NaNs
-    start_times_in_bins = cats_start.mul(agg_df["start_time"], axis=0).replace(
-        0, np.nan
-    )
-    # create a dataframe of binned dxt start events where occupied bins contain
-    # the proportional time spent in the bin
-    start_fraction_bin_occupancy = (bin_edge_data[1:] - start_times_in_bins) / bin_size
-    # create a dataframe of binned dxt end events where occupied bins contain
-    # the end time and unoccupied bins are populated with NaNs
-    end_times_in_bins = cats_end.mul(agg_df["end_time"], axis=0).replace(0, np.nan)
-    # create a dataframe of binned dxt end events where occupied bins contain
-    # the proportional time spent in the bin
-    end_fraction_bin_occupancy = (end_times_in_bins - bin_edge_data[:-1]) / bin_size
-    # combine the start/end fractional bin occupancy dataframes by multiplying
-    # them together. Fill any missing values with (1)
-    combo = start_fraction_bin_occupancy.mul(
-        end_fraction_bin_occupancy, fill_value=1, axis=0
-    )
-    # add the start/end dummy variable dataframes
-    # and replace any zeros with NaN's
-    cats = cats_start.add(cats_end, fill_value=0)
-    cats.replace(0, np.nan, inplace=True)
-    # for each row (IO event) fill in any empty (NaN) bins
-    # between filled bins because those are time spans b/w start
-    # and stop events
-    # interpolation is pointless when there is
-    # a single non-null value in a row
-    null_mask = cats.notna().sum(axis=1) > 1
-    null_mask = null_mask.loc[null_mask == True].index
-    cats_vals = cats.iloc[null_mask].values
-    nan_mask = ~np.isnan(cats_vals)
-    fill_locs = np.where(nan_mask)
-    num_rows = cats_vals.shape[0]
-    start_index = 0
-    row = 0
-
-    # TODO: this is already much faster than
-    # pandas per gh-798, but consider moving
-    # to i.e., Cython or numba?
-    while start_index < (2 * num_rows):
-        start_bound = fill_locs[1][start_index]
-        end_bound = fill_locs[1][start_index + 1]
-        cats_vals[row, start_bound:end_bound] = 1
-        start_index += 2
-        row += 1
-
-    cats.iloc[null_mask] = cats_vals
-    # each time bin containing an event has a 1 in it, otherwise NaN
-    # store mask for restoring fully occupied bins
-    mask_occ = cats == 2
-    # set the fraction of segment per occupied bin
-    cats = cats.mul(fraction_of_dxt_segment_in_a_bin, axis=0)
-    # start/end in adjacent bins require special treatment
-    adjacent_mask = (cats.count(axis=1) == 2) & (cats.sum(axis=1) == 2)
-    # multiply them by the true fractions of DXT segments, which
-    # may actually be > 1 (i.e., the non-1-capped fractions)
-    cats[adjacent_mask] = cats[adjacent_mask].mul(
-        true_fraction_of_dxt_segment_in_a_bin[adjacent_mask], axis=0
-    )
-    # adjust the fractions of the starts/ends for partial occupancy
-    # of bins
-    cats = cats.mul(combo, fill_value=1, axis=0)
-    # start and end are in bin, so restore it
-    cats = cats.mask(mask_occ, 1)
-    # each full or fractional bin event is now multiplied by
-    # the bytes data
-    cats = cats.mul(agg_df["length"], axis=0)
-    cats.index = agg_df["rank"]
-    hmap_df = cats.groupby("rank").sum()
-    hmap_df = hmap_df.reindex(index=range(nprocs), fill_value=0.0)
     return hmap_df
+
+
+def bin_segments(
+    ranks: "npt.ArrayLike",
+    start_times: "npt.ArrayLike",
+    end_times: "npt.ArrayLike",
+    lengths: "npt.ArrayLike",
+    bin_edges: "npt.NDArray[np.float64]",
+    nprocs: int,
+) -> "npt.NDArray[np.float64]":
+    """
+    Distributes the bytes of each IO event over the time bins it overlaps,
+    in proportion to the fraction of the event's duration spent in each
+    bin, and sums them per rank.
+
+    Parameters
+    ----------
+
+    ranks, start_times, end_times, lengths: the rank, start/end times, and
+    bytes of each IO event.
+
+    bin_edges: the ``xbins + 1`` evenly spaced edges of the time bins.
+    Bins are closed on the right, like ``pd.cut()``, with an event starting
+    at time 0 counted in the first bin.
+
+    nprocs: the number of MPI ranks/processes used at runtime. Events of
+    ranks outside of ``[0, nprocs)`` are ignored.
+
+    Returns
+    -------
+
+    hmap_data: a ``(nprocs, xbins)`` array of the bytes read/written by each
+    rank in each time interval.
+
+    Notes
+    -----
+
+    Each event is handled once: the (partially occupied) bins it starts
+    and ends in are scattered into the result directly, and the fully
+    occupied bins in between are added as a range through a running sum
+    over the bins. Memory use is proportional to the number of events plus
+    the size of the result, regardless of how many bins each event spans.
+
+    """
+    ranks = np.asarray(ranks, dtype=np.int64)
+    start_times = np.asarray(start_times, dtype=np.float64)
+    end_times = np.asarray(end_times, dtype=np.float64)
+    lengths = np.asarray(lengths, dtype=np.float64)
+    xbins = len(bin_edges) - 1
+    max_time = bin_edges[-1]
+    bin_size = bin_edges[1] - bin_edges[0]
+
+    # drop events of unknown ranks and events entirely outside of the bins
+    keep = ((ranks >= 0) & (ranks < nprocs) &
+            (end_times >= 0.0) & (start_times <= max_time))
+    ranks = ranks[keep]
+    start_times = start_times[keep]
+    end_times = np.maximum(end_times[keep], start_times)
+    lengths = lengths[keep]
+
+    # bytes are spread over the part of each event within the bins
+    clip_start = np.clip(start_times, 0.0, max_time)
+    clip_end = np.clip(end_times, 0.0, max_time)
+    durations = end_times - start_times
+    start_bins = np.clip(np.searchsorted(bin_edges, clip_start, side="left") - 1, 0, xbins - 1)
+    end_bins = np.clip(np.searchsorted(bin_edges, clip_end, side="left") - 1, 0, xbins - 1)
+
+    rates = np.divide(lengths, durations, out=np.zeros_like(lengths), where=durations > 0)
+    same_bin = start_bins == end_bins
+    # events within a single bin put all of their (in range) bytes there
+    clip_durations = clip_end - clip_start
+    same_bytes = np.where(clip_durations < durations, rates * clip_durations, lengths)
+
+    row = ranks * xbins
+    size = nprocs * xbins
+    hmap = np.zeros(size)
+    hmap += np.bincount(row[same_bin] + start_bins[same_bin],
+                        weights=same_bytes[same_bin], minlength=size)
+
+    # the bins holding the start and end of longer events are partially
+    # occupied
+    spread = ~same_bin
+    ranks, row = ranks[spread], row[spread]
+    start_bins, end_bins = start_bins[spread], end_bins[spread]
+    rates = rates[spread]
+    hmap += np.bincount(row + start_bins,
+                        weights=rates * (bin_edges[start_bins + 1] - clip_start[spread]),
+                        minlength=size)
+    hmap += np.bincount(row + end_bins,
+                        weights=rates * (clip_end[spread] - bin_edges[end_bins]),
+                        minlength=size)
+
+    # and the bins in between are fully occupied: add each event's rate at
+    # its first full bin and remove it after its last one, then take the
+    # running sum over the bins of each rank
+    middle = end_bins > start_bins + 1
+    drow = ranks[middle] * (xbins + 1)
+    dsize = nprocs * (xbins + 1)
+    first = drow + start_bins[middle] + 1
+    last = drow + end_bins[middle]
+    rate_diff = (np.bincount(first, weights=rates[middle], minlength=dsize) -
+                 np.bincount(last, weights=rates[middle], minlength=dsize))
+    active_diff = (np.bincount(first, minlength=dsize) -
+                   np.bincount(last, minlength=dsize))
+    full_rates = np.cumsum(rate_diff.reshape(nprocs, xbins + 1), axis=1)[:, :xbins]
+    # only bins that events are active in, so rounding errors of the
+    # running sum don't leak into empty bins
+    active = np.cumsum(active_diff.reshape(nprocs, xbins + 1), axis=1)[:, :xbins] > 0
+    hmap = hmap.reshape(nprocs, xbins)
+    hmap += np.where(active, full_rates * bin_size, 0.0)
+    return hmap
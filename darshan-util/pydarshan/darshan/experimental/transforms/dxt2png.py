@@ -49,7 +49,7 @@ def segment(rec):
         item.update({'type': 'r'})
 
     for item in rec['write_segments']:
-        item.update({'type': '2'})
+        item.update({'type': 'w'})
 
     trace = rec['read_segments'] + rec['write_segments']
     minsize = calc_minsize(trace)
@@ -97,10 +97,10 @@ def segment(rec):
 
         #print(typ, off, lee, sta, end)
 
-        xx = i*factor;
-        yy = height * (off / minsize)
+        xx = int(i*factor)
+        yy = int(height * (off / minsize))
 
-        wi = 1 * factor;
+        wi = sanitize_size(factor)
         he = sanitize_size( height * (lee / minsize) )
     
 
@@ -134,7 +134,7 @@ def wallclock(rec):
         item.update({'type': 'r'})
 
     for item in rec['write_segments']:
-        item.update({'type': '2'})
+        item.update({'type': 'w'})
 
     trace = rec['read_segments'] + rec['write_segments']
     minsize = calc_minsize(trace)
@@ -170,8 +170,8 @@ def wallclock(rec):
         end = event['end_time'] - start
 
 
-        xx = sta/duration * width;
-        yy = height * (off / minsize)
+        xx = int(sta/duration * width)
+        yy = int(height * (off / minsize))
 
         wi = sanitize_size( (end-sta)*factor );
         he = sanitize_size( height * (lee / minsize) )
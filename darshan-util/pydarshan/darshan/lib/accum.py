@@ -79,3 +79,57 @@ def log_module_overview_table(derived_metrics,
                                                       border=0,
                                                       header=False)
     return ret
+
+def log_overhead_table(job_data: dict):
+    """
+    Creates a table of the Darshan instrumentation overhead recorded
+    in the job metadata when the runtime library was run with
+    ``DARSHAN_OVERHEAD_ACCOUNTING`` enabled.
+
+    Parameters
+    ----------
+    job_data: the job dictionary of a report's metadata (i.e.,
+    ``report.metadata["job"]``).
+
+    Returns
+    -------
+    A ``DarshanReportTable`` with one row per instrumented module,
+    or ``None`` if the log has no overhead accounting data. If any
+    module reported the memory high-water mark of its arena, the
+    table includes the total across processes.
+
+    """
+    proc_time = job_data["nprocs"] * job_data["run_time"]
+    rows = {}
+    arena_bytes = {}
+    for key, value in job_data["metadata"].items():
+        if key.startswith("arena_"):
+            arena_bytes[key[len("arena_"):]] = value.split(",")[0]
+            continue
+        if not key.startswith("overhead_"):
+            continue
+        total, max_proc, calls, contended, lock_wait = \
+            [float(v) for v in value.split(",")]
+        pct = total / proc_time * 100 if proc_time > 0 else 0.0
+        rows[key[len("overhead_"):]] = [f"{total:.6f}",
+                                        f"{max_proc:.6f}",
+                                        f"{pct:.4f}",
+                                        f"{int(calls)}",
+                                        f"{int(contended)}",
+                                        f"{lock_wait:.6f}"]
+    if not rows:
+        return None
+    df = pd.DataFrame.from_dict(rows, orient="index",
+                                columns=["total time (s)",
+                                         "max process time (s)",
+                                         "% of run time",
+                                         "calls",
+                                         "lock contended",
+                                         "lock wait (s)"])
+    if arena_bytes:
+        df["arena memory (bytes)"] = [arena_bytes.get(mod, "")
+                                      for mod in df.index]
+    ret = plot_common_access_table.DarshanReportTable(df,
+                                                      border=0,
+                                                      justify="center")
+    return ret
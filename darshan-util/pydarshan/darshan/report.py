@@ -8,6 +8,7 @@ interaction and aggregation of Darshan logs using Python.
 
 
 import darshan.backend.cffi_backend as backend
+from darshan.backend.log_cache import LogCache, cache_path
 
 from darshan.datatypes.heatmap import Heatmap
 
@@ -74,9 +75,79 @@ class DarshanRecordCollection(collections.abc.MutableSequence):
 
         self._type = "collection"  # collection => list(), single => [record], nested => [[], ... ,[]]
         self._records = list()     # internal format before user conversion
-    
+
+    @classmethod
+    def _view(cls, mod, report, parts):
+        """
+        Returns a collection of records selected from other collections,
+        without copying them. parts is a list of (collection, index) pairs,
+        where index holds the positions of the selected records in the
+        collection, or is None to select all of them.
+
+        The records are shared with the other collections until the view is
+        modified or its records are converted, see _records.
+        """
+        view = cls(mod=mod, report=report)
+        view._parts = []
+        for coll, index in parts:
+            if index is None:
+                index = np.arange(len(coll))
+            else:
+                index = np.asarray(index, dtype=np.intp)
+            if coll._parts is None:
+                view._parts.append((coll._record_list, index))
+                continue
+            # a view of a view selects from the underlying records directly
+            for records, coll_index, start, end in coll._part_ranges():
+                mask = (index >= start) & (index < end)
+                if mask.any():
+                    view._parts.append((records, coll_index[index[mask] - start]))
+        view._offsets = np.cumsum([0] + [len(index) for _, index in view._parts])
+        return view
+
+    def _part_ranges(self):
+        for (records, index), start, end in zip(self._parts, self._offsets[:-1], self._offsets[1:]):
+            yield records, index, start, end
+
+    @property
+    def _records(self):
+        # views turn into a plain list of (shared) records when the list is
+        # needed, e.g., to be modified or converted
+        if self._parts is not None:
+            self._record_list = [records[i] for records, index in self._parts for i in index]
+            self._parts = None
+        return self._record_list
+
+    @_records.setter
+    def _records(self, records):
+        self._record_list = records
+        self._parts = None
+
+    def _record(self, key):
+        """
+        Returns the record at the given position, without turning a view
+        into a list.
+        """
+        if self._parts is None:
+            return self._record_list[key]
+        n = len(self)
+        if key < 0:
+            key += n
+        if key < 0 or key >= n:
+            raise IndexError("record index out of range")
+        part = np.searchsorted(self._offsets, key, side="right") - 1
+        records, index = self._parts[part]
+        return records[index[key - self._offsets[part]]]
+
+    def _iter_records(self):
+        if self._parts is None:
+            return iter(self._record_list)
+        return (records[i] for records, index in self._parts for i in index)
+
     def __len__(self):
-        return len(self._records)
+        if self._parts is not None:
+            return int(self._offsets[-1])
+        return len(self._record_list)
     
     def __setitem__(self, key, val):
         self._records[key] = val
@@ -86,9 +157,9 @@ class DarshanRecordCollection(collections.abc.MutableSequence):
             if isinstance(key, collections.abc.Hashable):
                 #TODO: might extend this style access to collection/nested type as well
                 #      but do not want to offer an access which might not be feasible to maintain
-                return self._records[0][key]
+                return self._record(0)[key]
             else:
-                return self._records[0]
+                return self._record(0)
 
         # Wrap single record in RecordCollection to attach conversions: to_json, to_dict, to_df, ...
         # This way conversion logic can be shared.
@@ -96,14 +167,26 @@ class DarshanRecordCollection(collections.abc.MutableSequence):
 
         if isinstance(key, slice):
             record._type = "collection"
-            record._records = self._records[key]
+            record._records = [self._record(i) for i in range(*key.indices(len(self)))]
         else:
             record._type = "record"
-            record.append(self._records[key])
+            record.append(self._record(key))
         return record
 
     def __delitem__(self, key):
-        del self._list[ii]
+        del self._records[key]
+
+    def __deepcopy__(self, memo):
+        # copy only the records of a view, not the collections it selects from
+        cls = self.__class__
+        result = cls.__new__(cls)
+        memo[id(self)] = result
+        for k, v in self.__dict__.items():
+            if k in ["_record_list", "_parts", "_offsets"]:
+                continue
+            setattr(result, k, copy.deepcopy(v, memo))
+        result._records = copy.deepcopy(list(self._iter_records()), memo)
+        return result
 
     def insert(self, key, val):
         self._records.insert(key, val)
@@ -231,6 +314,12 @@ class DarshanRecordCollection(collections.abc.MutableSequence):
         elif mod in ['DXT_POSIX', 'DXT_MPIIO']:
             # format already in a dict format, but may offer switches for expansion
             logger.warn("WARNING: The output of DarshanRecordCollection.to_dict() may change in the future.")
+            # segments read with dtype='numpy' are structured arrays
+            for rec in records:
+                for key in ['write_segments', 'read_segments']:
+                    if isinstance(rec[key], np.ndarray):
+                        names = rec[key].dtype.names
+                        rec[key] = [dict(zip(names, seg)) for seg in rec[key].tolist()]
         else:
             for i, rec in enumerate(records):
                 rec['counters'] = dict(zip(counters['counters'], rec['counters']))
@@ -310,7 +399,8 @@ class DarshanReport(object):
             start_time=None, end_time=None,
             automatic_summary=False,
             read_all=True,
-            filter_patterns=None, filter_mode="exclude"):
+            filter_patterns=None, filter_mode="exclude",
+            cache=False):
         """
         Args:
             filename (str): filename to open (optional)
@@ -319,6 +409,8 @@ class DarshanReport(object):
             read_all (bool): whether to read all records for log
             filter_patterns (list of strings): list of Python regex strings to match against
             filter_mode (str): filter mode to use (either "exclude" or "include")
+            cache (bool or str): keep decoded records in a sidecar cache file
+                next to the log (True) or in the given directory (str), see open()
 
         Return:
             None
@@ -326,6 +418,8 @@ class DarshanReport(object):
         """
         self.filename = filename
         self.log = None
+        self._cache = None
+        self._name_filter = (None, "exclude")   # name filter of the current name records
 
         # Behavioral Options
         self.dtype = dtype                          # default dtype to return when viewing records
@@ -372,7 +466,8 @@ class DarshanReport(object):
         self.provenance_reports = {}
 
         if filename:
-            self.open(filename, read_all=read_all, filter_patterns=filter_patterns, filter_mode=filter_mode)
+            self.open(filename, read_all=read_all, filter_patterns=filter_patterns, filter_mode=filter_mode,
+                      cache=cache)
 
 
     @property
@@ -406,15 +501,24 @@ class DarshanReport(object):
 #   
       
 
-    def open(self, filename, read_all=False, filter_patterns=None, filter_mode="exclude"):
+    def open(self, filename, read_all=False, filter_patterns=None, filter_mode="exclude",
+             cache=False):
         """
         Open log file via CFFI backend.
 
+        With the cache enabled, name records, the records of generic modules
+        and accumulator results are written to a sidecar file
+        (``<filename>.idx``) the first time they are read, and are
+        memory-mapped from it instead of decoded from the log when the same
+        log is opened again. The cache is rebuilt if the log changes.
+
         Args:
             filename (str): filename to open (optional)
             read_all (bool): whether to read all records for log
             filter_patterns (list of strings): list of Python regex strings to match against
             filter_mode (str): filter mode to use (either "exclude" or "include")
+            cache (bool or str): enable the cache, keeping the cache file next to
+                the log (True) or in the given directory (str)
 
         Return:
             None
@@ -428,6 +532,10 @@ class DarshanReport(object):
             if not bool(self.log['handle']):
                 raise RuntimeError("Failed to open file.")
 
+            if cache:
+                cache_dir = cache if isinstance(cache, str) else None
+                self._cache = LogCache(filename, cache_path(filename, cache_dir))
+
             self.read_metadata()
 
             if read_all:
@@ -458,12 +566,38 @@ class DarshanReport(object):
             if k in ["log"]:
                 # blacklist of members not to copy
                 continue
+            if k in ["_cache"]:
+                # the copy is not backed by the cache file
+                setattr(result, k, None)
+                continue
             setattr(result, k, copy.deepcopy(v, memo))
         return result
 
         # TODO: might consider treating self.log as list of open logs to not deactivate load functions?
 
 
+    def _derive(self):
+        """
+        Returns a report sharing the metadata, modules, counters and name
+        records of this report, without any records, as the base of a
+        filtered or derived report. Records are added as views of this
+        report's records (see DarshanRecordCollection._view()), so nothing
+        is copied until copy.deepcopy() is called on the result.
+        """
+        cls = self.__class__
+        result = cls.__new__(cls)
+        result.__dict__.update(self.__dict__)
+        # the log stays with this report
+        result.log = None
+        result._cache = None
+        result.records = {}
+        result.data = dict(self.data)
+        result.data['records'] = result.records
+        result.provenance_graph = list(self.provenance_graph)
+        result.provenance_reports = dict(self.provenance_reports)
+        return result
+
+
     def read_metadata(self):
         """
         Read metadata such as the job, the executables and available modules.
@@ -504,9 +638,23 @@ class DarshanReport(object):
         """
         if filter_patterns and filter_mode not in {"exclude", "include"}:
             raise RuntimeError("Invalid filter mode used for read_name_records().")
-        tmp_name_records = backend.log_get_name_records(self.log)
+        tmp_name_records = None
+        filter_patterns_applied = False
+        if self._cache is not None:
+            tmp_name_records = self._cache.get_name_records()
+        elif filter_patterns and self.log['name_records'] is None:
+            # let darshan-util filter names as they are decoded, if it
+            # supports the patterns
+            tmp_name_records = backend.log_get_matching_name_records(
+                    self.log, filter_patterns, filter_mode)
+            if tmp_name_records is not None:
+                filter_patterns_applied = True
+        if tmp_name_records is None:
+            tmp_name_records = backend.log_get_name_records(self.log)
+            if self._cache is not None:
+                self._cache.put_name_records(tmp_name_records)
         # filter name records according to user-supplied patterns
-        if filter_patterns:
+        if filter_patterns and not filter_patterns_applied:
             compiled_patterns = [re.compile(p) for p in filter_patterns]
             tmp_name_records = {
                 rec_id : rec_name
@@ -518,6 +666,12 @@ class DarshanReport(object):
         self.data["name_records"] = tmp_name_records
         self.name_records = self.data['name_records']
         self.name_records_read = True
+        self._name_filter = (filter_patterns, filter_mode)
+        # records of filtered out names are dropped while they are read
+        if filter_patterns and self._cache is None:
+            backend.log_set_record_filter(self.log, self.name_records.keys())
+        else:
+            backend.log_set_record_filter(self.log, None)
 
 
     def read_all(self, dtype=None, filter_patterns=None, filter_mode="exclude"):
@@ -532,17 +686,26 @@ class DarshanReport(object):
             None
         """
 
-        self.read_all_generic_records(dtype=dtype, filter_patterns=filter_patterns, filter_mode=filter_mode)
-        self.read_all_dxt_records(dtype=dtype, filter_patterns=filter_patterns, filter_mode=filter_mode)
-        if "LUSTRE" in self.data['modules']:
-            self.mod_read_all_lustre_records(dtype=dtype, filter_patterns=filter_patterns, filter_mode=filter_mode)
-        if "APMPI" in self.data['modules']:
-            self.mod_read_all_apmpi_records(dtype=dtype)
-        if "APXC" in self.data['modules']:
-            self.mod_read_all_apxc_records(dtype=dtype)
-        if "HEATMAP" in self.data['modules']:
-            self.read_all_heatmap_records()
-        
+        # decode the modules on background threads, in the order they are
+        # converted below
+        generic = [mod for mod in self.data['modules'] if mod not in
+                   ['DXT_POSIX', 'DXT_MPIIO', 'LUSTRE', 'APMPI', 'APXC', 'HEATMAP']
+                   and (self._cache is None or self._cache.get_records(mod) is None)]
+        backend.log_reader_open(self.log, generic + ['DXT_POSIX', 'DXT_MPIIO', 'LUSTRE', 'HEATMAP'])
+        try:
+            self.read_all_generic_records(dtype=dtype, filter_patterns=filter_patterns, filter_mode=filter_mode)
+            self.read_all_dxt_records(dtype=dtype, filter_patterns=filter_patterns, filter_mode=filter_mode)
+            if "LUSTRE" in self.data['modules']:
+                self.mod_read_all_lustre_records(dtype=dtype, filter_patterns=filter_patterns, filter_mode=filter_mode)
+            if "APMPI" in self.data['modules']:
+                self.mod_read_all_apmpi_records(dtype=dtype)
+            if "APXC" in self.data['modules']:
+                self.mod_read_all_apxc_records(dtype=dtype)
+            if "HEATMAP" in self.data['modules']:
+                self.read_all_heatmap_records()
+        finally:
+            backend.log_reader_close(self.log)
+
         return
 
 
@@ -572,6 +735,8 @@ class DarshanReport(object):
         Read all dxt records from darshan log and return as dictionary.
 
         Args:
+            dtype (str): 'dict' for lists of segment dictionaries (default),
+                'numpy' for structured arrays, 'pandas' for DataFrames
             filter_patterns (list of strings): list of Python regex strings to match against
             filter_mode (str): filter mode to use (either "exclude" or "include")
 
@@ -579,7 +744,7 @@ class DarshanReport(object):
             None
         """
 
-        dtype = dtype if dtype else self.dtype
+        dtype = self._dxt_dtype(dtype)
 
         for mod in self.data['modules']:
             self.mod_read_all_dxt_records(mod, dtype=dtype, warnings=False, reads=reads, writes=writes,
@@ -682,16 +847,19 @@ class DarshanReport(object):
             self.read_name_records(filter_patterns=filter_patterns, filter_mode=filter_mode)
 
         # fetch records
-        rec = backend.log_get_generic_record(self.log, mod, dtype=dtype)
-        while rec != None:
-            if rec['id'] in self.name_records:
-                # only keep records we have names for, otherwise the record
-                # likely has a name that was excluded
-                self.records[mod].append(rec)
-                self._modules[mod]['num_records'] += 1
-
-            # fetch next
+        if self._cache is not None:
+            self._mod_read_cached_records(mod, dtype)
+        else:
             rec = backend.log_get_generic_record(self.log, mod, dtype=dtype)
+            while rec != None:
+                if rec['id'] in self.name_records:
+                    # only keep records we have names for, otherwise the record
+                    # likely has a name that was excluded
+                    self.records[mod].append(rec)
+                    self._modules[mod]['num_records'] += 1
+
+                # fetch next
+                rec = backend.log_get_generic_record(self.log, mod, dtype=dtype)
 
         # process/combine records if the format dtype allows for this
         if dtype == 'pandas':
@@ -721,6 +889,59 @@ class DarshanReport(object):
                 }]
 
 
+    def _mod_read_cached_records(self, mod, dtype):
+        """
+        Reads the records of a generic module from the cache, decoding them
+        from the log and adding them to the cache first if needed.
+        """
+        cols = self._cache.get_records(mod)
+        if cols is None:
+            cols = backend.log_get_generic_columns(self.log, mod)
+            self._cache.put_records(mod, cols)
+
+        # only keep records we have names for, as above
+        name_ids = np.fromiter(self.name_records.keys(), dtype=np.uint64,
+                               count=len(self.name_records))
+        ids = cols['id']
+        ranks = cols['rank']
+        file_rec_ids = cols.get('file_rec_id')
+        for i in np.flatnonzero(np.isin(ids, name_ids)):
+            file_rec_id = None if file_rec_ids is None else int(file_rec_ids[i])
+            rec = backend.make_generic_record(int(ids[i]), int(ranks[i]),
+                                              cols['counters'][i], cols['fcounters'][i],
+                                              mod, dtype, file_rec_id)
+            self.records[mod].append(rec)
+            self._modules[mod]['num_records'] += 1
+
+
+    def accumulate_records(self, mod):
+        """
+        Passes the records read for a module to the Darshan accumulator
+        interface (see backend.accumulate_records()). With the cache
+        enabled, the result is kept in the cache for reports using the
+        same name filter.
+
+        Args:
+            mod (str): Identifier of module to accumulate
+
+        Return:
+            namedtuple containing derived_metrics (cdata object) and
+            summary_record (dict)
+
+        """
+        filter_patterns, filter_mode = self._name_filter
+        if self._cache is not None:
+            acc = self._cache.get_accumulated(mod, filter_patterns, filter_mode)
+            if acc is not None:
+                return acc
+
+        acc = backend.accumulate_records(self.records[mod].to_df(), mod,
+                                         self.metadata['job']['nprocs'])
+        if self._cache is not None:
+            self._cache.put_accumulated(mod, acc, filter_patterns, filter_mode)
+        return acc
+
+
     def mod_read_all_apmpi_records(self, mod="APMPI", dtype=None, warnings=True,
                                    refresh_names=False):
         """ 
@@ -821,6 +1042,18 @@ class DarshanReport(object):
             rec = backend.log_get_apxc_record(self.log, mod, "PERF", dtype=dtype)
 
 
+    def _dxt_dtype(self, dtype):
+        """
+        Returns the dtype to read DXT segments with.  Unless asked for
+        explicitly, segments are lists of dicts even for the default 'numpy'
+        report dtype, as code that edits or concatenates the segments relies
+        on that; the structured array views are opt-in.
+        """
+        if dtype:
+            return dtype
+        return 'pandas' if self.dtype == 'pandas' else 'dict'
+
+
     def mod_read_all_dxt_records(self, mod, dtype=None, warnings=True, reads=True, writes=True,
                                  filter_patterns=None, filter_mode="exclude",
                                  refresh_names=False):
@@ -829,7 +1062,8 @@ class DarshanReport(object):
 
         Args:
             mod (str): Identifier of module to fetch all records
-            dtype (str): 'numpy' for ndarray (default), 'dict' for python dictionary
+            dtype (str): 'dict' for lists of segment dictionaries (default),
+                'numpy' for structured arrays, 'pandas' for DataFrames
             filter_patterns (list of strings): list of Python regex strings to match against
             filter_mode (str): filter mode to use (either "exclude" or "include")
 
@@ -851,7 +1085,7 @@ class DarshanReport(object):
             return 
 
         # handling options
-        dtype = dtype if dtype else self.dtype
+        dtype = self._dxt_dtype(dtype)
 
         self.records[mod] = DarshanRecordCollection(mod=mod, report=self)
 
@@ -272,3 +272,29 @@ def test_reverse_record_array(python_filter, expected_counts):
                         actual_wo_files,
                         actual_rw_files],
                         expected_counts)
+
+
+@pytest.mark.parametrize("log_name", [
+    "sample.darshan",
+    "ior_hdf5_example.darshan",
+    "sample-dxt-simple.darshan",
+    "noposixopens.darshan",
+    ])
+def test_log_peek(tmp_path, log_name):
+    # log_peek() reads only the header and job record, but should agree
+    # with the full open path
+    log_path = get_log_path(log_name)
+    log = backend.log_open(log_path)
+    expected_job = backend.log_get_job(log)
+    expected_modules = backend.log_get_modules(log)
+    backend.log_close(log)
+
+    info = backend.log_peek(log_path)
+    assert info["job"] == expected_job
+    assert info["modules"] == expected_modules
+
+    bad_log = str(tmp_path / "bad.darshan")
+    with open(bad_log, "wb") as f:
+        f.write(b"not a log")
+    with pytest.raises(RuntimeError):
+        backend.log_peek(bad_log)
@@ -0,0 +1,62 @@
+import numpy as np
+import pytest
+
+import darshan.backend.cffi_backend as backend
+from darshan.datatypes.dxt_trace import DXTTrace
+from darshan.log_utils import get_log_path
+
+
+def _dxt_segments(logfile):
+    # (record_id, rank, op, offset, length, start, end) of every segment,
+    # read through the record-at-a-time interface
+    log = backend.log_open(logfile)
+    segs = []
+    for op_base, mod in enumerate(["DXT_POSIX", "DXT_MPIIO"]):
+        while True:
+            rec = backend.log_get_dxt_record(log, mod)
+            if rec is None:
+                break
+            for op, key in ((2 * op_base, "write_segments"), (2 * op_base + 1, "read_segments")):
+                for seg in rec[key]:
+                    segs.append((rec["id"], rec["rank"], op, seg["offset"], seg["length"],
+                                 seg["start_time"], seg["end_time"]))
+    backend.log_close(log)
+    return segs
+
+
+@pytest.mark.parametrize("logfile", [
+    "sample-dxt-simple.darshan",
+    "dxt.darshan",
+    ])
+def test_dxt_export_matches_records(tmp_path, logfile):
+    logfile = get_log_path(logfile)
+    out = str(tmp_path / "trace.dxt")
+    expected = _dxt_segments(logfile)
+
+    nsegs = backend.log_dxt_export(logfile, out)
+    assert nsegs == len(expected)
+
+    trace = DXTTrace(out)
+    assert len(trace) == nsegs
+    actual = []
+    for chunk in trace.chunks():
+        actual += zip(chunk["record_id"].tolist(), chunk["rank"].tolist(),
+                      chunk["op"].tolist(), chunk["offset"].tolist(),
+                      chunk["length"].tolist(), chunk["start_time"].tolist(),
+                      chunk["end_time"].tolist())
+    assert sorted(actual) == sorted(expected)
+    assert set(trace.names) == {seg[0] for seg in expected}
+
+
+def test_dxt_export_filters(tmp_path):
+    logfile = get_log_path("dxt.darshan")
+    expected = _dxt_segments(logfile)
+    out = str(tmp_path / "trace.dxt")
+
+    backend.log_dxt_export(logfile, out, start_time=1.0, end_time=2.0, ranks=(0, 1))
+    df = DXTTrace(out).to_dataframe()
+    assert len(df) == sum(1 for seg in expected
+                          if seg[1] <= 1 and seg[6] >= 1.0 and seg[5] <= 2.0)
+    assert np.all(df["rank"] <= 1)
+    assert np.all(df["end_time"] >= 1.0)
+    assert np.all(df["start_time"] <= 2.0)
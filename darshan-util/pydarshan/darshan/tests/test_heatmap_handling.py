@@ -602,3 +602,37 @@ def test_get_heatmap_df(
             assert actual_hmap_data.values.sum() == 4202504
         elif ops[0] == "write":
             assert actual_hmap_data.values.sum() == 4195800
+
+
+@pytest.mark.parametrize("xbins", [1, 3, 10])
+def test_bin_segments(xbins):
+    # compare against the overlap of each event with each bin, computed
+    # directly; includes events starting at time 0, zero-length events,
+    # events spanning many bins, and events extending past the last bin
+    bin_edges = np.linspace(0.0, 10.0, xbins + 1)
+    ranks = np.array([0, 0, 1, 1, 2, 3, 0])
+    start_times = np.array([0.0, 1.0, 2.5, 4.0, 9.0, 12.0, 3.3])
+    end_times = np.array([0.5, 9.5, 2.5, 4.1, 14.0, 13.0, 6.7])
+    lengths = np.array([100, 1000, 10, 50, 500, 70, 340])
+    nprocs = 5
+
+    expected = np.zeros((nprocs, xbins))
+    for rank, start, end, length in zip(ranks, start_times, end_times, lengths):
+        if start > bin_edges[-1]:
+            continue
+        if end == start:
+            expected[rank, max(np.searchsorted(bin_edges, start) - 1, 0)] += length
+            continue
+        for i in range(xbins):
+            overlap = min(end, bin_edges[i + 1]) - max(start, bin_edges[i])
+            if overlap > 0:
+                expected[rank, i] += length * overlap / (end - start)
+
+    actual = heatmap_handling.bin_segments(ranks=ranks,
+                                           start_times=start_times,
+                                           end_times=end_times,
+                                           lengths=lengths,
+                                           bin_edges=bin_edges,
+                                           nprocs=nprocs)
+    assert actual.shape == (nprocs, xbins)
+    assert_allclose(actual, expected, atol=1e-9)
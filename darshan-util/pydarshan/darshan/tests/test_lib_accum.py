@@ -1,6 +1,10 @@
 import darshan
-from darshan.backend.cffi_backend import accumulate_records
-from darshan.lib.accum import log_file_count_summary_table, log_module_overview_table
+from darshan.backend.cffi_backend import accumulate_common_values, accumulate_records
+from darshan.lib.accum import (
+    log_file_count_summary_table,
+    log_module_overview_table,
+    log_overhead_table,
+)
 from darshan.log_utils import get_log_path
 
 import pytest
@@ -222,3 +226,77 @@ def test_module_overview_table(log_path, mod_name, expected):
                                      "I/O performance estimate"]
 
                 assert_frame_equal(actual_df, expected_df)
+
+
+def test_overhead_table():
+    # overhead accounting is stored by the runtime library in the
+    # job metadata as "overhead_<module>=<total time>,<max process time>,
+    # <calls>,<lock contended>,<lock wait time>"
+    job_data = {"nprocs": 4,
+                "run_time": 10.0,
+                "metadata": {"lib_ver": "3.4.7",
+                             "overhead_POSIX": "0.400000,0.150000,1000,12,0.020000",
+                             "overhead_HEATMAP": "0.040000,0.010000,800,0,0.000000"}}
+    actual_df = log_overhead_table(job_data=job_data).df
+    expected_df = pd.DataFrame([["0.400000", "0.150000", "1.0000", "1000", "12", "0.020000"],
+                                ["0.040000", "0.010000", "0.1000", "800", "0", "0.000000"]],
+                               index=["POSIX", "HEATMAP"],
+                               columns=["total time (s)",
+                                        "max process time (s)",
+                                        "% of run time",
+                                        "calls",
+                                        "lock contended",
+                                        "lock wait (s)"])
+    assert_frame_equal(actual_df, expected_df)
+
+    # modules allocating from an arena also store "arena_<module>=<total
+    # bytes>,<max process bytes>"
+    job_data["metadata"]["arena_POSIX"] = "262272,65568"
+    actual_df = log_overhead_table(job_data=job_data).df
+    expected_df["arena memory (bytes)"] = ["262272", ""]
+    assert_frame_equal(actual_df, expected_df)
+
+    # logs without overhead accounting don't get a table
+    job_data["metadata"] = {"lib_ver": "3.4.7"}
+    assert log_overhead_table(job_data=job_data) is None
+
+
+@pytest.mark.parametrize("log_name, mod_name", [
+    ("ior_hdf5_example.darshan", "POSIX"),
+    ("ior_hdf5_example.darshan", "MPI-IO"),
+    ("sample.darshan", "POSIX"),
+])
+def test_accumulate_common_values(log_name, mod_name):
+    # with few distinct values, the sketched counts are the exact sums of
+    # the records' common value counters
+    log_path = get_log_path(log_name)
+    with darshan.DarshanReport(log_path) as report:
+        nprocs = report.metadata["job"]["nprocs"]
+        rec_dict = report.records[mod_name].to_df()
+    prefix = "POSIX" if mod_name == "POSIX" else "MPIIO"
+    counters = rec_dict["counters"]
+
+    actual = accumulate_common_values(rec_dict, mod_name, nprocs, n=64)
+    sets = [("access_size", "ACCESS")]
+    if mod_name == "POSIX":
+        sets.append(("stride", "STRIDE"))
+    assert set(actual["set"]) <= {name for name, _ in sets}
+    for set_name, kind in sets:
+        expected = {}
+        for i in range(1, 5):
+            values = counters[f"{prefix}_{kind}{i}_{kind}"]
+            counts = counters[f"{prefix}_{kind}{i}_COUNT"]
+            for value, count in zip(values, counts):
+                if count > 0:
+                    expected[value] = expected.get(value, 0) + count
+        rows = actual[actual["set"] == set_name]
+        assert dict(zip(rows["value"], rows["count"])) == expected
+        assert (rows["error"] == 0).all()
+        assert rows["count"].is_monotonic_decreasing
+
+
+def test_accumulate_common_values_unsupported():
+    # STDIO records have no common value counters; rec_dict is not needed
+    # to raise this error
+    with pytest.raises(RuntimeError, match="does not track common values"):
+        accumulate_common_values({}, "STDIO", 1)
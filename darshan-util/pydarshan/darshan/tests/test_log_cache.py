@@ -0,0 +1,135 @@
+import multiprocessing
+import os
+import shutil
+
+import numpy as np
+import pytest
+from pandas.testing import assert_frame_equal
+
+import darshan
+import darshan.backend.cffi_backend as backend
+from darshan.backend.log_cache import LogCache
+from darshan.log_utils import get_log_path
+
+
+@pytest.fixture
+def log_copy(tmp_path):
+    # the cache is written next to the log, so work on a copy
+    path = str(tmp_path / "ior_hdf5_example.darshan")
+    shutil.copy(get_log_path("ior_hdf5_example.darshan"), path)
+    return path
+
+
+def _assert_reports_equal(actual, expected):
+    assert actual.name_records == expected.name_records
+    for mod in ["POSIX", "MPI-IO", "H5F", "H5D", "STDIO"]:
+        assert actual.modules[mod] == expected.modules[mod]
+        if len(expected.records[mod]) == 0:
+            assert len(actual.records[mod]) == 0
+            continue
+        actual_df = actual.records[mod].to_df()
+        expected_df = expected.records[mod].to_df()
+        for key in ["counters", "fcounters"]:
+            assert_frame_equal(actual_df[key], expected_df[key])
+    acc = actual.accumulate_records("POSIX")
+    expected_acc = expected.accumulate_records("POSIX")
+    assert (bytes(backend.ffi.buffer(acc.derived_metrics)) ==
+            bytes(backend.ffi.buffer(expected_acc.derived_metrics)))
+    for key in ["counters", "fcounters"]:
+        assert_frame_equal(acc.summary_record[key], expected_acc.summary_record[key])
+
+
+@pytest.mark.parametrize("filter_patterns, filter_mode", [
+    (None, "exclude"),
+    ([r"\.h5$"], "include"),
+    ])
+def test_cached_report_matches_log(log_copy, filter_patterns, filter_mode):
+    expected = darshan.DarshanReport(log_copy, filter_patterns=filter_patterns,
+                                     filter_mode=filter_mode)
+
+    # the first read writes the cache, the second one reads from it
+    for _ in range(2):
+        with darshan.DarshanReport(log_copy, cache=True, filter_patterns=filter_patterns,
+                                   filter_mode=filter_mode) as report:
+            assert os.path.exists(log_copy + ".idx")
+            _assert_reports_equal(report, expected)
+
+    cache = LogCache(log_copy)
+    assert cache.get_name_records() == backend.log_get_name_records(backend.log_open(log_copy))
+    assert cache.get_records("POSIX")["counters"].shape == (1, len(backend.counter_names("POSIX")))
+    assert cache.get_accumulated("POSIX", filter_patterns, filter_mode) is not None
+    # results are cached per name filter
+    assert cache.get_accumulated("POSIX", [r"\.dat$"], "include") is None
+
+
+def test_cache_dir(log_copy, tmp_path):
+    cache_dir = str(tmp_path / "cache")
+    darshan.DarshanReport(log_copy, cache=cache_dir)
+    assert os.listdir(cache_dir) == ["ior_hdf5_example.darshan.idx"]
+    assert not os.path.exists(log_copy + ".idx")
+
+
+def test_cache_validation(log_copy):
+    darshan.DarshanReport(log_copy, cache=True)
+    assert LogCache(log_copy).get_records("POSIX") is not None
+
+    # a new mtime alone does not invalidate the cache
+    os.utime(log_copy, ns=(0, 0))
+    assert LogCache(log_copy).get_records("POSIX") is not None
+
+    # a different log does
+    shutil.copy(get_log_path("sample.darshan"), log_copy)
+    assert LogCache(log_copy).get_records("POSIX") is None
+    report = darshan.DarshanReport(log_copy, cache=True)
+    expected = darshan.DarshanReport(get_log_path("sample.darshan"))
+    assert report.name_records == expected.name_records
+
+    # as does a corrupt cache file
+    with open(log_copy + ".idx", "r+b") as f:
+        f.truncate(100)
+    assert LogCache(log_copy).get_name_records() is None
+    report = darshan.DarshanReport(log_copy, cache=True)
+    assert report.name_records == expected.name_records
+
+
+def _put_entries(log_path, writer, n_entries, barrier):
+    cache = LogCache(log_path)
+    barrier.wait()
+    for i in range(n_entries):
+        cache.put_records(f"TEST{writer}", {f"col{i}": np.full(1000 + i, writer * 1000 + i)})
+
+
+def _load_entries(log_path, n_loads, barrier):
+    barrier.wait()
+    for _ in range(n_loads):
+        cache = LogCache(log_path)
+        assert cache._toc_offset is not None
+        for writer in (1, 2):
+            for name, arr in (cache.get_records(f"TEST{writer}") or {}).items():
+                i = int(name[3:])
+                assert (arr == writer * 1000 + i).all()
+
+
+def test_concurrent_writers(log_copy):
+    # two processes append to the same cache file while a third one
+    # keeps loading it; no entry may be lost or read half-written
+    darshan.DarshanReport(log_copy, cache=True)
+    ctx = multiprocessing.get_context("fork")
+    n_entries = 50
+    barrier = ctx.Barrier(3)
+    procs = [ctx.Process(target=_put_entries, args=(log_copy, writer, n_entries, barrier))
+             for writer in (1, 2)]
+    procs.append(ctx.Process(target=_load_entries, args=(log_copy, 50, barrier)))
+    for proc in procs:
+        proc.start()
+    for proc in procs:
+        proc.join()
+        assert proc.exitcode == 0
+
+    cache = LogCache(log_copy)
+    assert cache.get_records("POSIX") is not None
+    for writer in (1, 2):
+        cols = cache.get_records(f"TEST{writer}")
+        assert len(cols) == n_entries
+        for i in range(n_entries):
+            assert (cols[f"col{i}"] == np.full(1000 + i, writer * 1000 + i)).all()
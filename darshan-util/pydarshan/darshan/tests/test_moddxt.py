@@ -1,5 +1,6 @@
 import os
 
+import numpy as np
 import pytest
 import darshan.backend.cffi_backend as backend
 from darshan.log_utils import get_log_path
@@ -37,3 +38,69 @@ def test_dxt_records(logfile, mod, expected_dict):
     log = backend.log_open(logfile)
     rec = backend.log_get_record(log, mod)
     assert rec == expected_dict
+
+    # the numpy and pandas forms hold the same segments
+    log = backend.log_open(logfile)
+    rec = backend.log_get_record(log, mod, dtype="numpy")
+    for key in ["write_segments", "read_segments"]:
+        assert isinstance(rec[key], np.ndarray)
+        assert [dict(zip(rec[key].dtype.names, seg)) for seg in rec[key].tolist()] == expected_dict[key]
+    log = backend.log_open(logfile)
+    rec = backend.log_get_record(log, mod, dtype="pandas")
+    for key in ["write_segments", "read_segments"]:
+        assert rec[key].to_dict("records") == expected_dict[key]
+
+
+@pytest.mark.parametrize("logfile", [
+    "sample-dxt-simple.darshan",
+    "dxt.darshan",
+    ])
+@pytest.mark.parametrize("mod", ["DXT_POSIX", "DXT_MPIIO"])
+def test_read_all_dxt_records(logfile, mod):
+    # the bulk read concatenates the segments of every record
+    logfile = get_log_path(logfile)
+    log = backend.log_open(logfile)
+    expected = {"write": [], "read": []}
+    while True:
+        rec = backend.log_get_dxt_record(log, mod, dtype="dict")
+        if rec is None:
+            break
+        for op in ["write", "read"]:
+            for seg in rec[op + "_segments"]:
+                expected[op].append(dict(id=rec["id"], rank=rec["rank"], **seg))
+
+    log = backend.log_open(logfile)
+    actual = backend.log_read_all_dxt_records(log, mod)
+    for op in ["write", "read"]:
+        assert actual[op].dtype.names == ("id", "rank", "offset", "length",
+                                          "start_time", "end_time")
+        assert [dict(zip(actual[op].dtype.names, seg))
+                for seg in actual[op].tolist()] == expected[op]
+
+
+@pytest.mark.parametrize("logfile", [
+    "sample-dxt-simple.darshan",
+    "dxt.darshan",
+    ])
+def test_dxt2png(logfile):
+    # dxt2png edits and concatenates the segments of report records, so
+    # DarshanReport has to keep handing them out as lists of dicts
+    pytest.importorskip("PIL")
+    import darshan
+    from darshan.experimental.transforms import dxt2png
+    report = darshan.DarshanReport(get_log_path(logfile))
+    drawn = 0
+    for mod in ["DXT_POSIX", "DXT_MPIIO"]:
+        if mod not in report.records:
+            continue
+        for rec in report.records[mod]:
+            assert isinstance(rec["write_segments"], list)
+            assert isinstance(rec["read_segments"], list)
+            if not any(seg["length"] for seg in
+                       rec["read_segments"] + rec["write_segments"]):
+                continue
+            for draw in [dxt2png.segment, dxt2png.wallclock]:
+                img = draw(rec)
+                assert img.width >= 1 and img.height >= 1
+            drawn += 1
+    assert drawn > 0
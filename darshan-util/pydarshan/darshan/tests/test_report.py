@@ -85,6 +85,45 @@ def test_load_records_filtered():
         assert 1 == len(report.data['records']['POSIX'])
         assert 1 == len(report.data['records']['MPI-IO'])
 
+@pytest.mark.parametrize("filter_patterns", [
+    [r"\.h5$"],
+    [r"^/tmp/test/macsio-", r"timings"],
+    [r"hdf5_[0-9]+.h5:"],
+    [r"\d+\.h5"],  # not a POSIX regex, filtered in Python
+    [r"(?i)MACSIO"],  # likewise
+    ])
+@pytest.mark.parametrize("filter_mode", ["exclude", "include"])
+def test_load_records_filtered_in_c(filter_patterns, filter_mode):
+    # names filtered by darshan-util must match those filtered in Python
+    logfile = get_log_path("shane_macsio_id29959_5-22-32552-7035573431850780836_1590156158.darshan")
+    log = backend.log_open(logfile)
+    compiled = [re.compile(p) for p in filter_patterns]
+    expected_names = {rec_id: name
+                      for rec_id, name in backend.log_get_name_records(log).items()
+                      if any(p.search(name) for p in compiled) == (filter_mode == "include")}
+    backend.log_close(log)
+
+    log = backend.log_open(logfile)
+    names = backend.log_get_matching_name_records(log, filter_patterns, filter_mode)
+    backend.log_close(log)
+    if all(backend._posix_regex_compatible(p) for p in filter_patterns):
+        assert names == expected_names
+    else:
+        assert names is None
+
+    with darshan.DarshanReport(logfile, filter_patterns=filter_patterns,
+                               filter_mode=filter_mode) as report:
+        assert report.name_records == expected_names
+        for mod in ["POSIX", "MPI-IO"]:
+            for rec in report.records[mod]:
+                assert rec["id"] in expected_names
+    with darshan.DarshanReport(logfile) as report:
+        for mod in ["POSIX", "MPI-IO"]:
+            expected_count = sum(rec["id"] in expected_names for rec in report.records[mod])
+            with darshan.DarshanReport(logfile, filter_patterns=filter_patterns,
+                                       filter_mode=filter_mode) as filtered:
+                assert len(filtered.records[mod]) == expected_count
+
 def test_dfs_daos_posix_match():
     # the ior runs by Shane with POSIX vs. DAOS DFS
     # backend should produce matching counters where
@@ -268,6 +307,43 @@ def test_deepcopy_fidelity_darshan_report(key, subkey):
                                        report.data['records'][key].to_numpy()[0][subkey])
 
 
+def test_report_operations_are_views():
+    # filtered and merged reports select records of their parent reports
+    # instead of copying them, until they are deep copied
+    darshan.enable_experimental()
+    with darshan.DarshanReport(get_log_path("sample.darshan")) as report:
+        stdio_ids = [rec["id"] for rec in report.records["STDIO"]._records]
+        stderr_id = next(rec_id for rec_id, name in report.name_records.items()
+                         if name == "<STDERR>")
+
+        filtered = report.filter(name_records=["<STDERR>"])
+        assert list(filtered.records) == ["STDIO"]
+        assert filtered.data["records"] is filtered.records
+        stdio = filtered.records["STDIO"]
+        assert len(stdio) == stdio_ids.count(stderr_id)
+        assert all(rec["id"] == stderr_id for rec in stdio._iter_records())
+        assert stdio[0]._records[0] is next(rec for rec in report.records["STDIO"]._records
+                                            if rec["id"] == stderr_id)
+
+        merged = report + filtered
+        assert len(merged.records["POSIX"]) == 1
+        assert len(merged.records["STDIO"]) == len(stdio_ids) + len(stdio)
+        assert merged.records["STDIO"][-1]._records[0] is stdio[-1]._records[0]
+        assert len(merged.filter(name_records=["<STDERR>"]).records["STDIO"]) == 2 * len(stdio)
+
+        # reduced records are new
+        reduced = filtered.reduce()
+        assert len(reduced.records["STDIO"]) == 1
+        assert_allclose(reduced.records["STDIO"][0]["counters"],
+                        np.sum([rec["counters"] for rec in stdio._iter_records()], axis=0))
+
+        # deep copies only hold the selected records
+        stdio_copy = copy.deepcopy(filtered).records["STDIO"]
+        assert len(stdio_copy) == len(stdio)
+        assert not np.may_share_memory(stdio_copy[0]["counters"], stdio[0]["counters"])
+        assert len(report.records["STDIO"]) == len(stdio_ids)
+
+
 class TestDarshanRecordCollection:
 
     @pytest.mark.parametrize("mod",
@@ -11,6 +11,8 @@
 
 static MunitResult inject_shared_file_records(const MunitParameter params[], void* data);
 static MunitResult inject_unique_file_records(const MunitParameter params[], void* data);
+static MunitResult merge_accumulators(const MunitParameter params[], void* data);
+static MunitResult track_common_values(const MunitParameter params[], void* data);
 static void* test_context_setup(const MunitParameter params[], void* user_data);
 static void test_context_tear_down(void *data);
 
@@ -35,6 +37,12 @@ static MunitTest tests[]
        {"/inject-unique-file-records", inject_unique_file_records,
         test_context_setup, test_context_tear_down, MUNIT_TEST_OPTION_NONE,
         test_params},
+       {"/merge-accumulators", merge_accumulators,
+        test_context_setup, test_context_tear_down, MUNIT_TEST_OPTION_NONE,
+        test_params},
+       {"/track-common-values", track_common_values,
+        test_context_setup, test_context_tear_down, MUNIT_TEST_OPTION_NONE,
+        test_params},
        {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL}};
 
 static const MunitSuite test_suite = {
@@ -237,6 +245,208 @@ static MunitResult inject_unique_file_records(const MunitParameter params[], voi
     return MUNIT_OK;
 }
 
+/* test merging accumulators that each saw one of the records, for both
+ * shared and unique files
+ */
+static MunitResult merge_accumulators(const MunitParameter params[], void* data)
+{
+    struct test_context* ctx = (struct test_context*)data;
+    int ret;
+    int shared_file_flag;
+    darshan_accumulator acc1, acc2, acc_empty, acc_other;
+    struct darshan_derived_metrics metrics;
+    void* record1;
+    void* record2;
+    void* record_agg;
+    struct darshan_base_record* base_rec;
+
+    record1 = malloc(DEF_MOD_BUF_SIZE);
+    munit_assert_not_null(record1);
+    record2 = malloc(DEF_MOD_BUF_SIZE);
+    munit_assert_not_null(record2);
+    record_agg = malloc(DEF_MOD_BUF_SIZE);
+    munit_assert_not_null(record_agg);
+
+    /* make sure we have a function defined to set example records */
+    munit_assert_not_null(set_dummy_fn[ctx->mod_id]);
+
+    for(shared_file_flag = 0; shared_file_flag < 2; shared_file_flag++) {
+        set_dummy_fn[ctx->mod_id](record1);
+        set_dummy_fn[ctx->mod_id](record2);
+        base_rec = record2;
+        base_rec->rank++;
+        if(!shared_file_flag)
+            base_rec->id++;
+
+        ret = darshan_accumulator_create(ctx->mod_id, 4, &acc1);
+        munit_assert_int(ret, ==, 0);
+        ret = darshan_accumulator_create(ctx->mod_id, 4, &acc2);
+        munit_assert_int(ret, ==, 0);
+        ret = darshan_accumulator_create(ctx->mod_id, 4, &acc_empty);
+        munit_assert_int(ret, ==, 0);
+
+        /* one record per accumulator, merged into an empty accumulator */
+        ret = darshan_accumulator_inject(acc1, record1, 1);
+        munit_assert_int(ret, ==, 0);
+        ret = darshan_accumulator_inject(acc2, record2, 1);
+        munit_assert_int(ret, ==, 0);
+        ret = darshan_accumulator_merge(acc_empty, acc1);
+        munit_assert_int(ret, ==, 0);
+        ret = darshan_accumulator_merge(acc_empty, acc2);
+        munit_assert_int(ret, ==, 0);
+
+        ret = darshan_accumulator_emit(acc_empty, &metrics, record_agg);
+        munit_assert_int(ret, ==, 0);
+        validate_double_dummy_fn[ctx->mod_id](record_agg, &metrics, shared_file_flag);
+        /* rank 1 gets the same time as rank 0; the lower rank wins */
+        munit_assert_int(metrics.unique_io_slowest_rank, ==, 0);
+
+        /* merging into an accumulator that already has records */
+        ret = darshan_accumulator_merge(acc1, acc2);
+        munit_assert_int(ret, ==, 0);
+        ret = darshan_accumulator_emit(acc1, &metrics, record_agg);
+        munit_assert_int(ret, ==, 0);
+        validate_double_dummy_fn[ctx->mod_id](record_agg, &metrics, shared_file_flag);
+
+        ret = darshan_accumulator_destroy(acc1);
+        munit_assert_int(ret, ==, 0);
+        ret = darshan_accumulator_destroy(acc2);
+        munit_assert_int(ret, ==, 0);
+        ret = darshan_accumulator_destroy(acc_empty);
+        munit_assert_int(ret, ==, 0);
+    }
+
+    /* accumulators of different modules cannot be merged */
+    ret = darshan_accumulator_create(ctx->mod_id, 4, &acc1);
+    munit_assert_int(ret, ==, 0);
+    ret = darshan_accumulator_create(
+        ctx->mod_id == DARSHAN_POSIX_MOD ? DARSHAN_STDIO_MOD : DARSHAN_POSIX_MOD,
+        4, &acc_other);
+    munit_assert_int(ret, ==, 0);
+    ret = darshan_accumulator_merge(acc1, acc_other);
+    munit_assert_int(ret, ==, -1);
+    darshan_accumulator_destroy(acc1);
+    darshan_accumulator_destroy(acc_other);
+
+    free(record1);
+    free(record2);
+    free(record_agg);
+
+    return MUNIT_OK;
+}
+
+/* test sketching common access sizes across records whose local top 4
+ * values hide the globally most common one
+ */
+static MunitResult track_common_values(const MunitParameter params[], void* data)
+{
+    struct test_context* ctx = (struct test_context*)data;
+    int ret;
+    int i, j;
+    darshan_accumulator acc1, acc2;
+    struct darshan_derived_metrics metrics;
+    struct darshan_common_value top[DARSHAN_COMMON_VALUE_SKETCH_SIZE];
+    struct darshan_common_value_sketch sketch;
+    int64_t *values, *counts;
+    void* records;
+    void* record;
+    void* record_agg;
+
+    ret = darshan_accumulator_create(ctx->mod_id, 4, &acc1);
+    munit_assert_int(ret, ==, 0);
+    ret = darshan_accumulator_create(ctx->mod_id, 4, &acc2);
+    munit_assert_int(ret, ==, 0);
+
+    if(!ctx->mod_fns->log_common_values) {
+        /* this module has no common values to track */
+        ret = darshan_accumulator_track_common_values(acc1);
+        munit_assert_int(ret, ==, -1);
+        darshan_accumulator_destroy(acc1);
+        darshan_accumulator_destroy(acc2);
+        return MUNIT_OK;
+    }
+
+    records = malloc(8 * DEF_MOD_BUF_SIZE);
+    munit_assert_not_null(records);
+    record_agg = malloc(DEF_MOD_BUF_SIZE);
+    munit_assert_not_null(record_agg);
+
+    /* each record's top 3 access sizes are unique to it, while 4096 is
+     * only its 4th most common access size, but the most common one overall
+     */
+    for(i = 0; i < 8; i++) {
+        record = (char*)records + i * DEF_MOD_BUF_SIZE;
+        set_dummy_fn[ctx->mod_id](record);
+        ret = ctx->mod_fns->log_common_values(record,
+            DARSHAN_COMMON_ACCESS_SIZES, &values, &counts);
+        munit_assert_int(ret, ==, 4);
+        for(j = 0; j < 3; j++) {
+            values[j] = 100 * (i + 1) + j;
+            counts[j] = 10 - j;
+        }
+        values[3] = 4096;
+        counts[3] = 2;
+    }
+
+    /* half of the records in each accumulator */
+    ret = darshan_accumulator_track_common_values(acc1);
+    munit_assert_int(ret, ==, 0);
+    ret = darshan_accumulator_track_common_values(acc2);
+    munit_assert_int(ret, ==, 0);
+    for(i = 0; i < 8; i++) {
+        record = (char*)records + i * DEF_MOD_BUF_SIZE;
+        ret = darshan_accumulator_inject((i < 4) ? acc1 : acc2, record, 1);
+        munit_assert_int(ret, ==, 0);
+    }
+    /* tracking can't be enabled once records have been injected */
+    munit_assert_int(darshan_accumulator_track_common_values(acc1), ==, -1);
+    ret = darshan_accumulator_merge(acc1, acc2);
+    munit_assert_int(ret, ==, 0);
+
+    /* fewer distinct values than the sketch size, so counts are exact */
+    ret = darshan_accumulator_emit_common_values(acc1,
+        DARSHAN_COMMON_ACCESS_SIZES, top, DARSHAN_COMMON_VALUE_SKETCH_SIZE);
+    munit_assert_int(ret, ==, 25);
+    munit_assert_int64(top[0].value, ==, 4096);
+    munit_assert_int64(top[0].count, ==, 16);
+    munit_assert_int64(top[0].error, ==, 0);
+    for(i = 1; i < ret; i++) {
+        munit_assert_int64(top[i].count, <=, top[i-1].count);
+        munit_assert_int64(top[i].error, ==, 0);
+    }
+
+    /* the aggregate record holds the most common values of the sketch */
+    ret = darshan_accumulator_emit(acc1, &metrics, record_agg);
+    munit_assert_int(ret, ==, 0);
+    ctx->mod_fns->log_common_values(record_agg, DARSHAN_COMMON_ACCESS_SIZES,
+        &values, &counts);
+    for(i = 0; i < 4; i++) {
+        munit_assert_int64(values[i], ==, top[i].value);
+        munit_assert_int64(counts[i], ==, top[i].count);
+    }
+
+    darshan_accumulator_destroy(acc1);
+    darshan_accumulator_destroy(acc2);
+    free(records);
+    free(record_agg);
+
+    /* once there are more distinct values than the sketch size, counts are
+     * bounded by their error
+     */
+    darshan_common_value_sketch_init(&sketch);
+    darshan_common_value_sketch_add(&sketch, 1, 1000);
+    for(i = 0; i < 200; i++)
+        darshan_common_value_sketch_add(&sketch, 2 + i, 1);
+    munit_assert_int64(sketch.total, ==, 1200);
+    ret = darshan_common_value_sketch_top(&sketch, top, 2);
+    munit_assert_int(ret, ==, 2);
+    munit_assert_int64(top[0].value, ==, 1);
+    munit_assert_int64(top[0].count - top[0].error, <=, 1000);
+    munit_assert_int64(top[0].count, >=, 1000);
+    munit_assert_int64(top[1].error, <=, sketch.total / DARSHAN_COMMON_VALUE_SKETCH_SIZE);
+
+    return MUNIT_OK;
+}
 
 int main(int argc, char **argv)
 {
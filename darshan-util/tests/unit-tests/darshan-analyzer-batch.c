@@ -0,0 +1,311 @@
+/*
+ * Copyright (C) 2026 University of Chicago.
+ * See COPYRIGHT notice in top-level directory.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "munit/munit.h"
+
+#include <darshan-logutils.h>
+
+/* tests are run from the darshan-util build directory */
+#define ANALYZER_PATH "./darshan-analyzer"
+
+#define LOG_COUNT 6
+#define MAX_COLS 64
+
+static MunitResult write_csv(const MunitParameter params[], void* data);
+static MunitResult resume_checkpoint(const MunitParameter params[], void* data);
+static void* test_context_setup(const MunitParameter params[], void* user_data);
+static void test_context_tear_down(void *data);
+
+/* test definition */
+static MunitTest tests[]
+    = {{"/write-csv", write_csv, test_context_setup,
+        test_context_tear_down, MUNIT_TEST_OPTION_NONE, NULL},
+       {"/resume-checkpoint", resume_checkpoint, test_context_setup,
+        test_context_tear_down, MUNIT_TEST_OPTION_NONE, NULL},
+       {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL}};
+
+static const MunitSuite test_suite = {
+    "/darshan-analyzer-batch", tests, NULL, 1, MUNIT_SUITE_OPTION_NONE
+};
+
+struct test_context {
+    char dir[64];
+    char log_dir[96];
+    char log_paths[LOG_COUNT][128];
+    char bad_path[128];
+    char out_path[96];
+    char ckpt_path[96];
+    char list_path[96];
+};
+
+/* a parsed csv table; rows[0] is the header */
+struct csv_table {
+    char *buf;
+    char *rows[LOG_COUNT + 2][MAX_COLS];
+    int n_rows;
+    int n_cols;
+};
+
+/* log i has job id 100+i, i+1 rank 0 POSIX records reading 100 bytes each,
+ * and one shared POSIX record writing 1000 bytes
+ */
+static void write_log(const char *path, int i)
+{
+    struct darshan_job job;
+    struct darshan_posix_file pfile;
+    darshan_fd fd;
+    int j, ret;
+
+    fd = darshan_log_create(path, DARSHAN_ZLIB_COMP, 0);
+    munit_assert_not_null(fd);
+
+    memset(&job, 0, sizeof(job));
+    job.jobid = 100 + i;
+    job.nprocs = 2;
+    job.start_time_sec = 1000;
+    job.end_time_sec = 1000 + i;
+    ret = darshan_log_put_job(fd, &job);
+    munit_assert_int(ret, ==, 0);
+    ret = darshan_log_put_exe(fd, "darshan-analyzer-batch");
+    munit_assert_int(ret, ==, 0);
+    ret = darshan_log_put_mounts(fd, NULL, 0);
+    munit_assert_int(ret, ==, 0);
+    ret = darshan_log_put_namehash(fd, NULL);
+    munit_assert_int(ret, ==, 0);
+
+    memset(&pfile, 0, sizeof(pfile));
+    pfile.base_rec.id = 1;
+    pfile.base_rec.rank = -1;
+    pfile.counters[POSIX_OPENS] = 2;
+    pfile.counters[POSIX_WRITES] = 2;
+    pfile.counters[POSIX_BYTES_WRITTEN] = 1000;
+    ret = mod_logutils[DARSHAN_POSIX_MOD]->log_put_record(fd, &pfile);
+    munit_assert_int(ret, ==, 0);
+    for(j = 0; j <= i; j++)
+    {
+        memset(&pfile, 0, sizeof(pfile));
+        pfile.base_rec.id = j + 2;
+        pfile.base_rec.rank = 0;
+        pfile.counters[POSIX_OPENS] = 1;
+        pfile.counters[POSIX_READS] = 1;
+        pfile.counters[POSIX_BYTES_READ] = 100;
+        ret = mod_logutils[DARSHAN_POSIX_MOD]->log_put_record(fd, &pfile);
+        munit_assert_int(ret, ==, 0);
+    }
+    darshan_log_close(fd);
+}
+
+/* creates a directory holding LOG_COUNT logs and one file that is not a
+ * log; outputs are written next to, not inside, the log directory
+ */
+static void* test_context_setup(const MunitParameter params[], void* user_data)
+{
+    (void) params;
+    (void) user_data;
+    struct test_context* ctx;
+    FILE *f;
+    int i;
+
+    ctx = calloc(1, sizeof(*ctx));
+    munit_assert_not_null(ctx);
+
+    strcpy(ctx->dir, "/tmp/darshan-analyzer-batch-XXXXXX");
+    munit_assert_not_null(mkdtemp(ctx->dir));
+    snprintf(ctx->log_dir, sizeof(ctx->log_dir), "%s/logs", ctx->dir);
+    munit_assert_int(mkdir(ctx->log_dir, 0700), ==, 0);
+    snprintf(ctx->out_path, sizeof(ctx->out_path), "%s/out.csv", ctx->dir);
+    snprintf(ctx->ckpt_path, sizeof(ctx->ckpt_path), "%s/out.ckpt", ctx->dir);
+    snprintf(ctx->list_path, sizeof(ctx->list_path), "%s/list", ctx->dir);
+
+    for(i = 0; i < LOG_COUNT; i++)
+    {
+        snprintf(ctx->log_paths[i], sizeof(ctx->log_paths[i]),
+            "%s/job%d.darshan", ctx->log_dir, i);
+        write_log(ctx->log_paths[i], i);
+    }
+
+    snprintf(ctx->bad_path, sizeof(ctx->bad_path), "%s/notes.txt", ctx->log_dir);
+    f = fopen(ctx->bad_path, "w");
+    munit_assert_not_null(f);
+    fputs("not a darshan log\n", f);
+    fclose(f);
+
+    return ctx;
+}
+
+static void test_context_tear_down(void *data)
+{
+    struct test_context *ctx = (struct test_context*)data;
+    int i;
+
+    for(i = 0; i < LOG_COUNT; i++)
+        unlink(ctx->log_paths[i]);
+    unlink(ctx->bad_path);
+    unlink(ctx->out_path);
+    unlink(ctx->ckpt_path);
+    unlink(ctx->list_path);
+    rmdir(ctx->log_dir);
+    rmdir(ctx->dir);
+    free(ctx);
+}
+
+static int run_analyzer(const char *args)
+{
+    char cmd[1024];
+
+    snprintf(cmd, sizeof(cmd), "%s %s 2>/dev/null", ANALYZER_PATH, args);
+    return(system(cmd));
+}
+
+/* reads a csv file without quoted fields into a table */
+static void read_csv(const char *path, struct csv_table *table)
+{
+    FILE *f;
+    long size;
+    char *line, *next, *field;
+    int n_cols;
+
+    memset(table, 0, sizeof(*table));
+    f = fopen(path, "r");
+    munit_assert_not_null(f);
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    table->buf = calloc(1, size + 1);
+    munit_assert_not_null(table->buf);
+    munit_assert_size(fread(table->buf, 1, size, f), ==, (size_t)size);
+    fclose(f);
+
+    for(line = table->buf; line && *line; line = next)
+    {
+        next = strchr(line, '\n');
+        if(next)
+            *next++ = '\0';
+        munit_assert_int(table->n_rows, <, LOG_COUNT + 2);
+        n_cols = 0;
+        for(field = strsep(&line, ","); field; field = strsep(&line, ","))
+        {
+            munit_assert_int(n_cols, <, MAX_COLS);
+            table->rows[table->n_rows][n_cols++] = field;
+        }
+        if(table->n_rows == 0)
+            table->n_cols = n_cols;
+        munit_assert_int(n_cols, ==, table->n_cols);
+        table->n_rows++;
+    }
+}
+
+static int csv_col(struct csv_table *table, const char *name)
+{
+    int i;
+
+    for(i = 0; i < table->n_cols; i++)
+        if(strcmp(table->rows[0][i], name) == 0)
+            return(i);
+    munit_errorf("missing column %s", name);
+    return(-1);
+}
+
+/* checks that the output has exactly one row, with the expected metrics,
+ * for each log in the directory
+ */
+static void check_rows(struct test_context *ctx)
+{
+    struct csv_table table;
+    int log_col, jobid_col, nprocs_col, files_col, shared_col, read_col, write_col;
+    int seen[LOG_COUNT] = {0};
+    int row, i;
+
+    read_csv(ctx->out_path, &table);
+    munit_assert_int(table.n_rows, ==, LOG_COUNT + 1);
+    log_col = csv_col(&table, "log");
+    jobid_col = csv_col(&table, "jobid");
+    nprocs_col = csv_col(&table, "nprocs");
+    files_col = csv_col(&table, "posix_files");
+    shared_col = csv_col(&table, "posix_shared_files");
+    read_col = csv_col(&table, "posix_bytes_read");
+    write_col = csv_col(&table, "posix_bytes_written");
+
+    for(row = 1; row < table.n_rows; row++)
+    {
+        i = atoi(table.rows[row][jobid_col]) - 100;
+        munit_assert_int(i, >=, 0);
+        munit_assert_int(i, <, LOG_COUNT);
+        munit_assert_int(seen[i], ==, 0);
+        seen[i] = 1;
+
+        munit_assert_string_equal(table.rows[row][log_col], ctx->log_paths[i]);
+        munit_assert_int(atoi(table.rows[row][nprocs_col]), ==, 2);
+        munit_assert_int(atoi(table.rows[row][files_col]), ==, i + 2);
+        munit_assert_int(atoi(table.rows[row][shared_col]), ==, 1);
+        munit_assert_int(atoi(table.rows[row][read_col]), ==, 100 * (i + 1));
+        munit_assert_int(atoi(table.rows[row][write_col]), ==, 1000);
+    }
+
+    free(table.buf);
+}
+
+/* every log is analyzed once across several threads, and files that are
+ * not logs are left out of the output
+ */
+static MunitResult write_csv(const MunitParameter params[], void* data)
+{
+    struct test_context* ctx = (struct test_context*)data;
+    char args[512];
+
+    (void) params;
+
+    snprintf(args, sizeof(args), "--output=%s --threads=3 %s",
+        ctx->out_path, ctx->log_dir);
+    munit_assert_int(run_analyzer(args), ==, 0);
+    check_rows(ctx);
+
+    return MUNIT_OK;
+}
+
+/* a second run with the same checkpoint appends only the logs that the
+ * first run did not analyze
+ */
+static MunitResult resume_checkpoint(const MunitParameter params[], void* data)
+{
+    struct test_context* ctx = (struct test_context*)data;
+    struct csv_table table;
+    char args[512];
+    FILE *f;
+    int i;
+
+    (void) params;
+
+    f = fopen(ctx->list_path, "w");
+    munit_assert_not_null(f);
+    for(i = 0; i < LOG_COUNT / 2; i++)
+        fprintf(f, "%s\n", ctx->log_paths[i]);
+    fclose(f);
+
+    snprintf(args, sizeof(args), "--output=%s --checkpoint=%s --threads=2 "
+        "--file-list=%s", ctx->out_path, ctx->ckpt_path, ctx->list_path);
+    munit_assert_int(run_analyzer(args), ==, 0);
+    read_csv(ctx->out_path, &table);
+    munit_assert_int(table.n_rows, ==, LOG_COUNT / 2 + 1);
+    free(table.buf);
+
+    snprintf(args, sizeof(args), "--output=%s --checkpoint=%s --threads=2 %s",
+        ctx->out_path, ctx->ckpt_path, ctx->log_dir);
+    munit_assert_int(run_analyzer(args), ==, 0);
+    check_rows(ctx);
+
+    return MUNIT_OK;
+}
+
+int main(int argc, char **argv)
+{
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,338 @@
+/*
+ * Copyright (C) 2026 University of Chicago.
+ * See COPYRIGHT notice in top-level directory.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "munit/munit.h"
+
+#include <darshan-logutils.h>
+
+#define POSIX_REC_COUNT 5000
+#define STDIO_REC_COUNT 3000
+
+static MunitResult read_modules_concurrently(const MunitParameter params[], void* data);
+static MunitResult close_iterators_early(const MunitParameter params[], void* data);
+static MunitResult read_filtered_records(const MunitParameter params[], void* data);
+static MunitResult match_names(const MunitParameter params[], void* data);
+static void* test_context_setup(const MunitParameter params[], void* user_data);
+static void test_context_tear_down(void *data);
+
+static void *read_module(void *arg);
+
+/* test definition */
+static char* nthreads_params[] = {"0", "1", "4", NULL};
+
+static MunitParameterEnum test_params[]
+    = {{"nthreads", nthreads_params}, {NULL, NULL}};
+
+static MunitTest tests[]
+    = {{"/read-modules-concurrently", read_modules_concurrently,
+        test_context_setup, test_context_tear_down, MUNIT_TEST_OPTION_NONE,
+        test_params},
+       {"/close-iterators-early", close_iterators_early,
+        test_context_setup, test_context_tear_down, MUNIT_TEST_OPTION_NONE,
+        test_params},
+       {"/read-filtered-records", read_filtered_records,
+        test_context_setup, test_context_tear_down, MUNIT_TEST_OPTION_NONE,
+        test_params},
+       {"/match-names", match_names, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL},
+       {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL}};
+
+static const MunitSuite test_suite = {
+    "/darshan-log-reader", tests, NULL, 1, MUNIT_SUITE_OPTION_NONE
+};
+
+struct test_context {
+    char log_path[64];
+    int nthreads;
+};
+
+/* per-thread state for read_module() */
+struct module_reader {
+    darshan_mod_iter iter;
+    darshan_module_id mod_id;
+    int expected;
+    int count;
+    int ret;
+};
+
+/* writes a small log with POSIX and STDIO records whose record ids count
+ * up from 1, so readers can check record order
+ */
+static void* test_context_setup(const MunitParameter params[], void* user_data)
+{
+    (void) user_data;
+    struct test_context* ctx;
+    struct darshan_job job;
+    struct darshan_posix_file pfile;
+    struct darshan_stdio_file sfile;
+    darshan_fd fd;
+    int tmp_fd;
+    int i, ret;
+
+    ctx = calloc(1, sizeof(*ctx));
+    munit_assert_not_null(ctx);
+    ctx->nthreads = atoi(munit_parameters_get(params, "nthreads"));
+
+    strcpy(ctx->log_path, "/tmp/darshan-log-reader-XXXXXX");
+    tmp_fd = mkstemp(ctx->log_path);
+    munit_assert_int(tmp_fd, >=, 0);
+    close(tmp_fd);
+
+    fd = darshan_log_create(ctx->log_path, DARSHAN_ZLIB_COMP, 0);
+    munit_assert_not_null(fd);
+
+    memset(&job, 0, sizeof(job));
+    job.nprocs = 1;
+    ret = darshan_log_put_job(fd, &job);
+    munit_assert_int(ret, ==, 0);
+    ret = darshan_log_put_exe(fd, "darshan-log-reader");
+    munit_assert_int(ret, ==, 0);
+    ret = darshan_log_put_mounts(fd, NULL, 0);
+    munit_assert_int(ret, ==, 0);
+    ret = darshan_log_put_namehash(fd, NULL);
+    munit_assert_int(ret, ==, 0);
+
+    memset(&pfile, 0, sizeof(pfile));
+    for(i = 0; i < POSIX_REC_COUNT; i++)
+    {
+        pfile.base_rec.id = i + 1;
+        pfile.counters[POSIX_OPENS] = i;
+        ret = mod_logutils[DARSHAN_POSIX_MOD]->log_put_record(fd, &pfile);
+        munit_assert_int(ret, ==, 0);
+    }
+    memset(&sfile, 0, sizeof(sfile));
+    for(i = 0; i < STDIO_REC_COUNT; i++)
+    {
+        sfile.base_rec.id = i + 1;
+        ret = mod_logutils[DARSHAN_STDIO_MOD]->log_put_record(fd, &sfile);
+        munit_assert_int(ret, ==, 0);
+    }
+    darshan_log_close(fd);
+
+    return ctx;
+}
+
+static void test_context_tear_down(void *data)
+{
+    struct test_context *ctx = (struct test_context*)data;
+
+    unlink(ctx->log_path);
+    free(ctx);
+}
+
+/* each module is drained by its own thread; records must come back
+ * complete and in log order
+ */
+static MunitResult read_modules_concurrently(const MunitParameter params[], void* data)
+{
+    struct test_context* ctx = (struct test_context*)data;
+    darshan_log_reader reader;
+    struct module_reader readers[2] = {
+        {NULL, DARSHAN_POSIX_MOD, POSIX_REC_COUNT, 0, 0},
+        {NULL, DARSHAN_STDIO_MOD, STDIO_REC_COUNT, 0, 0}};
+    pthread_t threads[2];
+    int i, ret;
+
+    reader = darshan_log_reader_open(ctx->log_path, ctx->nthreads);
+    munit_assert_not_null(reader);
+
+    for(i = 0; i < 2; i++)
+    {
+        readers[i].iter = darshan_log_reader_mod_iter(reader, readers[i].mod_id);
+        munit_assert_not_null(readers[i].iter);
+    }
+    for(i = 0; i < 2; i++)
+    {
+        ret = pthread_create(&threads[i], NULL, read_module, &readers[i]);
+        munit_assert_int(ret, ==, 0);
+    }
+    for(i = 0; i < 2; i++)
+    {
+        pthread_join(threads[i], NULL);
+        munit_assert_int(readers[i].ret, ==, 0);
+        munit_assert_int(readers[i].count, ==, readers[i].expected);
+        darshan_mod_iter_close(readers[i].iter);
+    }
+
+    darshan_log_reader_close(reader);
+
+    return MUNIT_OK;
+}
+
+/* iterators closed before they are drained, or never read at all, must
+ * not block or leak
+ */
+static MunitResult close_iterators_early(const MunitParameter params[], void* data)
+{
+    struct test_context* ctx = (struct test_context*)data;
+    darshan_log_reader reader;
+    darshan_mod_iter posix_iter, stdio_iter, missing_iter;
+    void *rec;
+    int i, ret;
+
+    reader = darshan_log_reader_open(ctx->log_path, ctx->nthreads);
+    munit_assert_not_null(reader);
+
+    posix_iter = darshan_log_reader_mod_iter(reader, DARSHAN_POSIX_MOD);
+    munit_assert_not_null(posix_iter);
+    stdio_iter = darshan_log_reader_mod_iter(reader, DARSHAN_STDIO_MOD);
+    munit_assert_not_null(stdio_iter);
+    missing_iter = darshan_log_reader_mod_iter(reader, DARSHAN_MPIIO_MOD);
+    munit_assert_not_null(missing_iter);
+
+    for(i = 0; i < 10; i++)
+    {
+        ret = darshan_mod_iter_next(posix_iter, &rec);
+        munit_assert_int(ret, ==, 1);
+        munit_assert_uint64(((struct darshan_base_record *)rec)->id, ==, i + 1);
+        free(rec);
+    }
+    darshan_mod_iter_close(posix_iter);
+
+    /* a module without data is simply empty */
+    ret = darshan_mod_iter_next(missing_iter, &rec);
+    munit_assert_int(ret, ==, 0);
+    munit_assert_null(rec);
+
+    /* the reader closes iterators that are still open */
+    darshan_log_reader_close(reader);
+    (void)stdio_iter;
+
+    return MUNIT_OK;
+}
+
+/* records whose ids are not in the set are skipped, both when reading
+ * through the log handle and through an iterator
+ */
+static MunitResult read_filtered_records(const MunitParameter params[], void* data)
+{
+    struct test_context* ctx = (struct test_context*)data;
+    struct darshan_record_id_set *ids;
+    darshan_log_reader reader;
+    darshan_mod_iter iter;
+    darshan_record_id id;
+    darshan_fd fd;
+    void *rec = NULL;
+    int count;
+    int i, ret;
+
+    /* every third record */
+    ids = darshan_record_id_set_create(NULL, 0);
+    munit_assert_not_null(ids);
+    for(i = 3; i <= POSIX_REC_COUNT; i += 3)
+    {
+        ret = darshan_record_id_set_add(ids, i);
+        munit_assert_int(ret, ==, 0);
+    }
+    ret = darshan_record_id_set_add(ids, 3);
+    munit_assert_int(ret, ==, 0);
+    munit_assert_int64(darshan_record_id_set_count(ids), ==, POSIX_REC_COUNT / 3);
+    munit_assert_int(darshan_record_id_set_contains(ids, 0), ==, 0);
+    munit_assert_int(darshan_record_id_set_contains(ids, 4), ==, 0);
+    munit_assert_int(darshan_record_id_set_contains(ids, 3 * 1000), ==, 1);
+
+    fd = darshan_log_open(ctx->log_path);
+    munit_assert_not_null(fd);
+    count = 0;
+    while((ret = darshan_log_get_filtered_record(fd, DARSHAN_POSIX_MOD, &rec, ids)) == 1)
+    {
+        id = ((struct darshan_base_record *)rec)->id;
+        munit_assert_uint64(id, ==, 3 * (count + 1));
+        free(rec);
+        rec = NULL;
+        count++;
+    }
+    munit_assert_int(ret, ==, 0);
+    munit_assert_int(count, ==, POSIX_REC_COUNT / 3);
+    darshan_log_close(fd);
+
+    reader = darshan_log_reader_open(ctx->log_path, ctx->nthreads);
+    munit_assert_not_null(reader);
+    iter = darshan_log_reader_mod_iter(reader, DARSHAN_STDIO_MOD);
+    munit_assert_not_null(iter);
+    count = 0;
+    while((ret = darshan_mod_iter_next_filtered(iter, &rec, ids)) == 1)
+    {
+        id = ((struct darshan_base_record *)rec)->id;
+        munit_assert_uint64(id, ==, 3 * (count + 1));
+        free(rec);
+        count++;
+    }
+    munit_assert_int(ret, ==, 0);
+    munit_assert_int(count, ==, STDIO_REC_COUNT / 3);
+    darshan_log_reader_close(reader);
+
+    darshan_record_id_set_destroy(ids);
+
+    return MUNIT_OK;
+}
+
+/* plain string patterns and regular expressions select the same names */
+static MunitResult match_names(const MunitParameter params[], void* data)
+{
+    const char *patterns[] = {"\\.h5$", "^/scratch/", "out[0-9]+\\.dat", "log"};
+    const char *bad_patterns[] = {"("};
+    struct darshan_name_filter *filter;
+
+    filter = darshan_name_filter_create(patterns, 4, DARSHAN_NAME_FILTER_INCLUDE);
+    munit_assert_not_null(filter);
+    munit_assert_int(darshan_name_filter_match(filter, "/home/a.h5"), ==, 1);
+    munit_assert_int(darshan_name_filter_match(filter, "/home/a.h5.bak"), ==, 0);
+    munit_assert_int(darshan_name_filter_match(filter, "/scratch/a"), ==, 1);
+    munit_assert_int(darshan_name_filter_match(filter, "/home/scratch/a"), ==, 0);
+    munit_assert_int(darshan_name_filter_match(filter, "/home/out12.dat"), ==, 1);
+    munit_assert_int(darshan_name_filter_match(filter, "/home/out.dat"), ==, 0);
+    munit_assert_int(darshan_name_filter_match(filter, "/home/catalog"), ==, 1);
+    darshan_name_filter_destroy(filter);
+
+    filter = darshan_name_filter_create(patterns, 4, DARSHAN_NAME_FILTER_EXCLUDE);
+    munit_assert_not_null(filter);
+    munit_assert_int(darshan_name_filter_match(filter, "/home/a.h5"), ==, 0);
+    munit_assert_int(darshan_name_filter_match(filter, "/home/out.dat"), ==, 1);
+    darshan_name_filter_destroy(filter);
+
+    /* no patterns keep every name */
+    filter = darshan_name_filter_create(NULL, 0, DARSHAN_NAME_FILTER_INCLUDE);
+    munit_assert_not_null(filter);
+    munit_assert_int(darshan_name_filter_match(filter, "/home/a"), ==, 1);
+    darshan_name_filter_destroy(filter);
+
+    filter = darshan_name_filter_create(bad_patterns, 1, DARSHAN_NAME_FILTER_INCLUDE);
+    munit_assert_null(filter);
+
+    return MUNIT_OK;
+}
+
+static void *read_module(void *arg)
+{
+    struct module_reader *mr = arg;
+    struct darshan_base_record *base_rec;
+    void *rec;
+    int ret;
+
+    while((ret = darshan_mod_iter_next(mr->iter, &rec)) == 1)
+    {
+        base_rec = rec;
+        if(base_rec->id != (darshan_record_id)(mr->count + 1))
+            ret = -1;
+        free(rec);
+        if(ret < 0)
+            break;
+        mr->count++;
+    }
+    mr->ret = ret;
+
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2026 University of Chicago.
+ * See COPYRIGHT notice in top-level directory.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "munit/munit.h"
+
+#include <darshan-logutils.h>
+
+#define LOOKUP_COUNT 20000
+
+static MunitResult trie_matches_linear_scan(const MunitParameter params[], void* data);
+static MunitResult bench_linear_lookup(const MunitParameter params[], void* data);
+static MunitResult bench_trie_lookup(const MunitParameter params[], void* data);
+static void* test_context_setup(const MunitParameter params[], void* user_data);
+static void test_context_tear_down(void *data);
+
+static int mnt_path_len_cmp(const void *a, const void *b);
+static struct darshan_mnt_info *linear_lookup(struct darshan_mnt_info *mnts,
+    int count, const char *path);
+
+/* test definition; the larger tables double as a benchmark of the trie
+ * against the linear scan it replaces, e.g.:
+ *   darshan-mnt-trie --param mount_count 4096 --iterations 5
+ */
+static char* mount_count_params[] = {"1", "16", "256", "4096", NULL};
+
+static MunitParameterEnum test_params[]
+    = {{"mount_count", mount_count_params}, {NULL, NULL}};
+
+static MunitTest tests[]
+    = {{"/trie-matches-linear-scan", trie_matches_linear_scan,
+        test_context_setup, test_context_tear_down, MUNIT_TEST_OPTION_NONE,
+        test_params},
+       {"/bench-linear-lookup", bench_linear_lookup,
+        test_context_setup, test_context_tear_down, MUNIT_TEST_OPTION_NONE,
+        test_params},
+       {"/bench-trie-lookup", bench_trie_lookup,
+        test_context_setup, test_context_tear_down, MUNIT_TEST_OPTION_NONE,
+        test_params},
+       {NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL}};
+
+static const MunitSuite test_suite = {
+    "/darshan-mnt-trie", tests, NULL, 1, MUNIT_SUITE_OPTION_NONE
+};
+
+struct test_context {
+    struct darshan_mnt_info *mnts;
+    int mount_count;
+    char **paths;
+    int path_count;
+};
+
+/* builds a synthetic mount table of the requested size, sorted the same way
+ * darshan_log_get_mounts() sorts it, along with a set of file names to look
+ * up in it
+ */
+static void* test_context_setup(const MunitParameter params[], void* user_data)
+{
+    (void) user_data;
+    struct test_context* ctx;
+    struct darshan_mnt_info *mnt;
+    char suffix[64];
+    int i, n;
+
+    ctx = calloc(1, sizeof(*ctx));
+    munit_assert_not_null(ctx);
+
+    n = atoi(munit_parameters_get(params, "mount_count"));
+    munit_assert_int(n, >, 0);
+
+    /* always include the root file system and a duplicated path, plus
+     * nested mounts whose names are prefixes of each other (/fs1, /fs10)
+     */
+    ctx->mount_count = n + 2;
+    ctx->mnts = calloc(ctx->mount_count, sizeof(*ctx->mnts));
+    munit_assert_not_null(ctx->mnts);
+    strcpy(ctx->mnts[0].mnt_path, "/");
+    strcpy(ctx->mnts[0].mnt_type, "rootfs");
+    strcpy(ctx->mnts[1].mnt_path, "/dup");
+    strcpy(ctx->mnts[1].mnt_type, "nfs");
+    for(i = 0; i < n; i++)
+    {
+        mnt = &ctx->mnts[i + 2];
+        switch(i % 3)
+        {
+            case 0:
+                sprintf(mnt->mnt_path, "/fs%d", i / 3);
+                break;
+            case 1:
+                sprintf(mnt->mnt_path, "/fs%d/proj%d", i / 9, i);
+                break;
+            default:
+                sprintf(mnt->mnt_path, "/fs%d/proj%d/user%d", i / 9, i - 1, i);
+                break;
+        }
+        sprintf(mnt->mnt_type, "type%d", i);
+    }
+    if(n > 1)
+        strcpy(ctx->mnts[ctx->mount_count - 1].mnt_path, "/dup");
+    qsort(ctx->mnts, ctx->mount_count, sizeof(*ctx->mnts), mnt_path_len_cmp);
+
+    /* file names under a random mount, some of them only sharing a string
+     * prefix with it, and a few relative names that match nothing
+     */
+    ctx->path_count = LOOKUP_COUNT;
+    ctx->paths = malloc(ctx->path_count * sizeof(*ctx->paths));
+    munit_assert_not_null(ctx->paths);
+    for(i = 0; i < ctx->path_count; i++)
+    {
+        mnt = &ctx->mnts[munit_rand_int_range(0, ctx->mount_count - 1)];
+        switch(munit_rand_int_range(0, 3))
+        {
+            case 0:
+                sprintf(suffix, "/file.%d", i);
+                break;
+            case 1:
+                sprintf(suffix, "%d/file", munit_rand_int_range(0, 9));
+                break;
+            case 2:
+                suffix[0] = '\0';
+                break;
+            default:
+                ctx->paths[i] = strdup("relative/file");
+                munit_assert_not_null(ctx->paths[i]);
+                continue;
+        }
+        ctx->paths[i] = malloc(strlen(mnt->mnt_path) + strlen(suffix) + 1);
+        munit_assert_not_null(ctx->paths[i]);
+        sprintf(ctx->paths[i], "%s%s", mnt->mnt_path, suffix);
+    }
+
+    return ctx;
+}
+
+static void test_context_tear_down(void *data)
+{
+    struct test_context *ctx = (struct test_context*)data;
+    int i;
+
+    for(i = 0; i < ctx->path_count; i++)
+        free(ctx->paths[i]);
+    free(ctx->paths);
+    free(ctx->mnts);
+    free(ctx);
+}
+
+/* the trie must pick exactly the entry the linear scan used to pick */
+static MunitResult trie_matches_linear_scan(const MunitParameter params[], void* data)
+{
+    struct test_context* ctx = (struct test_context*)data;
+    struct darshan_mnt_trie *trie;
+    struct darshan_mnt_info *expected, *found;
+    int i;
+
+    trie = darshan_mnt_trie_create(ctx->mnts, ctx->mount_count);
+    munit_assert_not_null(trie);
+
+    for(i = 0; i < ctx->path_count; i++)
+    {
+        expected = linear_lookup(ctx->mnts, ctx->mount_count, ctx->paths[i]);
+        found = darshan_mnt_trie_lookup(trie, ctx->paths[i]);
+        munit_assert_ptr_equal(found, expected);
+    }
+
+    found = darshan_mnt_trie_lookup(trie, "/dup/file");
+    munit_assert_not_null(found);
+    munit_assert_string_equal(found->mnt_path, "/dup");
+    munit_assert_ptr_equal(found, linear_lookup(ctx->mnts, ctx->mount_count,
+        "/dup/file"));
+
+    darshan_mnt_trie_destroy(trie);
+
+    /* an empty table never matches */
+    trie = darshan_mnt_trie_create(NULL, 0);
+    munit_assert_not_null(trie);
+    munit_assert_null(darshan_mnt_trie_lookup(trie, "/fs0/file"));
+    darshan_mnt_trie_destroy(trie);
+
+    return MUNIT_OK;
+}
+
+static MunitResult bench_linear_lookup(const MunitParameter params[], void* data)
+{
+    struct test_context* ctx = (struct test_context*)data;
+    int i, matched = 0;
+
+    for(i = 0; i < ctx->path_count; i++)
+    {
+        if(linear_lookup(ctx->mnts, ctx->mount_count, ctx->paths[i]))
+            matched++;
+    }
+    munit_assert_int(matched, >, 0);
+
+    return MUNIT_OK;
+}
+
+static MunitResult bench_trie_lookup(const MunitParameter params[], void* data)
+{
+    struct test_context* ctx = (struct test_context*)data;
+    struct darshan_mnt_trie *trie;
+    int i, matched = 0;
+
+    trie = darshan_mnt_trie_create(ctx->mnts, ctx->mount_count);
+    munit_assert_not_null(trie);
+
+    for(i = 0; i < ctx->path_count; i++)
+    {
+        if(darshan_mnt_trie_lookup(trie, ctx->paths[i]))
+            matched++;
+    }
+    munit_assert_int(matched, >, 0);
+
+    darshan_mnt_trie_destroy(trie);
+
+    return MUNIT_OK;
+}
+
+int main(int argc, char **argv)
+{
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
+
+static int mnt_path_len_cmp(const void *a, const void *b)
+{
+    size_t len_a = strlen(((const struct darshan_mnt_info *)a)->mnt_path);
+    size_t len_b = strlen(((const struct darshan_mnt_info *)b)->mnt_path);
+
+    if(len_a > len_b)
+        return(-1);
+    else if(len_a < len_b)
+        return(1);
+    else
+        return(0);
+}
+
+/* the lookup the darshan-util tools used before darshan_mnt_trie */
+static struct darshan_mnt_info *linear_lookup(struct darshan_mnt_info *mnts,
+    int count, const char *path)
+{
+    int i;
+
+    for(i = 0; i < count; i++)
+    {
+        if(strncmp(mnts[i].mnt_path, path, strlen(mnts[i].mnt_path)) == 0)
+            return(&mnts[i]);
+    }
+
+    return(NULL);
+}
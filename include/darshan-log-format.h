@@ -131,6 +131,7 @@ struct darshan_base_record
 #include "darshan-heatmap-log-format.h"
 #include "darshan-dfs-log-format.h"
 #include "darshan-daos-log-format.h"
+#include "darshan-overlap-log-format.h"
 
 /* X-macro for keeping module ordering consistent */
 /* NOTE: first val used to define module enum values,
@@ -179,7 +180,8 @@ struct darshan_base_record
     X(DARSHAN_APMPI_MOD,    "APMPI",      __APMPI_VER,           __apmpi_logutils) \
     X(DARSHAN_HEATMAP_MOD,  "HEATMAP",    DARSHAN_HEATMAP_VER,   &heatmap_logutils) \
     X(DARSHAN_DFS_MOD,      "DFS",        DARSHAN_DFS_VER,       &dfs_logutils) \
-    X(DARSHAN_DAOS_MOD,     "DAOS",       DARSHAN_DAOS_VER,      &daos_logutils)
+    X(DARSHAN_DAOS_MOD,     "DAOS",       DARSHAN_DAOS_VER,      &daos_logutils) \
+    X(DARSHAN_OVERLAP_MOD,  "OVERLAP",    DARSHAN_OVERLAP_VER,   &overlap_logutils)
 
 /* unique identifiers to distinguish between available darshan modules */
 /* NOTES: - valid ids range from [0...DARSHAN_MAX_MODS-1]
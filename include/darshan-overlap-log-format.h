@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 University of Chicago.
+ * See COPYRIGHT notice in top-level directory.
+ *
+ */
+
+#ifndef __DARSHAN_OVERLAP_LOG_FORMAT_H
+#define __DARSHAN_OVERLAP_LOG_FORMAT_H
+
+/* current OVERLAP log format version */
+#define DARSHAN_OVERLAP_VER 1
+
+/* NOTE: "blocks" are aligned, OVERLAP_BLOCK_SIZE sized units of the file,
+ * normally the file system's lock or stripe unit.  A block is shared if
+ * more than one rank wrote to it, and falsely shared if no byte of it was
+ * written by more than one rank.
+ */
+#define OVERLAP_COUNTERS \
+    /* number of write operations */\
+    X(OVERLAP_WRITES) \
+    /* total bytes written */\
+    X(OVERLAP_BYTES_WRITTEN) \
+    /* number of distinct bytes written */\
+    X(OVERLAP_UNIQUE_BYTES) \
+    /* bytes written more than once by the same rank */\
+    X(OVERLAP_REWRITE_BYTES) \
+    /* distinct bytes written by more than one rank */\
+    X(OVERLAP_SHARED_BYTES) \
+    /* number of ranks that wrote to the file */\
+    X(OVERLAP_WRITER_RANKS) \
+    /* size of the blocks used for the block counters */\
+    X(OVERLAP_BLOCK_SIZE) \
+    /* number of blocks written */\
+    X(OVERLAP_BLOCKS) \
+    /* number of blocks written by more than one rank */\
+    X(OVERLAP_SHARED_BLOCKS) \
+    /* number of shared blocks without any byte written by more than one rank */\
+    X(OVERLAP_FALSE_SHARED_BLOCKS) \
+    /* largest number of ranks that wrote to a single block */\
+    X(OVERLAP_MAX_BLOCK_WRITERS) \
+    /* histogram of the number of ranks that wrote to each block */\
+    X(OVERLAP_BLOCK_WRITERS_1) \
+    X(OVERLAP_BLOCK_WRITERS_2) \
+    X(OVERLAP_BLOCK_WRITERS_3_4) \
+    X(OVERLAP_BLOCK_WRITERS_5_8) \
+    X(OVERLAP_BLOCK_WRITERS_9_16) \
+    X(OVERLAP_BLOCK_WRITERS_17_PLUS) \
+    /* unwritten bytes counted as written after coarsening written extents */\
+    X(OVERLAP_COARSENED_BYTES) \
+    /* end of counters */\
+    X(OVERLAP_NUM_INDICES)
+
+#define OVERLAP_F_COUNTERS \
+    /* mean number of ranks that wrote to each written block */\
+    X(OVERLAP_F_MEAN_BLOCK_WRITERS) \
+    /* end of counters */\
+    X(OVERLAP_F_NUM_INDICES)
+
+#define X(a) a,
+/* integer statistics for OVERLAP file records */
+enum darshan_overlap_indices
+{
+    OVERLAP_COUNTERS
+};
+
+/* floating point statistics for OVERLAP file records */
+enum darshan_overlap_f_indices
+{
+    OVERLAP_F_COUNTERS
+};
+#undef X
+
+/* file record structure for files written through POSIX, describing where
+ * the writes of one or more ranks overlapped.  A record includes:
+ *      - a darshan_base_record structure, which contains the record id & rank
+ *      - integer overlap counters (byte and block counts, writer histogram)
+ *      - floating point overlap counters
+ */
+struct darshan_overlap_file
+{
+    struct darshan_base_record base_rec;
+    int64_t counters[OVERLAP_NUM_INDICES];
+    double fcounters[OVERLAP_F_NUM_INDICES];
+};
+
+#endif /* __DARSHAN_OVERLAP_LOG_FORMAT_H */